@@ -4,6 +4,8 @@
 #include "fl/engine_events.h"
 #include "fl/compiler_control.h"
 #include "fl/int.h"
+#include "fl/frame_stats.h"
+#include "fl/trace.h"
 
 /// @file FastLED.cpp
 /// Central source file for FastLED, implements the CFastLED class/object
@@ -118,14 +120,26 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 static void* gControllersData[MAX_CLED_CONTROLLERS];
 
 void CFastLED::show(uint8_t scale) {
+	FL_TRACE_SCOPE("show");
+#if FASTLED_FRAME_STATS
+	fl::FrameStats &stats = fl::FrameStats::instance();
+	stats.beginShow(micros());
+#endif
 #ifndef FASTLED_MANUAL_ENGINE_EVENTS
 	fl::EngineEvents::onBeginFrame();
+#endif
+#if FASTLED_FRAME_STATS
+	const fl::u32 waitBegin = micros();
 #endif
 	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
 	lastshow = micros();
+#if FASTLED_FRAME_STATS
+	stats.endWait(waitBegin, lastshow);
+#endif
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
+		FL_TRACE_SCOPE("power");
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
 	}
 
@@ -147,6 +161,7 @@ void CFastLED::show(uint8_t scale) {
 	pCur = CLEDController::head();
 	for (length = 0; length < MAX_CLED_CONTROLLERS && pCur; length++) {
 		if (pCur->getEnabled()) {
+			FL_TRACE_SCOPE("controller.show");
 			pCur->showLedsInternal(scale);
 		}
 		pCur = pCur->next();
@@ -162,11 +177,34 @@ void CFastLED::show(uint8_t scale) {
 		length++;
 		pCur = pCur->next();
 	}
+#if !FASTLED_FRAME_STATS
 	countFPS();
+#endif
 	onEndFrame();
 #ifndef FASTLED_MANUAL_ENGINE_EVENTS
 	fl::EngineEvents::onEndShowLeds();
 #endif
+#if FASTLED_FRAME_STATS
+	stats.endShow(micros());
+	m_nFPS = stats.fps();
+#endif
+#if FASTLED_HAS_ENGINE_EVENTS && !defined(FASTLED_MANUAL_ENGINE_EVENTS)
+	runIdleSlice();
+#if FASTLED_FRAME_STATS
+	stats.endIdleSlice(micros());
+#endif
+#endif
+}
+
+void CFastLED::runIdleSlice() {
+	fl::FrameScheduler &scheduler = fl::FrameScheduler::instance();
+	fl::u32 budget = scheduler.idleBudget();
+	// Time the next show() would otherwise spin away in its refresh rate limit.
+	fl::u32 spent = micros() - lastshow;
+	if (m_nMinMicros && spent < m_nMinMicros && m_nMinMicros - spent > budget) {
+		budget = m_nMinMicros - spent;
+	}
+	scheduler.runIdle(budget);
 }
 
 void CFastLED::onEndFrame() {
@@ -196,8 +234,16 @@ CLEDController & CFastLED::operator[](int x) {
 }
 
 void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
+#if FASTLED_FRAME_STATS
+	fl::FrameStats &stats = fl::FrameStats::instance();
+	const fl::u32 waitBegin = micros();
+	stats.beginShow(waitBegin);
+#endif
 	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
 	lastshow = micros();
+#if FASTLED_FRAME_STATS
+	stats.endWait(waitBegin, lastshow);
+#endif
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
@@ -234,7 +280,12 @@ void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
 		length++;
 		pCur = pCur->next();
 	}
+#if FASTLED_FRAME_STATS
+	stats.endShow(micros());
+	m_nFPS = stats.fps();
+#else
 	countFPS();
+#endif
 	onEndFrame();
 }
 
@@ -401,6 +401,11 @@ public:
 	/// Manually trigger the end show LEDs event
 	/// @note This is called automatically by show() unless FASTLED_MANUAL_ENGINE_EVENTS is defined
 	void onEndShowLeds() { fl::EngineEvents::onEndShowLeds(); }
+
+	/// Run deferred listeners and fl::FrameScheduler tasks for the idle budget, or
+	/// until the refresh rate limit allows the next frame if that is later.
+	/// @note This is called automatically by show() unless FASTLED_MANUAL_ENGINE_EVENTS is defined
+	void runIdleSlice();
 	
 	/// @} Manual Engine Events
 
@@ -868,7 +873,8 @@ public:
 
 	/// For debugging, this will keep track of time between calls to countFPS(). Every
 	/// `nFrames` calls, it will update an internal counter for the current FPS.
-	/// @todo Make this a rolling counter
+	/// When FASTLED_FRAME_STATS is on, show() uses fl::FrameStats instead, which
+	/// also has frame time histograms, jitter and a per phase breakdown.
 	/// @param nFrames how many frames to time for determining FPS
 	void countFPS(int nFrames=25);
 
@@ -31,17 +31,30 @@ void CLEDController::clearLedDataInternal(int nLeds) {
 }
 
 ColorAdjustment CLEDController::getAdjustmentData(uint8_t brightness) {
-    // *premixed = getAdjustment(brightness);
-    // if (color_correction) {
-    //     *color_correction = getAdjustment(255);
-    // }
+    return getOutputProfile(brightness).adjustment;
+}
+
+const OutputProfile &CLEDController::getOutputProfile(uint8_t brightness) {
+    ProfileCache &cache = m_ProfileCache;
+    if (cache.valid && brightness == cache.brightness &&
+        m_DitherMode == cache.profile.dither &&
+        m_ColorCorrection == cache.correction &&
+        m_ColorTemperature == cache.temperature) {
+        return cache.profile;
+    }
     #if FASTLED_HD_COLOR_MIXING
-    ColorAdjustment out = {this->getAdjustment(brightness), this->getAdjustment(255), brightness};
+    ColorAdjustment adjustment = {getAdjustment(brightness), getAdjustment(255), brightness};
     #else
-    ColorAdjustment out = {getAdjustment(brightness)};
+    ColorAdjustment adjustment = {getAdjustment(brightness)};
     #endif
-    return out;
+    cache.profile.adjustment = adjustment;
+    PixelControllerCore::ditherSteps(adjustment.premixed, cache.profile.ditherSteps);
+    cache.profile.dither = m_DitherMode;
+    cache.brightness = brightness;
+    cache.correction = m_ColorCorrection;
+    cache.temperature = m_ColorTemperature;
+    cache.valid = true;
+    return cache.profile;
 }
 
-
 FASTLED_NAMESPACE_END
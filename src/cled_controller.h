@@ -63,6 +63,22 @@ public:
 
 
     Rgbw mRgbMode = RgbwInvalid::value();
+
+protected:
+    /// The OutputProfile show() last used and the settings it was built for.
+    /// Pointer aligned and kept as the last member so the class has no tail
+    /// padding: subclass members must start past sizeof(CLEDController) for
+    /// StripIdMap to find a controller from one of their addresses.
+    struct alignas(alignof(void *)) ProfileCache {
+        OutputProfile profile;  ///< @see getOutputProfile()
+        CRGB correction;        ///< correction the profile was built for
+        CRGB temperature;       ///< temperature the profile was built for
+        fl::u8 brightness = 0;  ///< brightness the profile was built for
+        bool valid = false;     ///< whether the profile has been built
+    };
+    ProfileCache m_ProfileCache;
+
+public:
     CLEDController& setRgbw(const Rgbw& arg = RgbwDefault::value()) {
         // Note that at this time (Sept 13th, 2024) this is only implemented in the ESP32 driver
         // directly. For an emulated version please see RGBWEmulatedController in chipsets.h
@@ -104,6 +120,12 @@ public:
 
     ColorAdjustment getAdjustmentData(fl::u8 brightness);
 
+    /// The color adjustment and dither setup show() uses at this brightness.
+    /// Cached per controller and rebuilt only when the brightness, color
+    /// correction, color temperature or dither mode changed since the last
+    /// call, so showing many controllers costs no setup per frame.
+    const OutputProfile &getOutputProfile(fl::u8 brightness);
+
     /// @copybrief show(const struct CRGB*, int, CRGB)
     ///
     /// Will scale for color correction and temperature. Can accept LED data not attached to this controller.
@@ -11,6 +11,7 @@
 
 #include "fl/force_inline.h"
 #include "fl/int.h"
+#include "fl/trace.h"
 #include "pixel_controller.h"
 #include "cled_controller.h"
 
@@ -31,11 +32,7 @@ protected:
     /// @param nLeds the number of LEDs to set to this color
     /// @param scale_pre_mixed the RGB scaling of color adjustment + global brightness to apply to each LED (in RGB8 mode).
     virtual void showColor(const CRGB& data, int nLeds, fl::u8 brightness) override {
-        // CRGB premixed, color_correction;
-        // getAdjustmentData(brightness, &premixed, &color_correction);
-        // ColorAdjustment color_adjustment = {premixed, color_correction, brightness};
-        ColorAdjustment color_adjustment = getAdjustmentData(brightness);
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, color_adjustment, getDither());
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, getOutputProfile(brightness));
         showPixels(pixels);
     }
 
@@ -44,8 +41,8 @@ protected:
     /// @param nLeds the number of LEDs being written out
     /// @param scale_pre_mixed the RGB scaling of color adjustment + global brightness to apply to each LED (in RGB8 mode).
     virtual void show(const struct CRGB *data, int nLeds, fl::u8 brightness) override {
-        ColorAdjustment color_adjustment = getAdjustmentData(brightness);
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, color_adjustment, getDither());
+        FL_TRACE_SCOPE("controller.encode");
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, getOutputProfile(brightness));
         if(nLeds < 0) {
             // nLeds < 0 implies that we want to show them in reverse
             pixels.mAdvance = -pixels.mAdvance;
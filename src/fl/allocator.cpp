@@ -1,6 +1,7 @@
 #include <stdlib.h>
 
 #include "fl/allocator.h"
+#include "fl/memory_budget.h"
 #include "fl/namespace.h"
 #include "fl/int.h"
 #include "fl/thread_local.h"
@@ -33,7 +34,7 @@ void DefaultFree(void *ptr) { free(ptr); }
 void *(*Alloc)(fl::size) = DefaultAlloc;
 void (*Dealloc)(void *) = DefaultFree;
 
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
 // Test hook interface pointer
 MallocFreeHook* gMallocFreeHook = nullptr;
 
@@ -59,7 +60,7 @@ struct MemoryGuard {
 
 } // namespace
 
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
 void SetMallocFreeHook(MallocFreeHook* hook) {
     gMallocFreeHook = hook;
 }
@@ -80,8 +81,13 @@ void *PSRamAllocate(fl::size size, bool zero) {
     if (ptr && zero) {
         memset(ptr, 0, size);
     }
+#if FASTLED_MEMORY_BUDGET
+    if (ptr) {
+        MemoryBudget::onAlloc(ptr, size);
+    }
+#endif
     
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
     if (gMallocFreeHook && ptr) {
         MemoryGuard allows_hook;
         if (allows_hook.enabled()) {
@@ -94,7 +100,7 @@ void *PSRamAllocate(fl::size size, bool zero) {
 }
 
 void PSRamDeallocate(void *ptr) {
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
     if (gMallocFreeHook && ptr) {
         // gMallocFreeHook->onFree(ptr);
         MemoryGuard allows_hook;
@@ -103,14 +109,24 @@ void PSRamDeallocate(void *ptr) {
         }
     }
 #endif
+#if FASTLED_MEMORY_BUDGET
+    if (ptr) {
+        MemoryBudget::onFree(ptr);
+    }
+#endif
     
     Dealloc(ptr);
 }
 
 void* Malloc(fl::size size) { 
     void* ptr = Alloc(size); 
+#if FASTLED_MEMORY_BUDGET
+    if (ptr) {
+        MemoryBudget::onAlloc(ptr, size);
+    }
+#endif
     
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
     if (gMallocFreeHook && ptr) {
         MemoryGuard allows_hook;    
         if (allows_hook.enabled()) {
@@ -123,7 +139,7 @@ void* Malloc(fl::size size) {
 }
 
 void Free(void *ptr) { 
-#if defined(FASTLED_TESTING)
+#if FASTLED_MALLOC_HOOKS
     if (gMallocFreeHook && ptr) {
         MemoryGuard allows_hook;
         if (allows_hook.enabled()) {
@@ -131,6 +147,11 @@ void Free(void *ptr) {
         }
     }
 #endif
+#if FASTLED_MEMORY_BUDGET
+    if (ptr) {
+        MemoryBudget::onFree(ptr);
+    }
+#endif
     
     Dealloc(ptr); 
 }
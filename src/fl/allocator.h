@@ -16,8 +16,16 @@
 
 namespace fl {
 
-// Test hooks for malloc/free operations
-#if defined(FASTLED_TESTING)
+#ifndef FASTLED_MALLOC_HOOKS
+#if defined(FASTLED_TESTING) || defined(FASTLED_STUB_IMPL)
+#define FASTLED_MALLOC_HOOKS 1
+#else
+#define FASTLED_MALLOC_HOOKS 0
+#endif
+#endif
+
+// Test hooks for malloc/free operations, also used by the sketch runner.
+#if FASTLED_MALLOC_HOOKS
 // Interface class for malloc/free test hooks
 class MallocFreeHook {
 public:
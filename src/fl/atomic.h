@@ -26,6 +26,29 @@ using atomic_uint = atomic<unsigned int>;
 using atomic_u32 = atomic<fl::u32>;
 using atomic_i32 = atomic<fl::i32>;
 
+// Orders for the load / store / exchange overloads that take one, and
+// fences. Without threads there is nothing to order, AtomicFake ignores them.
+#if FASTLED_MULTITHREADED
+using memory_order = std::memory_order;
+constexpr memory_order memory_order_relaxed = std::memory_order_relaxed;
+constexpr memory_order memory_order_acquire = std::memory_order_acquire;
+constexpr memory_order memory_order_release = std::memory_order_release;
+constexpr memory_order memory_order_seq_cst = std::memory_order_seq_cst;
+
+inline void atomic_thread_fence(memory_order order) {
+    std::atomic_thread_fence(order);
+}
+#else
+enum memory_order {
+    memory_order_relaxed,
+    memory_order_acquire,
+    memory_order_release,
+    memory_order_seq_cst,
+};
+
+inline void atomic_thread_fence(memory_order) {}
+#endif
+
 ///////////////////// IMPLEMENTATION //////////////////////////////////////
 
 template <typename T> class AtomicFake {
@@ -40,15 +63,15 @@ template <typename T> class AtomicFake {
     AtomicFake& operator=(AtomicFake&&) = delete;
     
     // Basic atomic operations - fake implementation (not actually atomic)
-    T load() const {
+    T load(memory_order = memory_order_seq_cst) const {
         return mValue;
     }
     
-    void store(T value) {
+    void store(T value, memory_order = memory_order_seq_cst) {
         mValue = value;
     }
     
-    T exchange(T value) {
+    T exchange(T value, memory_order = memory_order_seq_cst) {
         T old = mValue;
         mValue = value;
         return old;
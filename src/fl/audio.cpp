@@ -126,15 +126,23 @@ void SoundLevelMeter::processBlock(const fl::i16 *samples, fl::size count) {
 }
 
 void AudioSample::fft(FFTBins *out) const {
-            fl::span<const fl::i16> sample = pcm();
+    fl::span<const fl::i16> sample = pcm();
+    get_flex_fft().run(sample, out, fftArgs(out->size(), sample.size()));
+}
+
+void AudioSample::warmupFFT(fl::size bands, fl::size samples) {
+    get_flex_fft().warmup(fftArgs(bands, samples));
+}
+
+FFT_Args AudioSample::fftArgs(fl::size bands, fl::size samples) {
     FFT_Args args;
-    args.samples = sample.size();
-    args.bands = out->size();
+    args.samples = samples;
+    args.bands = bands;
     args.fmin = FFT_Args::DefaultMinFrequency();
     args.fmax = FFT_Args::DefaultMaxFrequency();
     args.sample_rate =
         FFT_Args::DefaultSampleRate(); // TODO: get sample rate from AudioSample
-    get_flex_fft().run(sample, out, args);
+    return args;
 }
 
 } // namespace fl
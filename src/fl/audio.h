@@ -38,6 +38,10 @@ class AudioSample {
     fl::u32 timestamp() const;  // Timestamp when sample became valid (millis)
 
     void fft(FFTBins *out) const;
+    // Prepares the FFT that fft() uses for this many bands and samples. The
+    // FFT cache is per thread, call it on the thread that calls fft().
+    static void warmupFFT(fl::size bands = FFT_Args::DefaultBands(),
+                          fl::size samples = FFT_Args::DefaultSamples());
 
     const_iterator begin() const { return pcm().begin(); }
     const_iterator end() const { return pcm().end(); }
@@ -49,6 +53,7 @@ class AudioSample {
 
   private:
     static const VectorPCM &empty();
+    static FFT_Args fftArgs(fl::size bands, fl::size samples);
     AudioSampleImplPtr mImpl;
 };
 
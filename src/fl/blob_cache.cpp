@@ -0,0 +1,183 @@
+#include <string.h>
+
+#include "fl/blob_cache.h"
+#include "fl/file_system.h"
+#include "fl/hash.h"
+#include "fl/math_macros.h"
+#include "fl/warn.h"
+
+namespace fl {
+
+namespace {
+
+// Entry layout, little endian: magic, key, payload size, payload checksum.
+// The checksum chains MurmurHash3 over kBlobCacheChunk sized pieces of the
+// payload, seeded with the key, so it can be computed while streaming.
+const u8 kBlobCacheMagic[4] = {'F', 'L', 'B', 'C'};
+const fl::size kBlobCacheHeaderSize = 16;
+const fl::size kBlobCacheChunk = 64;
+
+void blob_cache_put_u32(u8 *dst, u32 v) {
+    dst[0] = u8(v);
+    dst[1] = u8(v >> 8);
+    dst[2] = u8(v >> 16);
+    dst[3] = u8(v >> 24);
+}
+
+u32 blob_cache_get_u32(const u8 *src) {
+    return u32(src[0]) | (u32(src[1]) << 8) | (u32(src[2]) << 16) |
+           (u32(src[3]) << 24);
+}
+
+bool blob_cache_read_fully(FileHandle &file, u8 *dst, fl::size n) {
+    fl::size done = 0;
+    while (done < n) {
+        const fl::size got = file.read(dst + done, n - done);
+        if (got == 0) {
+            return false;
+        }
+        done += got;
+    }
+    return true;
+}
+
+} // namespace
+
+BlobCacheKey::BlobCacheKey(const char *kind, u32 version) : mHash(0) {
+    add(kind, strlen(kind));
+    add(version);
+}
+
+BlobCacheKey &BlobCacheKey::add(const void *data, fl::size n) {
+    // Chain the hashes, each field seeds the next one.
+    mHash = MurmurHash3_x86_32(data, n, mHash);
+    return *this;
+}
+
+BlobCache::BlobCache(FileSystem *fs, const char *directory)
+    : mFs(fs), mDirectory(directory) {}
+
+string BlobCache::pathFor(const BlobCacheKey &key) const {
+    static const char kHex[] = "0123456789abcdef";
+    char name[9];
+    u32 v = key.value();
+    for (int i = 7; i >= 0; --i) {
+        name[i] = kHex[v & 0xF];
+        v >>= 4;
+    }
+    name[8] = 0;
+    string path = mDirectory;
+    path.append("/");
+    path.append(name);
+    path.append(".bin");
+    return path;
+}
+
+bool BlobCache::load(const BlobCacheKey &key, void *dst, fl::size n) {
+    return loadEntry(key, static_cast<u8 *>(dst), nullptr, n);
+}
+
+bool BlobCache::load(const BlobCacheKey &key, Sink &sink, fl::size n) {
+    return loadEntry(key, nullptr, &sink, n);
+}
+
+bool BlobCache::store(const BlobCacheKey &key, const void *data, fl::size n) {
+    return storeEntry(key, static_cast<const u8 *>(data), nullptr, n);
+}
+
+bool BlobCache::store(const BlobCacheKey &key, Source &source, fl::size n) {
+    return storeEntry(key, nullptr, &source, n);
+}
+
+bool BlobCache::loadEntry(const BlobCacheKey &key, u8 *dst, Sink *sink,
+                          fl::size n) {
+    if (!mFs || (!dst && !sink)) {
+        mStats.misses++;
+        return false;
+    }
+    string path = pathFor(key);
+    FileHandlePtr file = mFs->openRead(path.c_str());
+    if (!file || !file->valid()) {
+        mStats.misses++;
+        return false;
+    }
+    u8 header[kBlobCacheHeaderSize];
+    bool ok = blob_cache_read_fully(*file, header, sizeof(header)) &&
+              memcmp(header, kBlobCacheMagic, sizeof(kBlobCacheMagic)) == 0 &&
+              blob_cache_get_u32(header + 4) == key.value() &&
+              blob_cache_get_u32(header + 8) == u32(n);
+    // A buffer is read straight into, a sink gets it through the chunk.
+    u8 chunk[kBlobCacheChunk];
+    u32 checksum = key.value();
+    for (fl::size done = 0; ok && done < n; done += kBlobCacheChunk) {
+        const fl::size len = MIN(n - done, kBlobCacheChunk);
+        u8 *piece = dst ? dst + done : chunk;
+        ok = blob_cache_read_fully(*file, piece, len);
+        if (ok) {
+            checksum = MurmurHash3_x86_32(piece, len, checksum);
+            if (sink) {
+                sink->accept(done, piece, len);
+            }
+        }
+    }
+    mFs->close(file);
+    if (!ok || checksum != blob_cache_get_u32(header + 12)) {
+        FASTLED_WARN("BlobCache: invalid entry " << path.c_str());
+        mStats.corrupt++;
+        return false;
+    }
+    mStats.hits++;
+    return true;
+}
+
+bool BlobCache::storeEntry(const BlobCacheKey &key, const u8 *data,
+                           Source *source, fl::size n) {
+    if (!mFs || (!data && !source)) {
+        return false;
+    }
+    u8 chunk[kBlobCacheChunk];
+    u32 checksum = key.value();
+    for (fl::size done = 0; done < n; done += kBlobCacheChunk) {
+        const fl::size len = MIN(n - done, kBlobCacheChunk);
+        const u8 *piece = data ? data + done : chunk;
+        if (source) {
+            source->fill(done, chunk, len);
+        }
+        checksum = MurmurHash3_x86_32(piece, len, checksum);
+    }
+    u8 header[kBlobCacheHeaderSize];
+    memcpy(header, kBlobCacheMagic, sizeof(kBlobCacheMagic));
+    blob_cache_put_u32(header + 4, key.value());
+    blob_cache_put_u32(header + 8, u32(n));
+    blob_cache_put_u32(header + 12, checksum);
+
+    if (!mDirectoryChecked && !mDirectory.empty()) {
+        // Platforms without mkdir() may still write into existing directories.
+        if (!mFs->mkdir(mDirectory.c_str())) {
+            FASTLED_WARN("BlobCache: could not create " << mDirectory.c_str());
+        }
+    }
+    mDirectoryChecked = true;
+    string path = pathFor(key);
+    FileWriterPtr file = mFs->openWrite(path.c_str());
+    if (!file) {
+        return false;
+    }
+    bool ok = file->write(header, sizeof(header));
+    for (fl::size done = 0; ok && done < n; done += kBlobCacheChunk) {
+        const fl::size len = MIN(n - done, kBlobCacheChunk);
+        const u8 *piece = data ? data + done : chunk;
+        if (source) {
+            source->fill(done, chunk, len);
+        }
+        ok = file->write(piece, len);
+    }
+    // A partly written entry fails the checksum on load.
+    if (!file->close() || !ok) {
+        return false;
+    }
+    mStats.stores++;
+    return true;
+}
+
+} // namespace fl
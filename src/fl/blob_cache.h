@@ -0,0 +1,125 @@
+#pragma once
+
+/*
+Persistent, content addressed cache for derived data.
+
+Several subsystems compute tables at startup that only depend on their
+construction parameters: XYMap look up tables, Corkscrew tile caches, palette
+expansions, FFT kernels. On constrained controllers this costs boot time and,
+worse, a transient peak of memory. BlobCache stores those tables on the
+FileSystem keyed by a hash of everything that generated them, and on the next
+boot validates the entry and reads it straight into the destination buffer.
+Entries are streamed to and from the file in small chunks, so neither side
+needs a second copy of the table. Callers whose table isn't laid out like
+the file can encode and decode it piece by piece with a Source and a Sink.
+
+Example:
+    fl::FileSystem fs;
+    fs.beginSd(CS_PIN);
+    fl::BlobCache cache(&fs);
+
+    fl::BlobCacheKey key("mytable", 1);  // bump the version on code changes.
+    key.add(width).add(height);
+    if (!cache.load(key, table, sizeof(table))) {
+        computeTable(table);
+        cache.store(key, table, sizeof(table));
+    }
+*/
+
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/stdint.h"
+#include "fl/str.h"
+#include "fl/type_traits.h"
+
+namespace fl {
+
+class FileSystem;
+
+// Hash of the parameters that generated a blob. Everything that changes the
+// derived data must be added, the version must be bumped whenever the
+// generator itself changes so that stale entries are never loaded.
+class BlobCacheKey {
+  public:
+    BlobCacheKey(const char *kind, u32 version);
+
+    BlobCacheKey &add(const void *data, fl::size n);
+    // Only for scalars, structs may contain uninitialized padding.
+    template <typename T>
+    typename fl::enable_if<fl::is_integral<T>::value ||
+                               fl::is_floating_point<T>::value,
+                           BlobCacheKey &>::type
+    add(T value) {
+        return add(&value, sizeof(T));
+    }
+
+    u32 value() const { return mHash; }
+
+  private:
+    u32 mHash;
+};
+
+class BlobCache {
+  public:
+    // Produces the payload of a stored entry in pieces.
+    struct Source {
+        virtual ~Source() {}
+        // Fills dst with payload bytes [offset, offset + n).
+        virtual void fill(fl::size offset, u8 *dst, fl::size n) = 0;
+    };
+    // Takes the payload of a loaded entry in order, in pieces.
+    struct Sink {
+        virtual ~Sink() {}
+        virtual void accept(fl::size offset, const u8 *src, fl::size n) = 0;
+    };
+
+    struct Stats {
+        u32 hits = 0;
+        u32 misses = 0;
+        u32 corrupt = 0; // Entries that existed but failed validation.
+        u32 stores = 0;
+    };
+
+    // fs may be null, in which case every load misses and stores fail. The
+    // directory is created on the first store, "" keeps entries in the root.
+    explicit BlobCache(FileSystem *fs, const char *directory = "/flcache");
+
+    // Reads exactly n bytes into dst. Returns false if the entry is missing,
+    // has a different size or fails the checksum; dst is undefined then.
+    bool load(const BlobCacheKey &key, void *dst, fl::size n);
+    bool store(const BlobCacheKey &key, const void *data, fl::size n);
+    // Same for a payload of n bytes passed through sink / source. The sink
+    // may have seen part of an entry that then fails validation. The source
+    // is read twice, once for the checksum in the header, once to write.
+    bool load(const BlobCacheKey &key, Sink &sink, fl::size n);
+    bool store(const BlobCacheKey &key, Source &source, fl::size n);
+
+    // Loads dst, or fills it with compute() and stores the result.
+    // Returns true on a cache hit.
+    template <typename Compute>
+    bool loadOrCompute(const BlobCacheKey &key, void *dst, fl::size n,
+                       Compute compute) {
+        if (load(key, dst, n)) {
+            return true;
+        }
+        compute();
+        store(key, dst, n);
+        return false;
+    }
+
+    string pathFor(const BlobCacheKey &key) const;
+    const Stats &stats() const { return mStats; }
+
+  private:
+    // Exactly one of dst / sink and data / source is set.
+    bool loadEntry(const BlobCacheKey &key, u8 *dst, Sink *sink, fl::size n);
+    bool storeEntry(const BlobCacheKey &key, const u8 *data, Source *source,
+                    fl::size n);
+
+    FileSystem *mFs;
+    string mDirectory;
+    bool mDirectoryChecked = false;
+    Stats mStats;
+};
+
+} // namespace fl
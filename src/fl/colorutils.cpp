@@ -12,6 +12,7 @@
 #include "FastLED.h"
 #include "fl/assert.h"
 #include "fl/colorutils.h"
+#include "fl/scale8_bulk.h"
 #include "fl/unused.h"
 #include "fl/xymap.h"
 
@@ -146,9 +147,8 @@ CHSV *blend(const CHSV *src1, const CHSV *src2, CHSV *dest, fl::u16 count,
 }
 
 void nscale8_video(CRGB *leds, fl::u16 num_leds, fl::u8 scale) {
-    for (fl::u16 i = 0; i < num_leds; ++i) {
-        leds[i].nscale8_video(scale);
-    }
+    scale8_video_bulk(reinterpret_cast<fl::u8 *>(leds), fl::size(num_leds) * 3,
+                      scale);
 }
 
 void fade_video(CRGB *leds, fl::u16 num_leds, fl::u8 fadeBy) {
@@ -168,22 +168,13 @@ void fade_raw(CRGB *leds, fl::u16 num_leds, fl::u8 fadeBy) {
 }
 
 void nscale8(CRGB *leds, fl::u16 num_leds, fl::u8 scale) {
-    for (fl::u16 i = 0; i < num_leds; ++i) {
-        leds[i].nscale8(scale);
-    }
+    scale8_bulk(reinterpret_cast<fl::u8 *>(leds), fl::size(num_leds) * 3,
+                scale);
 }
 
 void fadeUsingColor(CRGB *leds, fl::u16 numLeds, const CRGB &colormask) {
-    fl::u8 fr, fg, fb;
-    fr = colormask.r;
-    fg = colormask.g;
-    fb = colormask.b;
-
-    for (fl::u16 i = 0; i < numLeds; ++i) {
-        leds[i].r = scale8_LEAVING_R1_DIRTY(leds[i].r, fr);
-        leds[i].g = scale8_LEAVING_R1_DIRTY(leds[i].g, fg);
-        leds[i].b = scale8(leds[i].b, fb);
-    }
+    scale8_rgb_bulk(reinterpret_cast<fl::u8 *>(leds), numLeds, colormask.r,
+                    colormask.g, colormask.b);
 }
 
 // CRGB HeatColor( fl::u8 temperature)
@@ -1,7 +1,11 @@
+#include <string.h>
+
 #include "fl/corkscrew.h"
+#include "fl/blob_cache.h"
 #include "fl/algorithm.h"
 #include "fl/assert.h"
 #include "fl/math.h"
+#include "fl/memory_budget.h"
 #include "fl/splat.h"
 #include "fl/warn.h"
 #include "fl/tile2x2.h"
@@ -20,6 +24,84 @@ namespace fl {
 
 namespace {
 
+// Serialized tile for the persistent cache: x, y as little endian i16 and the
+// alpha, for each of the 2x2 entries. Written field by field so that no struct
+// padding ends up in the file.
+const fl::size kCorkscrewTileBytes = 4 * 5;
+
+void corkscrew_encode_tile(const Tile2x2_u8_wrap &tile, fl::u8 *out) {
+    for (fl::u16 x = 0; x < 2; ++x) {
+        for (fl::u16 y = 0; y < 2; ++y) {
+            const Tile2x2_u8_wrap::Entry &e = tile.at(x, y);
+            const fl::u16 px = static_cast<fl::u16>(e.first.x);
+            const fl::u16 py = static_cast<fl::u16>(e.first.y);
+            *out++ = fl::u8(px);
+            *out++ = fl::u8(px >> 8);
+            *out++ = fl::u8(py);
+            *out++ = fl::u8(py >> 8);
+            *out++ = e.second;
+        }
+    }
+}
+
+Tile2x2_u8_wrap corkscrew_decode_tile(const fl::u8 *in) {
+    Tile2x2_u8_wrap tile;
+    for (fl::u16 x = 0; x < 2; ++x) {
+        for (fl::u16 y = 0; y < 2; ++y) {
+            Tile2x2_u8_wrap::Entry &e = tile.at(x, y);
+            e.first.x = static_cast<fl::i16>(fl::u16(in[0]) | (fl::u16(in[1]) << 8));
+            e.first.y = static_cast<fl::i16>(fl::u16(in[2]) | (fl::u16(in[3]) << 8));
+            e.second = in[4];
+            in += 5;
+        }
+    }
+    return tile;
+}
+
+// Encodes the tiles for BlobCache::store() a chunk at a time. A chunk may
+// start or end inside a tile, so the tile is encoded aside and sliced.
+class CorkscrewTileSource : public BlobCache::Source {
+  public:
+    explicit CorkscrewTileSource(const fl::vector<Tile2x2_u8_wrap> &tiles)
+        : mTiles(tiles) {}
+    void fill(fl::size offset, fl::u8 *dst, fl::size n) override {
+        while (n > 0) {
+            fl::u8 encoded[kCorkscrewTileBytes];
+            const fl::size skip = offset % kCorkscrewTileBytes;
+            const fl::size take = MIN(n, kCorkscrewTileBytes - skip);
+            corkscrew_encode_tile(mTiles[offset / kCorkscrewTileBytes], encoded);
+            memcpy(dst, encoded + skip, take);
+            dst += take;
+            offset += take;
+            n -= take;
+        }
+    }
+
+  private:
+    const fl::vector<Tile2x2_u8_wrap> &mTiles;
+};
+
+// Decodes BlobCache::load() chunks back into tiles, one tile at a time.
+class CorkscrewTileSink : public BlobCache::Sink {
+  public:
+    explicit CorkscrewTileSink(fl::vector<Tile2x2_u8_wrap> &tiles)
+        : mTiles(tiles) {}
+    void accept(fl::size offset, const fl::u8 *src, fl::size n) override {
+        for (fl::size i = 0; i < n; ++i, ++offset) {
+            const fl::size pos = offset % kCorkscrewTileBytes;
+            mEncoded[pos] = src[i];
+            if (pos == kCorkscrewTileBytes - 1) {
+                mTiles[offset / kCorkscrewTileBytes] =
+                    corkscrew_decode_tile(mEncoded);
+            }
+        }
+    }
+
+  private:
+    fl::vector<Tile2x2_u8_wrap> &mTiles;
+    fl::u8 mEncoded[kCorkscrewTileBytes];
+};
+
 // New helper function to calculate individual LED position
 vec2f calculateLedPositionExtended(fl::u16 ledIndex, fl::u16 numLeds, float totalTurns, const Gap& gapParams, fl::u16 width, fl::u16 height) {
     FL_UNUSED(height);
@@ -178,12 +260,32 @@ void Corkscrew::setCachingEnabled(bool enabled) {
 
 void Corkscrew::initializeCache() const {
     if (!mCacheInitialized && mCachingEnabled) {
+        MemScope scope(MemCategory::kCorkscrew);
         // Initialize cache with tiles for each LED position
         mTileCache.resize(mInput.numLeds);
-        
-        // Populate cache lazily
-        for (fl::size i = 0; i < mInput.numLeds; ++i) {
-            mTileCache[i] = calculateTileAtWrap(static_cast<float>(i));
+        auto compute = [this]() {
+            for (fl::size i = 0; i < mInput.numLeds; ++i) {
+                mTileCache[i] = calculateTileAtWrap(static_cast<float>(i));
+            }
+        };
+        if (mPersistentCache) {
+            BlobCacheKey key("corkscrew_tiles", 2);
+            key.add(mInput.totalTurns)
+                .add(mInput.numLeds)
+                .add(mInput.gapParams.num_leds)
+                .add(mInput.gapParams.gap)
+                .add(mInput.invert);
+            // Tiles go to and from the file in chunks, never as a second
+            // serialized copy of the whole cache.
+            const fl::size bytes = mTileCache.size() * kCorkscrewTileBytes;
+            CorkscrewTileSink sink(mTileCache);
+            if (!mPersistentCache->load(key, sink, bytes)) {
+                compute();
+                CorkscrewTileSource source(mTileCache);
+                mPersistentCache->store(key, source, bytes);
+            }
+        } else {
+            compute();
         }
         
         mCacheInitialized = true;
@@ -194,6 +296,7 @@ void Corkscrew::initializeCache() const {
 
 void Corkscrew::initializeBuffer() const {
     if (!mBufferInitialized) {
+        MemScope scope(MemCategory::kCorkscrew);
         fl::size buffer_size = static_cast<fl::size>(mState.width) * static_cast<fl::size>(mState.height);
         mCorkscrewLeds.resize(buffer_size, CRGB::Black);
         mBufferInitialized = true;
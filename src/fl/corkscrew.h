@@ -49,6 +49,7 @@
 namespace fl {
 
 // Forward declarations
+class BlobCache;
 class Leds;
 class ScreenMap;
 template<typename T> class Grid;
@@ -220,6 +221,9 @@ class Corkscrew {
 
     // Caching control
     void setCachingEnabled(bool enabled);
+    // Optional persistent backing for the tile cache. The cache must outlive
+    // this object, pass nullptr to detach.
+    void setPersistentCache(BlobCache *cache) { mPersistentCache = cache; }
 
     // New functionality: rectangular buffer and drawing
     // Get access to the rectangular buffer (lazily initialized)
@@ -281,6 +285,7 @@ class Corkscrew {
     mutable fl::vector<Tile2x2_u8_wrap> mTileCache;
     mutable bool mCacheInitialized = false;
     bool mCachingEnabled = true; // Default to enabled
+    BlobCache *mPersistentCache = nullptr;
 };
 
 } // namespace fl
@@ -1,6 +1,7 @@
 #include "fl/engine_events.h"
 #include "fl/namespace.h"
 #include "fl/int.h"
+#include "fl/trace.h"
 
 
 namespace fl {
@@ -32,13 +33,106 @@ EngineEvents *EngineEvents::getInstance() {
 
 #if FASTLED_HAS_ENGINE_EVENTS
 void EngineEvents::_onPlatformPreLoop() {
+    FrameScheduler &scheduler = FrameScheduler::instance();
     for (auto &item : mListeners) {
         auto listener = item.listener;
+        u32 start = scheduler.now();
         listener->onPlatformPreLoop();
+        _record(listener, start, false);
     }
     for (auto &item : mListeners) {
         auto listener = item.listener;
+        u32 start = scheduler.now();
         listener->onPlatformPreLoop2();
+        _record(listener, start, false);
+    }
+}
+
+EngineEvents::Pair *EngineEvents::_find(Listener *listener) {
+    for (auto &item : mListeners) {
+        if (item.listener == listener) {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+void EngineEvents::_record(Listener *listener, u32 start, bool deferred) {
+    u32 elapsed = FrameScheduler::instance().now() - start;
+    Pair *pair = _find(listener);
+    if (!pair) {
+        return; // Removed itself during the callback.
+    }
+    ListenerStats &stats = pair->stats;
+    stats.calls++;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+    if (pair->budget && elapsed > pair->budget) {
+        stats.deadlineMisses++;
+    }
+    if (deferred) {
+        stats.deferredCalls++;
+    }
+}
+
+void EngineEvents::_setBudget(Listener *listener, u32 budgetMicros) {
+    if (Pair *pair = _find(listener)) {
+        pair->budget = budgetMicros;
+    }
+}
+
+void EngineEvents::_setDeferred(Listener *listener, bool deferred,
+                                FrameScheduler::Priority priority,
+                                u32 budgetMicros) {
+    if (Pair *pair = _find(listener)) {
+        pair->deferred = deferred;
+        pair->deferredPriority = priority;
+        pair->budget = budgetMicros;
+    }
+}
+
+const EngineEvents::ListenerStats *EngineEvents::_stats(Listener *listener) {
+    Pair *pair = _find(listener);
+    return pair ? &pair->stats : nullptr;
+}
+
+void EngineEvents::_defer(Listener *listener, PendingEvent event) {
+    Pair *pair = _find(listener);
+    if (!pair) {
+        return;
+    }
+    const bool queued = pair->pending != 0;
+    pair->pending |= event;
+    if (queued) {
+        return; // Coalesced with the callback that is already queued.
+    }
+    // Only the pointer is captured, _runDeferred checks that the listener is
+    // still registered before calling it.
+    FrameScheduler::instance().post(
+        [listener]() { EngineEvents::getInstance()->_runDeferred(listener); },
+        pair->deferredPriority, pair->budget);
+}
+
+void EngineEvents::_runDeferred(Listener *listener) {
+    Pair *pair = _find(listener);
+    if (!pair) {
+        return;
+    }
+    u8 pending = pair->pending;
+    pair->pending = 0;
+    FrameScheduler &scheduler = FrameScheduler::instance();
+    // Same order as show() dispatches them.
+    if (pending & kPendingEndFrame) {
+        u32 start = scheduler.now();
+        listener->onEndFrame();
+        _record(listener, start, true);
+    }
+    if ((pending & kPendingEndShowLeds) && _hasListener(listener)) {
+        u32 start = scheduler.now();
+        listener->onEndShowLeds();
+        _record(listener, start, true);
     }
 }
 
@@ -76,32 +170,52 @@ void EngineEvents::_removeListener(Listener *listener) {
 }
 
 void EngineEvents::_onBeginFrame() {
+    FL_TRACE_SCOPE("events.begin_frame");
     // Make the copy of the listener list to avoid issues with listeners being
     // added or removed during the loop.
     ListenerList copy = mListeners;
+    FrameScheduler &scheduler = FrameScheduler::instance();
     for (auto &item : copy) {
         auto listener = item.listener;
+        u32 start = scheduler.now();
         listener->onBeginFrame();
+        _record(listener, start, false);
     }
 }
 
 void EngineEvents::_onEndShowLeds() {
+    FL_TRACE_SCOPE("events.end_show_leds");
     // Make the copy of the listener list to avoid issues with listeners being
     // added or removed during the loop.
     ListenerList copy = mListeners;
+    FrameScheduler &scheduler = FrameScheduler::instance();
     for (auto &item : copy) {
         auto listener = item.listener;
+        if (item.deferred) {
+            _defer(listener, kPendingEndShowLeds);
+            continue;
+        }
+        u32 start = scheduler.now();
         listener->onEndShowLeds();
+        _record(listener, start, false);
     }
 }
 
 void EngineEvents::_onEndFrame() {
+    FL_TRACE_SCOPE("events.end_frame");
     // Make the copy of the listener list to avoid issues with listeners being
     // added or removed during the loop.
     ListenerList copy = mListeners;
+    FrameScheduler &scheduler = FrameScheduler::instance();
     for (auto &item : copy) {
         auto listener = item.listener;
+        if (item.deferred) {
+            _defer(listener, kPendingEndFrame);
+            continue;
+        }
+        u32 start = scheduler.now();
         listener->onEndFrame();
+        _record(listener, start, false);
     }
 }
 
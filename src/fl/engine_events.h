@@ -1,5 +1,6 @@
 #pragma once
 
+#include "fl/frame_scheduler.h"
 #include "fl/namespace.h"
 #include "fl/screenmap.h"
 #include "fl/singleton.h"
@@ -21,6 +22,15 @@ namespace fl {
 
 class EngineEvents {
   public:
+    // Time spent in a listener, summed over all of its callbacks.
+    struct ListenerStats {
+        fl::u32 calls = 0;
+        fl::u32 totalMicros = 0;
+        fl::u32 maxMicros = 0;
+        fl::u32 deadlineMisses = 0; // Calls that took longer than the budget.
+        fl::u32 deferredCalls = 0;  // Calls that ran in the idle slice.
+    };
+
     class Listener {
       public:
         // Note that the subclass must call EngineEvents::addListener(this) to
@@ -71,6 +81,46 @@ class EngineEvents {
 #endif
     }
 
+    // Calls to the listener that take longer than budgetMicros count as
+    // deadline misses in its stats. 0 disables the check.
+    static void setBudget(Listener *listener, fl::u32 budgetMicros) {
+#if FASTLED_HAS_ENGINE_EVENTS
+        EngineEvents::getInstance()->_setBudget(listener, budgetMicros);
+#else
+        (void)listener;
+        (void)budgetMicros;
+#endif
+    }
+
+    // For listeners that are not needed on the frame path (UI json,
+    // telemetry). Their onEndShowLeds() and onEndFrame() are queued and run in
+    // the FrameScheduler idle slice after show(), coalesced if the slice had
+    // no room for them. Budget as in setBudget().
+    static void setDeferred(
+        Listener *listener, bool deferred,
+        FrameScheduler::Priority priority = FrameScheduler::kLow,
+        fl::u32 budgetMicros = 0) {
+#if FASTLED_HAS_ENGINE_EVENTS
+        EngineEvents::getInstance()->_setDeferred(listener, deferred, priority,
+                                                  budgetMicros);
+#else
+        (void)listener;
+        (void)deferred;
+        (void)priority;
+        (void)budgetMicros;
+#endif
+    }
+
+    // nullptr if the listener is not registered.
+    static const ListenerStats *stats(Listener *listener) {
+#if FASTLED_HAS_ENGINE_EVENTS
+        return EngineEvents::getInstance()->_stats(listener);
+#else
+        (void)listener;
+        return nullptr;
+#endif
+    }
+
     static void onBeginFrame() {
 #if FASTLED_HAS_ENGINE_EVENTS
         EngineEvents::getInstance()->_onBeginFrame();
@@ -128,15 +178,34 @@ class EngineEvents {
     void _onCanvasUiSet(CLEDController *strip, const ScreenMap &xymap);
     void _onPlatformPreLoop();
     bool _hasListener(Listener *listener);
+    void _setBudget(Listener *listener, fl::u32 budgetMicros);
+    void _setDeferred(Listener *listener, bool deferred,
+                      FrameScheduler::Priority priority, fl::u32 budgetMicros);
+    const ListenerStats *_stats(Listener *listener);
 #if FASTLED_HAS_ENGINE_EVENTS
+    enum PendingEvent : fl::u8 {
+        kPendingEndFrame = 1,
+        kPendingEndShowLeds = 2,
+    };
+
     struct Pair {
         Pair() = default;
         Listener *listener = nullptr;
         int priority = 0;
         Pair(Listener *listener, int priority)
             : listener(listener), priority(priority) {}
+        fl::u32 budget = 0;
+        bool deferred = false;
+        FrameScheduler::Priority deferredPriority = FrameScheduler::kLow;
+        fl::u8 pending = 0; // PendingEvent bits, non zero while queued.
+        ListenerStats stats;
     };
 
+    Pair *_find(Listener *listener);
+    void _record(Listener *listener, fl::u32 start, bool deferred);
+    void _defer(Listener *listener, PendingEvent event);
+    void _runDeferred(Listener *listener);
+
     typedef fl::vector_inlined<Pair, 16> ListenerList;
     ListenerList mListeners;
 
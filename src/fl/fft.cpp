@@ -42,6 +42,8 @@ void FFT::run(const span<const fl::i16> &sample, FFTBins *out,
     get_or_create(args2).run(sample, out);
 }
 
+void FFT::warmup(const FFT_Args &args) { get_or_create(args); }
+
 void FFT::clear() { mMap->clear(); }
 
 fl::size FFT::size() const { return mMap->size(); }
@@ -108,6 +108,11 @@ class FFT {
             void run(const span<const i16> &sample, FFTBins *out,
              const FFT_Args &args = FFT_Args());
 
+    // Creates the FFT for args ahead of time. Kernel generation is the
+    // expensive part of an FFT, call this from setup() so that it never
+    // happens in the first run() on the render path.
+    void warmup(const FFT_Args &args = FFT_Args());
+
     void clear();
     fl::size size() const;
 
@@ -17,6 +17,7 @@
 
 #include "fl/array.h"
 #include "fl/audio.h"
+#include "fl/compiler_control.h"
 #include "fl/fft.h"
 #include "fl/fft_impl.h"
 #include "fl/str.h"
@@ -25,6 +26,22 @@
 #include "fl/warn.h"
 
 #include "fl/memfill.h"
+#include "fl/memory_budget.h"
+
+// Compile in the kernels for the default FFT_Args so that the common
+// configuration never generates them at runtime. Costs ~1.7kb of flash, on
+// AVR const data also lives in ram so it is off there.
+#ifndef FASTLED_FFT_PRECOMPUTED_KERNELS
+#if defined(__AVR__)
+#define FASTLED_FFT_PRECOMPUTED_KERNELS 0
+#else
+#define FASTLED_FFT_PRECOMPUTED_KERNELS 1
+#endif
+#endif
+
+#if FASTLED_FFT_PRECOMPUTED_KERNELS
+#include "fl/fft_kernels_512x16.hpp"
+#endif
 // #define SAMPLES IS2_AUDIO_BUFFER_LEN
 #define AUDIO_SAMPLE_RATE 44100
 #define SAMPLES 512
@@ -41,7 +58,8 @@ namespace fl {
 class FFTContext {
   public:
     FFTContext(int samples, int bands, float fmin, float fmax, int sample_rate)
-        : m_fftr_cfg(nullptr), m_kernels(nullptr) {
+        : m_fftr_cfg(nullptr), m_elems(nullptr), m_offsets(nullptr),
+          m_precomputed(false) {
         fl::memfill(&m_cq_cfg, 0, sizeof(m_cq_cfg));
         m_cq_cfg.samples = samples;
         m_cq_cfg.bands = bands;
@@ -49,22 +67,24 @@ class FFTContext {
         m_cq_cfg.fmax = fmax;
         m_cq_cfg.fs = sample_rate;
         m_cq_cfg.min_val = MIN_VAL;
+        MemScope scope(MemCategory::kAudio);
         m_fftr_cfg = kiss_fftr_alloc(samples, 0, NULL, NULL);
         if (!m_fftr_cfg) {
             FASTLED_WARN("Failed to allocate FFTImpl context");
             return;
         }
-        m_kernels = generate_kernels(m_cq_cfg);
+        if (!usePrecomputedKernels()) {
+            generateKernels();
+        }
     }
     ~FFTContext() {
         if (m_fftr_cfg) {
             kiss_fftr_free(m_fftr_cfg);
         }
-        if (m_kernels) {
-            free_kernels(m_kernels, m_cq_cfg);
-        }
     }
 
+    bool precomputed() const { return m_precomputed; }
+
     fl::size sampleSize() const { return m_cq_cfg.samples; }
 
     void fft_unit_test(span<const i16> buffer, FFTBins *out) {
@@ -77,7 +97,7 @@ class FFTContext {
         FASTLED_STACK_ARRAY(kiss_fft_cpx, cq, m_cq_cfg.bands);
         // initialize
         kiss_fftr(m_fftr_cfg, buffer.data(), fft);
-        apply_kernels(fft, cq, m_kernels, m_cq_cfg);
+        applyKernels(fft, cq);
         const float maxf = m_cq_cfg.fmax;
         const float minf = m_cq_cfg.fmin;
         const float delta_f = (maxf - minf) / m_cq_cfg.bands;
@@ -122,9 +142,71 @@ class FFTContext {
     }
 
   private:
+    bool usePrecomputedKernels() {
+#if FASTLED_FFT_PRECOMPUTED_KERNELS
+        FL_DISABLE_WARNING_PUSH
+        FL_DISABLE_WARNING(float-equal);
+        using namespace fft_precomputed;
+        bool match = m_cq_cfg.samples == kSamples &&
+                     m_cq_cfg.bands == kBands &&
+                     m_cq_cfg.fmin == kMinFrequency &&
+                     m_cq_cfg.fmax == kMaxFrequency &&
+                     m_cq_cfg.fs == float(kSampleRate) &&
+                     m_cq_cfg.min_val == kMinVal &&
+                     m_cq_cfg.window_type == HAMMING;
+        FL_DISABLE_WARNING_POP
+        if (match) {
+            m_elems = kElems;
+            m_offsets = kOffsets;
+            m_precomputed = true;
+        }
+        return match;
+#else
+        return false;
+#endif
+    }
+
+    // One band at a time into flat storage, the only transient memory is
+    // kernel_scratch_size() bytes, the fftr config is shared with run().
+    void generateKernels() {
+        fl::vector<kiss_fft_cpx> scratch;
+        scratch.resize((kernel_scratch_size(m_cq_cfg) + sizeof(kiss_fft_cpx) -
+                        1) /
+                       sizeof(kiss_fft_cpx));
+        m_offset_storage.resize(m_cq_cfg.bands + 1);
+        m_offset_storage[0] = 0;
+        for (int band = 0; band < m_cq_cfg.bands; ++band) {
+            int n = generate_kernel_band(m_cq_cfg, m_fftr_cfg, band,
+                                         scratch.data());
+            fl::size start = m_kernel_storage.size();
+            m_kernel_storage.resize(start + n);
+            copy_kernel_band(m_cq_cfg, scratch.data(),
+                             m_kernel_storage.data() + start);
+            m_offset_storage[band + 1] = u32(start + n);
+        }
+        m_elems = m_kernel_storage.data();
+        m_offsets = m_offset_storage.data();
+    }
+
+    void applyKernels(const kiss_fft_cpx *fft, kiss_fft_cpx *cq) const {
+        for (int band = 0; band < m_cq_cfg.bands; ++band) {
+            for (u32 j = m_offsets[band]; j < m_offsets[band + 1]; ++j) {
+                const sparse_arr_elem &e = m_elems[j];
+                kiss_fft_cpx weighted_val;
+                C_MUL(weighted_val, fft[e.n], e.val);
+                C_ADDTO(cq[band], weighted_val);
+            }
+        }
+    }
+
     kiss_fftr_cfg m_fftr_cfg;
-    cq_kernels_t m_kernels;
     cq_kernel_cfg m_cq_cfg;
+    // Either points into the precomputed table or into the storage below.
+    const sparse_arr_elem *m_elems;
+    const u32 *m_offsets;
+    bool m_precomputed;
+    fl::vector<sparse_arr_elem> m_kernel_storage;
+    fl::vector<u32> m_offset_storage;
 };
 
 FFTImpl::FFTImpl(const FFT_Args &args) {
@@ -143,6 +225,10 @@ fl::string FFTImpl::info() const {
     }
 }
 
+bool FFTImpl::precomputedKernels() const {
+    return mContext && mContext->precomputed();
+}
+
 fl::size FFTImpl::sampleSize() const {
     if (mContext) {
         return mContext->sampleSize();
@@ -31,6 +31,9 @@ class FFTImpl : public fl::Referent {
     ~FFTImpl();
 
     fl::size sampleSize() const;
+    // True if the constant-Q kernels come from the compiled in table
+    // (FASTLED_FFT_PRECOMPUTED_KERNELS) instead of being generated.
+    bool precomputedKernels() const;
     // Note that the sample sizes MUST match the samples size passed into the
     // constructor.
     Result run(const AudioSample &sample, FFTBins *out);
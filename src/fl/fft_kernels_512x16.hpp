@@ -0,0 +1,107 @@
+#pragma once
+
+// Constant-Q kernels for the default FFT_Args (512 samples, 16 bands,
+// 174.6 Hz - 4698.3 Hz at 44.1 kHz, hamming window, MIN_VAL 5000). Generated
+// on the host with generate_kernel_band(), the fft tests check that the
+// runtime generator still produces exactly these values.
+//
+// Only included by fft_impl.cpp and tests/test_fft.cpp.
+
+#include "third_party/cq_kernel/cq_kernel.h"
+#include "fl/int.h"
+
+namespace fl {
+namespace fft_precomputed {
+
+const int kSamples = 512;
+const int kBands = 16;
+const int kSampleRate = 44100;
+const float kMinFrequency = 174.6f;
+const float kMaxFrequency = 4698.3f;
+const int kMinVal = 5000;
+
+// Band b uses kElems[kOffsets[b]] .. kElems[kOffsets[b + 1] - 1].
+const fl::u32 kOffsets[kBands + 1] = {0,  1,  3,  6,   9,   13,  18,  24, 32,
+                                      42, 54, 69, 87, 110, 139, 174, 218};
+
+const sparse_arr_elem kElems[] = {
+    // band 0
+    {2, {8827, -2}},
+    // band 1
+    {2, {7599, -53}}, {3, {-7916, -49}},
+    // band 2
+    {2, {5594, -41}}, {3, {-8751, 7}}, {4, {6959, 38}},
+    // band 3
+    {3, {-7302, 85}}, {4, {8819, 9}}, {5, {-6896, -98}},
+    // band 4
+    {3, {-5298, 64}}, {4, {7848, -48}}, {5, {-8774, -7}}, {6, {7441, 55}},
+    // band 5
+    {4, {5900, -77}}, {5, {-7857, 50}}, {6, {8750, -5}}, {7, {-8180, -50}},
+    {8, {6337, 77}},
+    // band 6
+    {5, {-5934, 194}}, {6, {7572, -160}}, {7, {-8602, 59}}, {8, {8714, 52}},
+    {9, {-7863, -153}}, {10, {6270, 194}},
+    // band 7
+    {6, {5591, -125}}, {7, {-7000, 111}}, {8, {8087, -74}}, {9, {-8696, 18}},
+    {10, {8682, 32}}, {11, {-8059, -83}}, {12, {6907, 116}}, {13, {-5438, -120}},
+    // band 8
+    {7, {-5019, 150}}, {8, {6194, -156}}, {9, {-7247, 127}}, {10, {8075, -86}},
+    {11, {-8591, 40}}, {12, {8712, 17}}, {13, {-8440, -75}}, {14, {7792, 115}},
+    {15, {-6825, -150}}, {16, {5667, 156}},
+    // band 9
+    {9, {-5277, 382}}, {10, {6222, -374}}, {11, {-7087, 331}}, {12, {7822, -266}},
+    {13, {-8370, 173}}, {14, {8673, -64}}, {15, {-8738, -50}}, {16, {8522, 165}},
+    {17, {-8053, -259}}, {18, {7383, 324}}, {19, {-6539, -374}}, {20, {5580, 374}},
+    // band 10
+    {11, {-5100, 466}}, {12, {5863, -466}}, {13, {-6600, 440}}, {14, {7246, -395}},
+    {15, {-7830, 332}}, {16, {8270, -233}}, {17, {-8566, 125}}, {18, {8710, -17}},
+    {19, {-8683, -107}}, {20, {8467, 215}}, {21, {-8108, -314}}, {22, {7605, 377}},
+    {23, {-6986, -448}}, {24, {6267, 466}}, {25, {-5486, -475}},
+    // band 11
+    {14, {5289, -592}}, {15, {-5860, 581}}, {16, {6408, -559}}, {17, {-6933, 503}},
+    {18, {7403, -447}}, {19, {-7806, 369}}, {20, {8119, -290}}, {21, {-8354, 178}},
+    {22, {8477, -78}}, {23, {-8522, -44}}, {24, {8454, 156}}, {25, {-8276, -268}},
+    {26, {7996, 357}}, {27, {-7638, -447}}, {28, {7213, 503}}, {29, {-6699, -548}},
+    {30, {6139, 581}}, {31, {-5558, -603}},
+    // band 12
+    {17, {-5084, 362}}, {18, {5529, -362}}, {19, {-6003, 362}}, {20, {6421, -348}},
+    {21, {-6825, 320}}, {22, {7201, -292}}, {23, {-7549, 264}}, {24, {7841, -222}},
+    {25, {-8092, 153}}, {26, {8245, -125}}, {27, {-8385, 69}}, {28, {8440, -13}},
+    {29, {-8440, -55}}, {30, {8357, 97}}, {31, {-8245, -167}}, {32, {8036, 208}},
+    {33, {-7800, -250}}, {34, {7493, 292}}, {35, {-7145, -320}}, {36, {6741, 348}},
+    {37, {-6309, -362}}, {38, {5864, 376}}, {39, {-5376, -376}},
+    // band 13
+    {21, {-4961, 884}}, {22, {5325, -919}}, {23, {-5690, 902}}, {24, {6054, -867}},
+    {25, {-6418, 850}}, {26, {6730, -815}}, {27, {-7060, 763}}, {28, {7338, -676}},
+    {29, {-7615, 607}}, {30, {7841, -537}}, {31, {-8032, 433}}, {32, {8188, -312}},
+    {33, {-8326, 208}}, {34, {8396, -138}}, {35, {-8431, 17}}, {36, {8413, 86}},
+    {37, {-8361, -208}}, {38, {8274, 312}}, {39, {-8153, -433}}, {40, {7962, 520}},
+    {41, {-7771, -607}}, {42, {7528, 693}}, {43, {-7251, -745}}, {44, {6939, 797}},
+    {45, {-6609, -850}}, {46, {6245, 902}}, {47, {-5915, -902}}, {48, {5499, 902}},
+    {49, {-5134, -919}},
+    // band 14
+    {27, {-5163, 1123}}, {28, {5423, -1123}}, {29, {-5725, 1101}}, {30, {6006, -1101}},
+    {31, {-6265, 1037}}, {32, {6546, -1015}}, {33, {-6805, 972}}, {34, {7021, -907}},
+    {35, {-7259, 842}}, {36, {7453, -777}}, {37, {-7626, 669}}, {38, {7778, -604}},
+    {39, {-7929, 496}}, {40, {8037, -410}}, {41, {-8123, 280}}, {42, {8188, -216}},
+    {43, {-8231, 64}}, {44, {8253, 43}}, {45, {-8253, -151}}, {46, {8166, 237}},
+    {47, {-8145, -367}}, {48, {8015, 453}}, {49, {-7907, -561}}, {50, {7756, 626}},
+    {51, {-7605, -756}}, {52, {7410, 799}}, {53, {-7216, -885}}, {54, {6978, 929}},
+    {55, {-6762, -1015}}, {56, {6481, 1037}}, {57, {-6244, -1123}}, {58, {5941, 1101}},
+    {59, {-5682, -1145}}, {60, {5379, 1123}}, {61, {-5077, -1145}},
+    // band 15
+    {33, {-4924, 1399}}, {34, {5139, -1426}}, {35, {-5435, 1399}}, {36, {5650, -1399}},
+    {37, {-5893, 1372}}, {38, {6135, -1345}}, {39, {-6404, 1291}}, {40, {6592, -1264}},
+    {41, {-6807, 1210}}, {42, {7050, -1157}}, {43, {-7238, 1103}}, {44, {7399, -995}},
+    {45, {-7615, 887}}, {46, {7749, -861}}, {47, {-7857, 753}}, {48, {8018, -672}},
+    {49, {-8126, 538}}, {50, {8180, -457}}, {51, {-8287, 349}}, {52, {8341, -242}},
+    {53, {-8368, 134}}, {54, {8422, -26}}, {55, {-8422, -107}}, {56, {8368, 215}},
+    {57, {-8341, -322}}, {58, {8314, 430}}, {59, {-8261, -538}}, {60, {8126, 618}},
+    {61, {-8072, -726}}, {62, {7911, 807}}, {63, {-7776, -914}}, {64, {7615, 968}},
+    {65, {-7453, -1049}}, {66, {7265, 1103}}, {67, {-7103, -1183}}, {68, {6888, 1210}},
+    {69, {-6673, -1264}}, {70, {6458, 1318}}, {71, {-6215, -1345}}, {72, {5946, 1372}},
+    {73, {-5731, -1399}}, {74, {5489, 1372}}, {75, {-5247, -1372}}, {76, {4978, 1372}},
+};
+
+} // namespace fft_precomputed
+} // namespace fl
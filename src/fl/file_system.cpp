@@ -105,8 +105,28 @@ bool FileSystem::readJson(const char *path, JsonDocument *doc) {
     return parseJson(text.c_str(), doc);
 }
 
+FileHandlePtr FileSystem::openBinaryScreenMap(const char *path) {
+    FileHandlePtr file = openRead(path);
+    if (!file || !file->valid()) {
+        return FileHandlePtr();
+    }
+    u8 magic[4] = {};
+    fl::size n = file->read(magic, sizeof(magic));
+    if (!ScreenMap::IsBinary(magic, n) || !file->seek(0)) {
+        close(file);
+        return FileHandlePtr();
+    }
+    return file;
+}
+
 bool FileSystem::readScreenMaps(const char *path,
                                 FixedMap<string, ScreenMap, 16> *out, string *error) {
+    if (FileHandlePtr file = openBinaryScreenMap(path)) {
+        // Binary layouts stream straight into the screen maps.
+        bool ok = ScreenMap::ParseBinary(*file, out, error);
+        close(file);
+        return ok;
+    }
     string text;
     if (!readText(path, &text)) {
         FASTLED_WARN("Failed to read file: " << path);
@@ -128,6 +148,12 @@ bool FileSystem::readScreenMaps(const char *path,
 
 bool FileSystem::readScreenMap(const char *path, const char *name,
                                ScreenMap *out, string *error) {
+    if (FileHandlePtr file = openBinaryScreenMap(path)) {
+        // Only the requested segment is decoded, the rest is skipped.
+        bool ok = ScreenMap::ParseBinary(*file, name, out, error);
+        close(file);
+        return ok;
+    }
     string text;
     if (!readText(path, &text)) {
         FASTLED_WARN("Failed to read file: " << path);
@@ -149,6 +175,29 @@ bool FileSystem::readScreenMap(const char *path, const char *name,
 
 void FileSystem::close(FileHandlePtr file) { mFs->close(file); }
 
+FileWriterPtr FileSystem::openWrite(const char *path) {
+    if (!mFs) {
+        return FileWriterPtr();
+    }
+    return mFs->openWrite(path);
+}
+
+bool FileSystem::writeFile(const char *path, const fl::u8 *data, fl::size n) {
+    FileWriterPtr file = openWrite(path);
+    if (!file) {
+        return false;
+    }
+    const bool written = file->write(data, n);
+    return file->close() && written;
+}
+
+bool FileSystem::mkdir(const char *path) {
+    if (!mFs) {
+        return false;
+    }
+    return mFs->mkdir(path);
+}
+
 FileHandlePtr FileSystem::openRead(const char *path) {
     return mFs->openRead(path);
 }
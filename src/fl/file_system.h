@@ -29,6 +29,7 @@ namespace fl {
 class ScreenMap;
 FASTLED_SMART_PTR(FileSystem);
 FASTLED_SMART_PTR(FileHandle);
+FASTLED_SMART_PTR(FileWriter);
 class Video;
 template <typename Key, typename Value, fl::size N> class FixedMap;
 
@@ -49,13 +50,24 @@ class FileSystem {
               fl::size nFrameHistory = 0); // Null if video could not be opened.
     bool readText(const char *path, string *out);
     bool readJson(const char *path, JsonDocument *doc);
+    // Accepts both json and binary (see ScreenMap::toBinary) layouts.
     bool readScreenMaps(const char *path, FixedMap<string, ScreenMap, 16> *out,
                         string *error = nullptr);
     bool readScreenMap(const char *path, const char *name, ScreenMap *out,
                        string *error = nullptr);
+    // Creates or replaces the file, written with write() calls and finished
+    // with close(). Null if the platform can't write.
+    FileWriterPtr openWrite(const char *path);
+    // openWrite(), one write() and close().
+    bool writeFile(const char *path, const fl::u8 *data, fl::size n);
+    // Creates the directory if missing. False if the platform can't.
+    bool mkdir(const char *path);
     void close(FileHandlePtr file);
 
   private:
+    // Opens path if it holds a binary screen map, otherwise returns null.
+    FileHandlePtr openBinaryScreenMap(const char *path);
+
     FsImplPtr mFs; // System dependent filesystem.
 };
 
@@ -80,6 +92,16 @@ class FileHandle : public Referent {
     }
 };
 
+// A file open for writing, see FsImpl::openWrite().
+class FileWriter : public Referent {
+  public:
+    virtual ~FileWriter() {}
+    // False if not all n bytes were written.
+    virtual bool write(const fl::u8 *data, fl::size n) = 0;
+    // Flushes and closes. False if the data may not have made it.
+    virtual bool close() = 0;
+};
+
 // Platforms will subclass this to implement the filesystem.
 class FsImpl : public Referent {
   public:
@@ -94,6 +116,16 @@ class FsImpl : public Referent {
     virtual void end() = 0;
     virtual void close(FileHandlePtr file) = 0;
     virtual FileHandlePtr openRead(const char *path) = 0;
+    // Optional: creates or replaces the file, written in pieces.
+    virtual FileWriterPtr openWrite(const char *path) {
+        (void)path;
+        return FileWriterPtr();
+    }
+    // Optional: creates the directory. True if it exists afterwards.
+    virtual bool mkdir(const char *path) {
+        (void)path;
+        return false;
+    }
 
     virtual bool ls(Visitor &visitor) {
         // todo: implement.
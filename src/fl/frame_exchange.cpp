@@ -0,0 +1,81 @@
+#include "fl/frame_exchange.h"
+
+#include "FastLED.h"
+#include "fl/assert.h"
+#include "fl/memory_budget.h"
+
+namespace fl {
+
+FrameExchange::~FrameExchange() {
+    // Newest slot first, so a controller added twice ends up with what it
+    // had before the first add().
+    for (fl::size i = mSlots.size(); i-- > 0;) {
+        Slot *slot = mSlots[i];
+        slot->controller->setLeds(slot->originalLeds, slot->originalSize);
+        delete slot;
+    }
+}
+
+int FrameExchange::add(CLEDController *controller) {
+    FL_ASSERT(controller, "FrameExchange::add: null controller");
+    Slot *slot = new Slot();
+    slot->controller = controller;
+    slot->originalLeds = controller->leds();
+    slot->originalSize = controller->size();
+    slot->size = fl::size(controller->size());
+    {
+        MemScope scope(MemCategory::kLeds);
+        slot->pixels.resize(slot->size * 3);
+    }
+    controller->setLeds(slot->buffer(slot->front), int(slot->size));
+    mSlots.push_back(slot);
+    return int(mSlots.size()) - 1;
+}
+
+fl::size FrameExchange::size(int slot) const { return mSlots[slot]->size; }
+
+CRGB *FrameExchange::acquire(int slot) {
+    Slot &s = *mSlots[slot];
+    return s.buffer(s.back);
+}
+
+void FrameExchange::submit(int slot) {
+    Slot &s = *mSlots[slot];
+    s.submitted.fetch_add(1);
+    // Hand the drawn buffer over and take back whichever one was waiting.
+    // The exchange orders the drawing before present()'s exchange.
+    s.back = u8(s.ready.exchange(u8(s.back | kFresh)) & ~kFresh);
+}
+
+fl::u32 FrameExchange::submitted(int slot) const {
+    return mSlots[slot]->submitted.load();
+}
+
+int FrameExchange::present() {
+    int changed = 0;
+    for (fl::size i = 0; i < mSlots.size(); ++i) {
+        Slot &s = *mSlots[i];
+        if (!(s.ready.load() & kFresh)) {
+            continue;
+        }
+        // Only present() clears kFresh, so the frame is still there.
+        s.front = u8(s.ready.exchange(s.front) & ~kFresh);
+        s.controller->setLeds(s.buffer(s.front), int(s.size));
+        ++changed;
+    }
+    return changed;
+}
+
+int FrameExchange::show(u8 brightness) {
+    const int changed = present();
+    FastLED.show(brightness);
+    return changed;
+}
+
+int FrameExchange::show() {
+    const int changed = present();
+    FastLED.show();
+    return changed;
+}
+
+} // namespace fl
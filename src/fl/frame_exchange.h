@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+Frame submission from several threads, for hosted builds that render
+different strips on different threads.
+
+CFastLED, CLEDController and the controller list are single threaded: show()
+and the LED arrays must only be touched by one thread. A FrameExchange sits
+in between. Each registered controller gets a slot with three frame buffers:
+
+    back   - the one its producer draws into, owned by that producer.
+    ready  - the newest submitted frame, owned by neither side.
+    front  - the one the controller shows, owned by the transmit thread.
+
+submit() swaps back and ready, present() swaps ready and front, each with a
+single atomic exchange. So a producer never waits for the transmit thread,
+the controller never sees a half drawn frame, and a frame submitted twice
+before present() is replaced by the newer one (latest wins).
+
+    fl::FrameExchange exchange;
+    const int left = exchange.add(&FastLED.addLeds<WS2812, 2>(leds, 60));
+    const int right = exchange.add(&FastLED.addLeds<WS2812, 3>(leds2, 60));
+
+    // producer thread, one per slot
+    CRGB *frame = exchange.acquire(left);
+    fill_rainbow(frame, exchange.size(left), hue++);
+    exchange.submit(left);
+
+    // transmit thread, the only one calling FastLED
+    exchange.show();
+
+Rules:
+    - Register every controller with add() before the threads start.
+    - At most one producer thread per slot.
+    - Only the transmit thread calls present() / show() and FastLED.
+
+Without FASTLED_MULTITHREADED the atomics are plain variables and the same
+calls work from one thread.
+*/
+
+#include "crgb.h"
+#include "fl/atomic.h"
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/vector.h"
+
+FASTLED_NAMESPACE_BEGIN
+class CLEDController;
+FASTLED_NAMESPACE_END
+
+namespace fl {
+
+class FrameExchange {
+  public:
+    FrameExchange() = default;
+    // Points every controller back at the LEDs it had before add().
+    ~FrameExchange();
+    FrameExchange(const FrameExchange &) = delete;
+    FrameExchange &operator=(const FrameExchange &) = delete;
+
+    // Gives the controller a slot sized to its current LED count and points
+    // it at the slot's (black) front buffer. Returns the slot index.
+    int add(CLEDController *controller);
+    int slots() const { return int(mSlots.size()); }
+    // LEDs per frame in the slot.
+    fl::size size(int slot) const;
+
+    // Producer side. The buffer to draw the next frame in; it stays the
+    // same until submit(). Holds whatever frame last left it, not
+    // necessarily the previous one submitted.
+    CRGB *acquire(int slot);
+    // Publishes the acquired buffer as the slot's newest frame.
+    void submit(int slot);
+    // Frames submitted to the slot so far.
+    fl::u32 submitted(int slot) const;
+
+    // Transmit side. Swaps the newest submitted frame of every slot that has
+    // one into its controller. Returns how many slots changed.
+    int present();
+    // present() then FastLED.show(brightness).
+    int show(fl::u8 brightness);
+    // present() then FastLED.show().
+    int show();
+
+  private:
+    static const fl::u8 kFresh = 0x80;  // ready holds an unshown frame
+
+    struct Slot {
+        CLEDController *controller = nullptr;
+        CRGB *originalLeds = nullptr;  // restored on destruction
+        int originalSize = 0;
+        fl::size size = 0;
+        fl::vector<CRGB> pixels;  // 3 * size: the three frame buffers
+        fl::u8 back = 0;          // producer's buffer index
+        fl::u8 front = 2;         // transmit thread's buffer index
+        fl::atomic<fl::u8> ready{1};
+        fl::atomic<fl::u32> submitted{0};
+
+        CRGB *buffer(fl::u8 index) { return pixels.data() + index * size; }
+    };
+
+    fl::vector<Slot *> mSlots;
+};
+
+} // namespace fl
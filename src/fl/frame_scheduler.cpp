@@ -0,0 +1,197 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "FastLED.h"
+
+#include "fl/frame_scheduler.h"
+#include "fl/singleton.h"
+#include "fl/trace.h"
+
+namespace fl {
+
+FrameScheduler &FrameScheduler::instance() {
+    return Singleton<FrameScheduler>::instance();
+}
+
+u32 FrameScheduler::now() const {
+    if (mClock) {
+        return mClock();
+    }
+    return ::micros();
+}
+
+int FrameScheduler::addTask(const char *name, Task task, Priority priority,
+                            u32 budgetMicros) {
+    Entry entry;
+    entry.id = mNextId++;
+    entry.name = name;
+    entry.task = task;
+    entry.priority = priority;
+    entry.budget = budgetMicros;
+    mTasks.push_back(entry);
+    return entry.id;
+}
+
+bool FrameScheduler::removeTask(int id) {
+    for (auto it = mTasks.begin(); it != mTasks.end(); ++it) {
+        if (it->id == id) {
+            mTasks.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameScheduler::post(Task task, Priority priority, u32 budgetMicros) {
+    Posted posted;
+    posted.task = task;
+    posted.priority = priority;
+    posted.budget = budgetMicros;
+    mPosted.push_back(posted);
+}
+
+u32 FrameScheduler::remainingMicros() const {
+    if (!mInSlice) {
+        return 0;
+    }
+    u32 elapsed = now() - mSliceStart;
+    return elapsed < mSliceBudget ? mSliceBudget - elapsed : 0;
+}
+
+bool FrameScheduler::fits(Priority priority, u32 budget) const {
+    if (priority == kCritical) {
+        return true;
+    }
+    u32 remaining = remainingMicros();
+    return budget ? budget <= remaining : remaining > 0;
+}
+
+FrameScheduler::Entry *FrameScheduler::find(int id) {
+    for (auto &entry : mTasks) {
+        if (entry.id == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const FrameScheduler::Entry *FrameScheduler::find(int id) const {
+    for (const auto &entry : mTasks) {
+        if (entry.id == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const FrameScheduler::TaskStats *FrameScheduler::stats(int id) const {
+    const Entry *entry = find(id);
+    return entry ? &entry->stats : nullptr;
+}
+
+const char *FrameScheduler::name(int id) const {
+    const Entry *entry = find(id);
+    return entry ? entry->name : nullptr;
+}
+
+int FrameScheduler::runIdle(u32 budgetMicros) {
+    if (mInSlice) {
+        return 0; // A task called show(), don't recurse.
+    }
+    FL_TRACE_SCOPE("scheduler.idle");
+    mInSlice = true;
+    mSliceStart = now();
+    mSliceBudget = budgetMicros;
+    int ran = 0;
+
+    // Work posted from inside the slice waits for the next one.
+    fl::vector<Posted> posted;
+    posted.swap(mPosted);
+    fl::vector<bool> postedDone;
+    postedDone.resize(posted.size(), false);
+
+    for (u8 p = kCritical; p <= kLow; ++p) {
+        const Priority priority = Priority(p);
+        for (fl::size i = 0; i < posted.size(); ++i) {
+            if (posted[i].priority != priority ||
+                !fits(priority, posted[i].budget)) {
+                continue;
+            }
+            posted[i].task();
+            postedDone[i] = true;
+            ran++;
+        }
+
+        // Ids in order of how long they have been waiting, tasks can add or
+        // remove tasks while they run so entries are looked up again.
+        fl::vector_inlined<int, 16> order;
+        for (const auto &entry : mTasks) {
+            if (entry.priority != priority) {
+                continue;
+            }
+            auto it = order.begin();
+            while (it != order.end() && find(*it)->waiting >= entry.waiting) {
+                ++it;
+            }
+            order.insert(it, entry.id);
+        }
+        for (int id : order) {
+            Entry *entry = find(id);
+            if (!entry) {
+                continue;
+            }
+            if (!fits(priority, entry->budget)) {
+                entry->waiting++;
+                entry->stats.deferrals++;
+                continue;
+            }
+            // Copy, the task may reallocate mTasks.
+            Task task = entry->task;
+            u32 start = now();
+            task();
+            u32 elapsed = now() - start;
+            ran++;
+            entry = find(id);
+            if (!entry) {
+                continue; // Removed itself.
+            }
+            TaskStats &stats = entry->stats;
+            stats.runs++;
+            stats.totalMicros += elapsed;
+            if (elapsed > stats.maxMicros) {
+                stats.maxMicros = elapsed;
+            }
+            if (entry->budget && elapsed > entry->budget) {
+                stats.deadlineMisses++;
+            }
+            entry->waiting = 0;
+        }
+    }
+
+    // Requeue what did not fit ahead of work posted during the slice.
+    fl::vector<Posted> later;
+    for (fl::size i = 0; i < posted.size(); ++i) {
+        if (!postedDone[i]) {
+            later.push_back(posted[i]);
+        }
+    }
+    for (auto &p : mPosted) {
+        later.push_back(p);
+    }
+    mPosted.swap(later);
+
+    if (now() - mSliceStart > mSliceBudget) {
+        mSliceOverruns++;
+    }
+    mInSlice = false;
+    return ran;
+}
+
+void FrameScheduler::clear() {
+    mTasks.clear();
+    mPosted.clear();
+    mSliceOverruns = 0;
+}
+
+} // namespace fl
@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+Cooperative, time budgeted scheduler for work that does not have to happen on
+the frame path: UI json, telemetry, console parsing and deferred
+EngineEvents listeners.
+
+FastLED.show() ends with an idle slice. The slice runs due tasks in priority
+order until its budget is spent, tasks that do not fit are deferred to the
+next slice and are preferred over tasks of the same priority that already ran.
+Nothing is preempted: a task that runs long only shows up in its stats.
+
+Example:
+    auto &sched = fl::FrameScheduler::instance();
+    int id = sched.addTask("telemetry", []() { sendTelemetry(); },
+                           fl::FrameScheduler::kLow, 500);
+    ...
+    const fl::FrameScheduler::TaskStats *s = sched.stats(id);
+    FASTLED_WARN("telemetry max " << s->maxMicros << "us, misses "
+                                 << s->deadlineMisses);
+*/
+
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/vector.h"
+
+// Idle slice after show() when no refresh rate limit leaves more time.
+#ifndef FASTLED_IDLE_BUDGET_MICROS
+#define FASTLED_IDLE_BUDGET_MICROS 1000
+#endif
+
+namespace fl {
+
+class FrameScheduler {
+  public:
+    enum Priority : fl::u8 {
+        kCritical = 0, // Always runs, even when the slice has no time left.
+        kHigh,
+        kNormal,
+        kLow,
+    };
+
+    using Task = fl::function<void()>;
+    // Returns a timestamp in microseconds, wrapping is fine.
+    using Clock = fl::function<fl::u32()>;
+
+    struct TaskStats {
+        fl::u32 runs = 0;
+        fl::u32 totalMicros = 0;
+        fl::u32 maxMicros = 0;
+        fl::u32 deadlineMisses = 0; // Runs that took longer than the budget.
+        fl::u32 deferrals = 0;      // Slices where the task did not fit.
+    };
+
+    static FrameScheduler &instance();
+
+    FrameScheduler() = default;
+
+    // Recurring task, runs at most once per idle slice. budgetMicros is how
+    // long the task is expected to take, 0 means "small". A task only starts
+    // if its budget fits into what is left of the slice. Returns the task id.
+    int addTask(const char *name, Task task, Priority priority = kNormal,
+                fl::u32 budgetMicros = 0);
+    bool removeTask(int id);
+    // One shot task, runs in the next slice that has room for it.
+    void post(Task task, Priority priority = kNormal, fl::u32 budgetMicros = 0);
+
+    // Runs an idle slice, returns the number of tasks that ran.
+    int runIdle(fl::u32 budgetMicros);
+    int runIdle() { return runIdle(mIdleBudget); }
+
+    // For tasks that can split their work, time left in the current slice.
+    fl::u32 remainingMicros() const;
+    bool inSlice() const { return mInSlice; }
+
+    void setIdleBudget(fl::u32 micros) { mIdleBudget = micros; }
+    fl::u32 idleBudget() const { return mIdleBudget; }
+
+    // nullptr if there is no recurring task with this id.
+    const TaskStats *stats(int id) const;
+    const char *name(int id) const;
+    fl::size numTasks() const { return mTasks.size(); }
+    fl::size numPending() const { return mPosted.size(); }
+    // Slices that ended later than their budget.
+    fl::u32 sliceOverruns() const { return mSliceOverruns; }
+
+    // Defaults to micros(), tests and headless runners install their own.
+    void setClock(Clock clock) { mClock = clock; }
+    fl::u32 now() const;
+
+    // Removes all tasks and stats.
+    void clear();
+
+  private:
+    struct Entry {
+        int id = 0;
+        const char *name = nullptr;
+        Task task;
+        Priority priority = kNormal;
+        fl::u32 budget = 0;
+        fl::u32 waiting = 0; // Slices since the task was deferred.
+        TaskStats stats;
+    };
+    struct Posted {
+        Task task;
+        Priority priority = kNormal;
+        fl::u32 budget = 0;
+    };
+
+    bool fits(Priority priority, fl::u32 budget) const;
+    Entry *find(int id);
+    const Entry *find(int id) const;
+
+    fl::vector<Entry> mTasks;
+    fl::vector<Posted> mPosted;
+    Clock mClock;
+    fl::u32 mIdleBudget = FASTLED_IDLE_BUDGET_MICROS;
+    fl::u32 mSliceStart = 0;
+    fl::u32 mSliceBudget = 0;
+    fl::u32 mSliceOverruns = 0;
+    int mNextId = 1;
+    bool mInSlice = false;
+};
+
+} // namespace fl
@@ -0,0 +1,185 @@
+#include "fl/frame_stats.h"
+#include "fl/singleton.h"
+
+namespace fl {
+
+int FrameTimeHistogram::bucketOf(u32 micros) {
+    if (micros < kSubBuckets) {
+        return int(micros);
+    }
+#if defined(__GNUC__) && !defined(__AVR__) // int is 16 bit on avr.
+    const int e = 31 - __builtin_clz(micros);
+#else
+    int e = 3;
+    while (micros >> (e + 1)) {
+        ++e;
+    }
+#endif
+    const int sub = int(micros >> (e - 3)) & (kSubBuckets - 1);
+    return kSubBuckets + (e - 3) * kSubBuckets + sub;
+}
+
+u32 FrameTimeHistogram::bucketUpper(int bucket) {
+    if (bucket < kSubBuckets) {
+        return u32(bucket);
+    }
+    const int e = (bucket - kSubBuckets) / kSubBuckets + 3;
+    const u32 sub = u32(bucket - kSubBuckets) % kSubBuckets;
+    const u32 lower = (kSubBuckets + sub) << (e - 3);
+    return lower + ((u32(1) << (e - 3)) - 1);
+}
+
+void FrameTimeHistogram::add(u32 micros) {
+    const int b = bucketOf(micros);
+    if (mCounts[b] == 0xFFFF) {
+        mTotal = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            mCounts[i] >>= 1;
+            mTotal += mCounts[i];
+        }
+    }
+    ++mCounts[b];
+    ++mTotal;
+    if (mSamples == 0 || micros < mMin) {
+        mMin = micros;
+    }
+    if (micros > mMax) {
+        mMax = micros;
+    }
+    ++mSamples;
+    mSum += micros;
+    mLast = micros;
+}
+
+void FrameTimeHistogram::reset() { *this = FrameTimeHistogram(); }
+
+u32 FrameTimeHistogram::mean() const {
+    return mSamples ? u32(mSum / mSamples) : 0;
+}
+
+u32 FrameTimeHistogram::percentile(u8 p) const {
+    if (mTotal == 0) {
+        return 0;
+    }
+    if (p > 100) {
+        p = 100;
+    }
+    u32 target = u32((u64(mTotal) * p + 99) / 100);
+    if (target == 0) {
+        target = 1;
+    }
+    u32 seen = 0;
+    for (int b = 0; b < kNumBuckets; ++b) {
+        seen += mCounts[b];
+        if (seen >= target) {
+            const u32 upper = bucketUpper(b);
+            return upper < mMax ? upper : mMax;
+        }
+    }
+    return mMax;
+}
+
+#if FASTLED_ENABLE_JSON
+void FrameTimeHistogram::toJson(FLArduinoJson::JsonObject &json) const {
+    json["p50"] = percentile(50);
+    json["p90"] = percentile(90);
+    json["p99"] = percentile(99);
+    json["min"] = min();
+    json["max"] = max();
+    json["mean"] = mean();
+    json["last"] = last();
+}
+
+void FrameTimeHistogram::bucketsToJson(FLArduinoJson::JsonArray &json) const {
+    for (int b = 0; b < kNumBuckets; ++b) {
+        if (mCounts[b]) {
+            FLArduinoJson::JsonArray pair = json.add<FLArduinoJson::JsonArray>();
+            pair.add(bucketUpper(b));
+            pair.add(mCounts[b]);
+        }
+    }
+}
+#endif
+
+FrameStats &FrameStats::instance() { return Singleton<FrameStats>::instance(); }
+
+void FrameStats::beginShow(u32 now) {
+    if (mHasShowEnd) {
+        mRender.add(now - mShowEnd);
+        const u32 frame = now - mShowBegin;
+        if (mFrame.samples()) {
+            const u32 prev = mFrame.last();
+            const u32 d = frame > prev ? frame - prev : prev - frame;
+            mJitter16 = mJitter16 + d - (mJitter16 >> 4);
+            mAvgFrame16 = mAvgFrame16 + frame - (mAvgFrame16 >> 4);
+        } else {
+            mAvgFrame16 = frame << 4;
+        }
+        mFrame.add(frame);
+    }
+    mShowBegin = now;
+    mWaited = 0;
+}
+
+void FrameStats::endWait(u32 waitBegin, u32 now) {
+    mWaited = now - waitBegin;
+    mIdle.add(mWaited + mIdleSlice);
+    mIdleSlice = 0;
+}
+
+void FrameStats::endShow(u32 now) {
+    mShow.add(now - mShowBegin - mWaited);
+    mShowEnd = now;
+    mHasShowEnd = true;
+    ++mFrames;
+}
+
+void FrameStats::endIdleSlice(u32 now) {
+    // The render phase starts when show() actually returns.
+    mIdleSlice = now - mShowEnd;
+    mShowEnd = now;
+}
+
+u16 FrameStats::fps() const {
+    if (mAvgFrame16 == 0) {
+        return 0;
+    }
+    const u32 fps = u32((u64(1000000) << 4) / mAvgFrame16);
+    return fps > 0xFFFF ? 0xFFFF : u16(fps);
+}
+
+void FrameStats::reset() { *this = FrameStats(); }
+
+#if FASTLED_ENABLE_JSON
+void FrameStats::toJson(FLArduinoJson::JsonObject &json) const {
+    json["frames"] = mFrames;
+    json["fps"] = fps();
+    json["jitter_us"] = jitterMicros();
+    FLArduinoJson::JsonObject frame = json["frame_us"].to<FLArduinoJson::JsonObject>();
+    mFrame.toJson(frame);
+    FLArduinoJson::JsonObject render = json["render_us"].to<FLArduinoJson::JsonObject>();
+    mRender.toJson(render);
+    FLArduinoJson::JsonObject show = json["show_us"].to<FLArduinoJson::JsonObject>();
+    mShow.toJson(show);
+    FLArduinoJson::JsonObject idle = json["idle_us"].to<FLArduinoJson::JsonObject>();
+    mIdle.toJson(idle);
+    FLArduinoJson::JsonArray buckets =
+        json["frame_histogram"].to<FLArduinoJson::JsonArray>();
+    mFrame.bucketsToJson(buckets);
+}
+#endif
+
+fl::string FrameStats::toJsonString() const {
+    fl::string out;
+#if FASTLED_ENABLE_JSON
+    FLArduinoJson::JsonDocument doc;
+    FLArduinoJson::JsonObject json = doc.to<FLArduinoJson::JsonObject>();
+    toJson(json);
+    serializeJson(doc, out);
+#else
+    out = "{}";
+#endif
+    return out;
+}
+
+} // namespace fl
@@ -0,0 +1,129 @@
+#pragma once
+
+/*
+Frame timing statistics, collected by FastLED.show().
+
+Every show() splits the time since the previous one into three phases:
+
+    render - from the end of the last show() to the start of this one, the
+             sketch's own loop() work.
+    idle   - the wait in show() for the max refresh rate (setMaxRefreshRate()),
+             plus the idle slice (FrameScheduler) the previous show() ran
+             before returning.
+    show   - the rest of show(): power limiting, encoding and pushing the
+             pixels out, EngineEvents listeners.
+
+and the whole frame (start of show() to start of the next show()). Each goes
+into a log bucketed histogram of fixed size (8 buckets per power of two, so
+percentiles are at most ~12% high), from which p50/p99 and friends are read.
+Jitter is the smoothed difference between consecutive frame times (RFC 3550
+style, 1/16 gain).
+
+    const fl::FrameStats &stats = fl::FrameStats::instance();
+    FASTLED_WARN("p99 " << stats.frame().percentile(99) << "us, jitter "
+                        << stats.jitterMicros() << "us");
+
+Defines:
+    FASTLED_FRAME_STATS - 1 to collect. Default on when the sketch has lots of
+                          memory (the histograms take ~2kB), else show() keeps
+                          the old countFPS() counter.
+*/
+
+#include "fl/int.h"
+#include "fl/json.h"
+#include "fl/namespace.h"
+#include "fl/sketch_macros.h"
+#include "fl/str.h"
+
+#ifndef FASTLED_FRAME_STATS
+#define FASTLED_FRAME_STATS SKETCH_HAS_LOTS_OF_MEMORY
+#endif
+
+namespace fl {
+
+// Histogram of microsecond durations. Values below 8 have exact buckets,
+// above that every power of two is split into 8 buckets. Counts are halved
+// when one would overflow, so old frames slowly lose weight.
+class FrameTimeHistogram {
+  public:
+    static const int kSubBuckets = 8;
+    static const int kNumBuckets = kSubBuckets + (32 - 3) * kSubBuckets;
+
+    void add(fl::u32 micros);
+    void reset();
+
+    // Samples seen since the last reset, not affected by halving.
+    fl::u32 samples() const { return mSamples; }
+    fl::u32 min() const { return mSamples ? mMin : 0; }
+    fl::u32 max() const { return mMax; }
+    fl::u32 mean() const;
+    fl::u32 last() const { return mLast; }
+    // Upper edge of the bucket holding the p-th percentile, capped at max().
+    fl::u32 percentile(fl::u8 p) const;
+
+    static int bucketOf(fl::u32 micros);
+    // Largest value that falls into the bucket.
+    static fl::u32 bucketUpper(int bucket);
+    fl::u16 count(int bucket) const { return mCounts[bucket]; }
+
+#if FASTLED_ENABLE_JSON
+    // {"p50":..,"p90":..,"p99":..,"min":..,"max":..,"mean":..,"last":..}
+    void toJson(FLArduinoJson::JsonObject &json) const;
+    // [[bucket upper us, count], ...] for the non empty buckets.
+    void bucketsToJson(FLArduinoJson::JsonArray &json) const;
+#endif
+
+  private:
+    fl::u16 mCounts[kNumBuckets] = {};
+    fl::u32 mTotal = 0; // Sum of mCounts.
+    fl::u32 mSamples = 0;
+    fl::u32 mMin = 0;
+    fl::u32 mMax = 0;
+    fl::u32 mLast = 0;
+    fl::u64 mSum = 0;
+};
+
+class FrameStats {
+  public:
+    static FrameStats &instance();
+
+    // Hooks called by CFastLED::show(), timestamps from micros().
+    void beginShow(fl::u32 now); // show() entered, render phase ends.
+    void endWait(fl::u32 waitBegin, fl::u32 now); // Refresh rate wait.
+    void endShow(fl::u32 now);   // Pixels are out.
+    // Idle slice run by show() after endShow(), show() returns at `now`.
+    void endIdleSlice(fl::u32 now);
+
+    const FrameTimeHistogram &frame() const { return mFrame; }
+    const FrameTimeHistogram &render() const { return mRender; }
+    const FrameTimeHistogram &show() const { return mShow; }
+    const FrameTimeHistogram &idle() const { return mIdle; }
+
+    fl::u32 frames() const { return mFrames; }
+    fl::u32 jitterMicros() const { return mJitter16 >> 4; }
+    // From the smoothed frame time, 0 until two frames were shown.
+    fl::u16 fps() const;
+
+    void reset();
+
+#if FASTLED_ENABLE_JSON
+    void toJson(FLArduinoJson::JsonObject &json) const;
+#endif
+    fl::string toJsonString() const;
+
+  private:
+    FrameTimeHistogram mFrame;
+    FrameTimeHistogram mRender;
+    FrameTimeHistogram mShow;
+    FrameTimeHistogram mIdle;
+    fl::u32 mFrames = 0;
+    fl::u32 mShowBegin = 0;
+    fl::u32 mWaited = 0;
+    fl::u32 mShowEnd = 0;
+    fl::u32 mIdleSlice = 0; // Idle slice after the last show(), counted as idle.
+    fl::u32 mJitter16 = 0;  // Jitter in 1/16 us.
+    fl::u32 mAvgFrame16 = 0; // Smoothed frame time in 1/16 us.
+    bool mHasShowEnd = false;
+};
+
+} // namespace fl
@@ -8,6 +8,8 @@
 #include "fl/json.h"
 #include "fl/algorithm.h"
 #include "fl/stdint.h"
+#include "fl/frame_stats.h"
+#include "fl/trace.h"
 #include "platforms/shared/ui/json/ui.h"
 
 namespace fl {
@@ -21,6 +23,10 @@ JsonConsole::JsonConsole(ReadAvailableCallback ReadAvailableCallback,
 }
 
 JsonConsole::~JsonConsole() {
+    if (mUpdateTaskId) {
+        FrameScheduler::instance().removeTask(mUpdateTaskId);
+    }
+
     // Clear input buffer
     mInputBuffer.clear();
     
@@ -53,6 +59,16 @@ void JsonConsole::init() {
     writeOutput("JsonConsole initialized. Type 'help' for commands.");
 }
 
+void JsonConsole::scheduleUpdates(FrameScheduler::Priority priority,
+                                   fl::u32 budgetMicros) {
+    FrameScheduler &scheduler = FrameScheduler::instance();
+    if (mUpdateTaskId) {
+        scheduler.removeTask(mUpdateTaskId);
+    }
+    mUpdateTaskId = scheduler.addTask(
+        "JsonConsole", [this]() { this->update(); }, priority, budgetMicros);
+}
+
 void JsonConsole::update() {
     if (!mUpdateEngineState) {
         return; // Not initialized
@@ -92,6 +108,10 @@ bool JsonConsole::executeCommand(const fl::string& command) {
         writeOutput("Available commands:");
         writeOutput("  <component_name>: <value>  - Set component value by name");
         writeOutput("  <component_id>: <value>    - Set component value by ID");
+        writeOutput("  trace                      - Print the FL_TRACE_SCOPE ring as Chrome trace json");
+        writeOutput("  trace clear                - Drop the recorded trace events");
+        writeOutput("  stats                      - Print the FrameStats json");
+        writeOutput("  stats reset                - Reset the frame statistics");
         writeOutput("  help                       - Show this help");
         writeOutput("Examples:");
         writeOutput("  slider: 80    - Set component named 'slider' to 80");
@@ -99,6 +119,26 @@ bool JsonConsole::executeCommand(const fl::string& command) {
         return true;
     }
     
+    if (trimmed == "trace") {
+        Tracer::instance().writeChromeTrace(
+            [this](const char *piece) { writeOutput(piece); });
+        return true;
+    }
+    if (trimmed == "trace clear") {
+        Tracer::instance().clear();
+        writeOutput("Trace cleared");
+        return true;
+    }
+    if (trimmed == "stats") {
+        writeOutput(FrameStats::instance().toJsonString().c_str());
+        return true;
+    }
+    if (trimmed == "stats reset") {
+        FrameStats::instance().reset();
+        writeOutput("Stats reset");
+        return true;
+    }
+
     FL_WARN("JsonConsole::executeCommand: Calling parseCommand");
     parseCommand(trimmed);
     FL_WARN("JsonConsole::executeCommand: parseCommand completed");
@@ -157,8 +197,7 @@ void JsonConsole::parseCommand(const fl::string& command) {
         return;
     }
     
-    // Work around fl::string::substring bug - it includes the end index when it shouldn't
-    fl::string name = command.substring(0, static_cast<fl::size>(colonPos - 1));
+    fl::string name = command.substring(0, static_cast<fl::size>(colonPos));
     fl::string valueStr = command.substring(static_cast<fl::size>(colonPos + 1), command.size());
     
     FL_WARN("JsonConsole::parseCommand: Raw name: '" << name.c_str() << "'");
@@ -227,13 +266,7 @@ bool JsonConsole::setSliderValue(const fl::string& name, float value) {
     } else {
         // Not a valid integer, try to find component ID by name
         int* componentIdPtr = mComponentNameToId.find_value(name);
-        
-        // WORKAROUND: Handle subtle string comparison issue in some environments
-        // Try with a fresh string if the parsed name doesn't work
-        if (!componentIdPtr && name == "slider") {
-            fl::string freshKey = "slider";
-            componentIdPtr = mComponentNameToId.find_value(freshKey);
-        }
+
         
         if (!componentIdPtr) {
             FL_WARN("JsonConsole: Component '" << name.c_str() << "' not found in mapping");
@@ -281,22 +314,27 @@ void JsonConsole::updateComponentMapping(const char* jsonStr) {
         return; // Invalid JSON
     }
     
-    // Clear existing mapping
-    mComponentNameToId.clear();
-    
-    // Parse component array and build name->ID mapping
+    // A full snapshot is the plain component array and replaces the mapping.
+    // A {"delta": [...]} only carries the components that changed, so it
+    // just refreshes those entries.
+    FLArduinoJson::JsonArrayConst array;
     if (doc.is<FLArduinoJson::JsonArray>()) {
-        auto array = doc.as<FLArduinoJson::JsonArrayConst>();
-        for (auto component : array) {
-            // Direct access to component fields (more reliable than type checking)
-            bool hasName = component["name"].is<const char*>();
-            bool hasId = component["id"].is<int>();
-            
-            if (hasName && hasId) {
-                fl::string name = component["name"].as<const char*>();
-                int id = component["id"].as<int>();
-                mComponentNameToId[name] = id;
-            }
+        mComponentNameToId.clear();
+        array = doc.as<FLArduinoJson::JsonArrayConst>();
+    } else if (doc["delta"].is<FLArduinoJson::JsonArray>()) {
+        array = doc["delta"].as<FLArduinoJson::JsonArrayConst>();
+    } else {
+        return;
+    }
+    for (auto component : array) {
+        // Direct access to component fields (more reliable than type checking)
+        bool hasName = component["name"].is<const char*>();
+        bool hasId = component["id"].is<int>();
+        
+        if (hasName && hasId) {
+            fl::string name = component["name"].as<const char*>();
+            int id = component["id"].as<int>();
+            mComponentNameToId[name] = id;
         }
     }
 }
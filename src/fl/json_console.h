@@ -1,5 +1,6 @@
 #pragma once
 
+#include "fl/frame_scheduler.h"
 #include "fl/function.h"
 #include "fl/str.h"
 #include "fl/hash_map.h"
@@ -25,6 +26,9 @@ FASTLED_SMART_PTR(JsonConsole);
  * - Components can be matched by either name (string) or ID (integer)
  * - If the component identifier can be converted to an integer, it's used as ID
  * - Otherwise, the string key is used to lookup the component by name
+ * - "trace" prints the FL_TRACE_SCOPE events as Chrome trace json, "trace clear"
+ *   drops them
+ * - "stats" prints fl::FrameStats as json, "stats reset" starts over
  */
 class JsonConsole : public fl::Referent {
 public:
@@ -60,6 +64,15 @@ public:
      * Should be called regularly (e.g., in main loop)
      */
     void update();
+
+    /**
+     * Run update() from the FrameScheduler idle slice after show() instead of
+     * calling it from the main loop, so console parsing stays off the frame path
+     * @param priority Scheduler priority, console input is usually kLow
+     * @param budgetMicros Expected time per update, 0 if small
+     */
+    void scheduleUpdates(FrameScheduler::Priority priority = FrameScheduler::kLow,
+                         fl::u32 budgetMicros = 0);
     
     /**
      * Parse and execute a console command
@@ -77,7 +90,8 @@ public:
     /**
      * Manually update component mapping from JSON string
      * This is useful for testing or when component data is available outside the normal JsonUI flow
-     * @param jsonStr JSON array of component data
+     * @param jsonStr JSON array of component data, replaces the mapping, or
+     *                a {"delta": [...]} that only updates the listed components
      */
     void updateComponentMapping(const char* jsonStr);
     
@@ -102,6 +116,9 @@ private:
     
     // Component name to ID mapping (updated when UI sends component list)
     fl::hash_map<fl::string, int> mComponentNameToId;
+
+    // FrameScheduler task running update(), 0 if not scheduled
+    int mUpdateTaskId = 0;
     
     // Helper methods
     void readInputFromSerial();
@@ -0,0 +1,134 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "FastLED.h"
+
+#include "fl/math8_bulk.h"
+#include "fl/simd.h"
+
+namespace fl {
+
+namespace {
+
+struct Math8BulkQadd {
+    template <typename B>
+    static typename B::u8x16 vec(const typename B::u8x16 &a,
+                                 const typename B::u8x16 &b) {
+        return B::adds_u8(a, b);
+    }
+    static u8 one(u8 a, u8 b) { return qadd8(a, b); }
+};
+
+struct Math8BulkQsub {
+    template <typename B>
+    static typename B::u8x16 vec(const typename B::u8x16 &a,
+                                 const typename B::u8x16 &b) {
+        return B::subs_u8(a, b);
+    }
+    static u8 one(u8 a, u8 b) { return qsub8(a, b); }
+};
+
+struct Math8BulkMax {
+    template <typename B>
+    static typename B::u8x16 vec(const typename B::u8x16 &a,
+                                 const typename B::u8x16 &b) {
+        return B::max_u8(a, b);
+    }
+    static u8 one(u8 a, u8 b) { return a > b ? a : b; }
+};
+
+struct Math8BulkMin {
+    template <typename B>
+    static typename B::u8x16 vec(const typename B::u8x16 &a,
+                                 const typename B::u8x16 &b) {
+        return B::min_u8(a, b);
+    }
+    static u8 one(u8 a, u8 b) { return a < b ? a : b; }
+};
+
+// The 128 bit kernels return how many bytes they processed, the caller
+// finishes the tail. A null src means every byte is combined with value.
+template <typename Op, typename B>
+fl::size math8_bulk_kernel(u8 *dst, const u8 *src, fl::size n, u8 value) {
+    fl::size i = 0;
+    if (src) {
+        for (; i + 16 <= n; i += 16) {
+            B::store(dst + i, Op::template vec<B>(B::load_u8x16(dst + i),
+                                                  B::load_u8x16(src + i)));
+        }
+        return i;
+    }
+    const typename B::u8x16 v = B::splat_u8(value);
+    for (; i + 16 <= n; i += 16) {
+        B::store(dst + i, Op::template vec<B>(B::load_u8x16(dst + i), v));
+    }
+    return i;
+}
+
+template <typename Op>
+void math8_bulk_run(u8 *dst, const u8 *src, fl::size n, u8 value) {
+    const simd::Isa isa = simd::activeIsa();
+    fl::size i = 0;
+#if FL_SIMD_HAS_SSE2
+    if (isa == simd::Isa::kAvx2 || isa == simd::Isa::kSse2) {
+        i = math8_bulk_kernel<Op, simd::Sse2>(dst, src, n, value);
+    }
+#endif
+#if FL_SIMD_HAS_NEON
+    if (isa == simd::Isa::kNeon) {
+        i = math8_bulk_kernel<Op, simd::Neon>(dst, src, n, value);
+    }
+#endif
+#if FL_SIMD_HAS_WASM
+    if (isa == simd::Isa::kWasm) {
+        i = math8_bulk_kernel<Op, simd::Wasm>(dst, src, n, value);
+    }
+#endif
+    (void)isa;
+    if (src) {
+        for (; i < n; ++i) {
+            dst[i] = Op::one(dst[i], src[i]);
+        }
+    } else {
+        for (; i < n; ++i) {
+            dst[i] = Op::one(dst[i], value);
+        }
+    }
+}
+
+} // namespace
+
+void qadd8_bulk(u8 *dst, const u8 *src, fl::size n) {
+    math8_bulk_run<Math8BulkQadd>(dst, src, n, 0);
+}
+
+void qadd8_bulk(u8 *dst, fl::size n, u8 value) {
+    math8_bulk_run<Math8BulkQadd>(dst, nullptr, n, value);
+}
+
+void qsub8_bulk(u8 *dst, const u8 *src, fl::size n) {
+    math8_bulk_run<Math8BulkQsub>(dst, src, n, 0);
+}
+
+void qsub8_bulk(u8 *dst, fl::size n, u8 value) {
+    math8_bulk_run<Math8BulkQsub>(dst, nullptr, n, value);
+}
+
+void max8_bulk(u8 *dst, const u8 *src, fl::size n) {
+    math8_bulk_run<Math8BulkMax>(dst, src, n, 0);
+}
+
+void max8_bulk(u8 *dst, fl::size n, u8 value) {
+    math8_bulk_run<Math8BulkMax>(dst, nullptr, n, value);
+}
+
+void min8_bulk(u8 *dst, const u8 *src, fl::size n) {
+    math8_bulk_run<Math8BulkMin>(dst, src, n, 0);
+}
+
+void min8_bulk(u8 *dst, fl::size n, u8 value) {
+    math8_bulk_run<Math8BulkMin>(dst, nullptr, n, value);
+}
+
+} // namespace fl
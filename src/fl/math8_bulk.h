@@ -0,0 +1,38 @@
+#pragma once
+
+/// @file math8_bulk.h
+/// Bulk saturating add/subtract and per byte max/min over flat byte arrays.
+/// These are the kernels behind the CRGBSet operators +=, -=, |= and &=, and
+/// addToRGB() / subFromRGB(): a CRGB array is 3 * n bytes and every one of
+/// those operators works per channel, so the channels need no special care.
+///
+/// The results are bit exact with qadd8(), qsub8() and the CRGB |= and &=
+/// operators. Hosted and ARM builds process 16 bytes per step with SSE2, NEON
+/// or WASM SIMD, other targets take the scalar loop.
+
+#include "fl/int.h"
+#include "fl/namespace.h"
+
+namespace fl {
+
+/// dst[i] = qadd8(dst[i], src[i])
+void qadd8_bulk(fl::u8 *dst, const fl::u8 *src, fl::size n);
+/// dst[i] = qadd8(dst[i], value)
+void qadd8_bulk(fl::u8 *dst, fl::size n, fl::u8 value);
+
+/// dst[i] = qsub8(dst[i], src[i])
+void qsub8_bulk(fl::u8 *dst, const fl::u8 *src, fl::size n);
+/// dst[i] = qsub8(dst[i], value)
+void qsub8_bulk(fl::u8 *dst, fl::size n, fl::u8 value);
+
+/// dst[i] = max(dst[i], src[i])
+void max8_bulk(fl::u8 *dst, const fl::u8 *src, fl::size n);
+/// dst[i] = max(dst[i], value)
+void max8_bulk(fl::u8 *dst, fl::size n, fl::u8 value);
+
+/// dst[i] = min(dst[i], src[i])
+void min8_bulk(fl::u8 *dst, const fl::u8 *src, fl::size n);
+/// dst[i] = min(dst[i], value)
+void min8_bulk(fl::u8 *dst, fl::size n, fl::u8 value);
+
+} // namespace fl
@@ -0,0 +1,352 @@
+#include <stdlib.h>
+
+#include "fl/memory_budget.h"
+
+#include "FastLED.h"
+#include "fl/corkscrew.h"
+#include "fl/fft.h"
+#include "fl/json.h"
+#include "fl/mutex.h"
+#include "fl/thread_local.h"
+#include "third_party/cq_kernel/cq_kernel.h"
+
+namespace fl {
+
+namespace {
+
+const int kMemCategories = int(MemCategory::kCount);
+
+#if FASTLED_MEMORY_BUDGET
+
+// Size and category of every live allocation, keyed by pointer. Open
+// addressing with linear probing, grown at half full. Its own storage comes
+// from plain malloc so it never feeds back into fl::Malloc().
+class MemBudgetTable {
+  public:
+    struct Entry {
+        void *ptr;
+        u32 size;
+        u8 category;
+    };
+
+    bool insert(void *ptr, u32 size, u8 category) {
+        if ((mCount + 1) * 2 > mCapacity && !grow()) {
+            return false;
+        }
+        place(Entry{ptr, size, category});
+        ++mCount;
+        return true;
+    }
+
+    // Copies the entry for ptr out and removes it. False if not tracked,
+    // e.g. allocated before the table could grow.
+    bool remove(void *ptr, Entry *out) {
+        if (!mCapacity) {
+            return false;
+        }
+        fl::size i = slot(ptr);
+        while (mEntries[i].ptr != ptr) {
+            if (!mEntries[i].ptr) {
+                return false;
+            }
+            i = (i + 1) & (mCapacity - 1);
+        }
+        *out = mEntries[i];
+        // Backward shift, so lookups need no tombstones.
+        fl::size hole = i;
+        for (fl::size j = (i + 1) & (mCapacity - 1); mEntries[j].ptr;
+             j = (j + 1) & (mCapacity - 1)) {
+            const fl::size home = slot(mEntries[j].ptr);
+            const bool between = hole <= j ? (home > hole && home <= j)
+                                           : (home > hole || home <= j);
+            if (!between) {
+                mEntries[hole] = mEntries[j];
+                hole = j;
+            }
+        }
+        mEntries[hole].ptr = nullptr;
+        --mCount;
+        return true;
+    }
+
+  private:
+    fl::size slot(void *ptr) const {
+        uintptr_t h = reinterpret_cast<uintptr_t>(ptr) >> 4;
+        h ^= h >> 17;
+        h *= 0x9E3779B1u;
+        return fl::size(h ^ (h >> 15)) & (mCapacity - 1);
+    }
+
+    void place(const Entry &e) {
+        fl::size i = slot(e.ptr);
+        while (mEntries[i].ptr) {
+            i = (i + 1) & (mCapacity - 1);
+        }
+        mEntries[i] = e;
+    }
+
+    bool grow() {
+        const fl::size capacity = mCapacity ? mCapacity * 2 : 256;
+        Entry *entries =
+            static_cast<Entry *>(calloc(capacity, sizeof(Entry)));
+        if (!entries) {
+            return false;
+        }
+        Entry *old = mEntries;
+        const fl::size oldCapacity = mCapacity;
+        mEntries = entries;
+        mCapacity = capacity;
+        for (fl::size i = 0; i < oldCapacity; ++i) {
+            if (old[i].ptr) {
+                place(old[i]);
+            }
+        }
+        free(old);
+        return true;
+    }
+
+    Entry *mEntries = nullptr;
+    fl::size mCapacity = 0;
+    fl::size mCount = 0;
+};
+
+struct MemBudgetState {
+    fl::mutex mutex;
+    MemBudgetTable table;
+    MemUsage usage[kMemCategories];
+    MemUsage total;
+};
+
+// Never destroyed: frees keep arriving from static destructors.
+MemBudgetState &mem_budget_state() {
+    static MemBudgetState *state = new MemBudgetState();
+    return *state;
+}
+
+u8 &mem_budget_category() {
+    static fl::ThreadLocal<u8> *category = new fl::ThreadLocal<u8>();
+    return category->access();
+}
+
+void mem_budget_charge(MemUsage &usage, u32 size) {
+    usage.live += size;
+    usage.allocs++;
+    if (usage.live > usage.peak) {
+        usage.peak = usage.live;
+    }
+}
+
+#endif // FASTLED_MEMORY_BUDGET
+
+const char *const kMemCategoryNames[kMemCategories] = {
+    "other",     "leds",        "fx_layer", "frame", "xymap",
+    "corkscrew", "draw_buffer", "audio",    "json",
+};
+
+} // namespace
+
+const char *toString(MemCategory category) {
+    const int i = int(category);
+    return i < kMemCategories ? kMemCategoryNames[i] : "unknown";
+}
+
+#if FASTLED_MEMORY_BUDGET
+MemScope::MemScope(MemCategory category) : mPrevious(current()) {
+    mem_budget_category() = u8(category);
+}
+
+MemScope::~MemScope() { mem_budget_category() = u8(mPrevious); }
+
+MemCategory MemScope::current() {
+    return MemCategory(mem_budget_category());
+}
+#else
+MemScope::MemScope(MemCategory category) : mPrevious(category) {}
+
+MemScope::~MemScope() {}
+
+MemCategory MemScope::current() { return MemCategory::kOther; }
+#endif
+
+bool MemoryBudget::enabled() { return FASTLED_MEMORY_BUDGET != 0; }
+
+#if FASTLED_MEMORY_BUDGET
+void MemoryBudget::onAlloc(void *ptr, fl::size size) {
+    const u8 category = mem_budget_category();
+    MemBudgetState &state = mem_budget_state();
+    fl::lock_guard<fl::mutex> lock(state.mutex);
+    if (!state.table.insert(ptr, u32(size), category)) {
+        return;
+    }
+    mem_budget_charge(state.usage[category], u32(size));
+    mem_budget_charge(state.total, u32(size));
+}
+
+void MemoryBudget::onFree(void *ptr) {
+    MemBudgetState &state = mem_budget_state();
+    fl::lock_guard<fl::mutex> lock(state.mutex);
+    MemBudgetTable::Entry entry;
+    if (!state.table.remove(ptr, &entry)) {
+        return;
+    }
+    state.usage[entry.category].live -= entry.size;
+    state.total.live -= entry.size;
+}
+
+MemUsage MemoryBudget::usage(MemCategory category) {
+    MemBudgetState &state = mem_budget_state();
+    fl::lock_guard<fl::mutex> lock(state.mutex);
+    return state.usage[int(category)];
+}
+
+MemUsage MemoryBudget::total() {
+    MemBudgetState &state = mem_budget_state();
+    fl::lock_guard<fl::mutex> lock(state.mutex);
+    return state.total;
+}
+
+void MemoryBudget::resetPeaks() {
+    MemBudgetState &state = mem_budget_state();
+    fl::lock_guard<fl::mutex> lock(state.mutex);
+    for (int i = 0; i < kMemCategories; ++i) {
+        state.usage[i].peak = state.usage[i].live;
+    }
+    state.total.peak = state.total.live;
+}
+#else
+void MemoryBudget::onAlloc(void *ptr, fl::size size) {
+    (void)ptr;
+    (void)size;
+}
+
+void MemoryBudget::onFree(void *ptr) { (void)ptr; }
+
+MemUsage MemoryBudget::usage(MemCategory category) {
+    (void)category;
+    return MemUsage();
+}
+
+MemUsage MemoryBudget::total() { return MemUsage(); }
+
+void MemoryBudget::resetPeaks() {}
+#endif
+
+u32 MemoryBudget::controllerLedBytes() {
+    u32 bytes = 0;
+    for (CLEDController *c = CLEDController::head(); c; c = c->next()) {
+        if (c->leds()) {
+            bytes += u32(c->size()) * sizeof(CRGB);
+        }
+    }
+    return bytes;
+}
+
+fl::string MemoryBudget::toJsonString() {
+    fl::string out;
+#if FASTLED_ENABLE_JSON
+    FLArduinoJson::JsonDocument doc;
+    FLArduinoJson::JsonObject json = doc.to<FLArduinoJson::JsonObject>();
+    const MemUsage sum = total();
+    FLArduinoJson::JsonObject all = json["total"].to<FLArduinoJson::JsonObject>();
+    all["live"] = sum.live;
+    all["peak"] = sum.peak;
+    all["allocs"] = sum.allocs;
+    json["controller_leds"] = controllerLedBytes();
+    FLArduinoJson::JsonObject categories =
+        json["categories"].to<FLArduinoJson::JsonObject>();
+    for (int i = 0; i < kMemCategories; ++i) {
+        const MemUsage u = usage(MemCategory(i));
+        FLArduinoJson::JsonObject c =
+            categories[kMemCategoryNames[i]].to<FLArduinoJson::JsonObject>();
+        c["live"] = u.live;
+        c["peak"] = u.peak;
+        c["allocs"] = u.allocs;
+    }
+    serializeJson(doc, out);
+#else
+    out = "{}";
+#endif
+    return out;
+}
+
+MemoryPlan &MemoryPlan::leds(u32 numLeds) {
+    return add(MemCategory::kLeds, numLeds * sizeof(CRGB));
+}
+
+MemoryPlan &MemoryPlan::frameExchange(u32 numLeds) {
+    return add(MemCategory::kLeds, 3 * numLeds * sizeof(CRGB));
+}
+
+MemoryPlan &MemoryPlan::fxEngine(u32 numLeds) {
+    return add(MemCategory::kFxLayer, 2 * numLeds * sizeof(CRGB));
+}
+
+MemoryPlan &MemoryPlan::frames(u32 numLeds, u32 count) {
+    return add(MemCategory::kFrame, count * numLeds * sizeof(CRGB));
+}
+
+MemoryPlan &MemoryPlan::xyMap(u16 width, u16 height) {
+    // XYMapLUT keeps bytes when every index fits in one.
+    const u32 n = u32(width) * height;
+    return add(MemCategory::kXYMap, n <= 256 ? n : n * sizeof(u16));
+}
+
+MemoryPlan &MemoryPlan::corkscrew(const CorkscrewInput &input,
+                                  bool tileCache) {
+    u32 bytes =
+        u32(input.calculateWidth()) * input.calculateHeight() * sizeof(CRGB);
+    if (tileCache) {
+        bytes += u32(input.numLeds) * sizeof(Tile2x2_u8_wrap);
+    }
+    return add(MemCategory::kCorkscrew, bytes);
+}
+
+MemoryPlan &MemoryPlan::drawBuffer(u32 strips, u32 maxLedsPerStrip,
+                                   bool rgbw) {
+    return add(MemCategory::kDrawBuffer,
+               strips * maxLedsPerStrip * (rgbw ? 4 : 3));
+}
+
+MemoryPlan &MemoryPlan::fft(const FFT_Args &args) {
+    const u32 bands = u32(args.bands);
+    const u32 bins = u32(args.samples) / 2 + 1;
+    return add(MemCategory::kAudio, bands * bins * sizeof(sparse_arr_elem) +
+                                        (bands + 1) * sizeof(u32));
+}
+
+MemoryPlan &MemoryPlan::add(MemCategory category, u32 bytes) {
+    mBytes[int(category)] += bytes;
+    return *this;
+}
+
+u32 MemoryPlan::bytes(MemCategory category) const {
+    return mBytes[int(category)];
+}
+
+u32 MemoryPlan::total() const {
+    u32 sum = 0;
+    for (int i = 0; i < kMemCategories; ++i) {
+        sum += mBytes[i];
+    }
+    return sum;
+}
+
+fl::string MemoryPlan::toJsonString() const {
+    fl::string out;
+#if FASTLED_ENABLE_JSON
+    FLArduinoJson::JsonDocument doc;
+    FLArduinoJson::JsonObject json = doc.to<FLArduinoJson::JsonObject>();
+    json["total"] = total();
+    FLArduinoJson::JsonObject categories =
+        json["categories"].to<FLArduinoJson::JsonObject>();
+    for (int i = 0; i < kMemCategories; ++i) {
+        categories[kMemCategoryNames[i]] = mBytes[i];
+    }
+    serializeJson(doc, out);
+#else
+    out = "{}";
+#endif
+    return out;
+}
+
+} // namespace fl
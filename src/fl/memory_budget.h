@@ -0,0 +1,162 @@
+#pragma once
+
+/*
+Memory accounting for the FastLED object graph.
+
+Heap memory taken through fl::Malloc() / PSRamAllocate() (so fl::vector,
+fl::allocator, fl::allocator_psram and PSRamAllocator) is charged to a
+category. The category is whatever MemScope is innermost on the allocating
+thread, MemCategory::kOther outside of any. FastLED tags its own big buffers:
+
+    kLeds       - FrameExchange frame buffers.
+    kFxLayer    - FxEngine layer surfaces.
+    kFrame      - Frames: video / FrameInterpolator frames, Blend2d buffers.
+    kXYMap      - XYMap look up tables.
+    kCorkscrew  - Corkscrew pixel buffer and tile cache.
+    kDrawBuffer - RectangularDrawBuffer blocks.
+    kAudio      - FFT kernels.
+    kJson       - JSON UI updates.
+
+Each category keeps its live bytes, the peak of those and an allocation
+count, read back with MemoryBudget::usage() or as JSON with
+MemoryBudget::toJsonString():
+
+    fl::MemUsage frames = fl::MemoryBudget::usage(fl::MemCategory::kFrame);
+    FASTLED_WARN("frames " << frames.live << " bytes, peak " << frames.peak);
+
+Sketch code can tag its own allocations the same way:
+
+    fl::MemScope scope(fl::MemCategory::kFxLayer);
+    mBuffer.resize(n);
+
+Memory from plain malloc() / new is not seen: fl::string, ArduinoJson
+documents and kiss_fft configs, for example.
+
+A MemoryPlan estimates the footprint of a configuration before building it,
+from the same sizes the classes allocate:
+
+    fl::MemoryPlan plan;
+    plan.leds(300).fxEngine(300).xyMap(32, 32).corkscrew(CorkscrewInput(19, 288));
+    if (!plan.fits(ESP.getFreePsram())) { ... }
+
+Defines:
+    FASTLED_MEMORY_BUDGET - 1 to account live allocations. Default on for
+                            test and stub builds, where the malloc hooks are
+                            on too. Each allocation then costs a side table
+                            entry. MemoryPlan and the MemScope calls are
+                            always available, with accounting off usage()
+                            reads all zeros.
+*/
+
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/str.h"
+
+#ifndef FASTLED_MEMORY_BUDGET
+#if defined(FASTLED_TESTING) || defined(FASTLED_STUB_IMPL)
+#define FASTLED_MEMORY_BUDGET 1
+#else
+#define FASTLED_MEMORY_BUDGET 0
+#endif
+#endif
+
+namespace fl {
+
+struct CorkscrewInput;
+struct FFT_Args;
+
+enum class MemCategory : fl::u8 {
+    kOther = 0,
+    kLeds,
+    kFxLayer,
+    kFrame,
+    kXYMap,
+    kCorkscrew,
+    kDrawBuffer,
+    kAudio,
+    kJson,
+    kCount,
+};
+
+// "leds", "fx_layer", ... as used in the JSON report.
+const char *toString(MemCategory category);
+
+// Charges heap allocations made on this thread to `category` while alive.
+// Scopes nest, the innermost one wins.
+class MemScope {
+  public:
+    explicit MemScope(MemCategory category);
+    ~MemScope();
+    MemScope(const MemScope &) = delete;
+    MemScope &operator=(const MemScope &) = delete;
+
+    // Category new allocations on this thread go to.
+    static MemCategory current();
+
+  private:
+    MemCategory mPrevious;
+};
+
+struct MemUsage {
+    fl::u32 live = 0;   // Bytes allocated and not yet freed.
+    fl::u32 peak = 0;   // Highest live since start or resetPeaks().
+    fl::u32 allocs = 0; // Allocations made, freed or not.
+};
+
+class MemoryBudget {
+  public:
+    // False when built without FASTLED_MEMORY_BUDGET.
+    static bool enabled();
+
+    static MemUsage usage(MemCategory category);
+    // All categories together. The peak is the peak of the sum.
+    static MemUsage total();
+    // Peaks restart from the current live bytes.
+    static void resetPeaks();
+    // Bytes of CRGB data attached to the registered controllers. Usually
+    // static arrays rather than heap, so not part of total().
+    static fl::u32 controllerLedBytes();
+    // {"total": {...}, "controller_leds": n, "categories": {"frame": {...}}}
+    static fl::string toJsonString();
+
+    // Called by fl::Malloc() and friends.
+    static void onAlloc(void *ptr, fl::size size);
+    static void onFree(void *ptr);
+};
+
+// Estimated heap footprint of a configuration, per category. The numbers
+// follow what the classes allocate for those sizes; allocator overhead is
+// not included.
+class MemoryPlan {
+  public:
+    // CRGB arrays for `numLeds` leds, charged to kLeds.
+    MemoryPlan &leds(fl::u32 numLeds);
+    // FrameExchange slot: three frames of `numLeds`.
+    MemoryPlan &frameExchange(fl::u32 numLeds);
+    // FxEngine over `numLeds`: two layer surfaces.
+    MemoryPlan &fxEngine(fl::u32 numLeds);
+    // `count` Frames of `numLeds`, e.g. a video's FrameInterpolator buffer.
+    MemoryPlan &frames(fl::u32 numLeds, fl::u32 count);
+    // XYMap look up table for a width x height grid.
+    MemoryPlan &xyMap(fl::u16 width, fl::u16 height);
+    MemoryPlan &corkscrew(const CorkscrewInput &input, bool tileCache = true);
+    // RectangularDrawBuffer: every strip padded to the longest one.
+    MemoryPlan &drawBuffer(fl::u32 strips, fl::u32 maxLedsPerStrip,
+                           bool rgbw = false);
+    // FFT kernels. An upper bound: every band keeps at most samples / 2 + 1
+    // bins. Builds with the precomputed kernels allocate none for the
+    // default FFT_Args.
+    MemoryPlan &fft(const FFT_Args &args);
+    MemoryPlan &add(MemCategory category, fl::u32 bytes);
+
+    fl::u32 bytes(MemCategory category) const;
+    fl::u32 total() const;
+    bool fits(fl::u32 budgetBytes) const { return total() <= budgetBytes; }
+    // {"total": n, "categories": {"leds": n, ...}}
+    fl::string toJsonString() const;
+
+  private:
+    fl::u32 mBytes[int(MemCategory::kCount)] = {};
+};
+
+} // namespace fl
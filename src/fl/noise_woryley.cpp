@@ -6,6 +6,9 @@ namespace {
 constexpr i32 Q15_ONE = 32768; // 1.0 in Q15
 // constexpr i32 Q15_HALF = Q15_ONE / 2;
 
+// Largest feature point offset inside a cell, 255 * 128.
+constexpr i32 WORLEY_MAX_OFFSET = 32640;
+
 // Helper: multiply two Q15 numbers (result in Q15)
 // i32 q15_mul(i32 a, i32 b) {
 //     return (i32)(((int64_t)a * b) >> 15);
@@ -21,20 +24,74 @@ u16 hash(i32 x, i32 y) {
     return (u16)((n ^ (n >> 16)) & 0xFFFF);
 }
 
+// Moves an offset by time * velocity (Q8 cells per Q15 time) and reflects it
+// back into [0, WORLEY_MAX_OFFSET].
+i32 worley_drift(i32 offset, i32 velocity, i32 time) {
+    const i64 period = 2 * WORLEY_MAX_OFFSET;
+    i64 p = (i64(offset) + ((i64(time) * velocity) >> 8)) % period;
+    if (p < 0) {
+        p += period;
+    }
+    return i32(p <= WORLEY_MAX_OFFSET ? p : period - p);
+}
+
 // Get fractional feature point inside a grid cell
-void feature_point(i32 gx, i32 gy, i32 &fx, i32 &fy) {
+void feature_point(i32 gx, i32 gy, i32 time, i32 &fx, i32 &fy) {
     u16 h = hash(gx, gy);
     fx = (h & 0xFF) * 128; // scale to Q15 (0–32767)
     fy = ((h >> 8) & 0xFF) * 128;
+    if (time != 0) {
+        u16 v = hash(gx ^ 0x5bd1, gy ^ 0x2c1b);
+        fx = worley_drift(fx, i8(v & 0xFF), time);
+        fy = worley_drift(fy, i8(v >> 8), time);
+    }
+}
+
+// Absolute feature point coordinate, wraps like the sample coordinates do.
+i32 feature_coord(i32 g, i32 f) { return i32((u32(g) << 15) + u32(f)); }
+
+// Keeps the two smallest Manhattan distances.
+inline void worley_accumulate(i32 x, i32 y, i32 feature_x, i32 feature_y,
+                              i32 &f1, i32 &f2) {
+    i32 dist = q15_abs(i32(u32(x) - u32(feature_x))) +
+               q15_abs(i32(u32(y) - u32(feature_y)));
+    if (dist < f1) {
+        f2 = f1;
+        f1 = dist;
+    } else if (dist < f2) {
+        f2 = dist;
+    }
+}
+
+// Normalize: maximum F1 distance is just below 2 * Q15_ONE, F2 can be
+// larger and is clamped.
+inline i32 worley_result(i32 f1, i32 f2, WorleyMode mode) {
+    i32 d = f1;
+    if (mode == WORLEY_F2) {
+        d = f2;
+    } else if (mode == WORLEY_F2_MINUS_F1) {
+        d = f2 - f1;
+    }
+    d >>= 1; // (d << 15) / (2 * Q15_ONE) without the overflow.
+    return d < Q15_ONE ? d : Q15_ONE - 1;
 }
+
+inline void worley_store(i32 *out, i32 v) { *out = v; }
+inline void worley_store(u8 *out, i32 v) { *out = u8(v >> 7); }
+
 } // namespace
 
 // Compute 2D Worley noise at (x, y) in Q15
 i32 worley_noise_2d_q15(i32 x, i32 y) {
+    return worley_noise_2d_q15(x, y, WORLEY_F1, 0);
+}
+
+i32 worley_noise_2d_q15(i32 x, i32 y, WorleyMode mode, i32 time) {
     i32 cell_x = x >> 15;
     i32 cell_y = y >> 15;
 
-    i32 min_dist = INT32_MAX;
+    i32 f1 = INT32_MAX;
+    i32 f2 = INT32_MAX;
 
     // Check surrounding 9 cells
     for (int dy = -1; dy <= 1; ++dy) {
@@ -43,26 +100,83 @@ i32 worley_noise_2d_q15(i32 x, i32 y) {
             i32 gy = cell_y + dy;
 
             i32 fx, fy;
-            feature_point(gx, gy, fx, fy);
-
-            i32 feature_x = (gx << 15) + fx;
-            i32 feature_y = (gy << 15) + fy;
+            feature_point(gx, gy, time, fx, fy);
 
-            i32 dx_q15 = x - feature_x;
-            i32 dy_q15 = y - feature_y;
+            // Manhattan distance, cheaper than Euclidean.
+            worley_accumulate(x, y, feature_coord(gx, fx),
+                              feature_coord(gy, fy), f1, f2);
+        }
+    }
+    return worley_result(f1, f2, mode);
+}
 
-            // Approximate distance using Manhattan (faster) or Euclidean
-            // (costlier)
-            i32 dist =
-                q15_abs(dx_q15) + q15_abs(dy_q15); // Manhattan distance
+void WorleyField::cacheCellRows(i32 cell_y, i32 time) {
+    for (i32 row = 0; row < 3; ++row) {
+        const i32 gy = cell_y - 1 + row;
+        for (i32 col = 0; col < mCellCols; ++col) {
+            const i32 gx = mCellX0 + col;
+            i32 fx, fy;
+            feature_point(gx, gy, time, fx, fy);
+            mFeatureX[row * mCellCols + col] = feature_coord(gx, fx);
+            mFeatureY[row * mCellCols + col] = feature_coord(gy, fy);
+        }
+    }
+}
 
-            if (dist < min_dist)
-                min_dist = dist;
+template <typename Out>
+void WorleyField::fillImpl(const WorleyFieldParams &params, u16 width,
+                           u16 height, Out *out) {
+    if (width == 0 || height == 0) {
+        return;
+    }
+    // The samples of a row span the same cell columns in every row, so the
+    // cache only changes when a row crosses into the next cell row.
+    const i32 x_last = params.x + (width - 1) * params.step_x;
+    const i32 first_cell = (params.x < x_last ? params.x : x_last) >> 15;
+    const i32 last_cell = (params.x < x_last ? x_last : params.x) >> 15;
+    mCellX0 = first_cell - 1;
+    mCellCols = last_cell - first_cell + 3;
+    mFeatureX.resize(3 * mCellCols);
+    mFeatureY.resize(3 * mCellCols);
+    const i32 *feature_x = mFeatureX.data();
+    const i32 *feature_y = mFeatureY.data();
+
+    bool cached = false;
+    i32 cached_cell_y = 0;
+    for (u16 row = 0; row < height; ++row) {
+        const i32 y = params.y + row * params.step_y;
+        const i32 cell_y = y >> 15;
+        if (!cached || cell_y != cached_cell_y) {
+            cacheCellRows(cell_y, params.time);
+            cached = true;
+            cached_cell_y = cell_y;
+        }
+        i32 x = params.x;
+        for (u16 col = 0; col < width; ++col, x += params.step_x) {
+            // Index of the cell left of this sample's cell.
+            const i32 c = (x >> 15) - mCellX0 - 1;
+            i32 f1 = INT32_MAX;
+            i32 f2 = INT32_MAX;
+            for (i32 r = 0; r < 3; ++r) {
+                const i32 base = r * mCellCols + c;
+                for (i32 k = base; k < base + 3; ++k) {
+                    worley_accumulate(x, y, feature_x[k], feature_y[k], f1,
+                                      f2);
+                }
+            }
+            worley_store(out++, worley_result(f1, f2, params.mode));
         }
     }
+}
+
+void WorleyField::fill(const WorleyFieldParams &params, u16 width,
+                       u16 height, i32 *out) {
+    fillImpl(params, width, height, out);
+}
 
-    // Normalize: maximum possible distance is roughly 2*Q15_ONE
-    return (min_dist << 15) / (2 * Q15_ONE);
+void WorleyField::fill8(const WorleyFieldParams &params, u16 width,
+                        u16 height, u8 *out) {
+    fillImpl(params, width, height, out);
 }
 
 } // namespace fl
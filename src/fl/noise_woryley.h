@@ -2,10 +2,62 @@
 
 #include "fl/stdint.h"
 #include "fl/int.h"
+#include "fl/vector.h"
 
 namespace fl {
 
+// Which distance a Worley sample reports. F1 is the distance to the closest
+// feature point (round cells), F2 to the second closest and F2 - F1 is zero
+// on the cell borders (cracked / veined look).
+enum WorleyMode { WORLEY_F1, WORLEY_F2, WORLEY_F2_MINUS_F1 };
+
 // Compute 2D Worley noise at (x, y) in Q15
 i32 worley_noise_2d_q15(i32 x, i32 y);
 
+// Same with a distance mode and a time offset. Coordinates are Q15 with one
+// feature point per 1.0 cell. Time is Q15 as well, each feature point drifts
+// inside its cell by up to half a cell per 1.0 of time and bounces off the
+// cell border, so the field animates smoothly. Time 0 is the static field of
+// worley_noise_2d_q15(x, y).
+i32 worley_noise_2d_q15(i32 x, i32 y, WorleyMode mode, i32 time);
+
+struct WorleyFieldParams {
+    // Q15 coordinate of the first sample and the distance between samples.
+    i32 x = 0;
+    i32 y = 0;
+    i32 step_x = 32768 / 8;
+    i32 step_y = 32768 / 8;
+    WorleyMode mode = WORLEY_F1;
+    i32 time = 0;
+};
+
+// Fills a whole grid of Worley samples. The per point function looks up and
+// hashes the 3x3 neighbouring cells for every sample; the field hashes each
+// feature point once per cell row and reuses it for every sample that sees
+// it. Results match worley_noise_2d_q15(x, y, mode, time) exactly.
+//
+// Keep the object around between frames, the cache buffers are reused.
+class WorleyField {
+  public:
+    // out must hold width * height values, row major, Q15 in [0, 32767].
+    void fill(const WorleyFieldParams &params, u16 width, u16 height,
+              i32 *out);
+    // Same scaled down to 0-255, ready for a palette lookup.
+    void fill8(const WorleyFieldParams &params, u16 width, u16 height,
+               u8 *out);
+
+  private:
+    template <typename Out>
+    void fillImpl(const WorleyFieldParams &params, u16 width, u16 height,
+                  Out *out);
+    void cacheCellRows(i32 cell_y, i32 time);
+
+    // Absolute feature point coordinates of three cell rows, cell_y - 1 to
+    // cell_y + 1, for the cell columns mCellX0 to mCellX0 + mCellCols - 1.
+    fl::vector<i32> mFeatureX;
+    fl::vector<i32> mFeatureY;
+    i32 mCellX0 = 0;
+    i32 mCellCols = 0;
+};
+
 } // namespace fl
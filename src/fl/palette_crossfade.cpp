@@ -0,0 +1,94 @@
+#include "fl/palette_crossfade.h"
+
+#include "fl/fill.h"
+
+namespace fl {
+
+PaletteCrossfade::PaletteCrossfade() {
+    fill_solid(mCurrent.entries, 256, CRGB::Black);
+    mFrom = mCurrent;
+    mTo = mCurrent;
+}
+
+PaletteCrossfade::PaletteCrossfade(const CRGBPalette16 &initial) {
+    setPalette(initial);
+}
+
+PaletteCrossfade::PaletteCrossfade(const CRGBPalette256 &initial) {
+    setPalette(initial);
+}
+
+void PaletteCrossfade::setPalette(const CRGBPalette16 &palette) {
+    UpscalePalette(palette, mCurrent);
+    // Source and target too, so setAmount() without a fade stays put.
+    mFrom = mCurrent;
+    mTo = mCurrent;
+    mAmount = 256;
+    mFading = false;
+}
+
+void PaletteCrossfade::setPalette(const CRGBPalette256 &palette) {
+    mCurrent = palette;
+    // Source and target too, so setAmount() without a fade stays put.
+    mFrom = mCurrent;
+    mTo = mCurrent;
+    mAmount = 256;
+    mFading = false;
+}
+
+void PaletteCrossfade::fadeTo(const CRGBPalette16 &target, u32 duration_ms,
+                              u32 now_ms) {
+    UpscalePalette(target, mTo);
+    start(duration_ms, now_ms);
+}
+
+void PaletteCrossfade::fadeTo(const CRGBPalette256 &target, u32 duration_ms,
+                              u32 now_ms) {
+    mTo = target;
+    start(duration_ms, now_ms);
+}
+
+void PaletteCrossfade::start(u32 duration_ms, u32 now_ms) {
+    mFrom = mCurrent;
+    mStart = now_ms;
+    mDuration = duration_ms;
+    mAmount = 0;
+    mFading = true;
+}
+
+bool PaletteCrossfade::update(u32 now_ms) {
+    if (!mFading) {
+        return false;
+    }
+    const u32 elapsed = now_ms - mStart;
+    u16 amount = 256;
+    if (elapsed < mDuration) {
+        amount = u16((u64(elapsed) * 256) / mDuration);
+    }
+    if (amount != mAmount) {
+        mAmount = amount;
+        blend();
+    }
+    mFading = mAmount < 256;
+    return mFading;
+}
+
+void PaletteCrossfade::setAmount(u16 amount) {
+    mAmount = amount > 256 ? 256 : amount;
+    blend();
+}
+
+// (from * (256 - a) + to * a) >> 8 on every byte of the table. No branches
+// and no carried state, so the compilers vectorize it where they can.
+void PaletteCrossfade::blend() {
+    const u8 *from = &mFrom.entries[0].raw[0];
+    const u8 *to = &mTo.entries[0].raw[0];
+    u8 *out = &mCurrent.entries[0].raw[0];
+    const u16 a = mAmount;
+    const u16 inv = 256 - a;
+    for (u16 i = 0; i < 256 * 3; ++i) {
+        out[i] = u8((from[i] * inv + to[i] * a) >> 8);
+    }
+}
+
+} // namespace fl
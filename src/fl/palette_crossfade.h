@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+Time based crossfade between two palettes on expanded 256 entry tables.
+
+nblendPaletteTowardPalette() steps a CRGBPalette16 towards a target and every
+ColorFromPalette() call then re-interpolates between the 16 entries. Here the
+source and target are upscaled once, when the fade starts, and update() blends
+the two tables into a third in one straight byte loop per frame. Lookups are
+then a plain table read:
+
+    PaletteCrossfade fade(OceanColors_p);
+    fade.fadeTo(LavaColors_p, 2000, millis());
+    ...
+    fade.update(millis());
+    leds[i] = fade[index];                         // or
+    leds[i] = ColorFromPalette(fade.palette(), index);
+
+Costs 3 * 768 bytes of RAM against 2 * 48 for a pair of CRGBPalette16, so it
+is meant for targets with RAM to spare that draw many pixels per frame.
+*/
+
+#include "fl/colorutils.h"
+#include "fl/int.h"
+
+namespace fl {
+
+class PaletteCrossfade {
+  public:
+    PaletteCrossfade();
+    explicit PaletteCrossfade(const CRGBPalette16 &initial);
+    explicit PaletteCrossfade(const CRGBPalette256 &initial);
+    explicit PaletteCrossfade(const TProgmemRGBPalette16 &initial)
+        : PaletteCrossfade(CRGBPalette16(initial)) {}
+
+    // Jumps to the palette, cancels any running fade.
+    void setPalette(const CRGBPalette16 &palette);
+    void setPalette(const CRGBPalette256 &palette);
+    void setPalette(const TProgmemRGBPalette16 &palette) {
+        setPalette(CRGBPalette16(palette));
+    }
+
+    // Starts a fade from whatever is showing now, so retargeting in the middle
+    // of a fade does not jump. A duration of 0 switches on the next update().
+    void fadeTo(const CRGBPalette16 &target, u32 duration_ms, u32 now_ms);
+    void fadeTo(const CRGBPalette256 &target, u32 duration_ms, u32 now_ms);
+    void fadeTo(const TProgmemRGBPalette16 &target, u32 duration_ms,
+                u32 now_ms) {
+        fadeTo(CRGBPalette16(target), duration_ms, now_ms);
+    }
+
+    // Advances the fade to now_ms, reblends only when the mix changed.
+    // Returns true while the fade is still running.
+    bool update(u32 now_ms);
+
+    // Manual control, 0 shows the source and 256 the target.
+    void setAmount(u16 amount);
+    u16 amount() const { return mAmount; }
+    bool isFading() const { return mFading; }
+
+    const CRGBPalette256 &palette() const { return mCurrent; }
+    const CRGB &operator[](u8 index) const { return mCurrent.entries[index]; }
+
+  private:
+    void start(u32 duration_ms, u32 now_ms);
+    void blend();
+
+    CRGBPalette256 mFrom;
+    CRGBPalette256 mTo;
+    CRGBPalette256 mCurrent;
+    u32 mStart = 0;
+    u32 mDuration = 0;
+    u16 mAmount = 256;
+    bool mFading = false;
+};
+
+} // namespace fl
@@ -0,0 +1,495 @@
+#include <string.h>
+
+#include "fl/pixel_ingest.h"
+#include "fl/math_macros.h"
+#include "fl/warn.h"
+
+namespace fl {
+
+namespace {
+
+// DDP header flags.
+const fl::u8 kDdpVersionMask = 0xC0;
+const fl::u8 kDdpVersion1 = 0x40;
+const fl::u8 kDdpFlagTimecode = 0x10;
+const fl::u8 kDdpFlagReply = 0x04;
+const fl::u8 kDdpFlagQuery = 0x02;
+const fl::u8 kDdpFlagPush = 0x01;
+const fl::u8 kDdpTypeRgb8 = 0x0B;
+const fl::u8 kDdpIdDisplay = 0x01;
+const fl::u8 kDdpIdFirstControl = 246; // control, config, status, ...
+const fl::size kDdpHeaderSize = 10;
+const fl::size kDdpHeaderSizeTimecode = 14;
+
+// E1.31 layout (ANSI E1.31-2018).
+const fl::u8 kAcnPacketId[12] = {'A', 'S', 'C', '-', 'E', '1',
+                                 '.', '1', '7', 0,   0,   0};
+const fl::u32 kE131VectorRootData = 0x00000004;
+const fl::u32 kE131VectorRootExtended = 0x00000008;
+const fl::u32 kE131VectorFramingData = 0x00000002;
+const fl::u32 kE131VectorFramingSync = 0x00000001;
+const fl::u8 kE131VectorDmpSetProperty = 0x02;
+const fl::u8 kE131OptionPreview = 0x80;
+const fl::u8 kE131OptionTerminated = 0x40;
+const fl::size kE131DataHeaderSize = 126;
+const fl::size kE131SyncPacketSize = 49;
+
+// Art-Net layout (Art-Net 4).
+const fl::u8 kArtNetId[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+const fl::u16 kArtNetOpDmx = 0x5000;
+const fl::u16 kArtNetOpSync = 0x5200;
+const fl::u8 kArtNetProtocolVersion = 14;
+const fl::size kArtNetDmxHeaderSize = 18;
+const fl::size kArtNetSyncSize = 14;
+
+// Sequence numbers within this many steps behind the last one are stale.
+const fl::u8 kStaleWindow = 20;
+
+fl::u16 ingest_read_be16(const fl::u8 *p) { return (fl::u16(p[0]) << 8) | p[1]; }
+
+fl::u32 ingest_read_be32(const fl::u8 *p) {
+    return (fl::u32(p[0]) << 24) | (fl::u32(p[1]) << 16) |
+           (fl::u32(p[2]) << 8) | p[3];
+}
+
+void ingest_write_be16(fl::u8 *p, fl::u16 v) {
+    p[0] = fl::u8(v >> 8);
+    p[1] = fl::u8(v);
+}
+
+void ingest_write_be32(fl::u8 *p, fl::u32 v) {
+    p[0] = fl::u8(v >> 24);
+    p[1] = fl::u8(v >> 16);
+    p[2] = fl::u8(v >> 8);
+    p[3] = fl::u8(v);
+}
+
+// E1.31 flags & length field: high nibble 0x7, low 12 bits the pdu length.
+void ingest_write_flags_length(fl::u8 *p, fl::size pdu_length) {
+    ingest_write_be16(p, fl::u16(0x7000 | (pdu_length & 0x0FFF)));
+}
+
+} // namespace
+
+bool decodeDDP(const fl::u8 *buf, fl::size len, IngestPacket *out) {
+    if (!buf || len < kDdpHeaderSize) {
+        return false;
+    }
+    const fl::u8 flags = buf[0];
+    if ((flags & kDdpVersionMask) != kDdpVersion1) {
+        return false;
+    }
+    const fl::size header = (flags & kDdpFlagTimecode) ? kDdpHeaderSizeTimecode
+                                                       : kDdpHeaderSize;
+    if (len < header) {
+        return false;
+    }
+    const fl::u16 length = ingest_read_be16(buf + 8);
+    if (header + length > len) {
+        return false;
+    }
+    IngestPacket packet;
+    packet.protocol = IngestProtocol::kDDP;
+    packet.sequence = buf[1] & 0x0F;
+    packet.hasSequence = packet.sequence != 0;
+    packet.offset = ingest_read_be32(buf + 4);
+    const bool control = (flags & (kDdpFlagQuery | kDdpFlagReply)) ||
+                         buf[3] >= kDdpIdFirstControl;
+    if (!control) {
+        packet.data = buf + header;
+        packet.length = length;
+        packet.hasData = length > 0;
+        packet.sync = (flags & kDdpFlagPush) != 0;
+    }
+    *out = packet;
+    return true;
+}
+
+bool decodeE131(const fl::u8 *buf, fl::size len, IngestPacket *out) {
+    if (!buf || len < kE131SyncPacketSize) {
+        return false;
+    }
+    if (ingest_read_be16(buf) != 0x0010 ||
+        memcmp(buf + 4, kAcnPacketId, sizeof(kAcnPacketId)) != 0) {
+        return false;
+    }
+    const fl::u32 root_vector = ingest_read_be32(buf + 18);
+    const fl::u32 framing_vector = ingest_read_be32(buf + 40);
+    IngestPacket packet;
+    packet.protocol = IngestProtocol::kE131;
+    if (root_vector == kE131VectorRootExtended) {
+        if (framing_vector != kE131VectorFramingSync) {
+            // Universe discovery, nothing to do with pixels.
+            *out = packet;
+            return true;
+        }
+        packet.hasSequence = true;
+        packet.sequence = buf[44];
+        packet.syncAddress = ingest_read_be16(buf + 45);
+        packet.sync = true;
+        *out = packet;
+        return true;
+    }
+    if (root_vector != kE131VectorRootData ||
+        framing_vector != kE131VectorFramingData ||
+        len < kE131DataHeaderSize) {
+        return false;
+    }
+    if (buf[117] != kE131VectorDmpSetProperty) {
+        return false;
+    }
+    // Property value count includes the start code.
+    const fl::u16 count = ingest_read_be16(buf + 123);
+    if (count == 0 || kE131DataHeaderSize - 1 + count > len) {
+        return false;
+    }
+    packet.hasSequence = true;
+    packet.sequence = buf[111];
+    packet.syncAddress = ingest_read_be16(buf + 109);
+    packet.universe = ingest_read_be16(buf + 113);
+    const fl::u8 options = buf[112];
+    const fl::u8 start_code = buf[125];
+    const bool skip =
+        (options & (kE131OptionPreview | kE131OptionTerminated)) ||
+        start_code != 0;
+    if (!skip) {
+        packet.data = buf + kE131DataHeaderSize;
+        packet.length = count - 1;
+        packet.hasData = packet.length > 0;
+    }
+    *out = packet;
+    return true;
+}
+
+bool decodeArtNet(const fl::u8 *buf, fl::size len, IngestPacket *out) {
+    if (!buf || len < kArtNetSyncSize ||
+        memcmp(buf, kArtNetId, sizeof(kArtNetId)) != 0) {
+        return false;
+    }
+    // The opcode is the only little endian field of the protocol.
+    const fl::u16 opcode = fl::u16(buf[8]) | (fl::u16(buf[9]) << 8);
+    IngestPacket packet;
+    packet.protocol = IngestProtocol::kArtNet;
+    if (opcode == kArtNetOpSync) {
+        packet.sync = true;
+    } else if (opcode == kArtNetOpDmx) {
+        if (len < kArtNetDmxHeaderSize) {
+            return false;
+        }
+        const fl::u16 length = ingest_read_be16(buf + 16);
+        if (kArtNetDmxHeaderSize + length > len || length > 512) {
+            return false;
+        }
+        packet.sequence = buf[12];
+        packet.hasSequence = packet.sequence != 0; // 0 disables sequencing.
+        packet.universe = fl::u16(buf[14]) | (fl::u16(buf[15] & 0x7F) << 8);
+        packet.data = buf + kArtNetDmxHeaderSize;
+        packet.length = length;
+        packet.hasData = length > 0;
+    }
+    // Every other opcode (ArtPoll, ArtAddress...) is valid but ignored.
+    *out = packet;
+    return true;
+}
+
+bool decodeIngestPacket(const fl::u8 *buf, fl::size len, IngestPacket *out) {
+    if (!buf || len == 0) {
+        return false;
+    }
+    // Note that a DDP header with the push flag also starts with an 'A'.
+    if (len >= sizeof(kArtNetId) &&
+        memcmp(buf, kArtNetId, sizeof(kArtNetId)) == 0) {
+        return decodeArtNet(buf, len, out);
+    }
+    if (len >= 16 && ingest_read_be16(buf) == 0x0010) {
+        return decodeE131(buf, len, out);
+    }
+    return decodeDDP(buf, len, out);
+}
+
+fl::size encodeDDP(fl::u8 *out, fl::size cap, fl::u32 offset,
+                   const fl::u8 *data, fl::u16 len, fl::u8 sequence,
+                   bool push) {
+    const fl::size total = kDdpHeaderSize + len;
+    if (!out || cap < total) {
+        return 0;
+    }
+    out[0] = kDdpVersion1 | (push ? kDdpFlagPush : 0);
+    out[1] = sequence & 0x0F;
+    out[2] = kDdpTypeRgb8;
+    out[3] = kDdpIdDisplay;
+    ingest_write_be32(out + 4, offset);
+    ingest_write_be16(out + 8, len);
+    if (len) {
+        memcpy(out + kDdpHeaderSize, data, len);
+    }
+    return total;
+}
+
+fl::size encodeE131(fl::u8 *out, fl::size cap, fl::u16 universe,
+                    const fl::u8 *data, fl::u16 len, fl::u8 sequence,
+                    fl::u16 syncAddress) {
+    const fl::size total = kE131DataHeaderSize + len;
+    if (!out || cap < total || len > 512) {
+        return 0;
+    }
+    memset(out, 0, kE131DataHeaderSize);
+    // Root layer.
+    ingest_write_be16(out, 0x0010);
+    memcpy(out + 4, kAcnPacketId, sizeof(kAcnPacketId));
+    ingest_write_flags_length(out + 16, total - 16);
+    ingest_write_be32(out + 18, kE131VectorRootData);
+    memcpy(out + 22, "FastLED-ingest!!", 16); // CID
+    // Framing layer.
+    ingest_write_flags_length(out + 38, total - 38);
+    ingest_write_be32(out + 40, kE131VectorFramingData);
+    memcpy(out + 44, "FastLED", 7); // Source name, zero padded to 64.
+    out[108] = 100;                  // Default priority.
+    ingest_write_be16(out + 109, syncAddress);
+    out[111] = sequence;
+    out[112] = 0; // Options.
+    ingest_write_be16(out + 113, universe);
+    // DMP layer.
+    ingest_write_flags_length(out + 115, total - 115);
+    out[117] = kE131VectorDmpSetProperty;
+    out[118] = 0xA1; // Address & data type.
+    ingest_write_be16(out + 119, 0);
+    ingest_write_be16(out + 121, 1);
+    ingest_write_be16(out + 123, fl::u16(len + 1));
+    out[125] = 0; // Start code.
+    if (len) {
+        memcpy(out + kE131DataHeaderSize, data, len);
+    }
+    return total;
+}
+
+fl::size encodeE131Sync(fl::u8 *out, fl::size cap, fl::u16 syncAddress,
+                        fl::u8 sequence) {
+    if (!out || cap < kE131SyncPacketSize) {
+        return 0;
+    }
+    memset(out, 0, kE131SyncPacketSize);
+    ingest_write_be16(out, 0x0010);
+    memcpy(out + 4, kAcnPacketId, sizeof(kAcnPacketId));
+    ingest_write_flags_length(out + 16, kE131SyncPacketSize - 16);
+    ingest_write_be32(out + 18, kE131VectorRootExtended);
+    memcpy(out + 22, "FastLED-ingest!!", 16);
+    ingest_write_flags_length(out + 38, kE131SyncPacketSize - 38);
+    ingest_write_be32(out + 40, kE131VectorFramingSync);
+    out[44] = sequence;
+    ingest_write_be16(out + 45, syncAddress);
+    return kE131SyncPacketSize;
+}
+
+fl::size encodeArtNet(fl::u8 *out, fl::size cap, fl::u16 universe,
+                      const fl::u8 *data, fl::u16 len, fl::u8 sequence) {
+    // The spec requires an even length in the range 2..512.
+    const fl::u16 padded = len < 2 ? 2 : fl::u16((len + 1) & ~1u);
+    const fl::size total = kArtNetDmxHeaderSize + padded;
+    if (!out || cap < total || padded > 512) {
+        return 0;
+    }
+    memcpy(out, kArtNetId, sizeof(kArtNetId));
+    out[8] = fl::u8(kArtNetOpDmx & 0xFF);
+    out[9] = fl::u8(kArtNetOpDmx >> 8);
+    out[10] = 0;
+    out[11] = kArtNetProtocolVersion;
+    out[12] = sequence;
+    out[13] = 0; // Physical port.
+    out[14] = fl::u8(universe & 0xFF);
+    out[15] = fl::u8((universe >> 8) & 0x7F);
+    ingest_write_be16(out + 16, padded);
+    memset(out + kArtNetDmxHeaderSize, 0, padded);
+    if (len) {
+        memcpy(out + kArtNetDmxHeaderSize, data, len);
+    }
+    return total;
+}
+
+fl::size encodeArtSync(fl::u8 *out, fl::size cap) {
+    if (!out || cap < kArtNetSyncSize) {
+        return 0;
+    }
+    memcpy(out, kArtNetId, sizeof(kArtNetId));
+    out[8] = fl::u8(kArtNetOpSync & 0xFF);
+    out[9] = fl::u8(kArtNetOpSync >> 8);
+    out[10] = 0;
+    out[11] = kArtNetProtocolVersion;
+    out[12] = 0; // Aux1
+    out[13] = 0; // Aux2
+    return kArtNetSyncSize;
+}
+
+fl::u16 PixelIngest::mapLeds(fl::u16 firstUniverse, CRGB *leds,
+                             fl::size numLeds, fl::u16 channelsPerUniverse) {
+    if (!leds || channelsPerUniverse == 0) {
+        FASTLED_WARN("PixelIngest::mapLeds: invalid arguments");
+        return firstUniverse;
+    }
+    fl::u8 *bytes = reinterpret_cast<fl::u8 *>(leds);
+    fl::size remaining = numLeds * 3;
+    fl::u16 universe = firstUniverse;
+    while (remaining > 0) {
+        Segment segment;
+        segment.dst = bytes;
+        segment.length = fl::u16(MIN(remaining, fl::size(channelsPerUniverse)));
+        segment.universe = universe++;
+        segment.linearBase = mLinearSize;
+        mSegments.push_back(segment);
+        mLinearSize += segment.length;
+        bytes += segment.length;
+        remaining -= segment.length;
+    }
+    return universe;
+}
+
+void PixelIngest::clearMappings() {
+    mSegments.clear();
+    mLinearSize = 0;
+    mReceivedCount = 0;
+    mDdpSequence = 0;
+    mSyncSequence = Sequence();
+    mSyncMode = false;
+    mDirty = false;
+}
+
+bool PixelIngest::ingest(const fl::u8 *buf, fl::size len) {
+    IngestPacket packet;
+    if (!decodeIngestPacket(buf, len, &packet)) {
+        mStats.invalid++;
+        return false;
+    }
+    apply(packet);
+    return true;
+}
+
+bool PixelIngest::isStale(Sequence *last, fl::u8 sequence) {
+    if (last->seen) {
+        // Signed distance, see E1.31-2018 section 6.7.2.
+        const fl::i8 diff = fl::i8(fl::u8(sequence - last->value));
+        if (diff <= 0 && diff > -fl::i8(kStaleWindow)) {
+            return true;
+        }
+    }
+    last->value = sequence;
+    last->seen = true;
+    return false;
+}
+
+void PixelIngest::apply(const IngestPacket &packet) {
+    mStats.packets++;
+    if (packet.protocol == IngestProtocol::kDDP) {
+        if (packet.hasSequence && mDdpSequence != 0) {
+            // 4 bit counter: anything in the lower half behind is stale.
+            const fl::u8 diff = (packet.sequence - mDdpSequence) & 0x0F;
+            if (diff == 0 || diff > 8) {
+                mStats.dropped++;
+                return;
+            }
+        }
+        if (packet.hasSequence) {
+            mDdpSequence = packet.sequence;
+        }
+        if (packet.hasData) {
+            writeLinear(packet);
+        }
+        if (packet.sync) {
+            mSyncMode = true;
+            presentFrame();
+        }
+        return;
+    }
+
+    if (packet.hasData) {
+        writeUniverse(packet);
+        // Synchronized E1.31 data waits for the matching sync packet.
+        if (packet.syncAddress != 0) {
+            mSyncMode = true;
+        }
+    }
+    if (packet.sync) {
+        if (packet.protocol == IngestProtocol::kE131 &&
+            isStale(&mSyncSequence, packet.sequence)) {
+            mStats.dropped++;
+            return;
+        }
+        mSyncMode = true;
+        presentFrame();
+        return;
+    }
+    if (!mSyncMode && !mSegments.empty() &&
+        mReceivedCount >= mSegments.size()) {
+        presentFrame();
+    }
+}
+
+void PixelIngest::writeUniverse(const IngestPacket &packet) {
+    bool matched = false;
+    // More than one segment may listen to the same universe (mirroring).
+    for (fl::size i = 0; i < mSegments.size(); ++i) {
+        Segment &segment = mSegments[i];
+        if (segment.universe != packet.universe) {
+            continue;
+        }
+        matched = true;
+        if (packet.hasSequence &&
+            isStale(&segment.lastSequence, packet.sequence)) {
+            mStats.dropped++;
+            return;
+        }
+        const fl::u16 n = MIN(packet.length, segment.length);
+        memcpy(segment.dst, packet.data, n);
+        mStats.pixels += n / 3;
+        mDirty = true;
+        if (!segment.received) {
+            segment.received = true;
+            mReceivedCount++;
+        }
+    }
+    if (!matched) {
+        mStats.unmapped++;
+    }
+}
+
+void PixelIngest::writeLinear(const IngestPacket &packet) {
+    const fl::u32 begin = packet.offset;
+    const fl::u32 end = begin + packet.length;
+    if (begin >= mLinearSize) {
+        mStats.unmapped++;
+        return;
+    }
+    for (fl::size i = 0; i < mSegments.size(); ++i) {
+        Segment &segment = mSegments[i];
+        const fl::u32 seg_begin = segment.linearBase;
+        const fl::u32 seg_end = seg_begin + segment.length;
+        if (seg_end <= begin) {
+            continue;
+        }
+        if (seg_begin >= end) {
+            break; // Segments are ordered by linear base.
+        }
+        const fl::u32 from = MAX(begin, seg_begin);
+        const fl::u32 to = MIN(end, seg_end);
+        memcpy(segment.dst + (from - seg_begin), packet.data + (from - begin),
+               to - from);
+        mStats.pixels += (to - from) / 3;
+        mDirty = true;
+    }
+}
+
+void PixelIngest::presentFrame() {
+    for (fl::size i = 0; i < mSegments.size(); ++i) {
+        mSegments[i].received = false;
+    }
+    mReceivedCount = 0;
+    if (!mDirty) {
+        return;
+    }
+    mDirty = false;
+    mStats.frames++;
+    if (mOnFrame) {
+        mOnFrame();
+    }
+}
+
+} // namespace fl
@@ -0,0 +1,154 @@
+#pragma once
+
+/*
+Protocol agnostic pixel ingest for network style lighting protocols.
+
+Decodes DDP, E1.31 (sACN) and Art-Net packets from raw byte buffers (usually
+the payload of a UDP datagram) and writes the channel data straight into the
+CRGB buffers that are owned by the CLEDControllers. There is no intermediate
+frame: the only copy is packet -> led buffer.
+
+Addressing:
+  * E1.31 and Art-Net address a universe, each channel maps to one byte of
+    the CRGB array that was mapped to that universe.
+  * DDP addresses a byte offset into one linear space. The linear space is the
+    concatenation of all mapped segments in the order they were mapped.
+
+Example:
+    CRGB leds[NUM_LEDS];
+    fl::PixelIngest ingest;
+    ingest.mapLeds(1, leds, NUM_LEDS);  // universes 1..N, 170 pixels each.
+    ingest.onFrame([]() { FastLED.show(); });
+    ...
+    // For each udp datagram received:
+    ingest.ingest(datagram, datagram_len);
+*/
+
+#include "fl/stdint.h"
+#include "fl/int.h"
+#include "fl/function.h"
+#include "fl/namespace.h"
+#include "fl/vector.h"
+
+#include "crgb.h"
+
+namespace fl {
+
+enum class IngestProtocol : fl::u8 { kUnknown = 0, kDDP, kE131, kArtNet };
+
+// Default udp ports of the supported protocols.
+enum IngestPort : fl::u16 {
+    kDdpPort = 4048,
+    kE131Port = 5568,
+    kArtNetPort = 6454,
+};
+
+// The decoded view of a packet. The data pointer points into the packet
+// buffer that was decoded, so it is only valid as long as that buffer is.
+struct IngestPacket {
+    IngestProtocol protocol = IngestProtocol::kUnknown;
+    bool hasData = false;  // Packet carries channel data.
+    bool sync = false;     // Packet asks for the frame to be presented.
+    bool hasSequence = false;
+    fl::u8 sequence = 0;
+    fl::u16 universe = 0;     // E1.31 / Art-Net only.
+    fl::u16 syncAddress = 0;  // E1.31 only, 0 means "not synchronized".
+    fl::u32 offset = 0;       // DDP byte offset into the linear space.
+    const fl::u8 *data = nullptr;
+    fl::u16 length = 0;
+};
+
+// Packet decoders. Return false if the buffer is not a valid packet of the
+// given protocol. Packets that are valid but not relevant for pixel data
+// (ArtPoll, DDP queries, ...) decode with hasData == false and sync == false.
+bool decodeDDP(const fl::u8 *buf, fl::size len, IngestPacket *out);
+bool decodeE131(const fl::u8 *buf, fl::size len, IngestPacket *out);
+bool decodeArtNet(const fl::u8 *buf, fl::size len, IngestPacket *out);
+// Detects the protocol from the packet header.
+bool decodeIngestPacket(const fl::u8 *buf, fl::size len, IngestPacket *out);
+
+// Packet encoders, used by senders and by the tests as packet fixtures.
+// Return the number of bytes written to out, or 0 if cap is too small.
+fl::size encodeDDP(fl::u8 *out, fl::size cap, fl::u32 offset,
+                   const fl::u8 *data, fl::u16 len, fl::u8 sequence,
+                   bool push);
+fl::size encodeE131(fl::u8 *out, fl::size cap, fl::u16 universe,
+                    const fl::u8 *data, fl::u16 len, fl::u8 sequence,
+                    fl::u16 syncAddress = 0);
+fl::size encodeE131Sync(fl::u8 *out, fl::size cap, fl::u16 syncAddress,
+                        fl::u8 sequence);
+fl::size encodeArtNet(fl::u8 *out, fl::size cap, fl::u16 universe,
+                      const fl::u8 *data, fl::u16 len, fl::u8 sequence);
+fl::size encodeArtSync(fl::u8 *out, fl::size cap);
+
+class PixelIngest {
+  public:
+    // 170 rgb pixels per universe, the usual convention for all consoles.
+    static const fl::u16 kDefaultChannelsPerUniverse = 510;
+
+    struct Stats {
+        fl::u32 packets = 0;   // Valid packets that were processed.
+        fl::u32 pixels = 0;    // Pixels written into led buffers.
+        fl::u32 frames = 0;    // Frames presented via onFrame.
+        fl::u32 dropped = 0;   // Stale or duplicate sequence numbers.
+        fl::u32 invalid = 0;   // Buffers that failed to decode.
+        fl::u32 unmapped = 0;  // Data for universes/offsets with no target.
+    };
+
+    PixelIngest() = default;
+
+    // Maps numLeds pixels onto consecutive universes starting at
+    // firstUniverse. Returns the universe after the last one that was used.
+    fl::u16 mapLeds(fl::u16 firstUniverse, CRGB *leds, fl::size numLeds,
+                    fl::u16 channelsPerUniverse = kDefaultChannelsPerUniverse);
+    void clearMappings();
+
+    // Decodes the packet and applies it. Returns false if the buffer was not a
+    // valid packet of any supported protocol.
+    bool ingest(const fl::u8 *buf, fl::size len);
+    // Applies an already decoded packet.
+    void apply(const IngestPacket &packet);
+
+    // Invoked whenever a complete frame has been written into the buffers.
+    // Without sync packets a frame is complete once every mapped universe has
+    // been received. Once a sync packet (ArtSync, E1.31 sync, DDP push) is
+    // seen, frames are only presented by sync packets.
+    void onFrame(fl::function<void()> callback) { mOnFrame = callback; }
+
+    bool syncMode() const { return mSyncMode; }
+    const Stats &stats() const { return mStats; }
+    void resetStats() { mStats = Stats(); }
+    fl::size numSegments() const { return mSegments.size(); }
+
+  private:
+    struct Sequence {
+        fl::u8 value = 0;
+        bool seen = false;
+    };
+
+    struct Segment {
+        fl::u8 *dst = nullptr;
+        fl::u32 linearBase = 0;  // Byte offset in the DDP linear space.
+        fl::u16 length = 0;      // Bytes.
+        fl::u16 universe = 0;
+        Sequence lastSequence;
+        bool received = false;
+    };
+
+    bool isStale(Sequence *last, fl::u8 sequence);
+    void writeUniverse(const IngestPacket &packet);
+    void writeLinear(const IngestPacket &packet);
+    void presentFrame();
+
+    fl::vector<Segment> mSegments;
+    fl::u32 mLinearSize = 0;
+    fl::u32 mReceivedCount = 0;
+    fl::u8 mDdpSequence = 0;
+    Sequence mSyncSequence;
+    bool mSyncMode = false;
+    bool mDirty = false;
+    Stats mStats;
+    fl::function<void()> mOnFrame;
+};
+
+} // namespace fl
@@ -0,0 +1,229 @@
+#pragma once
+
+/*
+Fused per pixel effect pipeline.
+
+Calling fill_noise16(), nblend(), fadeToBlackBy() and napplyGamma_video() in
+a row walks the LED buffer four times. A pipeline collects the per pixel
+stages into one type at compile time and runs them in a single loop, each
+pixel goes through the whole chain while it is in registers:
+
+    fl::pipe(leds, NUM_LEDS)
+        .noise16(1, x, 60, 1, hue_x, 30, now)
+        .blend(overlay, 128)
+        .fade(20)
+        .gamma(2.2f)
+        .blur1d(64)             // pass boundary, runs the stages above first
+        .fade(4)
+        .run();
+
+Stages that need neighbouring pixels (blur, XY remaps, anything through
+pass()) are pass boundaries: the fused loop so far runs, then the stage runs
+over the whole buffer and a fresh pipeline continues on the result. Nothing
+runs until run() or a boundary, so a pipeline that is built and dropped
+leaves the buffer untouched.
+
+Every stage gives the same bytes as the function it replaces. Custom stages
+go through map() with a callable taking (CRGB &pixel, fl::size index).
+*/
+
+#include "crgb.h"
+#include "fl/blur.h"
+#include "fl/colorutils.h"
+#include "fl/int.h"
+#include "fl/shared_ptr.h"
+#include "fl/xymap.h"
+#include "noise.h"
+
+namespace fl {
+
+// Stages. Each one has apply(CRGB &pixel, fl::size index).
+
+struct PipeIdentity {
+    void apply(CRGB &, fl::size) const {}
+};
+
+template <typename Stage> struct PipeIsEmpty {
+    enum { value = 0 };
+};
+template <> struct PipeIsEmpty<PipeIdentity> {
+    enum { value = 1 };
+};
+
+template <typename First, typename Second> struct PipeChain {
+    First first;
+    Second second;
+    void apply(CRGB &c, fl::size i) const {
+        first.apply(c, i);
+        second.apply(c, i);
+    }
+};
+
+// Same as nscale8() on the buffer.
+struct PipeScale {
+    u8 scale;
+    void apply(CRGB &c, fl::size) const { c.nscale8(scale); }
+};
+
+// Same as nblend(leds, overlay, n, amount).
+struct PipeBlend {
+    const CRGB *overlay;
+    fract8 amount;
+    void apply(CRGB &c, fl::size i) const { nblend(c, overlay[i], amount); }
+};
+
+// Same as napplyGamma_video(), with the pow() calls moved into a table that
+// is built once per pipeline instead of three times per pixel. The table is
+// shared, every then() copies the chain and would copy it otherwise.
+struct PipeGamma {
+    struct Table {
+        u8 values[256];
+    };
+    fl::shared_ptr<Table> table;
+
+    explicit PipeGamma(float gamma) : table(fl::make_shared<Table>()) {
+        for (int v = 0; v < 256; ++v) {
+            table->values[v] = applyGamma_video(u8(v), gamma);
+        }
+    }
+    void apply(CRGB &c, fl::size) const {
+        const u8 *values = table->values;
+        c.r = values[c.r];
+        c.g = values[c.g];
+        c.b = values[c.b];
+    }
+};
+
+// Same as fill_noise16(), computed per pixel. Like fill_noise16() the noise
+// field starts over every 255 leds.
+struct PipeNoise16 {
+    u8 octaves;
+    u16 x;
+    int scale;
+    u8 hue_octaves;
+    u16 hue_x;
+    int hue_scale;
+    u16 time;
+    u8 hue_shift;
+
+    void apply(CRGB &c, fl::size i) const {
+        const u32 k = u32(i % 255);
+        u8 v = 0;
+        for (u8 o = 0; o < octaves; ++o) {
+            const u32 xx = (u32(x) << o) + k * (u32(scale) << o);
+            u32 accum = u32(inoise16(xx, time)) >> o;
+            accum += u32(v) << 8;
+            if (accum > 65535) {
+                accum = 65535;
+            }
+            v = u8(accum >> 8);
+        }
+        u8 h = 0;
+        for (u8 o = 0; o < hue_octaves; ++o) {
+            const u32 xx = (u32(hue_x) << o) + k * (u32(hue_scale) << o);
+            h = qadd8(h, inoise8(u16(xx), time) >> o);
+        }
+        c = CHSV(u8(h + hue_shift), 255, v);
+    }
+};
+
+// Wraps a callable taking (CRGB &, fl::size).
+template <typename Fn> struct PipeMap {
+    Fn fn;
+    void apply(CRGB &c, fl::size i) const { fn(c, i); }
+};
+
+template <typename Stages> class PixelPipe {
+  public:
+    template <typename Next>
+    using Then = PixelPipe<PipeChain<Stages, Next>>;
+
+    PixelPipe(CRGB *leds, fl::size n, const Stages &stages)
+        : mLeds(leds), mSize(n), mStages(stages) {}
+
+    CRGB *leds() const { return mLeds; }
+    fl::size size() const { return mSize; }
+
+    // Appends any stage type with a matching apply().
+    template <typename Next> Then<Next> then(const Next &next) const {
+        PipeChain<Stages, Next> chain = {mStages, next};
+        return Then<Next>(mLeds, mSize, chain);
+    }
+
+    Then<PipeScale> nscale8(u8 scale) const {
+        PipeScale stage = {scale};
+        return then(stage);
+    }
+    Then<PipeScale> fade(u8 fadeBy) const { return nscale8(255 - fadeBy); }
+
+    Then<PipeBlend> blend(const CRGB *overlay, fract8 amountOfOverlay) const {
+        PipeBlend stage = {overlay, amountOfOverlay};
+        return then(stage);
+    }
+
+    Then<PipeGamma> gamma(float gamma) const { return then(PipeGamma(gamma)); }
+
+    Then<PipeNoise16> noise16(u8 octaves, u16 x, int scale, u8 hue_octaves,
+                              u16 hue_x, int hue_scale, u16 time,
+                              u8 hue_shift = 0) const {
+        PipeNoise16 stage = {octaves, x,         scale, hue_octaves,
+                             hue_x,   hue_scale, time,  hue_shift};
+        return then(stage);
+    }
+
+    template <typename Fn> Then<PipeMap<Fn>> map(Fn fn) const {
+        PipeMap<Fn> stage = {fn};
+        return then(stage);
+    }
+
+    // Runs the fused stages, one pass over the buffer. An empty pipeline
+    // does not touch it.
+    void run() const {
+        if (PipeIsEmpty<Stages>::value) {
+            return;
+        }
+        for (fl::size i = 0; i < mSize; ++i) {
+            CRGB c = mLeds[i];
+            mStages.apply(c, i);
+            mLeds[i] = c;
+        }
+    }
+
+    // Pass boundaries.
+
+    // Runs the pipeline so far, then fn(leds, n).
+    template <typename Fn> PixelPipe<PipeIdentity> pass(Fn fn) const {
+        run();
+        fn(mLeds, mSize);
+        return PixelPipe<PipeIdentity>(mLeds, mSize, PipeIdentity());
+    }
+
+    PixelPipe<PipeIdentity> blur1d(fract8 blur_amount) const {
+        run();
+        fl::blur1d(mLeds, u16(mSize), blur_amount);
+        return PixelPipe<PipeIdentity>(mLeds, mSize, PipeIdentity());
+    }
+
+    PixelPipe<PipeIdentity> blur2d(u8 width, u8 height, fract8 blur_amount,
+                                   const XYMap &xymap) const {
+        run();
+        fl::blur2d(mLeds, width, height, blur_amount, xymap);
+        return PixelPipe<PipeIdentity>(mLeds, mSize, PipeIdentity());
+    }
+
+  private:
+    CRGB *mLeds;
+    fl::size mSize;
+    Stages mStages;
+};
+
+// Starts an empty pipeline over n leds.
+inline PixelPipe<PipeIdentity> pipe(CRGB *leds, fl::size n) {
+    return PixelPipe<PipeIdentity>(leds, n, PipeIdentity());
+}
+
+template <fl::size N> PixelPipe<PipeIdentity> pipe(CRGB (&leds)[N]) {
+    return pipe(leds, N);
+}
+
+} // namespace fl
@@ -0,0 +1,157 @@
+#include "fl/planar_rgb.h"
+
+#include "FastLED.h"
+#include "fl/colorutils.h"
+#include "fl/scale8_bulk.h"
+#include "lib8tion/math8.h"
+#include "lib8tion/scale8.h"
+#include "pixel_controller_core.h"
+
+namespace fl {
+
+void PlanarRGB::resize(fl::size n) {
+    if (n == mSize) {
+        return;
+    }
+    fl::vector<u8> next;
+    next.resize(n * 3, 0);
+    const fl::size keep = n < mSize ? n : mSize;
+    for (u8 c = 0; c < 3; ++c) {
+        const u8 *from = mData.data() + c * mSize;
+        u8 *to = next.data() + c * n;
+        for (fl::size i = 0; i < keep; ++i) {
+            to[i] = from[i];
+        }
+    }
+    mData.swap(next);
+    mSize = n;
+}
+
+void PlanarRGB::fromInterleaved(const CRGB *pixels, fl::size n) {
+    if (n != mSize) {
+        mData.resize(n * 3);
+        mSize = n;
+    }
+    u8 *pr = r();
+    u8 *pg = g();
+    u8 *pb = b();
+    for (fl::size i = 0; i < n; ++i) {
+        pr[i] = pixels[i].r;
+        pg[i] = pixels[i].g;
+        pb[i] = pixels[i].b;
+    }
+}
+
+void PlanarRGB::toInterleaved(CRGB *pixels) const {
+    const u8 *pr = r();
+    const u8 *pg = g();
+    const u8 *pb = b();
+    for (fl::size i = 0; i < mSize; ++i) {
+        pixels[i].r = pr[i];
+        pixels[i].g = pg[i];
+        pixels[i].b = pb[i];
+    }
+}
+
+void PlanarRGB::writeOrdered(const PixelOrder &order, const CRGB &scale,
+                             u8 *out) const {
+    const u8 *p0 = plane(order.slot[0]);
+    const u8 *p1 = plane(order.slot[1]);
+    const u8 *p2 = plane(order.slot[2]);
+    const u8 s0 = scale.raw[order.slot[0]];
+    const u8 s1 = scale.raw[order.slot[1]];
+    const u8 s2 = scale.raw[order.slot[2]];
+    for (fl::size i = 0; i < mSize; ++i) {
+        out[0] = scale8(p0[i], s0);
+        out[1] = scale8(p1[i], s1);
+        out[2] = scale8(p2[i], s2);
+        out += 3;
+    }
+}
+
+namespace planar {
+
+void fill_solid(PlanarRGB &planes, const CRGB &color) {
+    const fl::size n = planes.size();
+    for (u8 c = 0; c < 3; ++c) {
+        u8 *p = planes.plane(c);
+        const u8 v = color.raw[c];
+        for (fl::size i = 0; i < n; ++i) {
+            p[i] = v;
+        }
+    }
+}
+
+void nscale8(PlanarRGB &planes, u8 scale) {
+    scale8_bulk(planes.data(), planes.size() * 3, scale);
+}
+
+void nscale8(PlanarRGB &planes, const CRGB &scale) {
+    // One contiguous run per channel, no per pixel scale lookup.
+    for (u8 c = 0; c < 3; ++c) {
+        scale8_bulk(planes.plane(c), planes.size(), scale.raw[c]);
+    }
+}
+
+void fadeToBlackBy(PlanarRGB &planes, u8 fadeBy) {
+    nscale8(planes, u8(255 - fadeBy));
+}
+
+void nblend(PlanarRGB &dst, const PlanarRGB &src, fract8 amountOfSrc) {
+    const fl::size n = dst.size() < src.size() ? dst.size() : src.size();
+    if (amountOfSrc == 0) {
+        return;
+    }
+    for (u8 c = 0; c < 3; ++c) {
+        u8 *d = dst.plane(c);
+        const u8 *s = src.plane(c);
+        if (amountOfSrc == 255) {
+            for (fl::size i = 0; i < n; ++i) {
+                d[i] = s[i];
+            }
+            continue;
+        }
+        for (fl::size i = 0; i < n; ++i) {
+            d[i] = blend8(d[i], s[i], amountOfSrc);
+        }
+    }
+}
+
+void blur1d(PlanarRGB &planes, fract8 blur_amount) {
+    const u8 keep = 255 - blur_amount;
+    const u8 seep = blur_amount >> 1;
+    const fl::size n = planes.size();
+    for (u8 c = 0; c < 3; ++c) {
+        u8 *p = planes.plane(c);
+        u8 carryover = 0;
+        for (fl::size i = 0; i < n; ++i) {
+            const u8 part = scale8(p[i], seep);
+            const u8 cur = qadd8(scale8(p[i], keep), carryover);
+            if (i) {
+                p[i - 1] = qadd8(p[i - 1], part);
+            }
+            p[i] = cur;
+            carryover = part;
+        }
+    }
+}
+
+void map_palette(PlanarRGB &planes, const u8 *indices, fl::size n,
+                 const CRGBPalette256 &palette) {
+    if (n > planes.size()) {
+        n = planes.size();
+    }
+    u8 *pr = planes.r();
+    u8 *pg = planes.g();
+    u8 *pb = planes.b();
+    for (fl::size i = 0; i < n; ++i) {
+        const CRGB &c = palette.entries[indices[i]];
+        pr[i] = c.r;
+        pg[i] = c.g;
+        pb[i] = c.b;
+    }
+}
+
+} // namespace planar
+
+} // namespace fl
@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+Planar (struct of arrays) RGB pixel buffer.
+
+A CRGB array interleaves r, g, b with a three byte stride, so a vector kernel
+has to shuffle channels apart and a pixel never lines up with a vector lane.
+PlanarRGB keeps all reds, then all greens, then all blues in one allocation,
+so every per channel kernel is a straight byte loop:
+
+    fl::PlanarRGB planes(NUM_LEDS);
+    planes.fromInterleaved(leds, NUM_LEDS);
+    fl::planar::fadeToBlackBy(planes, 20);
+    fl::planar::blur1d(planes, 64);
+    planes.toInterleaved(leds);         // or straight to wire order bytes
+    planes.writeOrdered(PixelOrder::of(GRB), scale, out);
+
+The kernels give the same bytes as their CRGB counterparts, so an effect can
+keep its pixels planar across several passes and convert once at the end.
+calculate_unscaled_power_mW() in power_mgt.h has a planar overload.
+*/
+
+#include "crgb.h"
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/vector.h"
+
+FASTLED_NAMESPACE_BEGIN
+struct PixelOrder;
+FASTLED_NAMESPACE_END
+
+namespace fl {
+
+class CRGBPalette256;
+
+class PlanarRGB {
+  public:
+    PlanarRGB() = default;
+    explicit PlanarRGB(fl::size n) { resize(n); }
+
+    fl::size size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    // New pixels are black, existing ones keep their value.
+    void resize(fl::size n);
+
+    u8 *r() { return mData.data(); }
+    u8 *g() { return mData.data() + mSize; }
+    u8 *b() { return mData.data() + 2 * mSize; }
+    const u8 *r() const { return mData.data(); }
+    const u8 *g() const { return mData.data() + mSize; }
+    const u8 *b() const { return mData.data() + 2 * mSize; }
+
+    // Channel 0, 1 or 2, the same indexing as CRGB::raw.
+    u8 *plane(u8 channel) { return mData.data() + channel * mSize; }
+    const u8 *plane(u8 channel) const {
+        return mData.data() + channel * mSize;
+    }
+
+    // All three planes back to back, size() * 3 bytes.
+    u8 *data() { return mData.data(); }
+    const u8 *data() const { return mData.data(); }
+
+    CRGB get(fl::size i) const { return CRGB(r()[i], g()[i], b()[i]); }
+    void set(fl::size i, const CRGB &c) {
+        r()[i] = c.r;
+        g()[i] = c.g;
+        b()[i] = c.b;
+    }
+
+    // Resizes to n and splits the pixels into planes.
+    void fromInterleaved(const CRGB *pixels, fl::size n);
+    // Writes size() pixels back as CRGB.
+    void toInterleaved(CRGB *pixels) const;
+
+    // Writes size() * 3 bytes in wire order, each channel scaled with scale8
+    // by its entry in scale. Reads the planes directly, the CRGB round trip
+    // is skipped. The controllers still encode from CRGB and don't call it.
+    void writeOrdered(const PixelOrder &order, const CRGB &scale,
+                      u8 *out) const;
+
+  private:
+    fl::vector<u8> mData;
+    fl::size mSize = 0;
+};
+
+namespace planar {
+
+void fill_solid(PlanarRGB &planes, const CRGB &color);
+
+// Same as nscale8() on a CRGB array.
+void nscale8(PlanarRGB &planes, u8 scale);
+// Same as nscale8() with a per channel scale.
+void nscale8(PlanarRGB &planes, const CRGB &scale);
+// Same as fadeToBlackBy() on a CRGB array.
+void fadeToBlackBy(PlanarRGB &planes, u8 fadeBy);
+
+// Same as nblend(CRGB*, const CRGB*, n, amount), over the smaller size.
+void nblend(PlanarRGB &dst, const PlanarRGB &src, fract8 amountOfSrc);
+
+// Same as blur1d() on a CRGB array.
+void blur1d(PlanarRGB &planes, fract8 blur_amount);
+
+// planes[i] = palette[indices[i]] for the first n pixels.
+void map_palette(PlanarRGB &planes, const u8 *indices, fl::size n,
+                 const CRGBPalette256 &palette);
+
+} // namespace planar
+
+} // namespace fl
@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+Q16.16 fixed point scalar and 2d vector for the geometry code.
+
+On AVR, ESP8266, Cortex-M0/M3 and the FPU-less RISC-V parts every float
+operation is a soft-float library call and sinf/cosf cost thousands of
+cycles, which makes XYPath drawing unusably slow. q16 keeps 16 integer and 16
+fractional bits in an i32, the trig comes from the sin32/cos32 table, so a
+point through a path, a transform and splat() is plain integer math.
+
+    q16 a = 3;                        // 3.0
+    q16 b = q16::from_float(0.25f);   // 0.25, once, outside the hot loop.
+    q16 c = a * b;                    // 0.75
+    vec2q16 p(c, q16::from_raw(0x8000)); // (0.75, 0.5)
+
+Angles are u32 in the sin32 convention, 16777216 per full circle, so they
+wrap for free. turns_to_angle() turns a q16 number of turns into one.
+
+FASTLED_GEOMETRY_Q16 selects the fixed point pipeline for XYPath drawing, see
+XYPathRenderer. It defaults on for targets without an FPU.
+*/
+
+#include "fl/force_inline.h"
+#include "fl/geometry.h"
+#include "fl/int.h"
+#include "fl/sin32.h"
+
+#ifndef FASTLED_GEOMETRY_Q16
+#if defined(__AVR__) || defined(ESP8266) || defined(__ARM_ARCH_6M__) ||       \
+    (defined(__arm__) && !defined(__ARM_FP)) ||                                \
+    (defined(__riscv) && !defined(__riscv_flen))
+#define FASTLED_GEOMETRY_Q16 1
+#else
+#define FASTLED_GEOMETRY_Q16 0
+#endif
+#endif
+
+namespace fl {
+
+class q16 {
+  public:
+    static constexpr i32 kOne = 0x10000;
+
+    constexpr q16() = default;
+    // Integer value, 3 -> 3.0. Implicit so q16 works as vec2<q16>.
+    constexpr q16(i32 v) : mRaw(v * kOne) {}
+
+    static constexpr q16 from_raw(i32 raw) { return q16(raw, RawTag()); }
+    static q16 from_float(float f) {
+        return from_raw(i32(f * float(kOne) + (f < 0 ? -0.5f : 0.5f)));
+    }
+
+    constexpr i32 raw() const { return mRaw; }
+    float to_float() const { return float(mRaw) / float(kOne); }
+    // Rounds towards negative infinity.
+    constexpr i32 to_int() const { return mRaw >> 16; }
+    // Fractional part in [0, 65535].
+    constexpr u16 frac() const { return u16(mRaw & 0xFFFF); }
+
+    constexpr q16 operator+(q16 o) const { return from_raw(mRaw + o.mRaw); }
+    constexpr q16 operator-(q16 o) const { return from_raw(mRaw - o.mRaw); }
+    constexpr q16 operator-() const { return from_raw(-mRaw); }
+    q16 operator*(q16 o) const { return from_raw(mul(mRaw, o.mRaw)); }
+    // Rare in the geometry code, takes a 64 bit divide.
+    q16 operator/(q16 o) const {
+        return from_raw(i32((i64(mRaw) * kOne) / o.mRaw));
+    }
+    q16 &operator+=(q16 o) { mRaw += o.mRaw; return *this; }
+    q16 &operator-=(q16 o) { mRaw -= o.mRaw; return *this; }
+    q16 &operator*=(q16 o) { mRaw = mul(mRaw, o.mRaw); return *this; }
+    q16 &operator/=(q16 o) { return *this = *this / o; }
+
+    constexpr bool operator==(q16 o) const { return mRaw == o.mRaw; }
+    constexpr bool operator!=(q16 o) const { return mRaw != o.mRaw; }
+    constexpr bool operator<(q16 o) const { return mRaw < o.mRaw; }
+    constexpr bool operator>(q16 o) const { return mRaw > o.mRaw; }
+    constexpr bool operator<=(q16 o) const { return mRaw <= o.mRaw; }
+    constexpr bool operator>=(q16 o) const { return mRaw >= o.mRaw; }
+
+    // (a * b) >> 16 from four 16x16 products, exact and without the 64 bit
+    // multiply that costs a library call on the small cores.
+    static FASTLED_FORCE_INLINE i32 mul(i32 a, i32 b) {
+        const i32 ah = a >> 16;
+        const i32 bh = b >> 16;
+        const u32 al = u32(a) & 0xFFFF;
+        const u32 bl = u32(b) & 0xFFFF;
+        u32 out = u32(ah * bh) << 16;
+        out += u32(ah * i32(bl));
+        out += u32(i32(al) * bh);
+        out += (al * bl) >> 16;
+        return i32(out);
+    }
+
+  private:
+    struct RawTag {};
+    constexpr q16(i32 raw, RawTag) : mRaw(raw) {}
+    i32 mRaw = 0;
+};
+
+using vec2q16 = vec2<q16>; // Q16.16 vector, see q16.
+
+// sin/cos in Q16.16, angle in the sin32 convention (16777216 = full circle).
+FASTLED_FORCE_INLINE q16 sin_q16(u32 angle) {
+    return q16::from_raw(sin32(angle) >> 15);
+}
+FASTLED_FORCE_INLINE q16 cos_q16(u32 angle) {
+    return q16::from_raw(cos32(angle) >> 15);
+}
+
+// Whole and fractional turns to a sin32 angle, 1.0 -> 16777216.
+FASTLED_FORCE_INLINE u32 turns_to_angle(q16 turns) {
+    return u32(turns.raw()) << 8;
+}
+
+// alpha16 in [0, 65535] to [0, 1.0], both ends exact.
+FASTLED_FORCE_INLINE q16 alpha16_to_q16(u16 alpha) {
+    return q16::from_raw(i32(alpha) + (alpha >> 15));
+}
+
+FASTLED_FORCE_INLINE vec2q16 to_vec2q16(const vec2f &v) {
+    return vec2q16(q16::from_float(v.x), q16::from_float(v.y));
+}
+FASTLED_FORCE_INLINE vec2f to_vec2f(const vec2q16 &v) {
+    return vec2f(v.x.to_float(), v.y.to_float());
+}
+
+} // namespace fl
@@ -1,6 +1,7 @@
 
 #include "fl/rectangular_draw_buffer.h"
 #include "fl/allocator.h"
+#include "fl/memory_budget.h"
 #include "fl/namespace.h"
 #include "rgbw.h"
 
@@ -61,6 +62,7 @@ bool RectangularDrawBuffer::onQueuingDone() {
     if (total_bytes > mAllLedsBufferUint8Size) {
         u8 *old_ptr = mAllLedsBufferUint8.release();
         fl::PSRamAllocator<u8>::Free(old_ptr);
+        MemScope scope(MemCategory::kDrawBuffer);
         u8 *ptr = fl::PSRamAllocator<u8>::Alloc(total_bytes);
         mAllLedsBufferUint8.reset(ptr);
     }
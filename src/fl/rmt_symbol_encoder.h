@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+Byte to RMT symbol encoding for the clockless ESP32 drivers, kept free of
+any ESP-IDF header so it builds and is tested on the host.
+
+An RMT symbol (rmt_item32_t in IDF4, rmt_symbol_word_t in IDF5) is one
+32 bit word: duration0:15 level0:1 duration1:15 level1:1. A clockless bit is
+one symbol, high for the bit's T0H/T1H and low for the rest, so a byte is
+eight symbols, msb first.
+
+Instead of testing each bit, the encoder keeps the four symbols of every
+nibble in a 256 byte table and copies two table rows per byte:
+
+    fl::RmtSymbolEncoder enc(fl::rmt_symbol(t0h, t0l), fl::rmt_symbol(t1h, t1l));
+    enc.encode(pixels, num_bytes, items);  // items holds num_bytes * 8 words
+
+encode() inlines, so calling it from an IRAM_ATTR refill keeps it in IRAM. It
+works on volatile destinations too, RMT memory only takes 32 bit writes.
+*/
+
+#include "fl/force_inline.h"
+#include "fl/int.h"
+
+namespace fl {
+
+// Packs a high-then-low pulse into an RMT symbol word, durations in RMT
+// ticks (15 bits each).
+constexpr u32 rmt_symbol(u32 high_ticks, u32 low_ticks) {
+    return (high_ticks & 0x7FFF) | (1u << 15) | ((low_ticks & 0x7FFF) << 16);
+}
+
+class RmtSymbolEncoder {
+  public:
+    RmtSymbolEncoder() { set(0, 0); }
+    RmtSymbolEncoder(u32 zero, u32 one) { set(zero, one); }
+
+    void set(u32 zero, u32 one) {
+        mZero = zero;
+        mOne = one;
+        for (u32 nibble = 0; nibble < 16; ++nibble) {
+            for (u32 bit = 0; bit < 4; ++bit) {
+                mNibbles[nibble][bit] = (nibble & (8u >> bit)) ? one : zero;
+            }
+        }
+    }
+
+    u32 zero() const { return mZero; }
+    u32 one() const { return mOne; }
+
+    // Eight symbols for one byte, msb first.
+    template <typename Word>
+    FASTLED_FORCE_INLINE void encode(u8 byteval, Word *out) const {
+        const u32 *hi = mNibbles[byteval >> 4];
+        const u32 *lo = mNibbles[byteval & 0x0F];
+        out[0] = hi[0];
+        out[1] = hi[1];
+        out[2] = hi[2];
+        out[3] = hi[3];
+        out[4] = lo[0];
+        out[5] = lo[1];
+        out[6] = lo[2];
+        out[7] = lo[3];
+    }
+
+    // n bytes to n * 8 symbols, returns the symbols written.
+    template <typename Word>
+    FASTLED_FORCE_INLINE u32 encode(const u8 *data, u32 n, Word *out) const {
+        for (u32 i = 0; i < n; ++i) {
+            encode(data[i], out + i * 8);
+        }
+        return n * 8;
+    }
+
+  private:
+    u32 mNibbles[16][4];
+    u32 mZero = 0;
+    u32 mOne = 0;
+};
+
+} // namespace fl
@@ -0,0 +1,236 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "FastLED.h"
+
+#include "fl/memfill.h"
+#include "fl/scale8_bulk.h"
+#include "fl/simd.h"
+
+namespace fl {
+
+namespace {
+
+// scale8() is i * (scale + 1) >> 8 with FASTLED_SCALE8_FIXED, else
+// i * scale >> 8. Both fit 16 bit lanes, 255 * 256 < 65536.
+inline u16 scale8_bulk_multiplier(u8 scale) {
+#if (FASTLED_SCALE8_FIXED == 1)
+    return u16(scale) + 1;
+#else
+    return scale;
+#endif
+}
+
+// The 128 bit kernels return how many bytes they processed, the caller
+// finishes the tail.
+
+template <typename B>
+fl::size scale8_bulk_kernel(u8 *data, fl::size n, u8 scale) {
+    const typename B::u16x8 mul = B::splat_u16(scale8_bulk_multiplier(scale));
+    fl::size i = 0;
+    for (; i + 16 <= n; i += 16) {
+        typename B::u8x16 v = B::load_u8x16(data + i);
+        typename B::u16x8 lo =
+            B::template shr_u16<8>(B::mullo_u16(B::widen_lo_u8(v), mul));
+        typename B::u16x8 hi =
+            B::template shr_u16<8>(B::mullo_u16(B::widen_hi_u8(v), mul));
+        B::store(data + i, B::narrow_u16(lo, hi));
+    }
+    return i;
+}
+
+// scale8_video(i, scale) = (i * scale >> 8) + (i && scale ? 1 : 0)
+template <typename B>
+fl::size scale8_video_bulk_kernel(u8 *data, fl::size n, u8 scale) {
+    const typename B::u16x8 mul = B::splat_u16(scale);
+    const typename B::u8x16 one = B::splat_u8(scale ? 1 : 0);
+    const typename B::u8x16 zero = B::splat_u8(0);
+    fl::size i = 0;
+    for (; i + 16 <= n; i += 16) {
+        typename B::u8x16 v = B::load_u8x16(data + i);
+        typename B::u16x8 lo =
+            B::template shr_u16<8>(B::mullo_u16(B::widen_lo_u8(v), mul));
+        typename B::u16x8 hi =
+            B::template shr_u16<8>(B::mullo_u16(B::widen_hi_u8(v), mul));
+        typename B::u8x16 add = B::andnot_u8(one, B::cmpeq_u8(v, zero));
+        B::store(data + i, B::add_u8(B::narrow_u16(lo, hi), add));
+    }
+    return i;
+}
+
+// The channel pattern repeats every 48 bytes, three 16 byte vectors that start
+// at channel 0, 1 and 2.
+template <typename B>
+fl::size scale8_rgb_bulk_kernel(u8 *rgb, fl::size n, const u8 scales[3]) {
+    typename B::u16x8 mul[6];
+    for (int k = 0; k < 6; ++k) {
+        u16 lanes[8];
+        for (int j = 0; j < 8; ++j) {
+            lanes[j] = scale8_bulk_multiplier(scales[(k * 8 + j) % 3]);
+        }
+        mul[k] = B::load_u16x8(lanes);
+    }
+    fl::size i = 0;
+    for (; i + 48 <= n; i += 48) {
+        for (int k = 0; k < 3; ++k) {
+            u8 *p = rgb + i + k * 16;
+            typename B::u8x16 v = B::load_u8x16(p);
+            typename B::u16x8 lo = B::template shr_u16<8>(
+                B::mullo_u16(B::widen_lo_u8(v), mul[k * 2]));
+            typename B::u16x8 hi = B::template shr_u16<8>(
+                B::mullo_u16(B::widen_hi_u8(v), mul[k * 2 + 1]));
+            B::store(p, B::narrow_u16(lo, hi));
+        }
+    }
+    return i;
+}
+
+#if FL_SIMD_HAS_AVX2
+// 32 bytes per step, the rest is left to the sse2 kernel. Unpack and pack
+// both work per 128 bit lane, so the byte order round trips.
+FL_SIMD_TARGET_AVX2 fl::size scale8_bulk_avx2(u8 *data, fl::size n,
+                                              u8 scale, bool video) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mul = _mm256_set1_epi16(
+        short(video ? u16(scale) : scale8_bulk_multiplier(scale)));
+    const __m256i one = _mm256_set1_epi8(char(video && scale ? 1 : 0));
+    fl::size i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i *p = reinterpret_cast<__m256i *>(data + i);
+        __m256i v = _mm256_loadu_si256(p);
+        __m256i lo = _mm256_unpacklo_epi8(v, zero);
+        __m256i hi = _mm256_unpackhi_epi8(v, zero);
+        lo = _mm256_srli_epi16(_mm256_mullo_epi16(lo, mul), 8);
+        hi = _mm256_srli_epi16(_mm256_mullo_epi16(hi, mul), 8);
+        __m256i r = _mm256_packus_epi16(lo, hi);
+        r = _mm256_add_epi8(r,
+                            _mm256_andnot_si256(_mm256_cmpeq_epi8(v, zero), one));
+        _mm256_storeu_si256(p, r);
+    }
+    return i;
+}
+#endif
+
+#if !defined(__AVR__)
+// Scalar fallback on 32 bit cores: four bytes per multiply pair, even and odd
+// bytes each get a 16 bit lane.
+inline u32 scale8_bulk_swar(u32 x, u32 mul) {
+    u32 even = (x & 0x00FF00FFu) * mul;
+    u32 odd = ((x >> 8) & 0x00FF00FFu) * mul;
+    return ((even >> 8) & 0x00FF00FFu) | (odd & 0xFF00FF00u);
+}
+
+// 0x01 in every byte of x that is non zero.
+inline u32 scale8_bulk_nonzero_swar(u32 x) {
+    u32 t = (x & 0x7F7F7F7Fu) + 0x7F7F7F7Fu;
+    return ((t | x) & 0x80808080u) >> 7;
+}
+
+fl::size scale8_bulk_swar_kernel(u8 *data, fl::size n, u8 scale, bool video) {
+    const u32 mul = video ? scale : scale8_bulk_multiplier(scale);
+    const u32 nonzero_scale = video && scale ? 1 : 0;
+    fl::size i = 0;
+    for (; i + 4 <= n; i += 4) {
+        u32 x;
+        fl::memcopy(&x, data + i, sizeof(x));
+        // The scaled bytes are at most 254, adding one never carries.
+        u32 r = scale8_bulk_swar(x, mul) +
+                scale8_bulk_nonzero_swar(x) * nonzero_scale;
+        fl::memcopy(data + i, &r, sizeof(r));
+    }
+    return i;
+}
+#endif
+
+// Runs the best kernel for the active ISA, returns the bytes processed.
+fl::size scale8_bulk_dispatch(u8 *data, fl::size n, u8 scale, bool video) {
+    const simd::Isa isa = simd::activeIsa();
+#if FL_SIMD_HAS_AVX2
+    if (isa == simd::Isa::kAvx2) {
+        // The sse2 kernel picks up the last 16..31 bytes.
+        fl::size i = scale8_bulk_avx2(data, n, scale, video);
+        return i + (video ? scale8_video_bulk_kernel<simd::Sse2>(
+                                data + i, n - i, scale)
+                          : scale8_bulk_kernel<simd::Sse2>(data + i, n - i,
+                                                           scale));
+    }
+#endif
+#if FL_SIMD_HAS_SSE2
+    if (isa == simd::Isa::kSse2) {
+        return video ? scale8_video_bulk_kernel<simd::Sse2>(data, n, scale)
+                     : scale8_bulk_kernel<simd::Sse2>(data, n, scale);
+    }
+#endif
+#if FL_SIMD_HAS_NEON
+    if (isa == simd::Isa::kNeon) {
+        return video ? scale8_video_bulk_kernel<simd::Neon>(data, n, scale)
+                     : scale8_bulk_kernel<simd::Neon>(data, n, scale);
+    }
+#endif
+#if FL_SIMD_HAS_WASM
+    if (isa == simd::Isa::kWasm) {
+        return video ? scale8_video_bulk_kernel<simd::Wasm>(data, n, scale)
+                     : scale8_bulk_kernel<simd::Wasm>(data, n, scale);
+    }
+#endif
+    (void)isa;
+#if defined(__AVR__)
+    (void)data;
+    (void)n;
+    (void)scale;
+    (void)video;
+    return 0;
+#else
+    return scale8_bulk_swar_kernel(data, n, scale, video);
+#endif
+}
+
+} // namespace
+
+void scale8_bulk(u8 *data, fl::size n, u8 scale) {
+    for (fl::size i = scale8_bulk_dispatch(data, n, scale, false); i < n; ++i) {
+        data[i] = scale8(data[i], scale);
+    }
+}
+
+void scale8_video_bulk(u8 *data, fl::size n, u8 scale) {
+    for (fl::size i = scale8_bulk_dispatch(data, n, scale, true); i < n; ++i) {
+        data[i] = scale8_video(data[i], scale);
+    }
+}
+
+void scale8_rgb_bulk(u8 *rgb, fl::size n_pixels, u8 scale_r, u8 scale_g,
+                     u8 scale_b) {
+    const fl::size n = n_pixels * 3;
+    const u8 scales[3] = {scale_r, scale_g, scale_b};
+    const simd::Isa isa = simd::activeIsa();
+    fl::size i = 0;
+    // SWAR needs one multiplier per word and the channels differ per byte,
+    // so the scalar ISA takes the plain loop.
+#if FL_SIMD_HAS_SSE2
+    if (isa == simd::Isa::kAvx2 || isa == simd::Isa::kSse2) {
+        i = scale8_rgb_bulk_kernel<simd::Sse2>(rgb, n, scales);
+    }
+#endif
+#if FL_SIMD_HAS_NEON
+    if (isa == simd::Isa::kNeon) {
+        i = scale8_rgb_bulk_kernel<simd::Neon>(rgb, n, scales);
+    }
+#endif
+#if FL_SIMD_HAS_WASM
+    if (isa == simd::Isa::kWasm) {
+        i = scale8_rgb_bulk_kernel<simd::Wasm>(rgb, n, scales);
+    }
+#endif
+    (void)isa;
+    for (; i < n; i += 3) {
+        rgb[i] = scale8(rgb[i], scales[0]);
+        rgb[i + 1] = scale8(rgb[i + 1], scales[1]);
+        rgb[i + 2] = scale8(rgb[i + 2], scales[2]);
+    }
+}
+
+const char *scale8_bulk_impl() { return simd::isaName(simd::activeIsa()); }
+
+} // namespace fl
@@ -0,0 +1,33 @@
+#pragma once
+
+/// @file scale8_bulk.h
+/// Bulk versions of scale8() and scale8_video() that treat a buffer as a flat
+/// byte array. These are the kernels behind nscale8(), fadeToBlackBy(),
+/// nscale8_video() and fadeUsingColor() for CRGB arrays.
+///
+/// The results are bit exact with the scalar functions in lib8tion/scale8.h,
+/// including FASTLED_SCALE8_FIXED. Hosted and ARM builds process 16 or 32
+/// bytes per step with SSE2, AVX2 or NEON, other 32 bit targets use SWAR on
+/// four bytes per step, AVR keeps the scalar assembly versions.
+
+#include "fl/int.h"
+#include "fl/namespace.h"
+
+namespace fl {
+
+/// data[i] = scale8(data[i], scale)
+void scale8_bulk(fl::u8 *data, fl::size n, fl::u8 scale);
+
+/// data[i] = scale8_video(data[i], scale)
+void scale8_video_bulk(fl::u8 *data, fl::size n, fl::u8 scale);
+
+/// Scales packed rgb triplets channel by channel: r by scale_r, g by scale_g,
+/// b by scale_b, with scale8() semantics. n_pixels * 3 bytes are processed.
+void scale8_rgb_bulk(fl::u8 *rgb, fl::size n_pixels, fl::u8 scale_r,
+                     fl::u8 scale_g, fl::u8 scale_b);
+
+/// Name of the kernel set that was compiled in: "avx2", "sse2", "neon",
+/// "swar" or "scalar".
+const char *scale8_bulk_impl();
+
+} // namespace fl
@@ -9,6 +9,7 @@
 #include "fl/map.h"
 #include "fl/namespace.h"
 #include "fl/str.h"
+#include "fl/vector.h"
 
 /* Screenmap maps strip indexes to x,y coordinates. This is used for FastLED Web
  * to map the 1D strip to a 2D screen. Note that the strip can have arbitrary
@@ -20,6 +21,7 @@ namespace fl {
 
 class string;
 class JsonDocument;
+class FileHandle;
 
 // ScreenMap screen map maps strip indexes to x,y coordinates for a ui
 // canvas in float format.
@@ -87,6 +89,29 @@ class ScreenMap {
                           string *jsonBuffer);
     static void toJson(const FixedMap<string, ScreenMap, 16> &, JsonDocument *doc);
 
+    // Compact binary format, see screenmap_binary.cpp for the layout.
+    // Coordinates are quantized to i16 over the bounding box of each segment,
+    // optionally delta + varint encoded. Parsing streams the points straight
+    // into the look up table, there is no intermediate document.
+    static bool ParseBinary(const u8 *data, fl::size len,
+                            FixedMap<string, ScreenMap, 16> *segmentMaps,
+                            string *err = nullptr);
+    static bool ParseBinary(FileHandle &file,
+                            FixedMap<string, ScreenMap, 16> *segmentMaps,
+                            string *err = nullptr);
+    // Lazy variant: only decodes the named segment, the others are skipped.
+    static bool ParseBinary(FileHandle &file, const char *screenMapName,
+                            ScreenMap *screenmap, string *err = nullptr);
+    static void toBinary(const FixedMap<string, ScreenMap, 16> &segmentMaps,
+                         fl::vector<u8> *out,
+                         bool deltaEncode = true);
+    // Converter for existing json layouts.
+    static bool JsonToBinary(const char *jsonStrScreenMap,
+                             fl::vector<u8> *out,
+                             bool deltaEncode = true, string *err = nullptr);
+    // True if the buffer starts with the binary magic number.
+    static bool IsBinary(const u8 *data, fl::size len);
+
   private:
     static const vec2f &empty();
     u32 length = 0;
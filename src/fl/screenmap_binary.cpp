@@ -0,0 +1,459 @@
+/* Compact binary serialization for ScreenMap.
+ *
+ * Json layouts of big sculptures (10k+ leds) take seconds to parse at boot and
+ * need a JsonDocument that is many times the size of the final look up table.
+ * The binary format is streamed straight into the LUT instead.
+ *
+ * Layout, all multi byte values are little endian:
+ *
+ *   "FLSM"          magic
+ *   u8              version (1)
+ *   u8              flags (reserved, 0)
+ *   u16             number of segments
+ *   per segment:
+ *     u8            name length, followed by the name bytes (no terminator)
+ *     u8            encoding: 0 = i16 pairs, 1 = zigzag varint deltas
+ *     u32           number of points
+ *     f32           diameter
+ *     f32, f32      origin x, y
+ *     f32           step, coordinate = origin + q * step
+ *     u32           payload size in bytes, allows segments to be skipped
+ *     payload       x0 y0 x1 y1 ... as i16 or varint(zigzag(q[i] - q[i-1]))
+ *
+ * Quantization spans the larger side of the bounding box with 65534 steps, so
+ * the error per coordinate is at most half a step.
+ */
+
+#include "fl/screenmap.h"
+
+#include "fl/bit_cast.h"
+#include "fl/file_system.h"
+#include "fl/json.h"
+#include "fl/math.h"
+#include "fl/math_macros.h"
+#include "fl/str.h"
+#include "fl/vector.h"
+#include "fl/warn.h"
+
+namespace fl {
+
+namespace {
+
+const u8 kScreenMapMagic[4] = {'F', 'L', 'S', 'M'};
+const u8 kScreenMapVersion = 1;
+const u8 kEncodingI16 = 0;
+const u8 kEncodingDelta = 1;
+const i32 kQuantMax = 32767;
+
+// Buffered little endian reader over either a memory block or a file.
+class ScreenMapBinaryReader {
+  public:
+    ScreenMapBinaryReader(const u8 *data, fl::size len)
+        : mFile(nullptr), mData(data), mLen(len), mPos(0) {}
+    explicit ScreenMapBinaryReader(FileHandle *file)
+        : mFile(file), mData(mBuf), mLen(0), mPos(0) {}
+
+    bool readBytes(u8 *dst, fl::size n) {
+        while (n > 0) {
+            if (mPos == mLen && !fill()) {
+                return false;
+            }
+            fl::size chunk = MIN(n, mLen - mPos);
+            for (fl::size i = 0; i < chunk; ++i) {
+                dst[i] = mData[mPos + i];
+            }
+            mPos += chunk;
+            dst += chunk;
+            n -= chunk;
+        }
+        return true;
+    }
+
+    bool readU8(u8 *out) {
+        if (mPos == mLen && !fill()) {
+            return false;
+        }
+        *out = mData[mPos++];
+        return true;
+    }
+
+    bool readU16(u16 *out) {
+        u8 b[2];
+        if (!readBytes(b, 2)) {
+            return false;
+        }
+        *out = u16(b[0]) | (u16(b[1]) << 8);
+        return true;
+    }
+
+    bool readU32(u32 *out) {
+        u8 b[4];
+        if (!readBytes(b, 4)) {
+            return false;
+        }
+        *out = u32(b[0]) | (u32(b[1]) << 8) | (u32(b[2]) << 16) |
+               (u32(b[3]) << 24);
+        return true;
+    }
+
+    bool readF32(float *out) {
+        u32 bits;
+        if (!readU32(&bits)) {
+            return false;
+        }
+        *out = fl::bit_cast<float>(bits);
+        return true;
+    }
+
+    bool readVarint(u32 *out) {
+        u32 value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            u8 b;
+            if (!readU8(&b)) {
+                return false;
+            }
+            value |= u32(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                *out = value;
+                return true;
+            }
+        }
+        return false; // Malformed, more than 5 bytes.
+    }
+
+    bool skip(fl::size n) {
+        fl::size buffered = MIN(n, mLen - mPos);
+        mPos += buffered;
+        n -= buffered;
+        if (n == 0) {
+            return true;
+        }
+        if (!mFile) {
+            return false;
+        }
+        return mFile->seek(mFile->pos() + n);
+    }
+
+    // Bytes that can still be read, buffered plus whatever is left in the file.
+    fl::size remaining() const {
+        return (mLen - mPos) + (mFile ? mFile->bytesLeft() : 0);
+    }
+
+  private:
+    bool fill() {
+        if (!mFile) {
+            return false;
+        }
+        mLen = mFile->read(mBuf, sizeof(mBuf));
+        mPos = 0;
+        return mLen > 0;
+    }
+
+    FileHandle *mFile;
+    const u8 *mData;
+    fl::size mLen;
+    fl::size mPos;
+    u8 mBuf[64];
+};
+
+struct ScreenMapSegmentHeader {
+    string name;
+    u8 encoding = 0;
+    u32 count = 0;
+    float diameter = -1.0f;
+    float originX = 0;
+    float originY = 0;
+    float step = 1.0f;
+    u32 payloadSize = 0;
+};
+
+void screenmap_put_u16(fl::vector<u8> *out, u16 v) {
+    out->push_back(u8(v));
+    out->push_back(u8(v >> 8));
+}
+
+void screenmap_put_u32(fl::vector<u8> *out, u32 v) {
+    out->push_back(u8(v));
+    out->push_back(u8(v >> 8));
+    out->push_back(u8(v >> 16));
+    out->push_back(u8(v >> 24));
+}
+
+void screenmap_put_f32(fl::vector<u8> *out, float v) {
+    screenmap_put_u32(out, fl::bit_cast<u32>(v));
+}
+
+void screenmap_put_varint(fl::vector<u8> *out, u32 v) {
+    while (v >= 0x80) {
+        out->push_back(u8(v | 0x80));
+        v >>= 7;
+    }
+    out->push_back(u8(v));
+}
+
+u32 screenmap_zigzag_encode(i32 v) { return (u32(v) << 1) ^ u32(v >> 31); }
+
+i32 screenmap_zigzag_decode(u32 v) { return i32(v >> 1) ^ -i32(v & 1); }
+
+i32 screenmap_quantize(float v, float origin, float step) {
+    float q = fl::floor((v - origin) / step + 0.5f);
+    if (q > kQuantMax) {
+        return kQuantMax;
+    }
+    if (q < -kQuantMax) {
+        return -kQuantMax;
+    }
+    return i32(q);
+}
+
+bool screenmap_fail(string *err, const char *msg) {
+    FASTLED_WARN("ScreenMap binary: " << msg);
+    if (err) {
+        *err = msg;
+    }
+    return false;
+}
+
+bool screenmap_read_file_header(ScreenMapBinaryReader &reader,
+                                u16 *numSegments, string *err) {
+    u8 magic[4];
+    u8 version, flags;
+    if (!reader.readBytes(magic, 4) || !ScreenMap::IsBinary(magic, 4)) {
+        return screenmap_fail(err, "bad magic");
+    }
+    if (!reader.readU8(&version) || !reader.readU8(&flags) ||
+        !reader.readU16(numSegments)) {
+        return screenmap_fail(err, "truncated header");
+    }
+    if (version != kScreenMapVersion) {
+        return screenmap_fail(err, "unsupported version");
+    }
+    return true;
+}
+
+bool screenmap_read_segment_header(ScreenMapBinaryReader &reader,
+                                   ScreenMapSegmentHeader *header,
+                                   string *err) {
+    u8 name_len;
+    if (!reader.readU8(&name_len)) {
+        return screenmap_fail(err, "truncated segment");
+    }
+    char name[256];
+    if (!reader.readBytes(reinterpret_cast<u8 *>(name), name_len)) {
+        return screenmap_fail(err, "truncated segment name");
+    }
+    name[name_len] = 0;
+    header->name = name;
+    if (!reader.readU8(&header->encoding) || !reader.readU32(&header->count) ||
+        !reader.readF32(&header->diameter) ||
+        !reader.readF32(&header->originX) ||
+        !reader.readF32(&header->originY) || !reader.readF32(&header->step) ||
+        !reader.readU32(&header->payloadSize)) {
+        return screenmap_fail(err, "truncated segment header");
+    }
+    if (header->encoding != kEncodingI16 &&
+        header->encoding != kEncodingDelta) {
+        return screenmap_fail(err, "unknown encoding");
+    }
+    // The count sizes the allocation, so check it against the data that is
+    // actually there before trusting it. Every point takes at least 4 bytes
+    // as i16 and 2 as varints.
+    const fl::u64 min_payload =
+        fl::u64(header->count) * (header->encoding == kEncodingI16 ? 4 : 2);
+    if (header->payloadSize > reader.remaining() ||
+        min_payload > header->payloadSize) {
+        return screenmap_fail(err, "point count exceeds payload");
+    }
+    return true;
+}
+
+} // namespace
+
+bool ScreenMap::IsBinary(const u8 *data, fl::size len) {
+    if (!data || len < sizeof(kScreenMapMagic)) {
+        return false;
+    }
+    for (fl::size i = 0; i < sizeof(kScreenMapMagic); ++i) {
+        if (data[i] != kScreenMapMagic[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decodes the payload of one segment directly into the screen map's LUT.
+static bool screenmap_read_points(ScreenMapBinaryReader &reader,
+                                  const ScreenMapSegmentHeader &header,
+                                  vec2f *dst, string *err) {
+    i32 qx = 0;
+    i32 qy = 0;
+    for (u32 i = 0; i < header.count; ++i) {
+        if (header.encoding == kEncodingDelta) {
+            u32 dx, dy;
+            if (!reader.readVarint(&dx) || !reader.readVarint(&dy)) {
+                return screenmap_fail(err, "truncated delta payload");
+            }
+            // Summed wide, so a crafted stream can't overflow. The writer
+            // never leaves the quantizer's range, so anything outside it
+            // is corrupt.
+            const fl::i64 nx = fl::i64(qx) + screenmap_zigzag_decode(dx);
+            const fl::i64 ny = fl::i64(qy) + screenmap_zigzag_decode(dy);
+            if (nx < -kQuantMax || nx > kQuantMax || ny < -kQuantMax ||
+                ny > kQuantMax) {
+                return screenmap_fail(err, "delta out of range");
+            }
+            qx = i32(nx);
+            qy = i32(ny);
+        } else {
+            u16 ux, uy;
+            if (!reader.readU16(&ux) || !reader.readU16(&uy)) {
+                return screenmap_fail(err, "truncated payload");
+            }
+            qx = i16(ux);
+            qy = i16(uy);
+        }
+        dst[i].x = header.originX + float(qx) * header.step;
+        dst[i].y = header.originY + float(qy) * header.step;
+    }
+    return true;
+}
+
+static bool screenmap_parse_binary(ScreenMapBinaryReader &reader,
+                                   const char *onlyName,
+                                   FixedMap<string, ScreenMap, 16> *segmentMaps,
+                                   ScreenMap *single, string *err) {
+    u16 num_segments = 0;
+    if (!screenmap_read_file_header(reader, &num_segments, err)) {
+        return false;
+    }
+    for (u16 s = 0; s < num_segments; ++s) {
+        ScreenMapSegmentHeader header;
+        if (!screenmap_read_segment_header(reader, &header, err)) {
+            return false;
+        }
+        if (onlyName && header.name != onlyName) {
+            if (!reader.skip(header.payloadSize)) {
+                return screenmap_fail(err, "truncated payload");
+            }
+            continue;
+        }
+        ScreenMap segment(header.count, header.diameter);
+        if (!screenmap_read_points(reader, header, &segment[0], err)) {
+            return false;
+        }
+        if (single) {
+            *single = segment;
+            return true;
+        }
+        if (!segmentMaps->update(header.name, segment)) {
+            FASTLED_WARN("ScreenMap binary: too many segments, dropping "
+                         << header.name.c_str());
+        }
+    }
+    if (onlyName) {
+        string msg = "ScreenMap not found: ";
+        msg.append(onlyName);
+        return screenmap_fail(err, msg.c_str());
+    }
+    return true;
+}
+
+bool ScreenMap::ParseBinary(const u8 *data, fl::size len,
+                            FixedMap<string, ScreenMap, 16> *segmentMaps,
+                            string *err) {
+    ScreenMapBinaryReader reader(data, len);
+    return screenmap_parse_binary(reader, nullptr, segmentMaps, nullptr, err);
+}
+
+bool ScreenMap::ParseBinary(FileHandle &file,
+                            FixedMap<string, ScreenMap, 16> *segmentMaps,
+                            string *err) {
+    ScreenMapBinaryReader reader(&file);
+    return screenmap_parse_binary(reader, nullptr, segmentMaps, nullptr, err);
+}
+
+bool ScreenMap::ParseBinary(FileHandle &file, const char *screenMapName,
+                            ScreenMap *screenmap, string *err) {
+    ScreenMapBinaryReader reader(&file);
+    return screenmap_parse_binary(reader, screenMapName, nullptr, screenmap,
+                                err);
+}
+
+void ScreenMap::toBinary(const FixedMap<string, ScreenMap, 16> &segmentMaps,
+                         fl::vector<u8> *out, bool deltaEncode) {
+    if (!out) {
+        FASTLED_WARN("ScreenMap::toBinary called with nullptr out");
+        return;
+    }
+    for (fl::size i = 0; i < sizeof(kScreenMapMagic); ++i) {
+        out->push_back(kScreenMapMagic[i]);
+    }
+    out->push_back(kScreenMapVersion);
+    out->push_back(0); // flags
+    screenmap_put_u16(out, u16(segmentMaps.size()));
+    for (auto kv : segmentMaps) {
+        const ScreenMap &map = kv.second;
+        const u32 n = map.getLength();
+        float min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+        for (u32 i = 0; i < n; ++i) {
+            const vec2f &p = map[i];
+            min_x = i ? MIN(min_x, p.x) : p.x;
+            max_x = i ? MAX(max_x, p.x) : p.x;
+            min_y = i ? MIN(min_y, p.y) : p.y;
+            max_y = i ? MAX(max_y, p.y) : p.y;
+        }
+        const float origin_x = (min_x + max_x) * 0.5f;
+        const float origin_y = (min_y + max_y) * 0.5f;
+        const float range = MAX(max_x - min_x, max_y - min_y);
+        const float step = range > 0.0f ? range / float(2 * kQuantMax) : 1.0f;
+
+        const u8 name_len = u8(MIN(kv.first.size(), fl::size(255)));
+        out->push_back(name_len);
+        for (u8 i = 0; i < name_len; ++i) {
+            out->push_back(u8(kv.first.c_str()[i]));
+        }
+        out->push_back(deltaEncode ? kEncodingDelta : kEncodingI16);
+        screenmap_put_u32(out, n);
+        screenmap_put_f32(out, map.getDiameter());
+        screenmap_put_f32(out, origin_x);
+        screenmap_put_f32(out, origin_y);
+        screenmap_put_f32(out, step);
+        // Payload size is patched once the payload has been written.
+        const fl::size size_pos = out->size();
+        screenmap_put_u32(out, 0);
+        const fl::size payload_start = out->size();
+        i32 prev_x = 0;
+        i32 prev_y = 0;
+        for (u32 i = 0; i < n; ++i) {
+            const vec2f &p = map[i];
+            i32 qx = screenmap_quantize(p.x, origin_x, step);
+            i32 qy = screenmap_quantize(p.y, origin_y, step);
+            if (deltaEncode) {
+                screenmap_put_varint(out, screenmap_zigzag_encode(qx - prev_x));
+                screenmap_put_varint(out, screenmap_zigzag_encode(qy - prev_y));
+                prev_x = qx;
+                prev_y = qy;
+            } else {
+                screenmap_put_u16(out, u16(i16(qx)));
+                screenmap_put_u16(out, u16(i16(qy)));
+            }
+        }
+        const u32 payload_size = u32(out->size() - payload_start);
+        for (int b = 0; b < 4; ++b) {
+            (*out)[size_pos + b] = u8(payload_size >> (8 * b));
+        }
+    }
+}
+
+bool ScreenMap::JsonToBinary(const char *jsonStrScreenMap,
+                             fl::vector<u8> *out, bool deltaEncode,
+                             string *err) {
+    FixedMap<string, ScreenMap, 16> segmentMaps;
+    if (!ParseJson(jsonStrScreenMap, &segmentMaps, err)) {
+        return false;
+    }
+    toBinary(segmentMaps, out, deltaEncode);
+    return true;
+}
+
+} // namespace fl
@@ -0,0 +1,86 @@
+#include "fl/simd.h"
+
+namespace fl {
+namespace simd {
+
+namespace detail {
+// Plain byte so there is no static constructor. Racing first calls all
+// store the same value.
+fl::u8 gActiveIsa = 0xff;
+} // namespace detail
+
+namespace {
+
+bool simd_cpu_has_avx2() {
+#if FL_SIMD_HAS_AVX2 && defined(__AVX2__)
+    return true;
+#elif FL_SIMD_HAS_AVX2
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+const char *isaName(Isa isa) {
+    switch (isa) {
+    case Isa::kScalar:
+        return "scalar";
+    case Isa::kSse2:
+        return "sse2";
+    case Isa::kAvx2:
+        return "avx2";
+    case Isa::kNeon:
+        return "neon";
+    case Isa::kWasm:
+        return "wasm";
+    }
+    return "unknown";
+}
+
+bool isaAvailable(Isa isa) {
+    switch (isa) {
+    case Isa::kScalar:
+        return true;
+    case Isa::kSse2:
+        return FL_SIMD_HAS_SSE2;
+    case Isa::kAvx2:
+        return simd_cpu_has_avx2();
+    case Isa::kNeon:
+        return FL_SIMD_HAS_NEON;
+    case Isa::kWasm:
+        return FL_SIMD_HAS_WASM;
+    }
+    return false;
+}
+
+Isa bestIsa() {
+    const Isa order[] = {Isa::kAvx2, Isa::kSse2, Isa::kNeon, Isa::kWasm};
+    for (Isa isa : order) {
+        if (isaAvailable(isa)) {
+            return isa;
+        }
+    }
+    return Isa::kScalar;
+}
+
+Isa detail::resolveActiveIsa() {
+    const Isa isa = bestIsa();
+    gActiveIsa = fl::u8(isa);
+    return isa;
+}
+
+bool forceIsa(Isa isa) {
+    if (!isaAvailable(isa)) {
+        return false;
+    }
+    detail::gActiveIsa = fl::u8(isa);
+    return true;
+}
+
+void resetIsa() { detail::gActiveIsa = 0xff; }
+
+} // namespace simd
+} // namespace fl
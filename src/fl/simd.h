@@ -0,0 +1,136 @@
+#pragma once
+
+/*
+Portable SIMD layer.
+
+Kernels are written once against a backend: a struct with the vector types
+u8x16, u16x8 and i32x4 and static functions operating on them. Every target
+has the Scalar backend, hosted x86 builds add Sse2, ARM builds with NEON add
+Neon and WASM builds with SIMD128 add Wasm. AVX2 is a 256 bit ISA and does
+not fit the 128 bit types; AVX2 kernels are written with intrinsics in
+functions marked FL_SIMD_TARGET_AVX2 and are only called when the cpu has it.
+
+Which ISA a bulk function uses is decided at runtime by activeIsa(): the
+best one that was compiled in and that the cpu supports, unless a test or
+benchmark forced one with forceIsa().
+
+Example kernel:
+    template <typename B> void add_one(fl::u8 *p, fl::size n) {
+        const typename B::u8x16 one = B::splat_u8(1);
+        for (fl::size i = 0; i + 16 <= n; i += 16) {
+            B::store(p + i, B::add_u8(B::load_u8x16(p + i), one));
+        }
+    }
+    add_one<fl::simd::Native>(data, n);
+
+Defines:
+    FASTLED_SIMD_DISABLE            - Only the scalar backend, on every target.
+    FASTLED_SIMD_RUNTIME_DISPATCH   - x86 gcc/clang: compile AVX2 kernels even
+                                      without -mavx2 and pick them when cpuid
+                                      says the cpu has AVX2. Default on.
+*/
+
+#include "fl/int.h"
+#include "fl/namespace.h"
+
+#ifndef FASTLED_SIMD_DISABLE
+#define FASTLED_SIMD_DISABLE 0
+#endif
+
+#if !FASTLED_SIMD_DISABLE && !defined(__AVR__)
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FL_SIMD_HAS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FL_SIMD_HAS_NEON 1
+#elif defined(__wasm_simd128__)
+#define FL_SIMD_HAS_WASM 1
+#endif
+#endif
+
+#if FL_SIMD_HAS_SSE2
+#if defined(__AVX2__)
+#define FL_SIMD_HAS_AVX2 1
+#define FL_SIMD_TARGET_AVX2
+#else
+#if !defined(FASTLED_SIMD_RUNTIME_DISPATCH) &&                                \
+    (defined(__GNUC__) || defined(__clang__))
+#define FASTLED_SIMD_RUNTIME_DISPATCH 1
+#endif
+#if FASTLED_SIMD_RUNTIME_DISPATCH
+#define FL_SIMD_HAS_AVX2 1
+#define FL_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+#endif
+
+#ifndef FL_SIMD_HAS_SSE2
+#define FL_SIMD_HAS_SSE2 0
+#endif
+#ifndef FL_SIMD_HAS_AVX2
+#define FL_SIMD_HAS_AVX2 0
+#endif
+#ifndef FL_SIMD_HAS_NEON
+#define FL_SIMD_HAS_NEON 0
+#endif
+#ifndef FL_SIMD_HAS_WASM
+#define FL_SIMD_HAS_WASM 0
+#endif
+
+#include "fl/simd_scalar.h"
+#if FL_SIMD_HAS_SSE2
+#include "fl/simd_sse2.h"
+#endif
+#if FL_SIMD_HAS_AVX2
+#include <immintrin.h>
+#endif
+#if FL_SIMD_HAS_NEON
+#include "fl/simd_neon.h"
+#endif
+#if FL_SIMD_HAS_WASM
+#include "fl/simd_wasm.h"
+#endif
+
+namespace fl {
+namespace simd {
+
+enum class Isa : fl::u8 { kScalar = 0, kSse2, kAvx2, kNeon, kWasm };
+
+// Best 128 bit backend known at compile time.
+#if FL_SIMD_HAS_SSE2
+typedef Sse2 Native;
+#elif FL_SIMD_HAS_NEON
+typedef Neon Native;
+#elif FL_SIMD_HAS_WASM
+typedef Wasm Native;
+#else
+typedef Scalar Native;
+#endif
+
+typedef Native::u8x16 u8x16;
+typedef Native::u16x8 u16x8;
+typedef Native::i32x4 i32x4;
+
+const char *isaName(Isa isa);
+// Compiled in and supported by this cpu.
+bool isaAvailable(Isa isa);
+Isa bestIsa();
+
+namespace detail {
+// activeIsa() as a byte, 0xff until the first call works it out.
+extern fl::u8 gActiveIsa;
+Isa resolveActiveIsa();
+} // namespace detail
+
+// The ISA bulk kernels dispatch on, bestIsa() unless forced. Worked out
+// once, then a byte load per call.
+inline Isa activeIsa() {
+    const fl::u8 isa = detail::gActiveIsa;
+    return isa != 0xff ? Isa(isa) : detail::resolveActiveIsa();
+}
+// Returns false and changes nothing if isa is not available.
+bool forceIsa(Isa isa);
+void resetIsa();
+
+} // namespace simd
+} // namespace fl
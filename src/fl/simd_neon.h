@@ -0,0 +1,75 @@
+#pragma once
+
+// NEON backend of fl/simd.h. Include fl/simd.h instead of this file.
+
+#include <arm_neon.h>
+
+#include "fl/int.h"
+
+namespace fl {
+namespace simd {
+
+struct Neon {
+    struct u8x16 {
+        uint8x16_t v;
+    };
+    struct u16x8 {
+        uint16x8_t v;
+    };
+    struct i32x4 {
+        int32x4_t v;
+    };
+
+    // u8x16
+    static u8x16 load_u8x16(const fl::u8 *p) { return {vld1q_u8(p)}; }
+    static void store(fl::u8 *p, u8x16 a) { vst1q_u8(p, a.v); }
+    static u8x16 splat_u8(fl::u8 x) { return {vdupq_n_u8(x)}; }
+    static u8x16 add_u8(u8x16 a, u8x16 b) { return {vaddq_u8(a.v, b.v)}; }
+    static u8x16 adds_u8(u8x16 a, u8x16 b) { return {vqaddq_u8(a.v, b.v)}; }
+    static u8x16 subs_u8(u8x16 a, u8x16 b) { return {vqsubq_u8(a.v, b.v)}; }
+    static u8x16 min_u8(u8x16 a, u8x16 b) { return {vminq_u8(a.v, b.v)}; }
+    static u8x16 max_u8(u8x16 a, u8x16 b) { return {vmaxq_u8(a.v, b.v)}; }
+    static u8x16 cmpeq_u8(u8x16 a, u8x16 b) { return {vceqq_u8(a.v, b.v)}; }
+    static u8x16 and_u8(u8x16 a, u8x16 b) { return {vandq_u8(a.v, b.v)}; }
+    static u8x16 or_u8(u8x16 a, u8x16 b) { return {vorrq_u8(a.v, b.v)}; }
+    static u8x16 andnot_u8(u8x16 a, u8x16 b) { return {vbicq_u8(a.v, b.v)}; }
+
+    // u16x8
+    static u16x8 load_u16x8(const fl::u16 *p) { return {vld1q_u16(p)}; }
+    static void store(fl::u16 *p, u16x8 a) { vst1q_u16(p, a.v); }
+    static u16x8 splat_u16(fl::u16 x) { return {vdupq_n_u16(x)}; }
+    static u16x8 add_u16(u16x8 a, u16x8 b) { return {vaddq_u16(a.v, b.v)}; }
+    static u16x8 mullo_u16(u16x8 a, u16x8 b) { return {vmulq_u16(a.v, b.v)}; }
+    template <int N> static u16x8 shr_u16(u16x8 a) {
+        return {vshrq_n_u16(a.v, N)};
+    }
+    template <int N> static u16x8 shl_u16(u16x8 a) {
+        return {vshlq_n_u16(a.v, N)};
+    }
+    static u16x8 widen_lo_u8(u8x16 a) { return {vmovl_u8(vget_low_u8(a.v))}; }
+    static u16x8 widen_hi_u8(u8x16 a) {
+        return {vmovl_u8(vget_high_u8(a.v))};
+    }
+    static u8x16 narrow_u16(u16x8 lo, u16x8 hi) {
+        return {vcombine_u8(vmovn_u16(lo.v), vmovn_u16(hi.v))};
+    }
+
+    // i32x4
+    static i32x4 load_i32x4(const fl::i32 *p) { return {vld1q_s32(p)}; }
+    static void store(fl::i32 *p, i32x4 a) { vst1q_s32(p, a.v); }
+    static i32x4 splat_i32(fl::i32 x) { return {vdupq_n_s32(x)}; }
+    static i32x4 add_i32(i32x4 a, i32x4 b) { return {vaddq_s32(a.v, b.v)}; }
+    static i32x4 sub_i32(i32x4 a, i32x4 b) { return {vsubq_s32(a.v, b.v)}; }
+    static i32x4 mullo_i32(i32x4 a, i32x4 b) { return {vmulq_s32(a.v, b.v)}; }
+    template <int N> static i32x4 sra_i32(i32x4 a) {
+        return {vshrq_n_s32(a.v, N)};
+    }
+    template <int N> static i32x4 shl_i32(i32x4 a) {
+        return {vshlq_n_s32(a.v, N)};
+    }
+    static i32x4 min_i32(i32x4 a, i32x4 b) { return {vminq_s32(a.v, b.v)}; }
+    static i32x4 max_i32(i32x4 a, i32x4 b) { return {vmaxq_s32(a.v, b.v)}; }
+};
+
+} // namespace simd
+} // namespace fl
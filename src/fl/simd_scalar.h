@@ -0,0 +1,259 @@
+#pragma once
+
+// Scalar backend of fl/simd.h, the reference the other backends are tested
+// against. Include fl/simd.h instead of this file.
+
+#include "fl/int.h"
+
+namespace fl {
+namespace simd {
+
+struct Scalar {
+    struct u8x16 {
+        fl::u8 v[16];
+    };
+    struct u16x8 {
+        fl::u16 v[8];
+    };
+    struct i32x4 {
+        fl::i32 v[4];
+    };
+
+    // u8x16
+    static u8x16 load_u8x16(const fl::u8 *p) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+    static void store(fl::u8 *p, const u8x16 &a) {
+        for (int i = 0; i < 16; ++i) {
+            p[i] = a.v[i];
+        }
+    }
+    static u8x16 splat_u8(fl::u8 x) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = x;
+        }
+        return r;
+    }
+    static u8x16 add_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = fl::u8(a.v[i] + b.v[i]);
+        }
+        return r;
+    }
+    // Saturating.
+    static u8x16 adds_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            int s = a.v[i] + b.v[i];
+            r.v[i] = fl::u8(s > 255 ? 255 : s);
+        }
+        return r;
+    }
+    static u8x16 subs_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] > b.v[i] ? fl::u8(a.v[i] - b.v[i]) : 0;
+        }
+        return r;
+    }
+    static u8x16 min_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+    static u8x16 max_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+    // 0xff where equal, 0 elsewhere.
+    static u8x16 cmpeq_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] == b.v[i] ? 0xff : 0;
+        }
+        return r;
+    }
+    static u8x16 and_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] & b.v[i];
+        }
+        return r;
+    }
+    static u8x16 or_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] | b.v[i];
+        }
+        return r;
+    }
+    // a & ~b
+    static u8x16 andnot_u8(const u8x16 &a, const u8x16 &b) {
+        u8x16 r;
+        for (int i = 0; i < 16; ++i) {
+            r.v[i] = a.v[i] & fl::u8(~b.v[i]);
+        }
+        return r;
+    }
+
+    // u16x8
+    static u16x8 load_u16x8(const fl::u16 *p) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+    static void store(fl::u16 *p, const u16x8 &a) {
+        for (int i = 0; i < 8; ++i) {
+            p[i] = a.v[i];
+        }
+    }
+    static u16x8 splat_u16(fl::u16 x) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = x;
+        }
+        return r;
+    }
+    static u16x8 add_u16(const u16x8 &a, const u16x8 &b) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = fl::u16(a.v[i] + b.v[i]);
+        }
+        return r;
+    }
+    // Low 16 bits of the product.
+    static u16x8 mullo_u16(const u16x8 &a, const u16x8 &b) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = fl::u16(fl::u32(a.v[i]) * b.v[i]);
+        }
+        return r;
+    }
+    // N in [1, 15].
+    template <int N> static u16x8 shr_u16(const u16x8 &a) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = fl::u16(a.v[i] >> N);
+        }
+        return r;
+    }
+    template <int N> static u16x8 shl_u16(const u16x8 &a) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = fl::u16(a.v[i] << N);
+        }
+        return r;
+    }
+    // Zero extends bytes 0-7 / 8-15.
+    static u16x8 widen_lo_u8(const u8x16 &a) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = a.v[i];
+        }
+        return r;
+    }
+    static u16x8 widen_hi_u8(const u8x16 &a) {
+        u16x8 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = a.v[i + 8];
+        }
+        return r;
+    }
+    // Lanes must be <= 255, backends differ for larger values.
+    static u8x16 narrow_u16(const u16x8 &lo, const u16x8 &hi) {
+        u8x16 r;
+        for (int i = 0; i < 8; ++i) {
+            r.v[i] = fl::u8(lo.v[i]);
+            r.v[i + 8] = fl::u8(hi.v[i]);
+        }
+        return r;
+    }
+
+    // i32x4
+    static i32x4 load_i32x4(const fl::i32 *p) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+    static void store(fl::i32 *p, const i32x4 &a) {
+        for (int i = 0; i < 4; ++i) {
+            p[i] = a.v[i];
+        }
+    }
+    static i32x4 splat_i32(fl::i32 x) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = x;
+        }
+        return r;
+    }
+    static i32x4 add_i32(const i32x4 &a, const i32x4 &b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = fl::i32(fl::u32(a.v[i]) + fl::u32(b.v[i]));
+        }
+        return r;
+    }
+    static i32x4 sub_i32(const i32x4 &a, const i32x4 &b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = fl::i32(fl::u32(a.v[i]) - fl::u32(b.v[i]));
+        }
+        return r;
+    }
+    // Low 32 bits of the product.
+    static i32x4 mullo_i32(const i32x4 &a, const i32x4 &b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = fl::i32(fl::u32(a.v[i]) * fl::u32(b.v[i]));
+        }
+        return r;
+    }
+    // Arithmetic shift, N in [1, 31].
+    template <int N> static i32x4 sra_i32(const i32x4 &a) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = a.v[i] >> N;
+        }
+        return r;
+    }
+    template <int N> static i32x4 shl_i32(const i32x4 &a) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = fl::i32(fl::u32(a.v[i]) << N);
+        }
+        return r;
+    }
+    static i32x4 min_i32(const i32x4 &a, const i32x4 &b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+    static i32x4 max_i32(const i32x4 &a, const i32x4 &b) {
+        i32x4 r;
+        for (int i = 0; i < 4; ++i) {
+            r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+};
+
+} // namespace simd
+} // namespace fl
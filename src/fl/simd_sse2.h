@@ -0,0 +1,115 @@
+#pragma once
+
+// SSE2 backend of fl/simd.h. Include fl/simd.h instead of this file.
+
+#include <emmintrin.h>
+
+#include "fl/int.h"
+
+namespace fl {
+namespace simd {
+
+struct Sse2 {
+    // Wrapped so that the three types overload separately.
+    struct u8x16 {
+        __m128i v;
+    };
+    struct u16x8 {
+        __m128i v;
+    };
+    struct i32x4 {
+        __m128i v;
+    };
+
+    // u8x16
+    static u8x16 load_u8x16(const fl::u8 *p) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))};
+    }
+    static void store(fl::u8 *p, u8x16 a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a.v);
+    }
+    static u8x16 splat_u8(fl::u8 x) { return {_mm_set1_epi8(char(x))}; }
+    static u8x16 add_u8(u8x16 a, u8x16 b) { return {_mm_add_epi8(a.v, b.v)}; }
+    static u8x16 adds_u8(u8x16 a, u8x16 b) { return {_mm_adds_epu8(a.v, b.v)}; }
+    static u8x16 subs_u8(u8x16 a, u8x16 b) { return {_mm_subs_epu8(a.v, b.v)}; }
+    static u8x16 min_u8(u8x16 a, u8x16 b) { return {_mm_min_epu8(a.v, b.v)}; }
+    static u8x16 max_u8(u8x16 a, u8x16 b) { return {_mm_max_epu8(a.v, b.v)}; }
+    static u8x16 cmpeq_u8(u8x16 a, u8x16 b) {
+        return {_mm_cmpeq_epi8(a.v, b.v)};
+    }
+    static u8x16 and_u8(u8x16 a, u8x16 b) { return {_mm_and_si128(a.v, b.v)}; }
+    static u8x16 or_u8(u8x16 a, u8x16 b) { return {_mm_or_si128(a.v, b.v)}; }
+    static u8x16 andnot_u8(u8x16 a, u8x16 b) {
+        return {_mm_andnot_si128(b.v, a.v)};
+    }
+
+    // u16x8
+    static u16x8 load_u16x8(const fl::u16 *p) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))};
+    }
+    static void store(fl::u16 *p, u16x8 a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a.v);
+    }
+    static u16x8 splat_u16(fl::u16 x) { return {_mm_set1_epi16(short(x))}; }
+    static u16x8 add_u16(u16x8 a, u16x8 b) {
+        return {_mm_add_epi16(a.v, b.v)};
+    }
+    static u16x8 mullo_u16(u16x8 a, u16x8 b) {
+        return {_mm_mullo_epi16(a.v, b.v)};
+    }
+    template <int N> static u16x8 shr_u16(u16x8 a) {
+        return {_mm_srli_epi16(a.v, N)};
+    }
+    template <int N> static u16x8 shl_u16(u16x8 a) {
+        return {_mm_slli_epi16(a.v, N)};
+    }
+    static u16x8 widen_lo_u8(u8x16 a) {
+        return {_mm_unpacklo_epi8(a.v, _mm_setzero_si128())};
+    }
+    static u16x8 widen_hi_u8(u8x16 a) {
+        return {_mm_unpackhi_epi8(a.v, _mm_setzero_si128())};
+    }
+    static u8x16 narrow_u16(u16x8 lo, u16x8 hi) {
+        return {_mm_packus_epi16(lo.v, hi.v)};
+    }
+
+    // i32x4
+    static i32x4 load_i32x4(const fl::i32 *p) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))};
+    }
+    static void store(fl::i32 *p, i32x4 a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a.v);
+    }
+    static i32x4 splat_i32(fl::i32 x) { return {_mm_set1_epi32(x)}; }
+    static i32x4 add_i32(i32x4 a, i32x4 b) {
+        return {_mm_add_epi32(a.v, b.v)};
+    }
+    static i32x4 sub_i32(i32x4 a, i32x4 b) {
+        return {_mm_sub_epi32(a.v, b.v)};
+    }
+    // SSE2 has no 32 bit mullo, multiply even and odd lanes separately.
+    static i32x4 mullo_i32(i32x4 a, i32x4 b) {
+        __m128i even = _mm_mul_epu32(a.v, b.v);
+        __m128i odd =
+            _mm_mul_epu32(_mm_srli_si128(a.v, 4), _mm_srli_si128(b.v, 4));
+        return {_mm_unpacklo_epi32(_mm_shuffle_epi32(even, 0x08),
+                                   _mm_shuffle_epi32(odd, 0x08))};
+    }
+    template <int N> static i32x4 sra_i32(i32x4 a) {
+        return {_mm_srai_epi32(a.v, N)};
+    }
+    template <int N> static i32x4 shl_i32(i32x4 a) {
+        return {_mm_slli_epi32(a.v, N)};
+    }
+    static i32x4 min_i32(i32x4 a, i32x4 b) {
+        __m128i gt = _mm_cmpgt_epi32(a.v, b.v);
+        return {_mm_or_si128(_mm_and_si128(gt, b.v), _mm_andnot_si128(gt, a.v))};
+    }
+    static i32x4 max_i32(i32x4 a, i32x4 b) {
+        __m128i gt = _mm_cmpgt_epi32(a.v, b.v);
+        return {_mm_or_si128(_mm_and_si128(gt, a.v), _mm_andnot_si128(gt, b.v))};
+    }
+};
+
+} // namespace simd
+} // namespace fl
@@ -0,0 +1,100 @@
+#pragma once
+
+// WASM SIMD128 backend of fl/simd.h, needs -msimd128. Include fl/simd.h
+// instead of this file.
+
+#include <wasm_simd128.h>
+
+#include "fl/int.h"
+
+namespace fl {
+namespace simd {
+
+struct Wasm {
+    struct u8x16 {
+        v128_t v;
+    };
+    struct u16x8 {
+        v128_t v;
+    };
+    struct i32x4 {
+        v128_t v;
+    };
+
+    // u8x16
+    static u8x16 load_u8x16(const fl::u8 *p) { return {wasm_v128_load(p)}; }
+    static void store(fl::u8 *p, u8x16 a) { wasm_v128_store(p, a.v); }
+    static u8x16 splat_u8(fl::u8 x) { return {wasm_u8x16_splat(x)}; }
+    static u8x16 add_u8(u8x16 a, u8x16 b) { return {wasm_i8x16_add(a.v, b.v)}; }
+    static u8x16 adds_u8(u8x16 a, u8x16 b) {
+        return {wasm_u8x16_add_sat(a.v, b.v)};
+    }
+    static u8x16 subs_u8(u8x16 a, u8x16 b) {
+        return {wasm_u8x16_sub_sat(a.v, b.v)};
+    }
+    static u8x16 min_u8(u8x16 a, u8x16 b) { return {wasm_u8x16_min(a.v, b.v)}; }
+    static u8x16 max_u8(u8x16 a, u8x16 b) { return {wasm_u8x16_max(a.v, b.v)}; }
+    static u8x16 cmpeq_u8(u8x16 a, u8x16 b) {
+        return {wasm_i8x16_eq(a.v, b.v)};
+    }
+    static u8x16 and_u8(u8x16 a, u8x16 b) { return {wasm_v128_and(a.v, b.v)}; }
+    static u8x16 or_u8(u8x16 a, u8x16 b) { return {wasm_v128_or(a.v, b.v)}; }
+    static u8x16 andnot_u8(u8x16 a, u8x16 b) {
+        return {wasm_v128_andnot(a.v, b.v)};
+    }
+
+    // u16x8
+    static u16x8 load_u16x8(const fl::u16 *p) { return {wasm_v128_load(p)}; }
+    static void store(fl::u16 *p, u16x8 a) { wasm_v128_store(p, a.v); }
+    static u16x8 splat_u16(fl::u16 x) { return {wasm_u16x8_splat(x)}; }
+    static u16x8 add_u16(u16x8 a, u16x8 b) {
+        return {wasm_i16x8_add(a.v, b.v)};
+    }
+    static u16x8 mullo_u16(u16x8 a, u16x8 b) {
+        return {wasm_i16x8_mul(a.v, b.v)};
+    }
+    template <int N> static u16x8 shr_u16(u16x8 a) {
+        return {wasm_u16x8_shr(a.v, N)};
+    }
+    template <int N> static u16x8 shl_u16(u16x8 a) {
+        return {wasm_i16x8_shl(a.v, N)};
+    }
+    static u16x8 widen_lo_u8(u8x16 a) {
+        return {wasm_u16x8_extend_low_u8x16(a.v)};
+    }
+    static u16x8 widen_hi_u8(u8x16 a) {
+        return {wasm_u16x8_extend_high_u8x16(a.v)};
+    }
+    static u8x16 narrow_u16(u16x8 lo, u16x8 hi) {
+        return {wasm_u8x16_narrow_i16x8(lo.v, hi.v)};
+    }
+
+    // i32x4
+    static i32x4 load_i32x4(const fl::i32 *p) { return {wasm_v128_load(p)}; }
+    static void store(fl::i32 *p, i32x4 a) { wasm_v128_store(p, a.v); }
+    static i32x4 splat_i32(fl::i32 x) { return {wasm_i32x4_splat(x)}; }
+    static i32x4 add_i32(i32x4 a, i32x4 b) {
+        return {wasm_i32x4_add(a.v, b.v)};
+    }
+    static i32x4 sub_i32(i32x4 a, i32x4 b) {
+        return {wasm_i32x4_sub(a.v, b.v)};
+    }
+    static i32x4 mullo_i32(i32x4 a, i32x4 b) {
+        return {wasm_i32x4_mul(a.v, b.v)};
+    }
+    template <int N> static i32x4 sra_i32(i32x4 a) {
+        return {wasm_i32x4_shr(a.v, N)};
+    }
+    template <int N> static i32x4 shl_i32(i32x4 a) {
+        return {wasm_i32x4_shl(a.v, N)};
+    }
+    static i32x4 min_i32(i32x4 a, i32x4 b) {
+        return {wasm_i32x4_min(a.v, b.v)};
+    }
+    static i32x4 max_i32(i32x4 a, i32x4 b) {
+        return {wasm_i32x4_max(a.v, b.v)};
+    }
+};
+
+} // namespace simd
+} // namespace fl
@@ -40,4 +40,33 @@ Tile2x2_u8 splat(vec2f xy) {
     return out;
 }
 
+// Q16 weight in [0, 65536] to [0..255], rounded like to_uint8().
+static u8 splat_q16_to_uint8(u32 w) { return u8((w * 255 + 0x8000) >> 16); }
+
+Tile2x2_u8 splat(vec2q16 xy) {
+    // 1) integer cell indices, floor for negative values too.
+    i16 cx = static_cast<i16>(xy.x.to_int());
+    i16 cy = static_cast<i16>(xy.y.to_int());
+
+    // 2) fractional offsets in [0..65535]
+    u32 fx = xy.x.frac();
+    u32 fy = xy.y.frac();
+
+    // 3) bilinear weights, expanded so no product overflows 32 bits:
+    //    (1 - fx) * (1 - fy) == 1 - fx - fy + fx * fy
+    u32 w_ur = (fx * fy) >> 16;
+    u32 w_lr = fx - w_ur;
+    u32 w_ul = fy - w_ur;
+    u32 w_ll = 0x10000 - fx - fy + w_ur;
+
+    // 4) build Tile2x2_u8 anchored at (cx,cy)
+    Tile2x2_u8 out(vec2<i16>(cx, cy));
+    out.lower_left() = splat_q16_to_uint8(w_ll);
+    out.lower_right() = splat_q16_to_uint8(w_lr);
+    out.upper_left() = splat_q16_to_uint8(w_ul);
+    out.upper_right() = splat_q16_to_uint8(w_ur);
+
+    return out;
+}
+
 }  // namespace
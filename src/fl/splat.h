@@ -11,6 +11,7 @@ Each of the four pixels in the tile is a fl::u8 value in the range
 #include "fl/tile2x2.h"
 #include "fl/int.h"
 #include "fl/geometry.h"
+#include "fl/q16.h"
 
 namespace fl {
 
@@ -23,4 +24,8 @@ namespace fl {
 
 Tile2x2_u8 splat(vec2f xy);
 
+/// Same as splat(vec2f) in fixed point, integer math only. Weights can
+/// differ from the float version by one count from rounding.
+Tile2x2_u8 splat(vec2q16 xy);
+
 } // namespace fl
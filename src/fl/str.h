@@ -191,7 +191,9 @@ template <fl::size SIZE = FASTLED_STR_INLINED_SIZE> class StrN {
     void copy(const char *str, fl::size len) {
         mLength = len;
         if (len + 1 <= SIZE) {
-            memcpy(mInlineData, str, len + 1);
+            // str may be a slice of a longer string, terminate it here.
+            memcpy(mInlineData, str, len);
+            mInlineData[len] = '\0';
             mHeapData.reset();
         } else {
             mHeapData = fl::make_intrusive<StringHolder>(str, len);
@@ -16,6 +16,14 @@
 #endif
 
 #ifdef FASTLED_STUB_MAIN_INCLUDE_INO
+#ifdef FASTLED_SKETCH_RUNNER
+// Sketches get Arduino.h implicitly on device, use the emulation from wasm.
+#include "platforms/wasm/compiler/Arduino.h"
+SerialEmulation Serial;
+SerialEmulation Serial1;
+SerialEmulation Serial2;
+SerialEmulation Serial3;
+#endif
 // Correctly include the file by expanding and stringifying the macro value
 #include _FASTLED_STRINGIFY(FASTLED_STUB_MAIN_INCLUDE_INO)
 #else
@@ -25,6 +33,45 @@ void loop() {}
 
 #include <iostream>  // ok include
 
+#ifdef FASTLED_SKETCH_RUNNER
+// Headless runner: sketch [--loops N] [--frame-us US] [--video out.rgb]
+// Runs the sketch on the virtual clock and prints the timing report as json.
+#include <stdio.h>   // ok include
+#include <stdlib.h>  // ok include
+#include <string.h>  // ok include
+
+#include "platforms/stub/sketch_runner.h"
+
+int main(int argc, char **argv) {
+    unsigned long loops = 600;
+    unsigned long frame_us = 16667;
+    const char *video = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "--loops") && has_value) {
+            loops = strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--frame-us") && has_value) {
+            frame_us = strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--video") && has_value) {
+            video = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--loops N] [--frame-us US] [--video out.rgb]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    fl::SketchRunner runner([]() { setup(); }, []() { loop(); });
+    runner.setFrameMicros(fl::u32(frame_us));
+    runner.setCapture(video != nullptr);
+    runner.run(fl::u32(loops));
+    printf("%s\n", runner.reportJson().c_str());
+    if (video && !runner.writeVideo(video)) {
+        return 1;
+    }
+    return 0;
+}
+#else
 int main() {
     // Super simple main function that just calls the setup and loop functions.
     setup();
@@ -32,4 +79,5 @@ int main() {
         loop();
     }
 }
+#endif // FASTLED_SKETCH_RUNNER
 #endif // FASTLED_STUB_MAIN_INCLUDE_INO
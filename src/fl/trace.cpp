@@ -0,0 +1,243 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "FastLED.h"
+
+#include "fl/atomic.h"
+#include "fl/mutex.h"
+#include "fl/singleton.h"
+#include "fl/strstream.h"
+#include "fl/thread_local.h"
+#include "fl/trace.h"
+#include "fl/vector.h"
+
+#if defined(ESP32) && defined(__XTENSA__)
+#define FL_TRACE_CYCLES 1
+#define FL_TRACE_CCOUNT 1
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                \
+    defined(__ARM_ARCH_8M_MAIN__)
+#define FL_TRACE_CYCLES 1
+#define FL_TRACE_DWT 1
+#else
+#define FL_TRACE_CYCLES 0
+#endif
+
+namespace fl {
+
+// Single writer ring. The owning thread is the only one that pushes. Each
+// slot is a small seqlock: its sequence is odd while the owner rewrites it
+// and 2 * (index + 1) once event `index` is complete. Readers copy a slot and
+// keep it only if the sequence was that same even value before and after,
+// so an event overwritten or still being written is never exported.
+class TraceRing {
+  public:
+    explicit TraceRing(fl::u32 tid) : mTid(tid) {}
+
+    void push(const char *name, fl::u32 begin, fl::u32 end) {
+        const fl::u32 head = mHead.load(fl::memory_order_relaxed);
+        Slot &s = mSlots[head % FASTLED_TRACE_RING_SIZE];
+        s.seq.store(2 * head + 1, fl::memory_order_relaxed);
+        fl::atomic_thread_fence(fl::memory_order_release);
+        s.name.store(name, fl::memory_order_relaxed);
+        s.begin.store(begin, fl::memory_order_relaxed);
+        s.duration.store(end - begin, fl::memory_order_relaxed);
+        s.seq.store(2 * (head + 1), fl::memory_order_release);
+        mHead.store(head + 1, fl::memory_order_release);
+    }
+
+    fl::u32 head() const { return mHead.load(fl::memory_order_acquire); }
+    // First index still held.
+    fl::u32 first(fl::u32 head) const {
+        const fl::u32 tail = mTail.load();
+        const fl::u32 oldest =
+            head > FASTLED_TRACE_RING_SIZE ? head - FASTLED_TRACE_RING_SIZE : 0;
+        return tail > oldest ? tail : oldest;
+    }
+    // Copies event i. False if the owner has overwritten it or is doing so.
+    bool read(fl::u32 i, TraceEvent *out) const {
+        const Slot &s = mSlots[i % FASTLED_TRACE_RING_SIZE];
+        const fl::u32 expected = 2 * (i + 1);
+        if (s.seq.load(fl::memory_order_acquire) != expected) {
+            return false;
+        }
+        out->name = s.name.load(fl::memory_order_relaxed);
+        out->begin = s.begin.load(fl::memory_order_relaxed);
+        out->duration = s.duration.load(fl::memory_order_relaxed);
+        fl::atomic_thread_fence(fl::memory_order_acquire);
+        return s.seq.load(fl::memory_order_relaxed) == expected;
+    }
+    void clear() { mTail.store(mHead.load()); }
+    fl::u32 tid() const { return mTid; }
+
+  private:
+    struct Slot {
+        fl::atomic_u32 seq{0};
+        fl::atomic<const char *> name{nullptr};
+        fl::atomic_u32 begin{0};
+        fl::atomic_u32 duration{0};
+    };
+
+    Slot mSlots[FASTLED_TRACE_RING_SIZE];
+    fl::atomic_u32 mHead{0};
+    fl::atomic_u32 mTail{0};
+    fl::u32 mTid;
+};
+
+namespace {
+
+// Rings are never freed so that events of threads that exited can still be
+// exported.
+struct TraceRegistry {
+    fl::mutex mutex;
+    fl::vector<TraceRing *> rings;
+    fl::ThreadLocal<TraceRing *> local;
+};
+
+TraceRegistry &trace_registry() { return Singleton<TraceRegistry>::instance(); }
+
+struct TraceExportEvent {
+    TraceEvent event;
+    fl::u32 tid;
+};
+
+// Microseconds with three decimals when the ticks are cpu cycles.
+void trace_append_micros(fl::StrStream &out, fl::u32 ticks, fl::u32 rate) {
+    out << (ticks / rate);
+    if (rate > 1) {
+        const fl::u32 frac = (ticks % rate) * 1000 / rate;
+        out << "." << (frac < 100 ? "0" : "") << (frac < 10 ? "0" : "")
+            << frac;
+    }
+}
+
+} // namespace
+
+Tracer &Tracer::instance() { return Singleton<Tracer>::instance(); }
+
+Tracer::Tracer() {
+#if FL_TRACE_DWT
+    // Enable the DWT cycle counter: DEMCR.TRCENA, then DWT_CTRL.CYCCNTENA.
+    *reinterpret_cast<volatile fl::u32 *>(0xE000EDFC) |= (1u << 24);
+    *reinterpret_cast<volatile fl::u32 *>(0xE0001000) |= 1u;
+#endif
+}
+
+fl::u32 Tracer::ticks() {
+#if FL_TRACE_CCOUNT
+    fl::u32 ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#elif FL_TRACE_DWT
+    return *reinterpret_cast<volatile fl::u32 *>(0xE0001004);
+#else
+    return ::micros();
+#endif
+}
+
+fl::u32 Tracer::ticksPerMicro() {
+#if FL_TRACE_CYCLES && defined(F_CPU)
+    return fl::u32(F_CPU / 1000000L);
+#elif FL_TRACE_CYCLES && defined(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+    return CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+#else
+    return 1;
+#endif
+}
+
+TraceRing *Tracer::localRing() {
+    TraceRegistry &reg = trace_registry();
+    TraceRing *&ring = reg.local.access();
+    if (!ring) {
+        fl::lock_guard<fl::mutex> lock(reg.mutex);
+        ring = new TraceRing(fl::u32(reg.rings.size()));
+        reg.rings.push_back(ring);
+    }
+    return ring;
+}
+
+void Tracer::record(const char *name, fl::u32 begin, fl::u32 end) {
+    if (!mEnabled) {
+        return;
+    }
+    localRing()->push(name, begin, end);
+}
+
+fl::size Tracer::numEvents() const {
+    TraceRegistry &reg = trace_registry();
+    fl::lock_guard<fl::mutex> lock(reg.mutex);
+    fl::size n = 0;
+    for (TraceRing *ring : reg.rings) {
+        const fl::u32 head = ring->head();
+        n += head - ring->first(head);
+    }
+    return n;
+}
+
+fl::u32 Tracer::numRecorded() const {
+    TraceRegistry &reg = trace_registry();
+    fl::lock_guard<fl::mutex> lock(reg.mutex);
+    fl::u32 n = 0;
+    for (TraceRing *ring : reg.rings) {
+        n += ring->head();
+    }
+    return n;
+}
+
+void Tracer::clear() {
+    TraceRegistry &reg = trace_registry();
+    fl::lock_guard<fl::mutex> lock(reg.mutex);
+    for (TraceRing *ring : reg.rings) {
+        ring->clear();
+    }
+}
+
+void Tracer::writeChromeTrace(const Writer &write) const {
+    fl::vector<TraceExportEvent> events;
+    {
+        TraceRegistry &reg = trace_registry();
+        fl::lock_guard<fl::mutex> lock(reg.mutex);
+        for (TraceRing *ring : reg.rings) {
+            const fl::u32 head = ring->head();
+            TraceExportEvent e;
+            e.tid = ring->tid();
+            for (fl::u32 i = ring->first(head); i != head; ++i) {
+                // Skips what the owner lapped while we copied.
+                if (ring->read(i, &e.event)) {
+                    events.push_back(e);
+                }
+            }
+        }
+    }
+    // Oldest begin as time zero, wrap safe as long as the trace is shorter
+    // than half the counter range.
+    fl::u32 origin = events.empty() ? 0 : events[0].event.begin;
+    for (const TraceExportEvent &e : events) {
+        if (i32(e.event.begin - origin) < 0) {
+            origin = e.event.begin;
+        }
+    }
+    const fl::u32 rate = ticksPerMicro();
+    write("{\"traceEvents\":[");
+    bool first = true;
+    for (const TraceExportEvent &e : events) {
+        fl::StrStream line;
+        line << (first ? "" : ",") << "{\"name\":\"" << e.event.name
+             << "\",\"ph\":\"X\",\"ts\":";
+        trace_append_micros(line, e.event.begin - origin, rate);
+        line << ",\"dur\":";
+        trace_append_micros(line, e.event.duration, rate);
+        line << ",\"pid\":1,\"tid\":" << e.tid << "}";
+        write(line.c_str());
+        first = false;
+    }
+    write("],\"displayTimeUnit\":\"ms\"}");
+}
+
+fl::string Tracer::chromeTraceJson() const {
+    fl::string out;
+    writeChromeTrace([&out](const char *piece) { out.append(piece); });
+    return out;
+}
+
+} // namespace fl
@@ -0,0 +1,120 @@
+#pragma once
+
+/*
+Scoped tracing for the frame path.
+
+    void MyFx::draw(DrawContext ctx) {
+        FL_TRACE_SCOPE("myfx.draw");
+        ...
+    }
+
+Each scope records its name, start and duration into a ring buffer. The
+library has scopes on show(), Fx draw, the compositor, XY remap, power
+calculation, controller encode, EngineEvents dispatch, the idle slice and
+the json UI. Export the last events with Tracer::writeChromeTrace() and load
+the output in chrome://tracing or https://ui.perfetto.dev. On devices the
+JsonConsole command "trace" prints the same json over serial.
+
+Defines:
+    FASTLED_TRACE            - 1 compiles the scopes in. Default 0, then
+                               FL_TRACE_SCOPE expands to nothing.
+    FASTLED_TRACE_RING_SIZE  - Events kept per thread (native) or in total
+                               (single threaded targets).
+
+Native builds keep one ring per thread, written only by its own thread, so
+recording takes no lock. Timestamps are micros(). On ESP32 (Xtensa) and
+Cortex-M3 and up the timestamps are cpu cycles, converted when exported.
+Names must be string literals or otherwise outlive the tracer.
+*/
+
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "fl/sketch_macros.h"
+#include "fl/str.h"
+
+#ifndef FASTLED_TRACE
+#define FASTLED_TRACE 0
+#endif
+
+#ifndef FASTLED_TRACE_RING_SIZE
+#if SKETCH_HAS_LOTS_OF_MEMORY
+#define FASTLED_TRACE_RING_SIZE 4096
+#else
+#define FASTLED_TRACE_RING_SIZE 128
+#endif
+#endif
+
+#define FL_TRACE_CONCAT_INNER(A, B) A##B
+#define FL_TRACE_CONCAT(A, B) FL_TRACE_CONCAT_INNER(A, B)
+
+#if FASTLED_TRACE
+#define FL_TRACE_SCOPE(NAME)                                                   \
+    fl::TraceScope FL_TRACE_CONCAT(fl_trace_scope_, __LINE__)(NAME)
+#else
+#define FL_TRACE_SCOPE(NAME) (void)0
+#endif
+
+namespace fl {
+
+struct TraceEvent {
+    const char *name;
+    fl::u32 begin;    // Ticks, see Tracer::ticksPerMicro().
+    fl::u32 duration; // Ticks.
+};
+
+class TraceRing;
+
+class Tracer {
+  public:
+    // Receives the export in pieces, one per event. Concatenated they are
+    // the json document.
+    using Writer = fl::function<void(const char *)>;
+
+    static Tracer &instance();
+
+    // Raw timestamp source and its rate.
+    static fl::u32 ticks();
+    static fl::u32 ticksPerMicro();
+
+    // Recording is on by default when FASTLED_TRACE is set.
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+    bool enabled() const { return mEnabled; }
+
+    void record(const char *name, fl::u32 begin, fl::u32 end);
+
+    // Events currently held by all rings.
+    fl::size numEvents() const;
+    // Total recorded, including the ones the rings already dropped.
+    fl::u32 numRecorded() const;
+    void clear();
+
+    // Chrome trace event format: {"traceEvents":[{"name":..,"ph":"X",
+    // "ts":..,"dur":..,"pid":1,"tid":..},..]}. Timestamps in microseconds,
+    // relative to the oldest event.
+    void writeChromeTrace(const Writer &write) const;
+    fl::string chromeTraceJson() const;
+
+    Tracer();
+
+  private:
+    TraceRing *localRing();
+
+    bool mEnabled = true;
+};
+
+class TraceScope {
+  public:
+    explicit TraceScope(const char *name)
+        : mName(name), mBegin(Tracer::ticks()) {}
+    ~TraceScope() { Tracer::instance().record(mName, mBegin, Tracer::ticks()); }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+  private:
+    const char *mName;
+    fl::u32 mBegin;
+};
+
+} // namespace fl
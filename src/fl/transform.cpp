@@ -157,6 +157,45 @@ Matrix3x3f TransformFloat::compile() const {
     return out;
 }
 
+TransformQ16 TransformQ16::From(const TransformFloat &tx) {
+    TransformQ16 out;
+    out.scale_x = q16::from_float(tx.scale_x());
+    out.scale_y = q16::from_float(tx.scale_y());
+    out.offset_x = q16::from_float(tx.offset_x());
+    out.offset_y = q16::from_float(tx.offset_y());
+    out.set_rotation(q16::from_float(tx.rotation()));
+    return out;
+}
+
+void TransformQ16::set_rotation(q16 turns) {
+    mRotation = turns;
+    const u32 angle = turns_to_angle(turns);
+    mCos = cos_q16(angle);
+    mSin = sin_q16(angle);
+}
+
+bool TransformQ16::is_identity() const {
+    return scale_x == 1 && scale_y == 1 && offset_x == 0 && offset_y == 0 &&
+           mRotation == 0;
+}
+
+vec2q16 TransformQ16::transform(const vec2q16 &xy) const {
+    q16 x = xy.x;
+    q16 y = xy.y;
+    if (scale_x != 1) {
+        x *= scale_x;
+    }
+    if (scale_y != 1) {
+        y *= scale_y;
+    }
+    x += offset_x;
+    y += offset_y;
+    if (mRotation != 0) {
+        return vec2q16(x * mCos - y * mSin, x * mSin + y * mCos);
+    }
+    return vec2q16(x, y);
+}
+
 } // namespace fl
 
 FL_DISABLE_WARNING_POP
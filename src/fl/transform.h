@@ -11,6 +11,7 @@ expensive trig functions are needed. Same with scale and offset.
 #include "fl/lut.h"
 #include "fl/math_macros.h"
 #include "fl/memory.h"
+#include "fl/q16.h"
 #include "fl/xymap.h"
 #include "lib8tion/types.h"
 
@@ -21,6 +22,19 @@ FASTLED_SMART_PTR(TransformFloatImpl);
 using alpha16 =
     u16; // fixed point representation of 0->1 in the range [0, 65535]
 
+// Rounds a float alpha to alpha16. Values outside [0, 1] are clamped, a
+// float out of the u16 range would otherwise convert with undefined
+// behaviour.
+inline alpha16 alpha16_from_float(float alpha) {
+    if (!(alpha > 0.0f)) {
+        return 0;
+    }
+    if (alpha >= 1.0f) {
+        return 65535;
+    }
+    return alpha16(alpha * 65535.0f + 0.5f);
+}
+
 // This transform assumes the coordinates are in the range [0,65535].
 struct Transform16 {
     // Make a transform that maps a rectangle to the given bounds from
@@ -139,4 +153,28 @@ struct TransformFloat {
     mutable Matrix3x3f mCompiled; // future use.
 };
 
+// Fixed point twin of TransformFloat for targets without an FPU, see q16.h.
+// Same parameters and the same order: scale, then offset, then rotation.
+// Build one per draw with From(), not per point, the conversion is float.
+struct TransformQ16 {
+    static TransformQ16 From(const TransformFloat &tx);
+
+    q16 scale_x = 1;
+    q16 scale_y = 1;
+    q16 offset_x = 0;
+    q16 offset_y = 0;
+
+    // rotation range is [0,1], not [0,2*PI]! Caches the sin and cos.
+    void set_rotation(q16 turns);
+    q16 rotation() const { return mRotation; }
+
+    vec2q16 transform(const vec2q16 &xy) const;
+    bool is_identity() const;
+
+  private:
+    q16 mRotation = 0;
+    q16 mCos = 1;
+    q16 mSin = 0;
+};
+
 } // namespace fl
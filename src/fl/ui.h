@@ -522,6 +522,29 @@ class UIDropdown : public UIElement {
     fl::unique_ptr<Button> mNextButton;
 };
 
+// Shows fl::FrameStats (fps, jitter, frame time percentiles and the per
+// phase breakdown) in the UI, refreshed every intervalMs.
+class UIFrameStats : public UIElement {
+  public:
+    FL_NO_COPY(UIFrameStats);
+    UIFrameStats(const char *name, fl::u32 intervalMs = 1000)
+        : mImpl(name, intervalMs) {}
+    ~UIFrameStats() {}
+
+    void setInterval(fl::u32 intervalMs) { mImpl.setInterval(intervalMs); }
+    fl::u32 interval() const { return mImpl.interval(); }
+
+    // Override setGroup to also update the implementation
+    void setGroup(const fl::string& groupName) override { 
+        UIElement::setGroup(groupName); 
+        // Update the implementation's group if it has the method (WASM platforms)
+        mImpl.setGroup(groupName);
+    }
+
+  protected:
+    UIFrameStatsImpl mImpl;
+};
+
 class UIGroup {
   public:
     FL_NO_COPY(UIGroup);
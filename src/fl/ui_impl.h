@@ -44,6 +44,10 @@
 #define FASTLED_HAS_UI_DROPDOWN 0
 #endif
 
+#ifndef FASTLED_HAS_UI_FRAME_STATS
+#define FASTLED_HAS_UI_FRAME_STATS 0
+#endif
+
 namespace fl {
 
 // If the platform is missing ui components, provide stubs.
@@ -354,6 +358,28 @@ class UIDropdownImpl {
 };
 #endif
 
+#if !FASTLED_HAS_UI_FRAME_STATS
+
+class UIFrameStatsImpl {
+  public:
+    UIFrameStatsImpl(const char *name, fl::u32 intervalMs = 1000)
+        : mIntervalMs(intervalMs) {
+        FASTLED_UNUSED(name);
+    }
+    ~UIFrameStatsImpl() {}
+
+    void setInterval(fl::u32 intervalMs) { mIntervalMs = intervalMs; }
+    fl::u32 interval() const { return mIntervalMs; }
+
+    // Stub method for group setting (does nothing on non-WASM platforms)
+    void setGroup(const fl::string& groupName) { FASTLED_UNUSED(groupName); }
+
+  private:
+    fl::u32 mIntervalMs;
+};
+
+#endif
+
 #ifndef FASTLED_HAS_UI_GROUP
 #define FASTLED_HAS_UI_GROUP 0
 #endif
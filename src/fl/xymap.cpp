@@ -6,10 +6,174 @@
 #include "fl/force_inline.h"
 #include "fl/namespace.h"
 #include "fl/screenmap.h"
+#include "fl/trace.h"
 #include "fl/xymap.h"
+#include "fl/blob_cache.h"
+#include "fl/hash.h"
+#include "fl/hash_map.h"
+#include "fl/memory_budget.h"
+#include "fl/mutex.h"
+#include "fl/singleton.h"
 
 namespace fl {
 
+namespace {
+
+// Identifies a table. Built in layouts are fully described by their type,
+// size and function; user tables by their size and a hash of the contents,
+// checked with XYMapLUT::equals() before sharing.
+struct XYMapLUTKey {
+    u8 type = 0;
+    u16 width = 0;
+    u16 height = 0;
+    uintptr_t function = 0;
+    u32 contentHash = 0;
+
+    bool operator==(const XYMapLUTKey &o) const {
+        return type == o.type && width == o.width && height == o.height &&
+               function == o.function && contentHash == o.contentHash;
+    }
+    bool operator!=(const XYMapLUTKey &o) const { return !(*this == o); }
+};
+
+struct XYMapLUTKeyHash {
+    u32 operator()(const XYMapLUTKey &key) const {
+        u32 words[5] = {key.type, u32(key.width) << 16 | key.height,
+                        u32(key.function), u32(u64(key.function) >> 32),
+                        key.contentHash};
+        return MurmurHash3_x86_32(words, sizeof(words));
+    }
+};
+
+class XYMapLUTRegistry {
+  public:
+    // The live table for key, or the one from build() when there is none.
+    template <typename BuildFn>
+    XYMapLUTPtr find(const XYMapLUTKey &key, BuildFn build) {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        XYMapLUTPtr table;
+        if (auto existing = mTables.find_value(key)) {
+            table = existing->lock();
+        }
+        if (!table) {
+            pruneExpired();
+            table = build();
+            mTables.insert(key, table);
+        }
+        return table;
+    }
+
+    // User tables, shared only when the contents really match.
+    XYMapLUTPtr internData(const XYMapLUTKey &key, const u16 *data, u32 n) {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        if (auto existing = mTables.find_value(key)) {
+            if (auto table = existing->lock()) {
+                if (table->equals(data, n)) {
+                    return table;
+                }
+                // Hash collision, keep the registered one and don't share.
+                return fl::make_intrusive<XYMapLUT>(data, n);
+            }
+        }
+        pruneExpired();
+        XYMapLUTPtr table = fl::make_intrusive<XYMapLUT>(data, n);
+        mTables.insert(key, table);
+        return table;
+    }
+
+    fl::size liveCount() {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        fl::size live = 0;
+        for (auto entry : mTables) {
+            if (entry.second.lock()) {
+                ++live;
+            }
+        }
+        return live;
+    }
+
+    fl::size registeredCount() {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        return mTables.size();
+    }
+
+  private:
+    // Drops the keys of freed tables, so the map doesn't grow with every
+    // geometry ever used. Only runs when a table is added.
+    void pruneExpired() {
+        mExpired.clear();
+        for (auto entry : mTables) {
+            if (entry.second.expired()) {
+                mExpired.push_back(entry.first);
+            }
+        }
+        for (const XYMapLUTKey &key : mExpired) {
+            mTables.erase(key);
+        }
+    }
+
+    fl::mutex mMutex;
+    fl::vector<XYMapLUTKey> mExpired;
+    fl::hash_map<XYMapLUTKey, fl::WeakPtr<XYMapLUT>, XYMapLUTKeyHash>
+        mTables;
+};
+
+XYMapLUTRegistry &xymap_lut_registry() {
+    return Singleton<XYMapLUTRegistry>::instance();
+}
+
+// Index for a built in layout, without the offset.
+u16 xymap_raw_index(XYMap::XyMapType type, XYFunction fn, u16 x, u16 y,
+                    u16 width, u16 height) {
+    if (type == XYMap::kSerpentine) {
+        return xy_serpentine(x % width, y % height, width, height);
+    }
+    if (type == XYMap::kLineByLine) {
+        return xy_line_by_line(x % width, y % height, width, height);
+    }
+    if (type == XYMap::kFunction) {
+        return fn(x, y, width, height);
+    }
+    return 0;
+}
+
+} // namespace
+
+XYMapLUT::XYMapLUT(const u16 *indices, u32 size) : mSize(size) {
+    MemScope scope(MemCategory::kXYMap);
+    u16 highest = 0;
+    for (u32 i = 0; i < size; ++i) {
+        highest = MAX(highest, indices[i]);
+    }
+    if (highest < 256) {
+        mNarrow.resize(size);
+        for (u32 i = 0; i < size; ++i) {
+            mNarrow[i] = u8(indices[i]);
+        }
+    } else {
+        mWide.resize(size);
+        memcpy(mWide.data(), indices, size * sizeof(u16));
+    }
+}
+
+bool XYMapLUT::equals(const u16 *indices, u32 size) const {
+    if (size != mSize) {
+        return false;
+    }
+    for (u32 i = 0; i < size; ++i) {
+        if (at(i) != indices[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+fl::size XYMapLUT::liveCount() { return xymap_lut_registry().liveCount(); }
+
+fl::size XYMapLUT::registeredCount() {
+    return xymap_lut_registry().registeredCount();
+}
+
 ScreenMap XYMap::toScreenMap() const {
     const u16 length = width * height;
     ScreenMap out(length);
@@ -42,9 +206,13 @@ XYMap XYMap::constructWithLookUpTable(u16 width, u16 height,
                                       const u16 *lookUpTable,
                                       u16 offset) {
     XYMap out(width, height, kLookUpTable);
-    out.mLookUpTable = fl::make_intrusive<LUT16>(width * height);
-    memcpy(out.mLookUpTable->getDataMutable(), lookUpTable,
-           width * height * sizeof(u16));
+    const u32 n = u32(width) * height;
+    XYMapLUTKey key;
+    key.type = kLookUpTable;
+    key.width = width;
+    key.height = height;
+    key.contentHash = MurmurHash3_x86_32(lookUpTable, n * sizeof(u16));
+    out.setLookUpTable(xymap_lut_registry().internData(key, lookUpTable, n));
     out.mOffset = offset;
     return out;
 }
@@ -59,9 +227,32 @@ XYMap XYMap::constructSerpentine(u16 width, u16 height,
 XYMap::XYMap(u16 width, u16 height, bool is_serpentine,
              u16 offset)
     : type(is_serpentine ? kSerpentine : kLineByLine), width(width),
-      height(height), mOffset(offset) {}
+      height(height), mTable(nullptr), mOffset(offset) {}
+
+XYMap::XYMap(const XYMap &other) : mTable(nullptr) { *this = other; }
+
+XYMap &XYMap::operator=(const XYMap &other) {
+    if (this == &other) {
+        return *this;
+    }
+    type = other.type;
+    mLutSource = other.mLutSource;
+    width = other.width;
+    height = other.height;
+    xyFunction = other.xyFunction;
+    mOffset = other.mOffset;
+    // An unbuilt table is found again in the registry on first use.
+    setLookUpTable(other.mLookUpTable);
+    return *this;
+}
+
+void XYMap::setLookUpTable(const XYMapLUTPtr &table) {
+    mLookUpTable = table;
+    mTable = table.get();
+}
 
 void XYMap::mapPixels(const CRGB *input, CRGB *output) const {
+    FL_TRACE_SCOPE("xymap.remap");
     u16 pos = 0;
     for (u16 y = 0; y < height; y++) {
         for (u16 x = 0; x < width; x++) {
@@ -75,21 +266,80 @@ void XYMap::convertToLookUpTable() {
     if (type == kLookUpTable) {
         return;
     }
-    mLookUpTable = fl::make_intrusive<LUT16>(width * height);
-    u16 *data = mLookUpTable->getDataMutable();
-    for (u16 y = 0; y < height; y++) {
-        for (u16 x = 0; x < width; x++) {
-            data[y * width + x] = mapToIndex(x, y);
+    // Built by buildLookUpTable() when first used.
+    mLutSource = type;
+    type = kLookUpTable;
+}
+
+const XYMapLUT *XYMap::lookUpTable() const {
+    return mTable ? mTable : buildLookUpTable();
+}
+
+const XYMapLUT *XYMap::buildLookUpTable() const {
+    MemScope scope(MemCategory::kXYMap);
+    XYMapLUTKey key;
+    key.type = u8(mLutSource);
+    key.width = width;
+    key.height = height;
+    key.function = reinterpret_cast<uintptr_t>(xyFunction);
+    const XyMapType source = mLutSource;
+    const XYFunction fn = xyFunction;
+    const u16 w = width;
+    const u16 h = height;
+    auto build = [&]() {
+        fl::vector<u16> indices(u32(w) * h);
+        for (u16 y = 0; y < h; y++) {
+            for (u16 x = 0; x < w; x++) {
+                indices[u32(y) * w + x] = xymap_raw_index(source, fn, x, y, w, h);
+            }
         }
+        return fl::make_intrusive<XYMapLUT>(indices.data(), u32(indices.size()));
+    };
+    mLookUpTable = xymap_lut_registry().find(key, build);
+    mTable = mLookUpTable.get();
+    return mTable;
+}
+
+XYMapLUTPtr XYMap::getLookUpTable() const {
+    if (type != kLookUpTable) {
+        return XYMapLUTPtr();
+    }
+    lookUpTable();
+    return mLookUpTable;
+}
+
+void XYMap::convertToLookUpTable(BlobCache &cache, u32 salt) {
+    if (type == kLookUpTable) {
+        return;
     }
+    // Version 2: the table holds indices without the offset.
+    BlobCacheKey key("xymap", 2);
+    key.add(width).add(height).add(u8(type)).add(mOffset).add(salt);
+    const u32 n = u32(width) * height;
+    fl::vector<u16> indices(n);
+    u16 *data = indices.data();
+    cache.loadOrCompute(key, data, n * sizeof(u16), [&]() {
+        for (u16 y = 0; y < height; y++) {
+            for (u16 x = 0; x < width; x++) {
+                data[y * width + x] =
+                    xymap_raw_index(type, xyFunction, x, y, width, height);
+            }
+        }
+    });
+    XYMapLUTKey lutKey;
+    lutKey.type = kLookUpTable;
+    lutKey.width = width;
+    lutKey.height = height;
+    lutKey.contentHash = MurmurHash3_x86_32(data, n * sizeof(u16));
+    setLookUpTable(xymap_lut_registry().internData(lutKey, data, n));
+    mLutSource = type;
     type = kLookUpTable;
-    xyFunction = nullptr;
 }
 
 void XYMap::setRectangularGrid() {
     type = kLineByLine;
     xyFunction = nullptr;
-    mLookUpTable.reset();
+    setLookUpTable(XYMapLUTPtr());
 }
 
 u16 XYMap::mapToIndex(const u16 &x, const u16 &y) const {
@@ -111,7 +361,7 @@ u16 XYMap::mapToIndex(const u16 &x, const u16 &y) const {
         index = xyFunction(x, y, width, height);
         break;
     case kLookUpTable:
-        index = mLookUpTable->getData()[y * width + x];
+        index = lookUpTable()->at(u32(y) * width + x);
         break;
     default:
         return 0;
@@ -128,6 +378,6 @@ u16 XYMap::getTotal() const { return width * height; }
 XYMap::XyMapType XYMap::getType() const { return type; }
 
 XYMap::XYMap(u16 width, u16 height, XyMapType type)
-    : type(type), width(width), height(height), mOffset(0) {}
+    : type(type), width(width), height(height), mTable(nullptr), mOffset(0) {}
 
 } // namespace fl
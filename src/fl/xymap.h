@@ -10,9 +10,11 @@
 #include "fl/clamp.h"
 #include "fl/lut.h"
 #include "fl/memory.h"
+#include "fl/vector.h"
 #include "fl/xmap.h" // Include xmap.h for LUT16
 
 namespace fl {
+class BlobCache;
 class ScreenMap;
 
 FASTLED_FORCE_INLINE u16 xy_serpentine(u16 x, u16 y,
@@ -35,6 +37,36 @@ FASTLED_FORCE_INLINE u16 xy_line_by_line(u16 x, u16 y,
 typedef u16 (*XYFunction)(u16 x, u16 y, u16 width,
                                u16 height);
 
+FASTLED_SMART_PTR(XYMapLUT);
+
+// Immutable x,y -> index table behind XYMap::convertToLookUpTable(). Tables
+// are interned, every XYMap with the same geometry shares one. Indices are
+// stored as u8 when they all fit, which halves the table for panels up to
+// 256 leds. The reference count is a plain int, so maps sharing a table
+// must be built, copied and destroyed on one thread.
+class XYMapLUT : public fl::Referent {
+  public:
+    XYMapLUT(const u16 *indices, u32 size);
+
+    u16 at(u32 i) const { return mNarrow.empty() ? mWide[i] : mNarrow[i]; }
+    u32 size() const { return mSize; }
+    bool isNarrow() const { return !mNarrow.empty(); }
+    fl::size bytes() const {
+        return mNarrow.size() + mWide.size() * sizeof(u16);
+    }
+    bool equals(const u16 *indices, u32 size) const;
+
+    // Tables currently alive in the intern registry.
+    static fl::size liveCount();
+    // Keys the registry holds, freed tables that weren't pruned yet included.
+    static fl::size registeredCount();
+
+  private:
+    u32 mSize;
+    fl::vector<u8> mNarrow;
+    fl::vector<u16> mWide;
+};
+
 // Maps x,y -> led index
 //
 // The common output led matrix you can buy on amazon is in a serpentine layout.
@@ -68,14 +100,22 @@ class XYMap {
     XYMap(u16 width, u16 height, bool is_serpentine = true,
           u16 offset = 0);
 
-    XYMap(const XYMap &other) = default;
-    XYMap &operator=(const XYMap &other) = default;
+    XYMap(const XYMap &other);
+    XYMap &operator=(const XYMap &other);
 
     fl::ScreenMap toScreenMap() const;
 
     void mapPixels(const CRGB *input, CRGB *output) const;
 
+    // Switches to a look up table. The table itself is built, or found in
+    // the shared tables, on the first mapToIndex() call.
     void convertToLookUpTable();
+    // Like convertToLookUpTable() but loads the table from the persistent
+    // cache when possible. For user functions the cache can't see the
+    // function itself, so pass a salt that changes whenever it changes.
+    void convertToLookUpTable(BlobCache &cache, u32 salt = 0);
+    // The shared table, built if it wasn't yet. Null unless isLUT().
+    XYMapLUTPtr getLookUpTable() const;
 
     void setRectangularGrid();
 
@@ -117,12 +157,22 @@ class XYMap {
 
   private:
     XYMap(u16 width, u16 height, XyMapType type);
+    // The table, built on the first call after convertToLookUpTable().
+    const XYMapLUT *lookUpTable() const;
+    const XYMapLUT *buildLookUpTable() const;
+    void setLookUpTable(const XYMapLUTPtr &table);
 
     XyMapType type;
+    // The layout a pending look up table is built from.
+    XyMapType mLutSource = kLookUpTable;
     u16 width;
     u16 height;
     XYFunction xyFunction = nullptr;
-    fl::LUT16Ptr mLookUpTable; // optional refptr to look up table.
+    // Shared table, filled in on first use after convertToLookUpTable().
+    // mTable is a plain copy of the pointer for the per pixel lookup. Not
+    // thread safe, like the rest of XYMap.
+    mutable XYMapLUTPtr mLookUpTable;
+    mutable const XYMapLUT *mTable;
     u16 mOffset = 0;      // offset to be added to the output
 };
 
@@ -9,6 +9,7 @@
 #include <math.h>
 
 #include "fl/assert.h"
+#include "fl/clamp.h"
 #include "fl/function.h"
 #include "fl/gradient.h"
 #include "fl/lut.h"
@@ -57,12 +58,24 @@ Tile2x2_u8 XYPath::at_subpixel(float alpha) {
     return mPathRenderer->at_subpixel(alpha);
 }
 
+vec2q16 XYPath::at_q16(alpha16 alpha) { return mPathRenderer->at_q16(alpha); }
+
+Tile2x2_u8 XYPath::at_subpixel_q16(alpha16 alpha) {
+    return mPathRenderer->at_subpixel_q16(alpha);
+}
+
 void XYPath::rasterize(float from, float to, int steps,
                        XYRasterU8Sparse &raster,
                        XYPath::AlphaFunction *optional_alpha_gen) {
     mPathRenderer->rasterize(from, to, steps, raster, optional_alpha_gen);
 }
 
+void XYPath::rasterize_q16(alpha16 from, alpha16 to, int steps,
+                           XYRasterU8Sparse &raster,
+                           XYPath::AlphaFunction *optional_alpha_gen) {
+    mPathRenderer->rasterize_q16(from, to, steps, raster, optional_alpha_gen);
+}
+
 vec2f XYPath::at(float alpha) { return mPathRenderer->at(alpha); }
 
 TransformFloat &XYPath::transform() { return mPathRenderer->transform(); }
@@ -77,6 +90,13 @@ XYPath::~XYPath() {}
 void XYPathRenderer::rasterize(
     float from, float to, int steps, XYRaster &raster,
     fl::function<u8(float)> *optional_alpha_gen) {
+#if FASTLED_GEOMETRY_Q16
+    if (mDrawBoundsSet) {
+        rasterize_q16(alpha16_from_float(from), alpha16_from_float(to), steps,
+                      raster, optional_alpha_gen);
+        return;
+    }
+#endif
     for (int i = 0; i < steps; ++i) {
         float alpha = fl::map_range<int, float>(i, 0, steps - 1, from, to);
         Tile2x2_u8 tile = at_subpixel(alpha);
@@ -89,6 +109,28 @@ void XYPathRenderer::rasterize(
     }
 }
 
+void XYPathRenderer::rasterize_q16(alpha16 from, alpha16 to, int steps,
+                                   XYRaster &raster,
+                                   fl::function<u8(float)> *optional_alpha_gen) {
+    if (!mDrawBoundsSet) {
+        FASTLED_WARN("XYPathRenderer::rasterize_q16: draw bounds not set");
+        return;
+    }
+    // Compile the transform once and step alpha in integers, the only float
+    // math left is for the optional alpha generator.
+    const TransformQ16 tx = TransformQ16::From(mTransform);
+    const i32 span = i32(to) - i32(from);
+    const i32 last = steps > 1 ? steps - 1 : 1;
+    for (int i = 0; i < steps; ++i) {
+        alpha16 a = alpha16(from + i32(i64(span) * i / last));
+        Tile2x2_u8 tile = splat_q16(a, tx);
+        if (optional_alpha_gen) {
+            tile.scale((*optional_alpha_gen)(a / 65535.0f));
+        }
+        raster.rasterize(tile);
+    }
+}
+
 void XYPathRenderer::setDrawBounds(u16 width, u16 height) {
     // auto &tx = *(mGridTransform.mImpl);
     auto &tx = mGridTransform;
@@ -110,6 +152,7 @@ void XYPathRenderer::setDrawBounds(u16 width, u16 height) {
 
     tx.set_scale_y((height - 1.0f) * 0.5f);
     tx.set_offset_y(height * 0.5f);
+    mGridTransformQ16 = TransformQ16::From(tx);
 
     onTransformFloatChanged();
     mDrawBoundsSet = true;
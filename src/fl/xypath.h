@@ -95,6 +95,10 @@ class XYPath : public Referent {
     virtual ~XYPath();
     vec2f at(float alpha);
     Tile2x2_u8 at_subpixel(float alpha);
+    // Fixed point versions, alpha in [0, 65535]. No float math per point for
+    // the built in paths, see q16.h and FASTLED_GEOMETRY_Q16.
+    vec2q16 at_q16(alpha16 alpha);
+    Tile2x2_u8 at_subpixel_q16(alpha16 alpha);
 
     // Rasterizes and draws to the leds.
     void drawColor(const CRGB &color, float from, float to, Leds *leds,
@@ -106,6 +110,9 @@ class XYPath : public Referent {
     // Low level draw function.
     void rasterize(float from, float to, int steps, XYRasterU8Sparse &raster,
                    AlphaFunction *optional_alpha_gen = nullptr);
+    void rasterize_q16(alpha16 from, alpha16 to, int steps,
+                       XYRasterU8Sparse &raster,
+                       AlphaFunction *optional_alpha_gen = nullptr);
 
     void setScale(float scale);
     string name() const;
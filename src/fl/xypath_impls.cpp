@@ -2,6 +2,7 @@
 #include "fl/xypath_impls.h"
 
 #include <math.h>
+#include <string.h>
 
 #include "fl/assert.h"
 #include "fl/function.h"
@@ -20,6 +21,7 @@ LinePath::LinePath(float x0, float y0, float x1, float y1) {
     params().y0 = y0;
     params().x1 = x1;
     params().y1 = y1;
+    updateQ16();
 }
 
 vec2f LinePath::compute(float alpha) {
@@ -29,14 +31,39 @@ vec2f LinePath::compute(float alpha) {
     return {x, y};
 }
 
+vec2q16 LinePath::compute_q16(alpha16 alpha) {
+    const float current[4] = {params().x0, params().y0, params().x1,
+                              params().y1};
+    if (memcmp(current, mQ16Source, sizeof(current)) != 0) {
+        updateQ16();
+    }
+    q16 t = alpha16_to_q16(alpha);
+    return vec2q16(mX0Q16 + t * mDxQ16, mY0Q16 + t * mDyQ16);
+}
+
+void LinePath::updateQ16() {
+    mQ16Source[0] = params().x0;
+    mQ16Source[1] = params().y0;
+    mQ16Source[2] = params().x1;
+    mQ16Source[3] = params().y1;
+    mX0Q16 = q16::from_float(params().x0);
+    mY0Q16 = q16::from_float(params().y0);
+    mDxQ16 = q16::from_float(params().x1) - mX0Q16;
+    mDyQ16 = q16::from_float(params().y1) - mY0Q16;
+}
+
 void LinePath::set(float x0, float y0, float x1, float y1) {
     params().x0 = x0;
     params().y0 = y0;
     params().x1 = x1;
     params().y1 = y1;
+    updateQ16();
 }
 
-void LinePath::set(const LinePathParams &p) { params() = p; }
+void LinePath::set(const LinePathParams &p) {
+    params() = p;
+    updateQ16();
+}
 
 vec2f CirclePath::compute(float alpha) {
     // α in [0,1] → (x,y) on the unit circle [-1, 1]
@@ -46,6 +73,11 @@ vec2f CirclePath::compute(float alpha) {
     return vec2f(x, y);
 }
 
+vec2q16 CirclePath::compute_q16(alpha16 alpha) {
+    u32 angle = turns_to_angle(alpha16_to_q16(alpha));
+    return vec2q16(cos_q16(angle), sin_q16(angle));
+}
+
 CirclePath::CirclePath() {}
 
 HeartPath::HeartPath() {}
@@ -79,8 +111,21 @@ vec2f HeartPath::compute(float alpha) {
     return vec2f(x, y);
 }
 
+vec2q16 HeartPath::compute_q16(alpha16 alpha) {
+    // Same curve as compute(), angles as multiples of the base angle wrap
+    // around the sin32 circle on their own.
+    u32 t = turns_to_angle(alpha16_to_q16(alpha));
+    q16 s = sin_q16(t);
+    q16 x = s * s * s;
+    q16 y = cos_q16(t) * 13 - cos_q16(t * 2) * 5 - cos_q16(t * 3) * 2 -
+            cos_q16(t * 4);
+    // y / 16 * 1.10 + 0.17
+    y = y * q16::from_raw(4506) + q16::from_raw(11141);
+    return vec2q16(x, y);
+}
+
 ArchimedeanSpiralPath::ArchimedeanSpiralPath(u8 turns, float radius)
-    : mTurns(turns), mRadius(radius) {}
+    : mTurns(turns), mRadius(radius), mRadiusQ16(q16::from_float(radius)) {}
 
 vec2f ArchimedeanSpiralPath::compute(float alpha) {
     // Parametric equation for an Archimedean spiral
@@ -103,6 +148,13 @@ vec2f ArchimedeanSpiralPath::compute(float alpha) {
     return vec2f(x, y);
 }
 
+vec2q16 ArchimedeanSpiralPath::compute_q16(alpha16 alpha) {
+    q16 t = alpha16_to_q16(alpha);
+    u32 theta = turns_to_angle(t) * mTurns;
+    q16 r = t * mRadiusQ16;
+    return vec2q16(r * cos_q16(theta), r * sin_q16(theta));
+}
+
 RosePath::RosePath(u8 n, u8 d) {
     mParams = fl::make_intrusive<RosePathParams>();
     params().n = n;
@@ -189,6 +241,21 @@ vec2f GielisCurvePath::compute(float alpha) {
     return vec2f{x, y};
 }
 
+vec2q16 RosePath::compute_q16(alpha16 alpha) {
+    const u32 n = params().n;
+    const u32 d = params().d ? params().d : 1;
+    // theta = alpha * n turns, r = |cos(n * theta / d)|. alpha * n * n in
+    // 16.16 turns fits 32 bits for any u8 n.
+    u32 turns = u32(alpha16_to_q16(alpha).raw()) * n;
+    u32 theta = turns << 8;
+    u32 petal = ((turns * n) / d) << 8;
+    q16 r = cos_q16(petal);
+    if (r < 0) {
+        r = -r;
+    }
+    return vec2q16(r * cos_q16(theta), r * sin_q16(theta));
+}
+
 const string CirclePath::name() const { return "CirclePath"; }
 
 vec2f PointPath::compute(float alpha) {
@@ -196,15 +263,24 @@ vec2f PointPath::compute(float alpha) {
     return mPoint;
 }
 
+vec2q16 PointPath::compute_q16(alpha16 alpha) {
+    FASTLED_UNUSED(alpha);
+    return mPointQ16;
+}
+
 const string PointPath::name() const { return "PointPath"; }
 
 void PointPath::set(float x, float y) { set(vec2f(x, y)); }
 
-void PointPath::set(vec2f p) { mPoint = p; }
+void PointPath::set(vec2f p) {
+    mPoint = p;
+    mPointQ16 = to_vec2q16(p);
+}
 
-PointPath::PointPath(float x, float y) : mPoint(x, y) {}
+PointPath::PointPath(float x, float y)
+    : mPoint(x, y), mPointQ16(to_vec2q16(mPoint)) {}
 
-PointPath::PointPath(vec2f p) : mPoint(p) {}
+PointPath::PointPath(vec2f p) : mPoint(p), mPointQ16(to_vec2q16(p)) {}
 
 const string LinePath::name() const { return "LinePath"; }
 
@@ -212,7 +288,9 @@ LinePathParams &LinePath::params() { return *mParams; }
 
 const LinePathParams &LinePath::params() const { return *mParams; }
 
-LinePath::LinePath(const LinePathParamsPtr &params) : mParams(params) {}
+LinePath::LinePath(const LinePathParamsPtr &params) : mParams(params) {
+    updateQ16();
+}
 
 const string HeartPath::name() const { return "HeartPath"; }
 
@@ -222,7 +300,10 @@ const string ArchimedeanSpiralPath::name() const {
 
 void ArchimedeanSpiralPath::setTurns(u8 turns) { mTurns = turns; }
 
-void ArchimedeanSpiralPath::setRadius(float radius) { mRadius = radius; }
+void ArchimedeanSpiralPath::setRadius(float radius) {
+    mRadius = radius;
+    mRadiusQ16 = q16::from_float(radius);
+}
 
 const string RosePath::name() const { return "RosePath"; }
 
@@ -56,6 +56,12 @@ class XYPathGenerator : public Referent {
   public:
     virtual const string name() const = 0;
     virtual vec2f compute(float alpha) = 0;
+    // Fixed point compute(), alpha in [0, 65535] for [0, 1]. The default goes
+    // through the float version, the built in paths override it with integer
+    // math for FPU-less targets, see q16.h.
+    virtual vec2q16 compute_q16(alpha16 alpha) {
+        return to_vec2q16(compute(alpha / 65535.0f));
+    }
     // No writes when returning false.
     virtual bool hasDrawBounds(rect<i16> *bounds) {
         FASTLED_UNUSED(bounds);
@@ -123,12 +129,14 @@ class PointPath : public XYPathGenerator {
     PointPath(float x, float y);
     PointPath(vec2f p);
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
     void set(float x, float y);
     void set(vec2f p);
 
   private:
     vec2f mPoint;
+    vec2q16 mPointQ16; // mPoint converted once for compute_q16().
 };
 
 class LinePath : public XYPathGenerator {
@@ -136,6 +144,7 @@ class LinePath : public XYPathGenerator {
     LinePath(const LinePathParamsPtr &params = fl::make_intrusive<LinePathParams>());
     LinePath(float x0, float y0, float x1, float y1);
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
     void set(float x0, float y0, float x1, float y1);
     void set(const LinePathParams &p);
@@ -144,13 +153,20 @@ class LinePath : public XYPathGenerator {
     const LinePathParams &params() const;
 
   private:
+    // The params are shared and can be edited in place, so the q16 copy
+    // remembers which values it was made from.
+    void updateQ16();
+
     intrusive_ptr<LinePathParams> mParams;
+    float mQ16Source[4] = {};
+    q16 mX0Q16, mY0Q16, mDxQ16, mDyQ16;
 };
 
 class CirclePath : public XYPathGenerator {
   public:
     CirclePath();
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
 };
 
@@ -158,6 +174,7 @@ class HeartPath : public XYPathGenerator {
   public:
     HeartPath();
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
 };
 
@@ -165,6 +182,7 @@ class ArchimedeanSpiralPath : public XYPathGenerator {
   public:
     ArchimedeanSpiralPath(u8 turns = 3, float radius = 1.0f);
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
 
     void setTurns(u8 turns);
@@ -173,6 +191,7 @@ class ArchimedeanSpiralPath : public XYPathGenerator {
   private:
     u8 mTurns; // Number of spiral turns
     float mRadius;  // Maximum radius of the spiral
+    q16 mRadiusQ16; // mRadius converted once for compute_q16().
 };
 
 class RosePath : public XYPathGenerator {
@@ -185,6 +204,7 @@ class RosePath : public XYPathGenerator {
     RosePath(const intrusive_ptr<RosePathParams> &p = fl::make_intrusive<RosePathParams>());
     RosePath(u8 n = 3, u8 d = 1);
     vec2f compute(float alpha) override;
+    vec2q16 compute_q16(alpha16 alpha) override;
     const string name() const override;
 
     RosePathParams &params();
@@ -21,12 +21,42 @@ vec2f XYPathRenderer::compute_float(float alpha, const TransformFloat &tx) {
     return out;
 }
 
+vec2q16 XYPathRenderer::compute_q16(alpha16 alpha, const TransformQ16 &tx) {
+    vec2q16 xy = mPath->compute_q16(alpha);
+    if (!tx.is_identity()) {
+        xy = tx.transform(xy);
+    }
+    return mGridTransformQ16.transform(xy);
+}
+
+vec2q16 XYPathRenderer::at_q16(alpha16 alpha) {
+    return compute_q16(alpha, TransformQ16::From(mTransform));
+}
+
+Tile2x2_u8 XYPathRenderer::splat_q16(alpha16 alpha, const TransformQ16 &tx) {
+    vec2q16 xy = compute_q16(alpha, tx);
+    // Shift back so whole pixels go 0…W–1, 0…H–1.
+    xy -= vec2q16(q16::from_raw(0x8000), q16::from_raw(0x8000));
+    return splat(xy);
+}
+
+Tile2x2_u8 XYPathRenderer::at_subpixel_q16(alpha16 alpha) {
+    if (!mDrawBoundsSet) {
+        FASTLED_WARN("XYPathRenderer::at_subpixel_q16: draw bounds not set");
+        return Tile2x2_u8();
+    }
+    return splat_q16(alpha, TransformQ16::From(mTransform));
+}
+
 Tile2x2_u8 XYPathRenderer::at_subpixel(float alpha) {
     // 1) continuous point, in “pixel‐centers” coordinates [0.5 … W–0.5]
     if (!mDrawBoundsSet) {
         FASTLED_WARN("XYPathRenderer::at_subpixel: draw bounds not set");
         return Tile2x2_u8();
     }
+#if FASTLED_GEOMETRY_Q16
+    return splat_q16(alpha16_from_float(alpha), TransformQ16::From(mTransform));
+#else
     vec2f xy = at(alpha);
 
     // 1) shift back so whole‐pixels go 0…W–1, 0…H–1
@@ -34,6 +64,7 @@ Tile2x2_u8 XYPathRenderer::at_subpixel(float alpha) {
     xy.y -= 0.5f;
 
     return splat(xy);
+#endif
 }
 
 } // namespace fl
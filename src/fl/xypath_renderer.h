@@ -23,10 +23,22 @@ class XYPathRenderer : public Referent {
                    TransformFloat transform = TransformFloat());
     vec2f at(float alpha);
 
+    // With FASTLED_GEOMETRY_Q16 this goes through at_subpixel_q16().
     Tile2x2_u8 at_subpixel(float alpha);
 
+    // Fixed point pipeline, alpha in [0, 65535]. Generator, transform, draw
+    // bounds and splat all in q16, see q16.h.
+    vec2q16 at_q16(alpha16 alpha);
+    Tile2x2_u8 at_subpixel_q16(alpha16 alpha);
+
+    // With FASTLED_GEOMETRY_Q16 and draw bounds set this is rasterize_q16().
     void rasterize(float from, float to, int steps, XYRasterU8Sparse &raster,
                    fl::function<u8(float)> *optional_alpha_gen = nullptr);
+    // Fixed point rasterize(): the transform is converted once, then every
+    // step is integer math for the built in paths.
+    void rasterize_q16(alpha16 from, alpha16 to, int steps,
+                       XYRasterU8Sparse &raster,
+                       fl::function<u8(float)> *optional_alpha_gen = nullptr);
 
     // Overloaded to allow transform to be passed in.
     vec2f at(float alpha, const TransformFloat &tx);
@@ -55,8 +67,11 @@ class XYPathRenderer : public Referent {
     XYPathGeneratorPtr mPath;
     TransformFloat mTransform;
     TransformFloat mGridTransform;
+    TransformQ16 mGridTransformQ16;
     bool mDrawBoundsSet = false;
     vec2f compute_float(float alpha, const TransformFloat &tx);
+    vec2q16 compute_q16(alpha16 alpha, const TransformQ16 &tx);
+    Tile2x2_u8 splat_q16(alpha16 alpha, const TransformQ16 &tx);
 };
 
 } // namespace fl
@@ -174,76 +174,65 @@ void AnimartrixLoop(Animartrix &self, fl::u32 now) {
     self.impl->loop();
 }
 
+// Every animation as X(enum, method) in AnimartrixAnim order. Builds the
+// table below, and lets tests run the animations with other math tiers.
+#define FL_ANIMARTRIX_ANIMATIONS(X)                                           \
+    X(RGB_BLOBS5, RGB_Blobs5)                                                 \
+    X(RGB_BLOBS4, RGB_Blobs4)                                                 \
+    X(RGB_BLOBS3, RGB_Blobs3)                                                 \
+    X(RGB_BLOBS2, RGB_Blobs2)                                                 \
+    X(RGB_BLOBS, RGB_Blobs)                                                   \
+    X(POLAR_WAVES, Polar_Waves)                                               \
+    X(SLOW_FADE, Slow_Fade)                                                   \
+    X(ZOOM2, Zoom2)                                                           \
+    X(ZOOM, Zoom)                                                             \
+    X(HOT_BLOB, Hot_Blob)                                                     \
+    X(SPIRALUS2, Spiralus2)                                                   \
+    X(SPIRALUS, Spiralus)                                                     \
+    X(YVES, Yves)                                                             \
+    X(SCALEDEMO1, Scaledemo1)                                                 \
+    X(LAVA1, Lava1)                                                           \
+    X(CALEIDO3, Caleido3)                                                     \
+    X(CALEIDO2, Caleido2)                                                     \
+    X(CALEIDO1, Caleido1)                                                     \
+    X(DISTANCE_EXPERIMENT, Distance_Experiment)                               \
+    X(CENTER_FIELD, Center_Field)                                             \
+    X(WAVES, Waves)                                                           \
+    X(CHASING_SPIRALS, Chasing_Spirals)                                       \
+    X(ROTATING_BLOB, Rotating_Blob)                                           \
+    X(RINGS, Rings)                                                           \
+    X(COMPLEX_KALEIDO, Complex_Kaleido)                                       \
+    X(COMPLEX_KALEIDO_2, Complex_Kaleido_2)                                   \
+    X(COMPLEX_KALEIDO_3, Complex_Kaleido_3)                                   \
+    X(COMPLEX_KALEIDO_4, Complex_Kaleido_4)                                   \
+    X(COMPLEX_KALEIDO_5, Complex_Kaleido_5)                                   \
+    X(COMPLEX_KALEIDO_6, Complex_Kaleido_6)                                   \
+    X(WATER, Water)                                                           \
+    X(PARAMETRIC_WATER, Parametric_Water)                                     \
+    X(MODULE_EXPERIMENT1, Module_Experiment1)                                 \
+    X(MODULE_EXPERIMENT2, Module_Experiment2)                                 \
+    X(MODULE_EXPERIMENT3, Module_Experiment3)                                 \
+    X(MODULE_EXPERIMENT4, Module_Experiment4)                                 \
+    X(MODULE_EXPERIMENT5, Module_Experiment5)                                 \
+    X(MODULE_EXPERIMENT6, Module_Experiment6)                                 \
+    X(MODULE_EXPERIMENT7, Module_Experiment7)                                 \
+    X(MODULE_EXPERIMENT8, Module_Experiment8)                                 \
+    X(MODULE_EXPERIMENT9, Module_Experiment9)                                 \
+    X(MODULE_EXPERIMENT10, Module_Experiment10)                               \
+    X(MODULE_EXPERIMENT_SM1, SM1)                                             \
+    X(MODULE_EXPERIMENT_SM2, SM2)                                             \
+    X(MODULE_EXPERIMENT_SM3, SM3)                                             \
+    X(MODULE_EXPERIMENT_SM4, SM4)                                             \
+    X(MODULE_EXPERIMENT_SM5, SM5)                                             \
+    X(MODULE_EXPERIMENT_SM6, SM6)                                             \
+    X(MODULE_EXPERIMENT_SM8, SM8)                                             \
+    X(MODULE_EXPERIMENT_SM9, SM9)                                             \
+    X(MODULE_EXPERIMENT_SM10, SM10)
+
 static const AnimartrixEntry ANIMATION_TABLE[] = {
-    {RGB_BLOBS5, "RGB_BLOBS5", &FastLEDANIMartRIX::RGB_Blobs5},
-    {RGB_BLOBS4, "RGB_BLOBS4", &FastLEDANIMartRIX::RGB_Blobs4},
-    {RGB_BLOBS3, "RGB_BLOBS3", &FastLEDANIMartRIX::RGB_Blobs3},
-    {RGB_BLOBS2, "RGB_BLOBS2", &FastLEDANIMartRIX::RGB_Blobs2},
-    {RGB_BLOBS, "RGB_BLOBS", &FastLEDANIMartRIX::RGB_Blobs},
-    {POLAR_WAVES, "POLAR_WAVES", &FastLEDANIMartRIX::Polar_Waves},
-    {SLOW_FADE, "SLOW_FADE", &FastLEDANIMartRIX::Slow_Fade},
-    {ZOOM2, "ZOOM2", &FastLEDANIMartRIX::Zoom2},
-    {ZOOM, "ZOOM", &FastLEDANIMartRIX::Zoom},
-    {HOT_BLOB, "HOT_BLOB", &FastLEDANIMartRIX::Hot_Blob},
-    {SPIRALUS2, "SPIRALUS2", &FastLEDANIMartRIX::Spiralus2},
-    {SPIRALUS, "SPIRALUS", &FastLEDANIMartRIX::Spiralus},
-    {YVES, "YVES", &FastLEDANIMartRIX::Yves},
-    {SCALEDEMO1, "SCALEDEMO1", &FastLEDANIMartRIX::Scaledemo1},
-    {LAVA1, "LAVA1", &FastLEDANIMartRIX::Lava1},
-    {CALEIDO3, "CALEIDO3", &FastLEDANIMartRIX::Caleido3},
-    {CALEIDO2, "CALEIDO2", &FastLEDANIMartRIX::Caleido2},
-    {CALEIDO1, "CALEIDO1", &FastLEDANIMartRIX::Caleido1},
-    {DISTANCE_EXPERIMENT, "DISTANCE_EXPERIMENT",
-     &FastLEDANIMartRIX::Distance_Experiment},
-    {CENTER_FIELD, "CENTER_FIELD", &FastLEDANIMartRIX::Center_Field},
-    {WAVES, "WAVES", &FastLEDANIMartRIX::Waves},
-    {CHASING_SPIRALS, "CHASING_SPIRALS", &FastLEDANIMartRIX::Chasing_Spirals},
-    {ROTATING_BLOB, "ROTATING_BLOB", &FastLEDANIMartRIX::Rotating_Blob},
-    {RINGS, "RINGS", &FastLEDANIMartRIX::Rings},
-    {COMPLEX_KALEIDO, "COMPLEX_KALEIDO", &FastLEDANIMartRIX::Complex_Kaleido},
-    {COMPLEX_KALEIDO_2, "COMPLEX_KALEIDO_2",
-     &FastLEDANIMartRIX::Complex_Kaleido_2},
-    {COMPLEX_KALEIDO_3, "COMPLEX_KALEIDO_3",
-     &FastLEDANIMartRIX::Complex_Kaleido_3},
-    {COMPLEX_KALEIDO_4, "COMPLEX_KALEIDO_4",
-     &FastLEDANIMartRIX::Complex_Kaleido_4},
-    {COMPLEX_KALEIDO_5, "COMPLEX_KALEIDO_5",
-     &FastLEDANIMartRIX::Complex_Kaleido_5},
-    {COMPLEX_KALEIDO_6, "COMPLEX_KALEIDO_6",
-     &FastLEDANIMartRIX::Complex_Kaleido_6},
-    {WATER, "WATER", &FastLEDANIMartRIX::Water},
-    {PARAMETRIC_WATER, "PARAMETRIC_WATER",
-     &FastLEDANIMartRIX::Parametric_Water},
-    {MODULE_EXPERIMENT1, "MODULE_EXPERIMENT1",
-     &FastLEDANIMartRIX::Module_Experiment1},
-    {MODULE_EXPERIMENT2, "MODULE_EXPERIMENT2",
-     &FastLEDANIMartRIX::Module_Experiment2},
-    {MODULE_EXPERIMENT3, "MODULE_EXPERIMENT3",
-     &FastLEDANIMartRIX::Module_Experiment3},
-    {MODULE_EXPERIMENT4, "MODULE_EXPERIMENT4",
-     &FastLEDANIMartRIX::Module_Experiment4},
-    {MODULE_EXPERIMENT5, "MODULE_EXPERIMENT5",
-     &FastLEDANIMartRIX::Module_Experiment5},
-    {MODULE_EXPERIMENT6, "MODULE_EXPERIMENT6",
-     &FastLEDANIMartRIX::Module_Experiment6},
-    {MODULE_EXPERIMENT7, "MODULE_EXPERIMENT7",
-     &FastLEDANIMartRIX::Module_Experiment7},
-    {MODULE_EXPERIMENT8, "MODULE_EXPERIMENT8",
-     &FastLEDANIMartRIX::Module_Experiment8},
-    {MODULE_EXPERIMENT9, "MODULE_EXPERIMENT9",
-     &FastLEDANIMartRIX::Module_Experiment9},
-    {MODULE_EXPERIMENT10, "MODULE_EXPERIMENT10",
-     &FastLEDANIMartRIX::Module_Experiment10},
-    {MODULE_EXPERIMENT_SM1, "MODULE_EXPERIMENT_SM1", &FastLEDANIMartRIX::SM1},
-    {MODULE_EXPERIMENT_SM2, "MODULE_EXPERIMENT_SM2", &FastLEDANIMartRIX::SM2},
-    {MODULE_EXPERIMENT_SM3, "MODULE_EXPERIMENT_SM3", &FastLEDANIMartRIX::SM3},
-    {MODULE_EXPERIMENT_SM4, "MODULE_EXPERIMENT_SM4", &FastLEDANIMartRIX::SM4},
-    {MODULE_EXPERIMENT_SM5, "MODULE_EXPERIMENT_SM5", &FastLEDANIMartRIX::SM5},
-    {MODULE_EXPERIMENT_SM6, "MODULE_EXPERIMENT_SM6", &FastLEDANIMartRIX::SM6},
-    {MODULE_EXPERIMENT_SM8, "MODULE_EXPERIMENT_SM8", &FastLEDANIMartRIX::SM8},
-    {MODULE_EXPERIMENT_SM9, "MODULE_EXPERIMENT_SM9", &FastLEDANIMartRIX::SM9},
-    {MODULE_EXPERIMENT_SM10, "MODULE_EXPERIMENT_SM10",
-     &FastLEDANIMartRIX::SM10},
+#define FL_ANIMARTRIX_ENTRY(ANIM, FUNC) {ANIM, #ANIM, &FastLEDANIMartRIX::FUNC},
+    FL_ANIMARTRIX_ANIMATIONS(FL_ANIMARTRIX_ENTRY)
+#undef FL_ANIMARTRIX_ENTRY
 };
 
 fl::string getAnimartrixName(int animation) {
@@ -59,6 +59,7 @@ License CC BY-NC 3.0
 #include "fl/namespace.h"
 #include "fl/math.h"
 #include "fl/compiler_control.h"
+#include "fx/2d/animartrix_math.h"
 
 #ifndef FL_ANIMARTRIX_USES_FAST_MATH
 #define FL_ANIMARTRIX_USES_FAST_MATH 1
@@ -70,8 +71,9 @@ License CC BY-NC 3.0
 //     * FL_ANIMARTRIX_USES_FAST_MATH 1: 90ms
 
 
-#define FL_SIN_F(x) sinf(x)
-#define FL_COS_F(x) cosf(x)
+// Trig goes through the math tier, see animartrix_math.h.
+#define FL_SIN_F(x) MathT::sin(x)
+#define FL_COS_F(x) MathT::cos(x)
 
 
 #if FL_ANIMARTRIX_USES_FAST_MATH
@@ -167,7 +169,8 @@ FASTLED_FORCE_INLINE uint8_t P(uint8_t x) {
     return *ptr;
 }
 
-class ANIMartRIX {
+// MathT is one of the math tiers in animartrix_math.h.
+template <typename MathT = fl::AnimartrixMath> class ANIMartRIXT {
 
   public:
     int num_x; // how many LEDs are in one row?
@@ -193,11 +196,11 @@ class ANIMartRIX {
 
     float show1, show2, show3, show4, show5, show6, show7, show8, show9, show0;
 
-    ANIMartRIX() {}
+    ANIMartRIXT() {}
 
-    ANIMartRIX(int w, int h) { this->init(w, h); }
+    ANIMartRIXT(int w, int h) { this->init(w, h); }
 
-    virtual ~ANIMartRIX() {}
+    virtual ~ANIMartRIXT() {}
 
     virtual uint16_t xyMap(uint16_t x, uint16_t y) = 0;
 
@@ -413,8 +416,8 @@ class ANIMartRIX {
                 float dx = xx - cx;
                 float dy = yy - cy;
 
-                distance[xx][yy] = hypotf(dx, dy);
-                polar_theta[xx][yy] = atan2f(dy, dx);
+                distance[xx][yy] = MathT::hypot(dx, dy);
+                polar_theta[xx][yy] = MathT::atan2(dy, dx);
             }
         }
     }
@@ -778,7 +781,7 @@ class ANIMartRIX {
                 animation.scale_x = 0.07;
                 animation.scale_y = 0.07;
                 animation.scale_z = 0.1;
-                animation.dist = 5 * sqrtf(distance[x][y]);
+                animation.dist = 5 * MathT::sqrt(distance[x][y]);
                 animation.offset_y = move.linear[0];
                 animation.offset_x = 0;
                 animation.z = 0;
@@ -788,7 +791,7 @@ class ANIMartRIX {
                 animation.scale_x = 0.07;
                 animation.scale_y = 0.07;
                 animation.scale_z = 0.1;
-                animation.dist = 4 * sqrtf(distance[x][y]);
+                animation.dist = 4 * MathT::sqrt(distance[x][y]);
                 animation.offset_y = move.linear[0];
                 animation.offset_x = 0;
                 animation.z = 0;
@@ -1510,7 +1513,7 @@ class ANIMartRIX {
             for (int y = 0; y < num_y; y++) {
 
                 animation.dist =
-                    sqrtf(distance[x][y]) * 0.7 * (move.directional[0] + 1.5);
+                    MathT::sqrt(distance[x][y]) * 0.7 * (move.directional[0] + 1.5);
                 animation.angle =
                     polar_theta[x][y] - move.radial[0] + distance[x][y] / 5;
 
@@ -1624,7 +1627,7 @@ class ANIMartRIX {
                 animation.dist = distance[x][y];
                 animation.angle = polar_theta[x][y] + move.radial[0] +
                                   move.noise_angle[0] + move.noise_angle[3];
-                animation.z = (sqrtf(animation.dist)); // - 10 * move.linear[0];
+                animation.z = (MathT::sqrt(animation.dist)); // - 10 * move.linear[0];
                 animation.scale_x = 0.1;
                 animation.scale_y = 0.1;
                 animation.offset_z = 10;
@@ -1681,7 +1684,7 @@ class ANIMartRIX {
                 animation.angle = polar_theta[x][y] + move.radial[0] +
                                   move.noise_angle[0] + move.noise_angle[3] +
                                   move.noise_angle[1];
-                animation.z = (sqrtf(animation.dist)); // - 10 * move.linear[0];
+                animation.z = (MathT::sqrt(animation.dist)); // - 10 * move.linear[0];
                 animation.scale_x = 0.1;
                 animation.scale_y = 0.1;
                 animation.offset_z = 10;
@@ -1740,7 +1743,7 @@ class ANIMartRIX {
                 animation.angle = polar_theta[x][y] + move.radial[0] +
                                   move.noise_angle[0] + move.noise_angle[3] +
                                   move.noise_angle[1];
-                animation.z = (sqrtf(animation.dist)); // - 10 * move.linear[0];
+                animation.z = (MathT::sqrt(animation.dist)); // - 10 * move.linear[0];
                 animation.scale_x = 0.1;
                 animation.scale_y = 0.1;
                 animation.offset_z = 10;
@@ -1799,7 +1802,7 @@ class ANIMartRIX {
                 animation.angle = polar_theta[x][y] + move.radial[0] +
                                   move.noise_angle[0] + move.noise_angle[3] +
                                   move.noise_angle[1];
-                animation.z = 3 + sqrtf(animation.dist);
+                animation.z = 3 + MathT::sqrt(animation.dist);
                 animation.scale_x = 0.1;
                 animation.scale_y = 0.1;
                 animation.offset_z = 10;
@@ -1857,7 +1860,7 @@ class ANIMartRIX {
                 animation.angle = polar_theta[x][y] + move.radial[0] +
                                   move.noise_angle[0] + move.noise_angle[3] +
                                   move.noise_angle[1];
-                animation.z = 3 + sqrtf(animation.dist);
+                animation.z = 3 + MathT::sqrt(animation.dist);
                 animation.scale_x = 0.05;
                 animation.scale_y = 0.05;
                 animation.offset_z = 10;
@@ -4088,6 +4091,8 @@ class ANIMartRIX {
     }
 };
 
+typedef ANIMartRIXT<> ANIMartRIX;
+
 } // namespace animartrix_detail
 
 // End fast math optimizations
@@ -0,0 +1,125 @@
+#pragma once
+
+// Math tiers for the Animartrix fx. Every pixel of every layer goes through
+// a sin/cos pair in render_value(), so the trig dominates the frame time.
+//
+//   FL_ANIMARTRIX_MATH_EXACT      libm sinf/cosf/sqrtf/atan2f/hypotf (default).
+//   FL_ANIMARTRIX_MATH_FLOAT_FAST polynomial sin/cos/atan2, ~1e-3 error.
+//   FL_ANIMARTRIX_MATH_FIXED      sin/cos from the sin32 table, atan2 as
+//                                 FLOAT_FAST.
+//
+// Pick one at compile time:
+//
+//   #define FL_ANIMARTRIX_MATH_TIER FL_ANIMARTRIX_MATH_FLOAT_FAST
+//   #include "fx/2d/animartrix.hpp"
+//
+// The tiers are also plain structs, animartrix_detail::ANIMartRIXT<Tier>
+// renders with any of them. tests/test_animartrix_math.cpp prints the per
+// animation error against the exact tier and the time per frame, pick the
+// fastest tier that still looks right for the installation.
+
+#include <math.h> // ok include
+
+#include "fl/force_inline.h"
+#include "fl/int.h"
+#include "fl/sin32.h"
+
+#define FL_ANIMARTRIX_MATH_EXACT 0
+#define FL_ANIMARTRIX_MATH_FLOAT_FAST 1
+#define FL_ANIMARTRIX_MATH_FIXED 2
+
+#ifndef FL_ANIMARTRIX_MATH_TIER
+#define FL_ANIMARTRIX_MATH_TIER FL_ANIMARTRIX_MATH_EXACT
+#endif
+
+namespace fl {
+
+struct AnimartrixMathExact {
+    static FASTLED_FORCE_INLINE float sin(float x) { return sinf(x); }
+    static FASTLED_FORCE_INLINE float cos(float x) { return cosf(x); }
+    static FASTLED_FORCE_INLINE float sqrt(float x) { return sqrtf(x); }
+    static FASTLED_FORCE_INLINE float atan2(float y, float x) {
+        return atan2f(y, x);
+    }
+    static FASTLED_FORCE_INLINE float hypot(float x, float y) {
+        return hypotf(x, y);
+    }
+};
+
+struct AnimartrixMathFloatFast {
+    // Parabola through the sine with one refinement step, max error ~1e-3.
+    static FASTLED_FORCE_INLINE float sin(float x) {
+        float t = x * 0.159154943f; // Turns.
+        // Nearest whole turn, int conversion is much cheaper than floorf.
+        if (t > 1e6f || t < -1e6f) {
+            t -= floorf(t + 0.5f);
+        } else {
+            t -= float(i32(t + (t < 0 ? -0.5f : 0.5f)));
+        }
+        // t in [-0.5, 0.5]: 4/pi x - 4/pi^2 x|x| with x = 2 pi t.
+        float y = 8.0f * t - 16.0f * t * fabsf(t);
+        return 0.225f * (y * fabsf(y) - y) + y;
+    }
+    static FASTLED_FORCE_INLINE float cos(float x) {
+        return sin(x + 1.57079633f);
+    }
+    static FASTLED_FORCE_INLINE float sqrt(float x) { return sqrtf(x); }
+    // Odd polynomial on the octant, max error ~2e-4 rad.
+    static FASTLED_FORCE_INLINE float atan2(float y, float x) {
+        const float ax = fabsf(x);
+        const float ay = fabsf(y);
+        const float mx = ax > ay ? ax : ay;
+        if (!(mx > 0.0f)) {
+            return 0.0f;
+        }
+        const float a = (ax > ay ? ay : ax) / mx;
+        const float s = a * a;
+        float r =
+            ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+        if (ay > ax) {
+            r = 1.57079633f - r;
+        }
+        if (x < 0) {
+            r = 3.14159265f - r;
+        }
+        return y < 0 ? -r : r;
+    }
+    // No overflow guard, the inputs are led coordinates.
+    static FASTLED_FORCE_INLINE float hypot(float x, float y) {
+        return sqrtf(x * x + y * y);
+    }
+};
+
+struct AnimartrixMathFixed {
+    // Radians to the sin32 circle, 16777216 per turn. The u32 wraps with the
+    // circle, large arguments are reduced first so the i32 doesn't overflow.
+    static FASTLED_FORCE_INLINE u32 angle(float x) {
+        if (x > 800.0f || x < -800.0f) {
+            x = fmodf(x, 6.28318531f);
+        }
+        return u32(i32(x * 2670176.85f));
+    }
+    static FASTLED_FORCE_INLINE float sin(float x) {
+        return float(sin32(angle(x))) * (1.0f / 2147418112.0f);
+    }
+    static FASTLED_FORCE_INLINE float cos(float x) {
+        return float(cos32(angle(x))) * (1.0f / 2147418112.0f);
+    }
+    static FASTLED_FORCE_INLINE float sqrt(float x) { return sqrtf(x); }
+    static FASTLED_FORCE_INLINE float atan2(float y, float x) {
+        return AnimartrixMathFloatFast::atan2(y, x);
+    }
+    static FASTLED_FORCE_INLINE float hypot(float x, float y) {
+        return AnimartrixMathFloatFast::hypot(x, y);
+    }
+};
+
+#if FL_ANIMARTRIX_MATH_TIER == FL_ANIMARTRIX_MATH_FLOAT_FAST
+typedef AnimartrixMathFloatFast AnimartrixMath;
+#elif FL_ANIMARTRIX_MATH_TIER == FL_ANIMARTRIX_MATH_FIXED
+typedef AnimartrixMathFixed AnimartrixMath;
+#else
+typedef AnimartrixMathExact AnimartrixMath;
+#endif
+
+} // namespace fl
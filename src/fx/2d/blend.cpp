@@ -9,6 +9,7 @@ are blended by the the max luminance of the components.
 #include "pixelset.h"
 
 #include "fl/stdint.h"
+#include "fl/memory_budget.h"
 
 namespace fl {
 
@@ -16,6 +17,7 @@ Blend2d::Blend2d(const XYMap &xymap) : Fx2d(xymap) {
     // Warning, the xyMap will be the final transrformation applied to the
     // frame. If the delegate Fx2d layers have their own transformation then
     // both will be applied.
+    MemScope scope(MemCategory::kFrame);
     mFrame = fl::make_intrusive<Frame>(mXyMap.getTotal());
     mFrameTransform = fl::make_intrusive<Frame>(mXyMap.getTotal());
 }
@@ -0,0 +1,30 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL
+#endif
+
+#include "FastLED.h"
+
+#include "worley.h"
+
+namespace fl {
+
+WorleyPalette::WorleyPalette(const XYMap &xyMap, const CRGBPalette16 &palette)
+    : Fx2d(xyMap), mPalette(palette) {
+    mNoise.resize(xyMap.getWidth() * xyMap.getHeight());
+}
+
+void WorleyPalette::draw(DrawContext context) {
+    const u16 width = getWidth();
+    const u16 height = getHeight();
+    mParams.time = i32((i64(context.now) * mSpeed) / 1000);
+    mField.fill8(mParams, width, height, mNoise.data());
+    const u8 *noise = mNoise.data();
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            const u16 idx = mXyMap.mapToIndex(x, y);
+            context.leds[idx] = ColorFromPalette(mPalette, *noise++);
+        }
+    }
+}
+
+} // namespace fl
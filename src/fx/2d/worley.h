@@ -0,0 +1,51 @@
+/// @file    worley.h
+/// @brief   Animated cellular (Worley) noise mapped through a palette.
+
+#pragma once
+
+#include "FastLED.h"
+#include "fl/memory.h"
+#include "fl/noise_woryley.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "fx/fx2d.h"
+
+namespace fl {
+
+FASTLED_SMART_PTR(WorleyPalette);
+
+// Fills the grid with WorleyField samples every frame. Cheap enough for 60
+// fps on large panels because the field hashes each feature point once per
+// cell row instead of nine times per pixel.
+class WorleyPalette : public Fx2d {
+  public:
+    WorleyPalette(const XYMap &xyMap,
+                  const CRGBPalette16 &palette = OceanColors_p);
+
+    void draw(DrawContext context) override;
+    fl::string fxName() const override { return "WorleyPalette"; }
+
+    void setPalette(const CRGBPalette16 &palette) { mPalette = palette; }
+    void setMode(WorleyMode mode) { mParams.mode = mode; }
+    // Pixels per cell, larger means bigger cells.
+    void setCellSize(u16 pixels) {
+        mParams.step_x = mParams.step_y = 32768 / (pixels ? pixels : 1);
+    }
+    // Q15 time units per second, 32768 moves each feature point by up to
+    // half a cell per second.
+    void setSpeed(i32 speed) { mSpeed = speed; }
+    // Scroll the field, Q15 cells.
+    void setOrigin(i32 x, i32 y) {
+        mParams.x = x;
+        mParams.y = y;
+    }
+
+  private:
+    WorleyField mField;
+    WorleyFieldParams mParams;
+    CRGBPalette16 mPalette;
+    i32 mSpeed = 32768 / 4;
+    fl::vector<u8> mNoise;
+};
+
+} // namespace fl
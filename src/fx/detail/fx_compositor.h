@@ -6,6 +6,7 @@
 #include "crgb.h"
 #include "fl/namespace.h"
 #include "fl/memory.h"
+#include "fl/trace.h"
 #include "fl/vector.h"
 #include "fx/detail/fx_layer.h"
 #include "fx/fx.h"
@@ -58,6 +59,7 @@ class FxCompositor {
 
 inline void FxCompositor::draw(fl::u32 now, fl::u32 warpedTime,
                                CRGB *finalBuffer) {
+    FL_TRACE_SCOPE("fx.compositor");
     if (!mLayers[0]->getFx()) {
         return;
     }
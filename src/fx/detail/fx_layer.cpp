@@ -6,6 +6,7 @@
 
 
 #include "fl/memfill.h"
+#include "fl/memory_budget.h"
 
 namespace fl {
 
@@ -19,6 +20,7 @@ void FxLayer::setFx(fl::intrusive_ptr<Fx> newFx) {
 void FxLayer::draw(fl::u32 now) {
     // assert(fx);
     if (!frame) {
+        MemScope scope(MemCategory::kFxLayer);
         frame = fl::make_intrusive<Frame>(fx->getNumLeds());
     }
 
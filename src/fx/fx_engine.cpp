@@ -1,3 +1,4 @@
+#include "fl/trace.h"
 #include "fx_engine.h"
 #include "video.h"
 
@@ -80,6 +81,7 @@ FxPtr FxEngine::getFx(int id) {
 }
 
 bool FxEngine::draw(fl::u32 now, CRGB *finalBuffer) {
+    FL_TRACE_SCOPE("fx.draw");
     mTimeFunction.update(now);
     fl::u32 warpedTime = mTimeFunction.time();
 
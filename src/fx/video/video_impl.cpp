@@ -4,6 +4,7 @@
 
 #include "fl/assert.h"
 #include "fl/math_macros.h"
+#include "fl/memory_budget.h"
 #include "fl/namespace.h"
 #include "fl/warn.h"
 
@@ -205,6 +206,7 @@ bool VideoImpl::updateBufferFromStream(fl::u32 now) {
         fl::u32 frame_to_fetch = frame_numbers[i];
         if (!recycled_frame) {
             // Happens when we are not full and we need to allocate a new frame.
+            MemScope scope(MemCategory::kFrame);
             recycled_frame = fl::make_intrusive<Frame>(mPixelsPerFrame);
         }
 
@@ -291,6 +293,7 @@ bool VideoImpl::updateBufferFromFile(fl::u32 now, bool forward) {
         fl::u32 frame_to_fetch = frame_numbers[i];
         if (!recycled_frame) {
             // Happens when we are not full and we need to allocate a new frame.
+            MemScope scope(MemCategory::kFrame);
             recycled_frame = fl::make_intrusive<Frame>(mPixelsPerFrame);
         }
 
@@ -19,6 +19,7 @@
 #include "fl/namespace.h"
 #include "eorder.h"
 #include "dither_mode.h"
+#include "pixel_controller_core.h"
 #include "pixel_iterator.h"
 #include "crgb.h"
 
@@ -36,55 +37,25 @@ FASTLED_NAMESPACE_BEGIN
 /// @see EOrder
 #define RO(X) RGB_BYTE(RGB_ORDER, X)
 
-/// Gets the assigned color channel for a byte's position in the output,
-/// using a passed RGB color order
-/// @param RO the RGB color order
-/// @param X the byte's position in the output (0-2)
-/// @returns the color channel for that byte (0 = red, 1 = green, 2 = blue)
-/// @see EOrder
-#define RGB_BYTE(RO,X) (((RO)>>(3*(2-(X)))) & 0x3)
-
-/// Gets the color channel for byte 0.
-/// @see RGB_BYTE(RO,X)
-#define RGB_BYTE0(RO) ((RO>>6) & 0x3)
-/// Gets the color channel for byte 1.
-/// @see RGB_BYTE(RO,X)
-#define RGB_BYTE1(RO) ((RO>>3) & 0x3)
-/// Gets the color channel for byte 2.
-/// @see RGB_BYTE(RO,X)
-#define RGB_BYTE2(RO) ((RO) & 0x3)
-
 // operator byte *(struct CRGB[] arr) { return (byte*)arr; }
 
-struct ColorAdjustment {
-    CRGB premixed;       /// the per-channel scale values premixed with brightness.
-    #if FASTLED_HD_COLOR_MIXING
-    CRGB color;          /// the per-channel scale values assuming full brightness.
-    uint8_t brightness;  /// the global brightness value
-    #endif
-};
-
 
 /// Pixel controller class.  This is the class that we use to centralize pixel access in a block of data, including
 /// support for things like RGB reordering, scaling, dithering, skipping (for ARGB data), and eventually, we will
 /// centralize 8/12/16 conversions here as well.
+/// The state and the runtime color order encoders live in the non-templated
+/// PixelControllerCore base, see pixel_controller_core.h.
 /// @tparam RGB_ORDER the rgb ordering for the LEDs (e.g. what order red, green, and blue data is written out in)
 /// @tparam LANES how many parallel lanes of output to write
 /// @tparam MASK bitmask for the output lanes
 template<EOrder RGB_ORDER, int LANES=1, uint32_t MASK=0xFFFFFFFF>
-struct PixelController {
-    const uint8_t *mData;    ///< pointer to the underlying LED data
-    int mLen;                ///< number of LEDs in the data for one lane
-    int mLenRemaining;       ///< counter for the number of LEDs left to process
-    uint8_t d[3];            ///< values for the scaled dither signal @see init_binary_dithering()
-    uint8_t e[3];            ///< values for the unscaled dither signal @see init_binary_dithering()
-    int8_t mAdvance;         ///< how many bytes to advance the pointer by each time. For CRGB this is 3.
+struct PixelController : public PixelControllerCore {
     int mOffsets[LANES];     ///< the number of bytes to offset each lane from the starting pointer @see initOffsets()
-    ColorAdjustment mColorAdjustment;
 
     enum {
         kLanes = LANES,
-        kMask = MASK
+        kMask = MASK,
+        kRgbOrder = RGB_ORDER
     };
 
     FASTLED_FORCE_INLINE PixelIterator as_iterator(const Rgbw& rgbw) {
@@ -145,8 +116,8 @@ struct PixelController {
     /// @param skip if the pointer is advancing, how many bytes to skip in addition to 3
     PixelController(
             const uint8_t *d, int len, ColorAdjustment color_adjustment,
-            EDitherMode dither, bool advance, uint8_t skip)
-                : mData(d), mLen(len), mLenRemaining(len), mColorAdjustment(color_adjustment) {
+            EDitherMode dither, bool advance, uint8_t skip) {
+        init(d, len, color_adjustment);
         enable_dithering(dither);
         mData += skip;
         mAdvance = (advance) ? 3+skip : 0;
@@ -160,8 +131,8 @@ struct PixelController {
     /// @param dither dither setting for the LEDs
     PixelController(
             const CRGB *d, int len, ColorAdjustment color_adjustment,
-            EDitherMode dither)
-                : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mColorAdjustment(color_adjustment) {
+            EDitherMode dither) {
+        init((const uint8_t*)d, len, color_adjustment);
         enable_dithering(dither);
         mAdvance = 3;
         initOffsets(len);
@@ -173,13 +144,40 @@ struct PixelController {
     /// @param color_adjustment LED scale values
     /// @param dither dither setting for the LEDs
     PixelController(
-            const CRGB &d, int len, ColorAdjustment color_adjustment, EDitherMode dither)
-                : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mColorAdjustment(color_adjustment) {
+            const CRGB &d, int len, ColorAdjustment color_adjustment, EDitherMode dither) {
+        init((const uint8_t*)&d, len, color_adjustment);
         enable_dithering(dither);
         mAdvance = 0;
         initOffsets(len);
     }
 
+    /// Constructor taking a controller's cached output profile, skips the
+    /// per show() setup of the adjustment and dither steps.
+    /// @param d pointer to LED data
+    /// @param len length of the LED data
+    /// @param profile scale values and dither setup for the LEDs
+    PixelController(const CRGB *d, int len, const OutputProfile &profile) {
+        init((const uint8_t*)d, len, profile.adjustment);
+        enable_dithering(profile);
+        mAdvance = 3;
+        initOffsets(len);
+    }
+
+    /// @copydoc PixelController(const CRGB*, int, const OutputProfile&)
+    PixelController(const CRGB &d, int len, const OutputProfile &profile) {
+        init((const uint8_t*)&d, len, profile.adjustment);
+        enable_dithering(profile);
+        mAdvance = 0;
+        initOffsets(len);
+    }
+
+    FASTLED_FORCE_INLINE void init(const uint8_t *d, int len, ColorAdjustment color_adjustment) {
+        mData = d;
+        mLen = len;
+        mLenRemaining = len;
+        mColorAdjustment = color_adjustment;
+    }
+
     #if FASTLED_HD_COLOR_MIXING
     uint8_t global_brightness() const {
         return mColorAdjustment.brightness;
@@ -187,104 +185,27 @@ struct PixelController {
     #endif
 
 
-#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
-
-/// Predicted max update rate, in Hertz
-#define MAX_LIKELY_UPDATE_RATE_HZ     400
-
-/// Minimum acceptable dithering rate, in Hertz
-#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
-
-/// The number of updates in a single dither cycle
-#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
-
-/// Set "virtual bits" of dithering to the highest level
-/// that is not likely to cause excessive flickering at
-/// low brightness levels + low update rates. 
-/// These pre-set values are a little ambitious, since
-/// a 400Hz update rate for WS2811-family LEDs is only
-/// possible with 85 pixels or fewer.
-/// Once we have a "number of milliseconds since last update"
-/// value available here, we can quickly calculate the correct
-/// number of "virtual bits" on the fly with a couple of "if"
-/// statements -- no division required.  At this point,
-/// the division is done at compile time, so there's no runtime
-/// cost, but the values are still hard-coded.
-/// @todo Can these macros be replaced with constants scoped to PixelController::init_binary_dithering()?
-#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
-
-/// Alias for RECOMMENDED_VIRTUAL_BITS
-#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
-
-#endif
-
-
     /// Set up the values for binary dithering
     void init_binary_dithering() {
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
-        // R is the digther signal 'counter'.
-        static uint8_t R = 0;
-        ++R;
-
-        // R is wrapped around at 2^ditherBits,
-        // so if ditherBits is 2, R will cycle through (0,1,2,3)
-        uint8_t ditherBits = VIRTUAL_BITS;
-        R &= (0x01 << ditherBits) - 1;
-
-        // Q is the "unscaled dither signal" itself.
-        // It's initialized to the reversed bits of R.
-        // If 'ditherBits' is 2, Q here will cycle through (0,128,64,192)
-        uint8_t Q = 0;
-
-        // Reverse bits in a byte
-        {
-            if(R & 0x01) { Q |= 0x80; }
-            if(R & 0x02) { Q |= 0x40; }
-            if(R & 0x04) { Q |= 0x20; }
-            if(R & 0x08) { Q |= 0x10; }
-            if(R & 0x10) { Q |= 0x08; }
-            if(R & 0x20) { Q |= 0x04; }
-            if(R & 0x40) { Q |= 0x02; }
-            if(R & 0x80) { Q |= 0x01; }
-        }
-
-        // Now we adjust Q to fall in the center of each range,
-        // instead of at the start of the range.
-        // If ditherBits is 2, Q will be (0, 128, 64, 192) at first,
-        // and this adjustment makes it (31, 159, 95, 223).
-        if( ditherBits < 8) {
-            Q += 0x01 << (7 - ditherBits);
-        }
-
-        // D and E form the "scaled dither signal"
-        // which is added to pixel values to affect the
-        // actual dithering.
-
-        // Setup the initial D and E values
-        for(int i = 0; i < 3; ++i) {
-                uint8_t s = mColorAdjustment.premixed.raw[i];
-                e[i] = s ? (256/s) + 1 : 0;
-                d[i] = scale8(Q, e[i]);
-#if (FASTLED_SCALE8_FIXED == 1)
-                if(d[i]) (--d[i]);
+        initBinaryDithering(nextDitherStep());
 #endif
-                if(e[i]) --e[i];
-        }
+    }
+
+    /// @copydoc init_binary_dithering()
+    /// @param steps the dither steps cached in an OutputProfile
+    void init_binary_dithering(const uint8_t steps[3]) {
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+        initBinaryDithering(nextDitherStep(), steps);
+#else
+        (void)steps;
 #endif
     }
 
-    /// Do we have n pixels left to process?
-    /// @param n the number to check against
-    /// @returns 'true' if there are more than n pixels left to process
-    FASTLED_FORCE_INLINE bool has(int n) {
-        return mLenRemaining >= n;
+    /// Advances the dither signal 'counter', one per controller type.
+    static uint8_t nextDitherStep() {
+        static uint8_t R = 0;
+        return ++R;
     }
 
     /// Toggle dithering enable
@@ -295,13 +216,18 @@ struct PixelController {
     void enable_dithering(EDitherMode dither) {
         switch(dither) {
             case BINARY_DITHER: init_binary_dithering(); break;
-            default: d[0]=d[1]=d[2]=e[0]=e[1]=e[2]=0; break;
+            default: clearDithering(); break;
         }
     }
 
-    /// Get the length of the LED strip
-    /// @returns PixelController::mLen
-    FASTLED_FORCE_INLINE int size() { return mLen; }
+    /// @copydoc enable_dithering(EDitherMode)
+    void enable_dithering(const OutputProfile &profile) {
+        if(profile.dither == BINARY_DITHER) {
+            init_binary_dithering(profile.ditherSteps);
+        } else {
+            clearDithering();
+        }
+    }
 
     /// Get the number of lanes of the Controller
     /// @returns LANES from template
@@ -311,19 +237,6 @@ struct PixelController {
     /// @returns PixelController::mAdvance
     FASTLED_FORCE_INLINE int advanceBy() { return mAdvance; }
 
-    /// Advance the data pointer forward, adjust position counter
-    FASTLED_FORCE_INLINE void advanceData() { mData += mAdvance; --mLenRemaining;}
-
-    /// Step the dithering forward
-    /// @note If updating here, be sure to update the asm version in clockless_trinket.h!
-    FASTLED_FORCE_INLINE void stepDithering() {
-            // IF UPDATING HERE, BE SURE TO UPDATE THE ASM VERSION IN
-            // clockless_trinket.h!
-            d[0] = e[0] - d[0];
-            d[1] = e[1] - d[1];
-            d[2] = e[2] - d[2];
-    }
-
     /// Some chipsets pre-cycle the first byte, which means we want to cycle byte 0's dithering separately
     FASTLED_FORCE_INLINE void preStepFirstByteDithering() {
         d[RO(0)] = e[RO(0)] - d[RO(0)];
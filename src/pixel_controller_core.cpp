@@ -0,0 +1,213 @@
+/// @file pixel_controller_core.cpp
+/// Out of line scale/dither/reorder core for PixelController<> and PixelIterator
+
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+#include "pixel_controller_core.h"
+#include "fl/five_bit_hd_gamma.h"
+#include "lib8tion/intmap.h"
+#include "lib8tion/scale8.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+void PixelControllerCore::ditherSteps(const CRGB &premixed, uint8_t steps[3]) {
+    for(int i = 0; i < 3; ++i) {
+        uint8_t s = premixed.raw[i];
+        steps[i] = s ? (256/s) + 1 : 0;
+    }
+}
+
+void PixelControllerCore::initBinaryDithering(uint8_t R) {
+    uint8_t steps[3];
+    ditherSteps(mColorAdjustment.premixed, steps);
+    initBinaryDithering(R, steps);
+}
+
+void PixelControllerCore::initBinaryDithering(uint8_t R, const uint8_t steps[3]) {
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+    // R is wrapped around at 2^ditherBits,
+    // so if ditherBits is 2, R will cycle through (0,1,2,3)
+    uint8_t ditherBits = VIRTUAL_BITS;
+    R &= (0x01 << ditherBits) - 1;
+
+    // Q is the "unscaled dither signal" itself.
+    // It's initialized to the reversed bits of R.
+    // If 'ditherBits' is 2, Q here will cycle through (0,128,64,192)
+    uint8_t Q = 0;
+
+    // Reverse bits in a byte
+    {
+        if(R & 0x01) { Q |= 0x80; }
+        if(R & 0x02) { Q |= 0x40; }
+        if(R & 0x04) { Q |= 0x20; }
+        if(R & 0x08) { Q |= 0x10; }
+        if(R & 0x10) { Q |= 0x08; }
+        if(R & 0x20) { Q |= 0x04; }
+        if(R & 0x40) { Q |= 0x02; }
+        if(R & 0x80) { Q |= 0x01; }
+    }
+
+    // Now we adjust Q to fall in the center of each range,
+    // instead of at the start of the range.
+    // If ditherBits is 2, Q will be (0, 128, 64, 192) at first,
+    // and this adjustment makes it (31, 159, 95, 223).
+    if( ditherBits < 8) {
+        Q += 0x01 << (7 - ditherBits);
+    }
+
+    // D and E form the "scaled dither signal"
+    // which is added to pixel values to affect the
+    // actual dithering.
+
+    // Setup the initial D and E values
+    for(int i = 0; i < 3; ++i) {
+            e[i] = steps[i];
+            d[i] = scale8(Q, e[i]);
+#if (FASTLED_SCALE8_FIXED == 1)
+            if(d[i]) (--d[i]);
+#endif
+            if(e[i]) --e[i];
+    }
+#else
+    (void)R;
+    (void)steps;
+    clearDithering();
+#endif
+}
+
+void PixelControllerCore::encodeRGB(const PixelOrder &order, uint8_t *b0_out,
+                                    uint8_t *b1_out, uint8_t *b2_out) const {
+    uint8_t *out[3] = {b0_out, b1_out, b2_out};
+    for (int slot = 0; slot < 3; ++slot) {
+        const uint8_t ch = order.slot[slot];
+        const uint8_t b = mData[ch];
+        *out[slot] = scale8(b ? qadd8(b, d[ch]) : 0,
+                            mColorAdjustment.premixed.raw[ch]);
+    }
+}
+
+void PixelControllerCore::encodeRGBW(const PixelOrder &order, Rgbw rgbw,
+                                     uint8_t *b0_out, uint8_t *b1_out,
+                                     uint8_t *b2_out, uint8_t *b3_out) const {
+#ifdef __AVR__
+    // Don't do RGBW conversion for AVR, just set the W pixel to black.
+    uint8_t out[3];
+    encodeRGB(order, &out[0], &out[1], &out[2]);
+    // Apply w-component insertion.
+    rgbw_partial_reorder(
+        rgbw.w_placement, out[0], out[1], out[2],
+        0, // Pre-ordered RGB data with a 0 white component.
+        b0_out, b1_out, b2_out, b3_out);
+#else
+    // Get the naive RGB data order in r,g,b order.
+    CRGB rgb(mData[0], mData[1], mData[2]);
+    uint8_t w = 0;
+    rgb_2_rgbw(rgbw.rgbw_mode,
+               rgbw.white_color_temp,
+               rgb.r, rgb.g, rgb.b,  // Input colors
+               mColorAdjustment.premixed.r, mColorAdjustment.premixed.g, mColorAdjustment.premixed.b,  // How these colors are scaled for color balance.
+               &rgb.r, &rgb.g, &rgb.b, &w);
+    // Now finish the ordering so that the output is in the native led order for all of RGBW.
+    rgbw_partial_reorder(
+        rgbw.w_placement,
+        rgb.raw[order.slot[0]],  // in-place re-ordering for the RGB data.
+        rgb.raw[order.slot[1]],
+        rgb.raw[order.slot[2]],
+        w,  // The white component is not ordered in this call.
+        b0_out, b1_out, b2_out, b3_out);  // RGBW data now in total native led order.
+#endif
+}
+
+void PixelControllerCore::encodeAPA102HD(const PixelOrder &order,
+                                         uint8_t *b0_out, uint8_t *b1_out,
+                                         uint8_t *b2_out,
+                                         uint8_t *brightness_out) const {
+    CRGB rgb = CRGB(mData[0], mData[1], mData[2]);
+    uint8_t brightness = 0;
+    if (rgb) {
+        #if FASTLED_HD_COLOR_MIXING
+        brightness = mColorAdjustment.brightness;
+        CRGB scale = mColorAdjustment.color;
+        #else
+        brightness = 255;
+        CRGB scale = mColorAdjustment.premixed;
+        #endif
+        fl::five_bit_hd_gamma_bitshift(
+            rgb,
+            scale,
+            brightness,
+            &rgb,
+            &brightness);
+    }
+    *b0_out = rgb.raw[order.slot[0]];
+    *b1_out = rgb.raw[order.slot[1]];
+    *b2_out = rgb.raw[order.slot[2]];
+    *brightness_out = brightness;
+}
+
+void PixelControllerCore::encodeWS2816HD(const PixelOrder &order,
+                                         uint16_t *s0_out, uint16_t *s1_out,
+                                         uint16_t *s2_out) const {
+    // Note that the WS2816 has a 4 bit gamma correction built in. To improve things this algorithm may
+    // change in the future with a partial gamma correction that is completed by the chipset gamma
+    // correction.
+    uint16_t rgb16[3] = {map8_to_16(mData[0]), map8_to_16(mData[1]),
+                         map8_to_16(mData[2])};
+    if (rgb16[0] || rgb16[1] || rgb16[2]) {
+#if FASTLED_HD_COLOR_MIXING
+        uint8_t brightness = mColorAdjustment.brightness;
+        CRGB scale = mColorAdjustment.color;
+#else
+        uint8_t brightness = 255;
+        CRGB scale = mColorAdjustment.premixed;
+#endif
+        for (int i = 0; i < 3; ++i) {
+            if (scale[i] != 255) {
+                rgb16[i] = scale16by8(rgb16[i], scale[i]);
+            }
+        }
+        if (brightness != 255) {
+            for (int i = 0; i < 3; ++i) {
+                rgb16[i] = scale16by8(rgb16[i], brightness);
+            }
+        }
+    }
+    *s0_out = rgb16[order.slot[0]];
+    *s1_out = rgb16[order.slot[1]];
+    *s2_out = rgb16[order.slot[2]];
+}
+
+#if FASTLED_HD_COLOR_MIXING
+void PixelControllerCore::hdScale(const PixelOrder &order, uint8_t *c0,
+                                  uint8_t *c1, uint8_t *c2,
+                                  uint8_t *brightness) const {
+    *c0 = mColorAdjustment.color.raw[order.slot[0]];
+    *c1 = mColorAdjustment.color.raw[order.slot[1]];
+    *c2 = mColorAdjustment.color.raw[order.slot[2]];
+    *brightness = mColorAdjustment.brightness;
+}
+#endif
+
+int PixelControllerCore::writeAll(const PixelOrder &order, Rgbw rgbw,
+                                  uint8_t *out) {
+    uint8_t *const begin = out;
+    if (rgbw.active()) {
+        while (has(1)) {
+            encodeRGBW(order, rgbw, out, out + 1, out + 2, out + 3);
+            out += 4;
+            advanceData();
+            stepDithering();
+        }
+    } else {
+        while (has(1)) {
+            encodeRGB(order, out, out + 1, out + 2);
+            out += 3;
+            advanceData();
+            stepDithering();
+        }
+    }
+    return int(out - begin);
+}
+
+FASTLED_NAMESPACE_END
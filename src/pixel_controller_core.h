@@ -0,0 +1,184 @@
+#pragma once
+
+/// @file pixel_controller_core.h
+/// Non-templated pixel state and encode core shared by every PixelController<>.
+///
+/// PixelController<RGB_ORDER, LANES, MASK> derives from PixelControllerCore,
+/// which holds everything that doesn't depend on the template parameters. The
+/// encode functions here take the color order as runtime data (PixelOrder), so
+/// there is one copy of the scale/dither/reorder code no matter how many
+/// chipset and color order combinations a sketch uses. PixelIterator is built
+/// on top of it. The templated, force inlined PixelController accessors stay
+/// for the bit banged drivers whose timing depends on them.
+
+#include "fl/stdint.h"
+
+#include "crgb.h"
+#include "dither_mode.h"
+#include "eorder.h"
+#include "fl/force_inline.h"
+#include "fl/int.h"
+#include "fl/namespace.h"
+#include "rgbw.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Gets the assigned color channel for a byte's position in the output,
+/// using a passed RGB color order
+/// @param RO the RGB color order
+/// @param X the byte's position in the output (0-2)
+/// @returns the color channel for that byte (0 = red, 1 = green, 2 = blue)
+/// @see EOrder
+#define RGB_BYTE(RO,X) (((RO)>>(3*(2-(X)))) & 0x3)
+
+/// Gets the color channel for byte 0.
+/// @see RGB_BYTE(RO,X)
+#define RGB_BYTE0(RO) ((RO>>6) & 0x3)
+/// Gets the color channel for byte 1.
+/// @see RGB_BYTE(RO,X)
+#define RGB_BYTE1(RO) ((RO>>3) & 0x3)
+/// Gets the color channel for byte 2.
+/// @see RGB_BYTE(RO,X)
+#define RGB_BYTE2(RO) ((RO) & 0x3)
+
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+
+/// Predicted max update rate, in Hertz
+#define MAX_LIKELY_UPDATE_RATE_HZ     400
+
+/// Minimum acceptable dithering rate, in Hertz
+#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
+
+/// The number of updates in a single dither cycle
+#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
+
+/// Set "virtual bits" of dithering to the highest level
+/// that is not likely to cause excessive flickering at
+/// low brightness levels + low update rates.
+/// These pre-set values are a little ambitious, since
+/// a 400Hz update rate for WS2811-family LEDs is only
+/// possible with 85 pixels or fewer.
+/// Once we have a "number of milliseconds since last update"
+/// value available here, we can quickly calculate the correct
+/// number of "virtual bits" on the fly with a couple of "if"
+/// statements -- no division required.  At this point,
+/// the division is done at compile time, so there's no runtime
+/// cost, but the values are still hard-coded.
+/// @todo Can these macros be replaced with constants scoped to PixelController::init_binary_dithering()?
+#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
+
+/// Alias for RECOMMENDED_VIRTUAL_BITS
+#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
+
+#endif
+
+struct ColorAdjustment {
+    CRGB premixed;       /// the per-channel scale values premixed with brightness.
+    #if FASTLED_HD_COLOR_MIXING
+    CRGB color;          /// the per-channel scale values assuming full brightness.
+    uint8_t brightness;  /// the global brightness value
+    #endif
+};
+
+/// What show() derives from a controller's color settings for one
+/// brightness: the premixed scales and the per channel dither steps. A
+/// CLEDController keeps one and rebuilds it only when correction,
+/// temperature, brightness or dither mode change.
+/// @see CLEDController::getOutputProfile()
+struct OutputProfile {
+    ColorAdjustment adjustment;
+    uint8_t ditherSteps[3];  ///< @see PixelControllerCore::ditherSteps()
+    EDitherMode dither;
+};
+
+/// A color order as data: the color channel (0 = red, 1 = green, 2 = blue)
+/// sent in each of the three output byte slots.
+struct PixelOrder {
+    uint8_t slot[3];
+
+    static PixelOrder of(EOrder order) {
+        PixelOrder out;
+        out.slot[0] = uint8_t(RGB_BYTE0(int(order)));
+        out.slot[1] = uint8_t(RGB_BYTE1(int(order)));
+        out.slot[2] = uint8_t(RGB_BYTE2(int(order)));
+        return out;
+    }
+};
+
+/// The part of a PixelController that doesn't depend on its template
+/// parameters, plus the out of line encode functions.
+struct PixelControllerCore {
+    const uint8_t *mData;    ///< pointer to the underlying LED data
+    int mLen;                ///< number of LEDs in the data for one lane
+    int mLenRemaining;       ///< counter for the number of LEDs left to process
+    uint8_t d[3];            ///< values for the scaled dither signal @see init_binary_dithering()
+    uint8_t e[3];            ///< values for the unscaled dither signal @see init_binary_dithering()
+    int8_t mAdvance;         ///< how many bytes to advance the pointer by each time. For CRGB this is 3.
+    ColorAdjustment mColorAdjustment;
+
+    /// Sets up d and e for step R of the binary dither cycle. The caller owns
+    /// the counter, see PixelController::init_binary_dithering().
+    void initBinaryDithering(uint8_t R);
+    /// Same, with the dither steps for mColorAdjustment.premixed already
+    /// worked out, as an OutputProfile caches them.
+    void initBinaryDithering(uint8_t R, const uint8_t steps[3]);
+    /// The unscaled dither step of each channel for a premixed scale,
+    /// (256 / scale) + 1 or 0 when the channel is off.
+    static void ditherSteps(const CRGB &premixed, uint8_t steps[3]);
+    void clearDithering() { d[0] = d[1] = d[2] = e[0] = e[1] = e[2] = 0; }
+
+    /// Do we have n pixels left to process?
+    /// @param n the number to check against
+    /// @returns 'true' if there are more than n pixels left to process
+    FASTLED_FORCE_INLINE bool has(int n) const { return mLenRemaining >= n; }
+
+    /// Get the length of the LED strip
+    /// @returns mLen
+    FASTLED_FORCE_INLINE int size() const { return mLen; }
+
+    /// Advance the data pointer forward, adjust position counter
+    FASTLED_FORCE_INLINE void advanceData() { mData += mAdvance; --mLenRemaining; }
+
+    /// Step the dithering forward
+    /// @note If updating here, be sure to update the asm version in clockless_trinket.h!
+    FASTLED_FORCE_INLINE void stepDithering() {
+            // IF UPDATING HERE, BE SURE TO UPDATE THE ASM VERSION IN
+            // clockless_trinket.h!
+            d[0] = e[0] - d[0];
+            d[1] = e[1] - d[1];
+            d[2] = e[2] - d[2];
+    }
+
+    /// @name Runtime color order encoders
+    /// Same results as the PixelController<> functions of the same purpose
+    /// (loadAndScaleRGB() and friends) for the matching template color order.
+    /// @{
+    void encodeRGB(const PixelOrder &order, uint8_t *b0_out, uint8_t *b1_out,
+                   uint8_t *b2_out) const;
+    void encodeRGBW(const PixelOrder &order, Rgbw rgbw, uint8_t *b0_out,
+                    uint8_t *b1_out, uint8_t *b2_out, uint8_t *b3_out) const;
+    void encodeAPA102HD(const PixelOrder &order, uint8_t *b0_out,
+                        uint8_t *b1_out, uint8_t *b2_out,
+                        uint8_t *brightness_out) const;
+    void encodeWS2816HD(const PixelOrder &order, uint16_t *s0_out,
+                        uint16_t *s1_out, uint16_t *s2_out) const;
+    #if FASTLED_HD_COLOR_MIXING
+    void hdScale(const PixelOrder &order, uint8_t *c0, uint8_t *c1,
+                 uint8_t *c2, uint8_t *brightness) const;
+    #endif
+    /// @}
+
+    /// Encodes all remaining pixels into out (3 or 4 bytes each, the latter
+    /// when rgbw is active), advancing and stepping the dithering per pixel.
+    /// @returns the number of bytes written
+    int writeAll(const PixelOrder &order, Rgbw rgbw, uint8_t *out);
+};
+
+FASTLED_NAMESPACE_END
@@ -8,6 +8,8 @@
 
 #include "fl/fill.h"
 #include "fl/blur.h"
+#include "fl/math8_bulk.h"
+#include "fl/scale8_bulk.h"
 
 #include "FastLED.h"
 
@@ -30,6 +32,82 @@
 
 #include "fl/namespace.h"
 
+namespace fl {
+namespace pixelset_bulk {
+
+// Bulk kernels for the CPixelView operators. The CRGB overloads run the flat
+// byte kernels over n * 3 bytes; for any other pixel type the templates
+// return false and the caller keeps its per pixel loop.
+
+template <typename T> inline bool scale(T *, fl::size, u8) { return false; }
+inline bool scale(CRGB *p, fl::size n, u8 s) {
+    scale8_bulk(p->raw, n * 3, s);
+    return true;
+}
+
+template <typename T> inline bool scale_video(T *, fl::size, u8) { return false; }
+inline bool scale_video(CRGB *p, fl::size n, u8 s) {
+    scale8_video_bulk(p->raw, n * 3, s);
+    return true;
+}
+
+template <typename T> inline bool scale_rgb(T *, fl::size, const T &) { return false; }
+inline bool scale_rgb(CRGB *p, fl::size n, const CRGB &s) {
+    scale8_rgb_bulk(p->raw, n, s.r, s.g, s.b);
+    return true;
+}
+
+template <typename T> inline bool qadd(T *, fl::size, u8) { return false; }
+inline bool qadd(CRGB *p, fl::size n, u8 v) {
+    qadd8_bulk(p->raw, n * 3, v);
+    return true;
+}
+
+template <typename T> inline bool qsub(T *, fl::size, u8) { return false; }
+inline bool qsub(CRGB *p, fl::size n, u8 v) {
+    qsub8_bulk(p->raw, n * 3, v);
+    return true;
+}
+
+template <typename T> inline bool max(T *, fl::size, u8) { return false; }
+inline bool max(CRGB *p, fl::size n, u8 v) {
+    max8_bulk(p->raw, n * 3, v);
+    return true;
+}
+
+template <typename T> inline bool min(T *, fl::size, u8) { return false; }
+inline bool min(CRGB *p, fl::size n, u8 v) {
+    min8_bulk(p->raw, n * 3, v);
+    return true;
+}
+
+template <typename T> inline bool qadd(T *, const T *, fl::size) { return false; }
+inline bool qadd(CRGB *d, const CRGB *s, fl::size n) {
+    qadd8_bulk(d->raw, s->raw, n * 3);
+    return true;
+}
+
+template <typename T> inline bool qsub(T *, const T *, fl::size) { return false; }
+inline bool qsub(CRGB *d, const CRGB *s, fl::size n) {
+    qsub8_bulk(d->raw, s->raw, n * 3);
+    return true;
+}
+
+template <typename T> inline bool max(T *, const T *, fl::size) { return false; }
+inline bool max(CRGB *d, const CRGB *s, fl::size n) {
+    max8_bulk(d->raw, s->raw, n * 3);
+    return true;
+}
+
+template <typename T> inline bool min(T *, const T *, fl::size) { return false; }
+inline bool min(CRGB *d, const CRGB *s, fl::size n) {
+    min8_bulk(d->raw, s->raw, n * 3);
+    return true;
+}
+
+} // namespace pixelset_bulk
+} // namespace fl
+
 FASTLED_NAMESPACE_BEGIN
 
 template<class PIXEL_TYPE>
@@ -118,8 +196,7 @@ public:
     /// Assign the passed in color to all elements in this set
     /// @param color the new color for the elements in the set
     inline CPixelView & operator=(const PIXEL_TYPE & color) {
-        for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) = color; }
-        return *this;
+        return forEach([&color](PIXEL_TYPE & pixel) { pixel = color; });
     }
 
     /// Print debug data to serial, disabled for release. 
@@ -137,67 +214,87 @@ public:
     /// @note If one set is smaller than the other, only the
     /// smallest number of items will be copied over.
     inline CPixelView & operator=(const CPixelView & rhs) {
-        for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) {
-            (*pixel) = (*rhspixel);
-        }
-        return *this;
+        return pairwise(rhs, [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel = other; });
     }
 
     /// @name Modification/Scaling Operators
     /// @{
 
     /// Add the passed in value to all channels for all of the pixels in this set
-    inline CPixelView & addToRGB(uint8_t inc) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) += inc; } return *this; }
+    inline CPixelView & addToRGB(uint8_t inc) {
+        if(fl::pixelset_bulk::qadd(first(), count(), inc)) { return *this; }
+        return forEach([inc](PIXEL_TYPE & pixel) { pixel.addToRGB(inc); });
+    }
     /// Add every pixel in the other set to this set
-    inline CPixelView & operator+=(CPixelView & rhs) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { (*pixel) += (*rhspixel); } return *this; }
+    inline CPixelView & operator+=(CPixelView & rhs) {
+        return pairwise(rhs, [](PIXEL_TYPE * d, const PIXEL_TYPE * s, fl::size n) { return fl::pixelset_bulk::qadd(d, s, n); },
+                        [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel += other; });
+    }
 
     /// Subtract the passed in value from all channels for all of the pixels in this set
-    inline CPixelView & subFromRGB(uint8_t inc) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) -= inc; } return *this; }
+    inline CPixelView & subFromRGB(uint8_t inc) {
+        if(fl::pixelset_bulk::qsub(first(), count(), inc)) { return *this; }
+        return forEach([inc](PIXEL_TYPE & pixel) { pixel.subtractFromRGB(inc); });
+    }
     /// Subtract every pixel in the other set from this set
-    inline CPixelView & operator-=(CPixelView & rhs) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { (*pixel) -= (*rhspixel); } return *this; }
+    inline CPixelView & operator-=(CPixelView & rhs) {
+        return pairwise(rhs, [](PIXEL_TYPE * d, const PIXEL_TYPE * s, fl::size n) { return fl::pixelset_bulk::qsub(d, s, n); },
+                        [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel -= other; });
+    }
 
     /// Increment every pixel value in this set
-    inline CPixelView & operator++() { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel)++; } return *this; }
+    inline CPixelView & operator++() {
+        if(fl::pixelset_bulk::qadd(first(), count(), 1)) { return *this; }
+        return forEach([](PIXEL_TYPE & pixel) { pixel++; });
+    }
     /// Increment every pixel value in this set
     inline CPixelView & operator++(int DUMMY_ARG) {
         FASTLED_UNUSED(DUMMY_ARG);
-        for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) {
-            (*pixel)++;
-        }
-        return *this;
+        return ++(*this);
     }
 
     /// Decrement every pixel value in this set
-    inline CPixelView & operator--() { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel)--; } return *this; }
+    inline CPixelView & operator--() {
+        if(fl::pixelset_bulk::qsub(first(), count(), 1)) { return *this; }
+        return forEach([](PIXEL_TYPE & pixel) { pixel--; });
+    }
     /// Decrement every pixel value in this set
     inline CPixelView & operator--(int DUMMY_ARG) {
         FASTLED_UNUSED(DUMMY_ARG);
-        for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) {
-            (*pixel)--;
-        }
-        return *this;
+        return --(*this);
     }
 
     /// Divide every LED by the given value
-    inline CPixelView & operator/=(uint8_t d) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) /= d; } return *this; }
+    inline CPixelView & operator/=(uint8_t d) { return forEach([d](PIXEL_TYPE & pixel) { pixel /= d; }); }
     /// Shift every LED in this set right by the given number of bits
-    inline CPixelView & operator>>=(uint8_t d) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) >>= d; } return *this; }
+    inline CPixelView & operator>>=(uint8_t d) { return forEach([d](PIXEL_TYPE & pixel) { pixel >>= d; }); }
     /// Multiply every LED in this set by the given value
-    inline CPixelView & operator*=(uint8_t d) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) *= d; } return *this; }
+    inline CPixelView & operator*=(uint8_t d) { return forEach([d](PIXEL_TYPE & pixel) { pixel *= d; }); }
 
     /// Scale every LED by the given scale
-    inline CPixelView & nscale8_video(uint8_t scaledown) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel).nscale8_video(scaledown); } return *this;}
+    inline CPixelView & nscale8_video(uint8_t scaledown) {
+        if(fl::pixelset_bulk::scale_video(first(), count(), scaledown)) { return *this; }
+        return forEach([scaledown](PIXEL_TYPE & pixel) { pixel.nscale8_video(scaledown); });
+    }
     /// Scale down every LED by the given scale
-    inline CPixelView & operator%=(uint8_t scaledown) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel).nscale8_video(scaledown); } return *this; }
+    inline CPixelView & operator%=(uint8_t scaledown) { return nscale8_video(scaledown); }
     /// Fade every LED down by the given scale
     inline CPixelView & fadeLightBy(uint8_t fadefactor) { return nscale8_video(255 - fadefactor); }
 
     /// Scale every LED by the given scale
-    inline CPixelView & nscale8(uint8_t scaledown) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel).nscale8(scaledown); } return *this; }
+    inline CPixelView & nscale8(uint8_t scaledown) {
+        if(fl::pixelset_bulk::scale(first(), count(), scaledown)) { return *this; }
+        return forEach([scaledown](PIXEL_TYPE & pixel) { pixel.nscale8(scaledown); });
+    }
     /// Scale every LED by the given scale
-    inline CPixelView & nscale8(PIXEL_TYPE & scaledown) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel).nscale8(scaledown); } return *this; }
+    inline CPixelView & nscale8(PIXEL_TYPE & scaledown) {
+        if(fl::pixelset_bulk::scale_rgb(first(), count(), scaledown)) { return *this; }
+        return forEach([&scaledown](PIXEL_TYPE & pixel) { pixel.nscale8(scaledown); });
+    }
     /// Scale every LED in this set by every led in the other set
-    inline CPixelView & nscale8(CPixelView & rhs) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { (*pixel).nscale8((*rhspixel)); } return *this; }
+    inline CPixelView & nscale8(CPixelView & rhs) {
+        return pairwise(rhs, [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel.nscale8(other); });
+    }
 
     /// Fade every LED down by the given scale
     inline CPixelView & fadeToBlackBy(uint8_t fade) { return nscale8(255 - fade); }
@@ -205,30 +302,45 @@ public:
     /// Apply the PIXEL_TYPE |= operator to every pixel in this set with the given PIXEL_TYPE value. 
     /// With CRGB, this brings up each channel to the higher of the two values
     /// @see CRGB::operator|=
-    inline CPixelView & operator|=(const PIXEL_TYPE & rhs) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) |= rhs; } return *this; }
+    inline CPixelView & operator|=(const PIXEL_TYPE & rhs) { return forEach([&rhs](PIXEL_TYPE & pixel) { pixel |= rhs; }); }
     /// Apply the PIXEL_TYPE |= operator to every pixel in this set with every pixel in the passed in set. 
     /// @copydetails operator|=(const PIXEL_TYPE&)
-    inline CPixelView & operator|=(const CPixelView & rhs) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { (*pixel) |= (*rhspixel); } return *this; }
+    inline CPixelView & operator|=(const CPixelView & rhs) {
+        return pairwise(rhs, [](PIXEL_TYPE * d, const PIXEL_TYPE * s, fl::size n) { return fl::pixelset_bulk::max(d, s, n); },
+                        [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel |= other; });
+    }
     /// Apply the PIXEL_TYPE |= operator to every pixel in this set. 
     /// @copydetails operator|=(const PIXEL_TYPE&)
-    inline CPixelView & operator|=(uint8_t d) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) |= d; } return *this; }
+    inline CPixelView & operator|=(uint8_t d) {
+        if(fl::pixelset_bulk::max(first(), count(), d)) { return *this; }
+        return forEach([d](PIXEL_TYPE & pixel) { pixel |= d; });
+    }
 
     /// Apply the PIXEL_TYPE &= operator to every pixel in this set with the given PIXEL_TYPE value. 
     /// With CRGB, this brings up each channel down to the lower of the two values
     /// @see CRGB::operator&=
-    inline CPixelView & operator&=(const PIXEL_TYPE & rhs) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) &= rhs; } return *this; }
+    inline CPixelView & operator&=(const PIXEL_TYPE & rhs) { return forEach([&rhs](PIXEL_TYPE & pixel) { pixel &= rhs; }); }
     /// Apply the PIXEL_TYPE &= operator to every pixel in this set with every pixel in the passed in set. 
     /// @copydetails operator&=(const PIXEL_TYPE&)
-    inline CPixelView & operator&=(const CPixelView & rhs) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { (*pixel) &= (*rhspixel); } return *this; }
+    inline CPixelView & operator&=(const CPixelView & rhs) {
+        return pairwise(rhs, [](PIXEL_TYPE * d, const PIXEL_TYPE * s, fl::size n) { return fl::pixelset_bulk::min(d, s, n); },
+                        [](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { pixel &= other; });
+    }
     /// Apply the PIXEL_TYPE &= operator to every pixel in this set with the passed in value. 
     /// @copydetails operator&=(const PIXEL_TYPE&)
-    inline CPixelView & operator&=(uint8_t d) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { (*pixel) &= d; } return *this; }
+    inline CPixelView & operator&=(uint8_t d) {
+        if(fl::pixelset_bulk::min(first(), count(), d)) { return *this; }
+        return forEach([d](PIXEL_TYPE & pixel) { pixel &= d; });
+    }
 
     /// @} Modification/Scaling Operators
 
 
     /// Returns whether or not any LEDs in this set are non-zero
-    inline operator bool() { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { if((*pixel)) return true; } return false; }
+    inline operator bool() {
+        for(const PIXEL_TYPE * pixel = first(), * _end = first() + count(); pixel != _end; ++pixel) { if((*pixel)) return true; }
+        return false;
+    }
 
 
     /// @name Color Util Functions
@@ -346,13 +458,17 @@ public:
     /// @param overlay the color to blend in
     /// @param amountOfOverlay the fraction of overlay to blend in
     /// @see ::nblend(CRGB&, const CRGB&, fract8)
-    inline CPixelView & nblend(const PIXEL_TYPE & overlay, fract8 amountOfOverlay) { for(iterator pixel = begin(), _end = end(); pixel != _end; ++pixel) { FUNCTION_NBLEND((*pixel), overlay, amountOfOverlay); } return *this; }
+    inline CPixelView & nblend(const PIXEL_TYPE & overlay, fract8 amountOfOverlay) {
+        return forEach([&overlay, amountOfOverlay](PIXEL_TYPE & pixel) { FUNCTION_NBLEND(pixel, overlay, amountOfOverlay); });
+    }
 
     /// Destructively blend another set of LEDs into this one
     /// @param rhs the set of LEDs to blend into this set
     /// @param amountOfOverlay the fraction of each color in the other set to blend in
     /// @see ::nblend(CRGB&, const CRGB&, fract8)
-    inline CPixelView & nblend(const CPixelView & rhs, fract8 amountOfOverlay) { for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) { FUNCTION_NBLEND((*pixel), (*rhspixel), amountOfOverlay); } return *this; }
+    inline CPixelView & nblend(const CPixelView & rhs, fract8 amountOfOverlay) {
+        return pairwise(rhs, [amountOfOverlay](PIXEL_TYPE & pixel, const PIXEL_TYPE & other) { FUNCTION_NBLEND(pixel, other, amountOfOverlay); });
+    }
 
     /// One-dimensional blur filter
     /// @param blur_amount the amount of blur to apply
@@ -439,6 +555,54 @@ public:
     const_iterator cend() const { return const_iterator(end_pos, dir); }  ///< Makes a const iterator instance for the end of the LED set, const qualified
 
     /// @} Iterator
+
+private:
+    // A set covers one contiguous run of memory in either direction, from
+    // first() up for count() pixels. Ops that treat every pixel alike run
+    // over that run and don't care about dir.
+    PIXEL_TYPE * first() const { return dir >= 0 ? leds : leds + len + 1; }
+    fl::size count() const { return fl::size(dir >= 0 ? len : -len); }
+
+    template<typename Fn>
+    CPixelView & forEach(Fn fn) {
+        for(PIXEL_TYPE * pixel = first(), * _end = pixel + count(); pixel != _end; ++pixel) { fn(*pixel); }
+        return *this;
+    }
+
+    // Applies each(pixel, rhspixel) to the pixels the two sets pair up, in
+    // the order the iterators would. Sets that run the same way pair run[i]
+    // with rhsrun[i] and go through bulk(run, rhsrun, n) when it returns
+    // true; sets that run opposite ways pair run[i] with rhsrun[n - 1 - i].
+    // Overlapping sets keep the iterator loop, its order is observable there.
+    template<typename Bulk, typename Each>
+    CPixelView & pairwise(const CPixelView & rhs, Bulk bulk, Each each) {
+        const fl::size n = count() < rhs.count() ? count() : rhs.count();
+        PIXEL_TYPE * run = dir >= 0 ? leds : leds - n + 1;
+        const PIXEL_TYPE * rhsrun = rhs.dir >= 0 ? rhs.leds : rhs.leds - n + 1;
+        const bool same = dir == rhs.dir;
+        const fl::uptr a = fl::uptr(run), b = fl::uptr(rhsrun);
+        const fl::uptr bytes = fl::uptr(n * sizeof(PIXEL_TYPE));
+        const bool disjoint = (a + bytes <= b) || (b + bytes <= a);
+        if(same && (disjoint || a == b)) {
+            if(!bulk(run, rhsrun, n)) {
+                for(fl::size i = 0; i < n; ++i) { each(run[i], rhsrun[i]); }
+            }
+            return *this;
+        }
+        if(!same && disjoint) {
+            for(fl::size i = 0; i < n; ++i) { each(run[i], rhsrun[n - 1 - i]); }
+            return *this;
+        }
+        for(iterator pixel = begin(), rhspixel = rhs.begin(), _end = end(), rhs_end = rhs.end(); (pixel != _end) && (rhspixel != rhs_end); ++pixel, ++rhspixel) {
+            each(*pixel, *rhspixel);
+        }
+        return *this;
+    }
+
+    template<typename Each>
+    CPixelView & pairwise(const CPixelView & rhs, Each each) {
+        return pairwise(rhs, [](PIXEL_TYPE *, const PIXEL_TYPE *, fl::size) { return false; }, each);
+    }
 };
 
 FASTLED_FORCE_INLINE
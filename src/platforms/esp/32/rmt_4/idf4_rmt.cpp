@@ -87,22 +87,7 @@ void RmtController::loadPixelDataForStreamEncoding(PixelIterator &pixels) {
     const int size_per_pixel = is_rgbw ? 4 : 3;
     const int size_in_bytes = pixels.size() * size_per_pixel;
     uint8_t *pData = getPixelBuffer(size_in_bytes);
-
-    if (!is_rgbw) {
-        while (pixels.has(1)) {
-            pixels.loadAndScaleRGB(pData, pData + 1, pData + 2);
-            pData += 3;
-            pixels.advanceData();
-            pixels.stepDithering();
-        }
-    } else {
-        while (pixels.has(1)) {
-            pixels.loadAndScaleRGBW(pData, pData + 1, pData + 2, pData + 3);
-            pData += 4;
-            pixels.advanceData();
-            pixels.stepDithering();
-        }
-    }
+    pixels.writeAll(pData);
 }
 
 #endif // FASTLED_RMT5
@@ -13,6 +13,7 @@
 #include "FastLED.h"
 #include "fl/force_inline.h"
 #include "fl/assert.h"
+#include "fl/rmt_symbol_encoder.h"
 #include "platforms/esp/32/rmt_4/idf4_rmt.h"
 #include "platforms/esp/32/rmt_4/idf4_rmt_impl.h"
 #include "platforms/esp/32/clock_cycles.h"
@@ -232,37 +233,6 @@ typedef struct
 extern rmt_block_mem_t RMTMEM;
 #endif
 
-// -- Write one byte's worth of RMT pulses to the big buffer
-//    out: A pointer into an array at least 8 units long (one unit for each bit).
-FASTLED_FORCE_INLINE void IRAM_ATTR convert_byte_to_rmt(
-    FASTLED_REGISTER uint8_t byteval,
-    FASTLED_REGISTER uint32_t zero,
-    FASTLED_REGISTER uint32_t one,
-    volatile rmt_item32_t *out)
-{
-    FASTLED_REGISTER uint32_t pixel_u32 = byteval;
-    pixel_u32 <<= 24;
-    uint32_t tmp[8];
-    for (FASTLED_REGISTER uint32_t j = 0; j < 8; j++)
-    {
-        FASTLED_REGISTER uint32_t new_val = (pixel_u32 & 0x80000000L) ? one : zero;
-        pixel_u32 <<= 1;
-        // Write to a non volatile buffer to keep this fast and
-        // allow the compiler to optimize this loop.
-        tmp[j] = new_val;
-    }
-
-    // Now write out the values to the volatile buffer
-    out[0].val = tmp[0];
-    out[1].val = tmp[1];
-    out[2].val = tmp[2];
-    out[3].val = tmp[3];
-    out[4].val = tmp[4];
-    out[5].val = tmp[5];
-    out[6].val = tmp[6];
-    out[7].val = tmp[7];
-}
-
 void GiveGTX_sem()
 {
     if (gTX_sem != NULL)
@@ -303,6 +273,7 @@ ESP32RMTController::ESP32RMTController(int DATA_PIN, int T1, int T2, int T3, int
     // T0L
     mZero.level1 = 0;
     mZero.duration1 = ESP_TO_RMT_CYCLES(T2 + T3); // TO_RMT_CYCLES(T2 + T3);
+    mEncoder.set(mZero.val, mOne.val);
 
     gControllers[gNumControllers] = this;
     gNumControllers++;
@@ -901,31 +872,33 @@ void ESP32RMTController::fillNext(bool check_time)
     }
     mLastFill = now;
 
-    // -- Get the zero and one values into local variables
-    FASTLED_REGISTER uint32_t one_val = mOne.val;
-    FASTLED_REGISTER uint32_t zero_val = mZero.val;
-
     // -- Use locals for speed
     volatile FASTLED_REGISTER rmt_item32_t *pItem = mRMT_mem_ptr;
+    volatile uint32_t *pWords = reinterpret_cast<volatile uint32_t *>(pItem);
 
-    for (FASTLED_REGISTER int i = 0; i < PULSES_PER_FILL / 8; i++)
+    // -- Encode the next bytes in one pass through the nibble table
+    int bytes = mSize - mCur;
+    if (bytes > PULSES_PER_FILL / 8)
     {
-        if (mCur < mSize)
-        {
+        bytes = PULSES_PER_FILL / 8;
+    }
+    if (bytes > 0)
+    {
+        pWords += mEncoder.encode(mPixelData + mCur, bytes, pWords);
+        mCur += bytes;
+    }
+    else
+    {
+        bytes = 0;
+    }
 
-            // -- Get the next four bytes of pixel data
-            convert_byte_to_rmt(mPixelData[mCur], zero_val, one_val, pItem);
-            pItem += 8;
-            mCur++;
-        }
-        else
-        {
-            // -- No more data; signal to the RMT we are done by filling the
-            //    rest of the buffer with zeros
-            pItem->val = 0;
-            pItem++;
-        }
+    // -- No more data; signal to the RMT we are done by filling the
+    //    rest of the buffer with zeros
+    for (FASTLED_REGISTER int i = bytes; i < PULSES_PER_FILL / 8; i++)
+    {
+        *pWords++ = 0;
     }
+    pItem = reinterpret_cast<volatile rmt_item32_t *>(pWords);
 
     // -- Flip to the other half, resetting the pointer if necessary
     mWhichHalf++;
@@ -958,7 +931,7 @@ void ESP32RMTController::initPulseBuffer(int size_in_bytes)
 //    This function is only used when the built-in RMT driver is chosen
 void ESP32RMTController::ingest(uint8_t byteval)
 {
-    convert_byte_to_rmt(byteval, mZero.val, mOne.val, mBuffer + mCurPulse);
+    mEncoder.encode(byteval, reinterpret_cast<uint32_t *>(mBuffer + mCurPulse));
     mCurPulse += 8;
 }
 
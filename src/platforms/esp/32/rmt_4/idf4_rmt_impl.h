@@ -13,6 +13,7 @@
 #include "FastLED.h"
 #include "idf4_rmt.h"
 #include "platforms/esp/32/clock_cycles.h"
+#include "fl/rmt_symbol_encoder.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -78,6 +79,7 @@ private:
     // -- Timing values for zero and one bits, derived from T1, T2, and T3
     rmt_item32_t mZero;
     rmt_item32_t mOne;
+    fl::RmtSymbolEncoder mEncoder; // Bytes to RMT items, built from mZero/mOne.
 
     // -- Total expected time to send 32 bits
     //    Each strip should get an interrupt roughly at this interval
@@ -65,6 +65,25 @@ public:
         return _file.isOpen(); 
     }
 };
+
+class SdFatFileWriter : public FileWriter {
+private:
+    SdFile _file;
+
+public:
+    explicit SdFatFileWriter(SdFile file) : _file(fl::move(file)) {}
+    ~SdFatFileWriter() override { close(); }
+
+    bool write(const fl::u8 *data, fl::size n) override {
+        return _file.isOpen() && fl::size(_file.write(data, n)) == n;
+    }
+    bool close() override {
+        if (!_file.isOpen()) {
+            return false;
+        }
+        return _file.close();
+    }
+};
 #else
 class SDFileHandle : public FileHandle {
 private:
@@ -114,6 +133,26 @@ public:
         return f; 
     }
 };
+
+class SDFileWriter : public FileWriter {
+private:
+    File _file;
+
+public:
+    explicit SDFileWriter(File file) : _file(file) {}
+    ~SDFileWriter() override { close(); }
+
+    bool write(const fl::u8 *data, fl::size n) override {
+        return _file && fl::size(_file.write(data, n)) == n;
+    }
+    bool close() override {
+        if (!_file) {
+            return false;
+        }
+        _file.close();
+        return true;
+    }
+};
 #endif
 
 class FsArduino : public FsImpl {
@@ -157,6 +196,34 @@ public:
 #endif
     }
 
+    FileWriterPtr openWrite(const char *name) override {
+#ifdef USE_SDFAT
+        SdFile file;
+        if (!file.open(name, O_WRITE | O_CREAT | O_TRUNC)) {
+            return FileWriterPtr();
+        }
+        return fl::make_intrusive<SdFatFileWriter>(fl::move(file));
+#else
+        // FILE_WRITE appends on most cores, so replace the file explicitly.
+        if (SD.exists(name)) {
+            SD.remove(name);
+        }
+        File file = SD.open(name, FILE_WRITE);
+        if (!file) {
+            return FileWriterPtr();
+        }
+        return fl::make_intrusive<SDFileWriter>(file);
+#endif
+    }
+
+    bool mkdir(const char *path) override {
+#ifdef USE_SDFAT
+        return _sd.exists(path) || _sd.mkdir(path);
+#else
+        return SD.exists(path) || SD.mkdir(path);
+#endif
+    }
+
     void close(FileHandlePtr file) override {
         // The close operation is now handled in the FileHandle wrapper classes
         // This method ensures the file is properly closed
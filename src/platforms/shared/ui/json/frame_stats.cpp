@@ -0,0 +1,69 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "FastLED.h"
+
+#include "fl/frame_stats.h"
+#include "fl/json.h"
+#include "fl/namespace.h"
+
+#include "platforms/shared/ui/json/frame_stats.h"
+#include "platforms/shared/ui/json/ui.h"
+
+#if FASTLED_ENABLE_JSON
+
+namespace fl {
+
+JsonFrameStatsImpl::JsonFrameStatsImpl(const string &name, fl::u32 intervalMs)
+    : mIntervalMs(intervalMs) {
+    JsonUiInternal::UpdateFunction update_fcn;
+    JsonUiInternal::ToJsonFunction to_json_fcn =
+        JsonUiInternal::ToJsonFunction([this](FLArduinoJson::JsonObject &json) {
+            static_cast<JsonFrameStatsImpl *>(this)->toJson(json);
+        });
+    mInternal = fl::make_intrusive<JsonUiInternal>(name, update_fcn, to_json_fcn);
+    addJsonUiComponent(mInternal);
+    mUpdater.init(this);
+}
+
+JsonFrameStatsImpl::~JsonFrameStatsImpl() { removeJsonUiComponent(mInternal); }
+
+JsonFrameStatsImpl &JsonFrameStatsImpl::Group(const fl::string &name) {
+    mInternal->setGroup(name);
+    return *this;
+}
+
+const string &JsonFrameStatsImpl::name() const { return mInternal->name(); }
+
+void JsonFrameStatsImpl::toJson(FLArduinoJson::JsonObject &json) const {
+    json["name"] = name();
+    json["group"] = mInternal->groupName().c_str();
+    json["type"] = "frame_stats";
+    json["id"] = mInternal->id();
+    FLArduinoJson::JsonObject stats = json["stats"].to<FLArduinoJson::JsonObject>();
+    FrameStats::instance().toJson(stats);
+}
+
+const fl::string &JsonFrameStatsImpl::groupName() const { return mInternal->groupName(); }
+
+void JsonFrameStatsImpl::setGroup(const fl::string &groupName) { mInternal->setGroup(groupName); }
+
+void JsonFrameStatsImpl::Updater::init(JsonFrameStatsImpl *owner) {
+    mOwner = owner;
+    fl::EngineEvents::addListener(this);
+}
+
+JsonFrameStatsImpl::Updater::~Updater() { fl::EngineEvents::removeListener(this); }
+
+void JsonFrameStatsImpl::Updater::onEndFrame() {
+    const fl::u32 now = ::millis();
+    if (now - mOwner->mLastPublish >= mOwner->mIntervalMs) {
+        mOwner->mLastPublish = now;
+        mOwner->mInternal->markChanged();
+    }
+}
+
+} // namespace fl
+
+#endif // FASTLED_ENABLE_JSON
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "fl/stdint.h"
+
+#include "fl/engine_events.h"
+#include "fl/str.h"
+#include "platforms/shared/ui/json/ui_internal.h"
+
+namespace fl {
+
+// Publishes fl::FrameStats as a read only "frame_stats" component. The
+// component is marked changed at most once per interval, so the frontend
+// gets a fresh snapshot without a json message every frame.
+class JsonFrameStatsImpl {
+  public:
+    JsonFrameStatsImpl(const fl::string &name, fl::u32 intervalMs = 1000);
+    ~JsonFrameStatsImpl();
+    JsonFrameStatsImpl &Group(const fl::string &name);
+
+    const fl::string &name() const;
+    void toJson(FLArduinoJson::JsonObject &json) const;
+    const fl::string &groupName() const;
+
+    // Method to allow parent UIElement class to set the group
+    void setGroup(const fl::string &groupName);
+
+    void setInterval(fl::u32 intervalMs) { mIntervalMs = intervalMs; }
+    fl::u32 interval() const { return mIntervalMs; }
+
+    int id() const {
+      return mInternal->id();
+    }
+
+  private:
+    struct Updater : fl::EngineEvents::Listener {
+        void init(JsonFrameStatsImpl *owner);
+        ~Updater();
+        void onEndFrame() override;
+        JsonFrameStatsImpl *mOwner = nullptr;
+    };
+
+    Updater mUpdater;
+
+    JsonUiInternalPtr mInternal;
+    fl::u32 mIntervalMs;
+    fl::u32 mLastPublish = 0;
+};
+
+} // namespace fl
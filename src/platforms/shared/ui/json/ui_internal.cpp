@@ -69,7 +69,13 @@ bool JsonUiInternal::hasChanged() const {
 }
 
 void JsonUiInternal::markChanged() {
+    // Called under the lock, so setChangeListener(nullptr) returning means
+    // the old listener is no longer used. The listener takes its own lock
+    // after this one and must never call back in while holding it.
     fl::lock_guard<fl::mutex> lock(mMutex);
+    if (!mHasChanged && mChangeListener) {
+        mChangeListener->onComponentChanged(mId);
+    }
     mHasChanged = true;
 }
 
@@ -78,6 +84,11 @@ void JsonUiInternal::clearChanged() {
     mHasChanged = false;
 }
 
+void JsonUiInternal::setChangeListener(ChangeListener *listener) {
+    fl::lock_guard<fl::mutex> lock(mMutex);
+    mChangeListener = listener;
+}
+
 int JsonUiInternal::nextId() {
     static fl::atomic<uint32_t> sNextId(0);
     return sNextId.fetch_add(1);
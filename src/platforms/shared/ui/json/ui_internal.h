@@ -20,6 +20,14 @@ class JsonUiInternal : public fl::Referent {
         fl::function<void(const FLArduinoJson::JsonVariantConst &)>;
     using ToJsonFunction = fl::function<void(FLArduinoJson::JsonObject &)>;
 
+    // Told when markChanged() sets the changed flag, so the manager can keep
+    // a dirty list instead of polling every component each frame.
+    class ChangeListener {
+      public:
+        virtual ~ChangeListener() = default;
+        virtual void onComponentChanged(int id) = 0;
+    };
+
     JsonUiInternal(const fl::string &name, UpdateFunction updateFunc,
                  ToJsonFunction toJsonFunc);
     ~JsonUiInternal();
@@ -37,6 +45,7 @@ class JsonUiInternal : public fl::Referent {
     bool hasChanged() const;
     void markChanged();
     void clearChanged();
+    void setChangeListener(ChangeListener *listener);
 
     bool clearFunctions();
 
@@ -49,6 +58,7 @@ class JsonUiInternal : public fl::Referent {
     fl::string mGroup;
     mutable fl::mutex mMutex;
     mutable bool mHasChanged = false; // Track if component has changed since last poll
+    ChangeListener *mChangeListener = nullptr;
 };
 
 } // namespace fl
@@ -1,5 +1,6 @@
 #include "fl/json.h"
 #include "fl/map.h"
+#include "fl/memory_budget.h"
 #include "fl/mutex.h"
 #include "fl/namespace.h"
 #include "ui_manager.h"
@@ -7,6 +8,7 @@
 #include "fl/warn.h"
 #include "fl/assert.h"
 #include "fl/string.h"
+#include "fl/trace.h"
 
 
 FL_DISABLE_WARNING(deprecated-declarations)
@@ -19,6 +21,8 @@ namespace fl {
 // Constructor is inline in header, just add logging to destructor
 JsonUiManager::JsonUiManager(Callback updateJs) : mUpdateJs(updateJs) {
     fl::EngineEvents::addListener(this);
+    // Json serialization does not need to happen on the frame path.
+    fl::EngineEvents::setDeferred(this, true, fl::FrameScheduler::kNormal);
 }
 
 
@@ -35,27 +39,88 @@ JsonUiManager::~JsonUiManager() {
     // FL_WARN("*************************************************************");
     // FL_ASSERT(false, "JsonUiManager destructor should not be running during UI updates");
     fl::EngineEvents::removeListener(this);
+    // Detached outside mMutex: markChanged() calls in with the component's
+    // lock held, the other order could deadlock.
+    fl::vector<JsonUiInternalPtr> components;
+    {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        for (auto &componentRef : mComponents) {
+            if (auto component = componentRef.lock()) {
+                components.push_back(component);
+            }
+        }
+    }
+    for (auto &component : components) {
+        component->setChangeListener(nullptr);
+    }
 }
 
 void JsonUiManager::addComponent(fl::WeakPtr<JsonUiInternal> component) {
     //FL_WARN("*** JsonUiManager::addComponent ENTRY ***");
-    fl::lock_guard<fl::mutex> lock(mMutex);
-    mComponents.insert(component);
-    mItemsAdded = true;
-    
-    // Mark the component as changed so it gets sent to the frontend initially
-    if (auto ptr = component.lock()) {
-        ptr->markChanged();
-        //FL_WARN("*** COMPONENT REGISTERED: ID " << ptr->id() << " name=" << ptr->name() << " (Total: " << mComponents.size() << ")");
+    auto ptr = component.lock();
+    {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        mComponents.insert(component);
+        // New components go out with the next full snapshot.
+        mItemsAdded = true;
+        if (ptr) {
+            mById.insert(ptr->id(), component);
+            auto existing = mByName.find_value(ptr->name());
+            if (!existing || !existing->lock()) {
+                mByName.insert(ptr->name(), component);
+            }
+            //FL_WARN("*** COMPONENT REGISTERED: ID " << ptr->id() << " name=" << ptr->name() << " (Total: " << mComponents.size() << ")");
+        }
+    }
+    // Outside mMutex, see ~JsonUiManager().
+    if (ptr) {
+        ptr->setChangeListener(this);
     }
 }
 
 void JsonUiManager::removeComponent(fl::WeakPtr<JsonUiInternal> component) {
+    auto ptr = component.lock();
+    if (ptr) {
+        ptr->setChangeListener(nullptr);
+    }
     fl::lock_guard<fl::mutex> lock(mMutex);
     mComponents.erase(component);
+    if (ptr) {
+        mById.erase(ptr->id());
+        auto named = mByName.find_value(ptr->name());
+        if (named && *named == component) {
+            mByName.erase(ptr->name());
+            indexName(ptr->name());
+        }
+    }
+}
+
+void JsonUiManager::indexName(const fl::string &name) {
+    // Rare, only when a shared name loses its first owner.
+    for (auto &componentRef : mComponents) {
+        auto component = componentRef.lock();
+        if (component && component->name() == name) {
+            mByName.insert(name, componentRef);
+            return;
+        }
+    }
+}
+
+JsonUiInternalPtr
+JsonUiManager::lockOrPrune(const fl::WeakPtr<JsonUiInternal> &ref) {
+    if (auto component = ref.lock()) {
+        return component;
+    }
+    // Destroyed without removeComponent(), drop it from the set. The caller
+    // erases the index entry it came from.
+    fl::WeakPtr<JsonUiInternal> expired = ref;
+    mComponents.erase(expired);
+    return JsonUiInternalPtr();
 }
 
 void JsonUiManager::processPendingUpdates() {
+    FL_TRACE_SCOPE("ui.update");
+    MemScope scope(MemCategory::kJson);
     // Force immediate processing of pending updates (for testing)
 
     if (mHasPendingUpdate) {
@@ -65,50 +130,78 @@ void JsonUiManager::processPendingUpdates() {
     }
 
 
-    bool shouldUpdate = false;
+    bool fullSnapshot = false;
     {
         fl::lock_guard<fl::mutex> lock(mMutex);
-        // Check if new components were added
-        shouldUpdate = mItemsAdded;
+        if (!mItemsAdded && mDirtyIds.empty()) {
+            return;
+        }
+        fullSnapshot = mItemsAdded;
         mItemsAdded = false;
-        
-        // Poll all components for changes (eliminates need for manual notifications)
-        if (!shouldUpdate) {
-            for (auto &componentRef : mComponents) {
-                if (auto component = componentRef.lock()) {
-                    if (component->hasChanged()) {
-                        shouldUpdate = true;
-                        break; // Found at least one change, no need to check more
-                    }
-                }
-            }
+        if (!fullSnapshot && mFullSnapshotInterval > 0 &&
+            ++mDeltasSinceSnapshot >= mFullSnapshotInterval) {
+            fullSnapshot = true;
         }
+        mPublishIds.swap(mDirtyIds);
+        mDirtyIds.clear();
     }
-    
-    if (shouldUpdate) {
-        // Clear the changed flags for all components
-        {
-            fl::lock_guard<fl::mutex> lock(mMutex);
-            for (auto &componentRef : mComponents) {
-                if (auto component = componentRef.lock()) {
-                    component->clearChanged();
-                }
-            }
-        }
-        
-        FLArduinoJson::JsonDocument doc;
-        auto json = doc.to<FLArduinoJson::JsonArray>();
-        toJson(json);
-        string jsonStr;
-        serializeJson(doc, jsonStr);
-        //FL_WARN("*** SENDING UI TO FRONTEND: " << jsonStr.substr(0, 100).c_str() << "...");
-        mUpdateJs(jsonStr.c_str());
+    if (fullSnapshot) {
+        publishFullSnapshot();
+    } else {
+        publishDelta();
     }
+}
 
+void JsonUiManager::publishFullSnapshot() {
+    // Everything goes out, so nothing is left dirty.
+    for (auto &component : getComponents()) {
+        component->clearChanged();
+    }
+    mDeltasSinceSnapshot = 0;
+    mPublishIds.clear();
 
+    FLArduinoJson::JsonDocument doc;
+    auto json = doc.to<FLArduinoJson::JsonArray>();
+    toJson(json);
+    mJsonBuffer.clear();
+    serializeJson(doc, mJsonBuffer);
+    mUpdateJs(mJsonBuffer.c_str());
+}
 
+void JsonUiManager::publishDelta() {
+    mPublishComponents.clear();
+    {
+        fl::lock_guard<fl::mutex> lock(mMutex);
+        for (int id : mPublishIds) {
+            auto ref = mById.find_value(id);
+            auto component = ref ? ref->lock() : JsonUiInternalPtr();
+            if (component) {
+                mPublishComponents.push_back(component);
+            }
+        }
+    }
+    mPublishIds.clear();
+    if (mPublishComponents.empty()) {
+        return; // Removed before they could be sent.
+    }
 
+    FLArduinoJson::JsonDocument doc;
+    auto delta = doc["delta"].to<FLArduinoJson::JsonArray>();
+    for (auto &component : mPublishComponents) {
+        // Cleared first, a change while serializing goes out next frame.
+        component->clearChanged();
+        auto obj = delta.add<FLArduinoJson::JsonObject>();
+        component->toJson(obj);
+    }
+    mPublishComponents.clear();
+    mJsonBuffer.clear();
+    serializeJson(doc, mJsonBuffer);
+    mUpdateJs(mJsonBuffer.c_str());
+}
 
+void JsonUiManager::onComponentChanged(int id) {
+    fl::lock_guard<fl::mutex> lock(mMutex);
+    mDirtyIds.push_back(id);
 }
 
 fl::vector<JsonUiInternalPtr> JsonUiManager::getComponents() {
@@ -128,27 +221,50 @@ fl::vector<JsonUiInternalPtr> JsonUiManager::getComponents() {
     return out;
 }
 
+// Non negative decimal ids only, so names that merely start with a digit
+// still go to the name index.
+static bool ui_manager_parse_id(const char *str, int *out) {
+    if (!*str) {
+        return false;
+    }
+    int id = 0;
+    for (const char *p = str; *p; ++p) {
+        if (*p < '0' || *p > '9' || id > 100000000) {
+            return false;
+        }
+        id = id * 10 + (*p - '0');
+    }
+    *out = id;
+    return true;
+}
+
 JsonUiInternalPtr JsonUiManager::findUiComponent(const char* id_or_name) {
-    auto components = getComponents();
-    
-    for (auto &component : components) {
-        int id = component->id();
-        string componentIdStr;
-        componentIdStr.append(id);
-        
-        if (fl::string::strcmp(componentIdStr.c_str(), id_or_name) == 0) {
-            //FL_WARN("*** Found component with ID " << id);
-            return component;
+    if (!id_or_name) {
+        return JsonUiInternalPtr();
+    }
+    fl::lock_guard<fl::mutex> lock(mMutex);
+    int id = 0;
+    if (ui_manager_parse_id(id_or_name, &id)) {
+        if (auto ref = mById.find_value(id)) {
+            if (auto component = lockOrPrune(*ref)) {
+                return component;
+            }
+            mById.erase(id);
         }
     }
 
     // If we didn't find it by id, try to find it by name
-    for (auto &component : components) {
-        if (fl::string::strcmp(component->name().c_str(), id_or_name) == 0) {
+    fl::string name(id_or_name);
+    if (auto ref = mByName.find_value(name)) {
+        if (auto component = lockOrPrune(*ref)) {
             return component;
         }
+        mByName.erase(name);
+        indexName(name);
+        if (auto next = mByName.find_value(name)) {
+            return next->lock();
+        }
     }
-    
     return JsonUiInternalPtr(); // Return null pointer if not found
 }
 
@@ -167,6 +283,7 @@ void JsonUiManager::updateUiComponents(const char* jsonStr) {
     // FL_WARN("*** JsonUiManager pointer: " << this);
     // FL_WARN("*** BEFORE: mHasPendingUpdate=" << (mHasPendingUpdate ? "true" : "false"));
     
+    MemScope scope(MemCategory::kJson);
     FLArduinoJson::JsonDocument doc;
     deserializeJson(doc, jsonStr);
     
@@ -2,6 +2,7 @@
 
 #include "fl/singleton.h"
 
+#include "fl/hash_map.h"
 #include "fl/map.h"
 #include "fl/memory.h"
 #include "fl/set.h"
@@ -13,8 +14,15 @@
 
 namespace fl {
 
-class JsonUiManager : fl::EngineEvents::Listener {
+// Publishes the ui to the frontend. Components report changes through
+// JsonUiInternal::ChangeListener into a dirty list, onEndFrame() then sends
+// only those as {"delta": [...]}. A full snapshot, the plain component array,
+// goes out when components are added and every kFullSnapshotInterval deltas.
+class JsonUiManager : fl::EngineEvents::Listener,
+                      JsonUiInternal::ChangeListener {
   public:
+    static const u32 kFullSnapshotInterval = 300;
+
     using Callback = fl::function<void(const char *)>;
     JsonUiManager(Callback updateJs);
     ~JsonUiManager();
@@ -33,24 +41,45 @@ class JsonUiManager : fl::EngineEvents::Listener {
       mUpdateJs = updateJs;
     }
 
+    // Deltas between full snapshots, 0 sends only deltas after the first.
+    void setFullSnapshotInterval(u32 deltas) { mFullSnapshotInterval = deltas; }
+
     JsonUiInternalPtr findUiComponent(const char* id_or_name);
 
 
   private:
     
     typedef fl::VectorSet<fl::WeakPtr<JsonUiInternal>> JsonUIRefSet;
+    typedef fl::hash_map<int, fl::WeakPtr<JsonUiInternal>> JsonUiIdIndex;
+    typedef fl::hash_map<fl::string, fl::WeakPtr<JsonUiInternal>>
+        JsonUiNameIndex;
 
     void onEndFrame() override;
+    void onComponentChanged(int id) override;
 
     fl::vector<JsonUiInternalPtr> getComponents();
     void toJson(FLArduinoJson::JsonArray &json);
-    JsonUiInternalPtr findUiComponent(const fl::string& idStr);
+    void publishFullSnapshot();
+    void publishDelta();
+    // Callers hold mMutex.
+    JsonUiInternalPtr lockOrPrune(const fl::WeakPtr<JsonUiInternal> &ref);
+    void indexName(const fl::string &name);
 
     Callback mUpdateJs;
     JsonUIRefSet mComponents;
+    // Kept in step with mComponents on add/remove, expired entries are
+    // pruned when a lookup runs into them.
+    JsonUiIdIndex mById;
+    JsonUiNameIndex mByName; // First registered component for each name.
     fl::mutex mMutex;
 
     bool mItemsAdded = false;
+    fl::vector<int> mDirtyIds;   // Guarded by mMutex.
+    fl::vector<int> mPublishIds; // Swapped out of mDirtyIds to publish.
+    fl::vector<JsonUiInternalPtr> mPublishComponents;
+    fl::string mJsonBuffer;      // Reused for every message.
+    u32 mFullSnapshotInterval = kFullSnapshotInterval;
+    u32 mDeltasSinceSnapshot = 0;
     FLArduinoJson::JsonDocument mPendingJsonUpdate;
     bool mHasPendingUpdate = false;
 };
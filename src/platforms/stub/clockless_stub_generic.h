@@ -11,10 +11,10 @@ FASTLED_NAMESPACE_BEGIN
 template <int DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 0>
 class ClocklessController : public CPixelLEDController<RGB_ORDER> {
 public:
-	virtual void init() { }
+	void init() override { }
 
 protected:
-	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+	void showPixels(PixelController<RGB_ORDER> & pixels) override {
 		FASTLED_UNUSED(pixels);
 	}
 };
@@ -1,6 +1,7 @@
 #ifdef FASTLED_STUB_IMPL  // Only use this if explicitly defined.
 
 #include "platforms/stub/led_sysdefs_stub.h"
+#include "platforms/stub/time_stub.h"
 #include "fl/unused.h"
 #include "fl/compiler_control.h"
 
@@ -21,6 +22,23 @@ static const auto start_time = std::chrono::system_clock::now();
 
 FL_DISABLE_WARNING_POP
 
+static bool gStubClockVirtual = false;
+static fl::u64 gStubClockMicros = 0;
+
+namespace fl {
+
+void setStubClockVirtual(bool enabled) { gStubClockVirtual = enabled; }
+
+bool stubClockIsVirtual() { return gStubClockVirtual; }
+
+fl::u64 stubClockMicros() { return gStubClockMicros; }
+
+void setStubClockMicros(fl::u64 micros) { gStubClockMicros = micros; }
+
+void advanceStubClock(fl::u64 micros) { gStubClockMicros += micros; }
+
+} // namespace fl
+
 void pinMode(uint8_t pin, uint8_t mode) {
     // Empty stub as we don't actually ever write anything
     FASTLED_UNUSED(pin);
@@ -28,16 +46,28 @@ void pinMode(uint8_t pin, uint8_t mode) {
 }
 
 uint32_t millis() {
+    if (gStubClockVirtual) {
+        return uint32_t(gStubClockMicros / 1000);
+    }
     auto current_time = std::chrono::system_clock::now();
     return std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
 }
 
 uint32_t micros() {
+    if (gStubClockVirtual) {
+        return uint32_t(gStubClockMicros);
+    }
     auto current_time = std::chrono::system_clock::now();
     return std::chrono::duration_cast<std::chrono::microseconds>(current_time - start_time).count();
 }
 
 void delay(int ms) {
+    if (gStubClockVirtual) {
+        if (ms > 0) {
+            gStubClockMicros += fl::u64(ms) * 1000;
+        }
+        return;
+    }
 #ifdef FASTLED_USE_PTHREAD_DELAY
     if (ms <= 0) {
         return; // nothing to wait for
@@ -54,6 +84,16 @@ void delay(int ms) {
 #endif
 }
 
+void delayMicroseconds(int us) {
+    if (gStubClockVirtual) {
+        if (us > 0) {
+            gStubClockMicros += fl::u64(us);
+        }
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
 void yield() {
 #ifdef FASTLED_USE_PTHREAD_YIELD
     // POSIX thread yield to allow other threads to run
@@ -57,6 +57,7 @@ extern "C" {
     uint32_t micros(void);
 
     void delay(int ms);
+    void delayMicroseconds(int us);
     void yield(void);
 }
 
@@ -0,0 +1,210 @@
+#ifndef FASTLED_INTERNAL
+#define FASTLED_INTERNAL 1
+#endif
+
+#include "platforms/stub/sketch_runner.h"
+
+#if FASTLED_HAS_SKETCH_RUNNER
+
+#include <algorithm> // ok include
+#include <chrono>    // ok include
+#include <stdio.h>   // ok include
+
+#include "FastLED.h"
+#include "fl/allocator.h"
+#include "fl/engine_events.h"
+#include "fl/json.h"
+#include "fl/warn.h"
+#include "platforms/stub/time_stub.h"
+
+namespace fl {
+
+namespace {
+
+fl::u64 sketch_runner_now_nanos() {
+    return fl::u64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count());
+}
+
+} // namespace
+
+// Listens for shows and counts allocations while the runner is running.
+class SketchRunner::Impl : public EngineEvents::Listener, public MallocFreeHook {
+  public:
+    explicit Impl(SketchRunner *owner) : mOwner(owner) {
+        EngineEvents::addListener(this);
+    }
+    ~Impl() override { EngineEvents::removeListener(this); }
+
+    void onEndShowLeds() override {
+        mPaused = true;
+        mOwner->onShow();
+        mPaused = false;
+    }
+
+    void onMalloc(void *ptr, fl::size size) override {
+        FASTLED_UNUSED(ptr);
+        if (!mPaused) {
+            ++allocs;
+            allocBytes += size;
+        }
+    }
+    void onFree(void *ptr) override {
+        FASTLED_UNUSED(ptr);
+        if (!mPaused) {
+            ++frees;
+        }
+    }
+
+    fl::u64 allocs = 0;
+    fl::u64 allocBytes = 0;
+    fl::u64 frees = 0;
+
+  private:
+    SketchRunner *mOwner;
+    bool mPaused = false;
+};
+
+SketchRunner::SketchRunner(Fn setup, Fn loop)
+    : mSetup(fl::move(setup)), mLoop(fl::move(loop)), mImpl(new Impl(this)) {}
+
+SketchRunner::~SketchRunner() { delete mImpl; }
+
+void SketchRunner::run(fl::u32 loops) {
+    const bool wasVirtual = stubClockIsVirtual();
+    const fl::u64 outerClock = stubClockMicros();
+    setStubClockVirtual(true);
+    setStubClockMicros(mClockMicros);
+    SetMallocFreeHook(mImpl);
+    if (!mSetupDone) {
+        mSetupDone = true;
+        const fl::u64 start = sketch_runner_now_nanos();
+        mSetup();
+        mSetupNanos = sketch_runner_now_nanos() - start;
+        mSetupAllocs = mImpl->allocs;
+    }
+    for (fl::u32 i = 0; i < loops; ++i) {
+        const fl::u64 frameStart = stubClockMicros();
+        const fl::u64 start = sketch_runner_now_nanos();
+        mLoop();
+        const fl::u64 nanos = sketch_runner_now_nanos() - start;
+        ClearMallocFreeHook();
+        mLoopNanos.push_back(nanos > 0xFFFFFFFFu ? 0xFFFFFFFFu : fl::u32(nanos));
+        SetMallocFreeHook(mImpl);
+        ++mLoops;
+        if (stubClockMicros() < frameStart + mFrameMicros) {
+            setStubClockMicros(frameStart + mFrameMicros);
+        }
+    }
+    ClearMallocFreeHook();
+    mClockMicros = stubClockMicros();
+    setStubClockVirtual(wasVirtual);
+    setStubClockMicros(outerClock);
+}
+
+void SketchRunner::onShow() {
+    ++mShows;
+    mStripSizes.clear();
+    for (CLEDController *c = CLEDController::head(); c; c = c->next()) {
+        mStripSizes.push_back(fl::u32(c->size()));
+    }
+    if (!mCapture) {
+        return;
+    }
+    SketchFrame frame;
+    frame.loop = mLoops;
+    frame.micros = stubClockMicros();
+    for (CLEDController *c = CLEDController::head(); c; c = c->next()) {
+        const CRGB *leds = c->leds();
+        for (int i = 0; leds && i < c->size(); ++i) {
+            frame.pixels.push_back(leds[i]);
+        }
+    }
+    mFrames.push_back(fl::move(frame));
+}
+
+SketchRunStats SketchRunner::stats() const {
+    SketchRunStats out;
+    out.loops = mLoops;
+    out.frames = mShows;
+    out.setupNanos = mSetupNanos;
+    out.allocs = mImpl->allocs;
+    out.allocBytes = mImpl->allocBytes;
+    out.frees = mImpl->frees;
+    out.setupAllocs = mSetupAllocs;
+    if (!mLoopNanos.empty()) {
+        fl::vector<fl::u32> sorted = mLoopNanos;
+        std::sort(sorted.begin(), sorted.end());
+        for (fl::u32 n : sorted) {
+            out.loopNanos += n;
+        }
+        out.loopMinNanos = sorted.front();
+        out.loopMaxNanos = sorted.back();
+        out.loopP50Nanos = sorted[(sorted.size() - 1) * 50 / 100];
+        out.loopP99Nanos = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+    return out;
+}
+
+bool SketchRunner::writeVideo(const char *path) const {
+    const fl::size frameSize = mFrames.empty() ? 0 : mFrames[0].pixels.size();
+    for (const SketchFrame &frame : mFrames) {
+        if (frame.pixels.size() != frameSize) {
+            FASTLED_WARN("SketchRunner: frame size changed at loop "
+                         << frame.loop << ", not writing " << path);
+            return false;
+        }
+    }
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        FASTLED_WARN("SketchRunner: can't open " << path);
+        return false;
+    }
+    bool ok = true;
+    for (const SketchFrame &frame : mFrames) {
+        const fl::size n = frame.pixels.size() * 3;
+        if (n && fwrite(frame.pixels.data(), 1, n, f) != n) {
+            ok = false;
+            break;
+        }
+    }
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        FASTLED_WARN("SketchRunner: failed writing " << path);
+    }
+    return ok;
+}
+
+fl::string SketchRunner::reportJson() const {
+    const SketchRunStats s = stats();
+    fl::JsonDocument doc;
+    FLArduinoJson::JsonObject json = doc.to<FLArduinoJson::JsonObject>();
+    json["loops"] = s.loops;
+    json["frames"] = s.frames;
+    json["virtual_us"] = mClockMicros;
+    json["setup_ns"] = s.setupNanos;
+    json["loop_total_ns"] = s.loopNanos;
+    json["loop_mean_ns"] = s.loops ? s.loopNanos / s.loops : 0;
+    json["loop_min_ns"] = s.loopMinNanos;
+    json["loop_p50_ns"] = s.loopP50Nanos;
+    json["loop_p99_ns"] = s.loopP99Nanos;
+    json["loop_max_ns"] = s.loopMaxNanos;
+    json["allocs"] = s.allocs;
+    json["alloc_bytes"] = s.allocBytes;
+    json["frees"] = s.frees;
+    json["setup_allocs"] = s.setupAllocs;
+    FLArduinoJson::JsonArray strips = json["strips"].to<FLArduinoJson::JsonArray>();
+    for (fl::u32 n : mStripSizes) {
+        strips.add(n);
+    }
+    fl::string out;
+    serializeJson(doc, out);
+    return out;
+}
+
+} // namespace fl
+
+#endif // FASTLED_HAS_SKETCH_RUNNER
@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+Headless sketch runner for the native stub build.
+
+Runs a sketch's setup()/loop() as fast as the host allows against the virtual
+stub clock (platforms/stub/time_stub.h), captures every frame shown by every
+CLEDController and measures what each loop() costs in wall time and heap
+allocations.
+
+    fl::SketchRunner runner(setup, loop);
+    runner.setFrameMicros(16667);  // ~60 fps of virtual time per loop().
+    runner.run(600);
+    FASTLED_WARN(runner.reportJson());
+    runner.writeVideo("out.rgb");
+
+Each loop() call advances the virtual clock to at least frameMicros past its
+start, more if the sketch delay()ed longer. A sketch that calls show() several
+times in one loop() with a max refresh rate set would wait forever on the
+frozen clock, use a frame step of at least the refresh period there.
+
+Captured frames hold the controllers' led buffers after show(), before
+brightness and color correction, concatenated in controller registration
+order. writeVideo() writes them back to back as RGB24, the raw format that
+fl::Video / PixelStream play back.
+
+Build a runner for an example with FASTLED_SKETCH_RUNNER and
+FASTLED_STUB_MAIN_INCLUDE_INO, see fl/stub_main.cpp and
+tests/cmake/SketchRunner.cmake.
+*/
+
+#include "crgb.h"
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/str.h"
+#include "fl/vector.h"
+
+#if defined(FASTLED_STUB_IMPL) && !defined(__EMSCRIPTEN__)
+#define FASTLED_HAS_SKETCH_RUNNER 1
+#else
+#define FASTLED_HAS_SKETCH_RUNNER 0
+#endif
+
+#if FASTLED_HAS_SKETCH_RUNNER
+
+namespace fl {
+
+struct SketchFrame {
+    fl::u32 loop = 0;   // loop() call that showed the frame.
+    fl::u64 micros = 0; // Virtual time of the show().
+    fl::vector<CRGB> pixels;
+};
+
+struct SketchRunStats {
+    fl::u32 loops = 0;
+    fl::u32 frames = 0;      // show() calls seen.
+    fl::u64 setupNanos = 0;
+    fl::u64 loopNanos = 0;   // Sum over all loop() calls.
+    fl::u32 loopMinNanos = 0;
+    fl::u32 loopMaxNanos = 0;
+    fl::u32 loopP50Nanos = 0;
+    fl::u32 loopP99Nanos = 0;
+    fl::u64 allocs = 0;      // Heap allocations through fl::Malloc.
+    fl::u64 allocBytes = 0;
+    fl::u64 frees = 0;
+    fl::u64 setupAllocs = 0; // Part of allocs made by setup().
+};
+
+class SketchRunner {
+  public:
+    using Fn = fl::function<void()>;
+
+    SketchRunner(Fn setup, Fn loop);
+    ~SketchRunner();
+
+    // Virtual time each loop() takes at least. Default 16667 (60 fps).
+    void setFrameMicros(fl::u32 micros) { mFrameMicros = micros; }
+    // Keep the pixels of every shown frame. Default on.
+    void setCapture(bool capture) { mCapture = capture; }
+
+    // Calls setup() on the first run, then loop() `loops` times.
+    void run(fl::u32 loops);
+
+    const fl::vector<SketchFrame> &frames() const { return mFrames; }
+    // Led count of each controller at the last captured frame.
+    const fl::vector<fl::u32> &stripSizes() const { return mStripSizes; }
+    SketchRunStats stats() const;
+
+    // Raw RGB24 frames back to back. False if the file can't be written or
+    // the frame size changed during the run.
+    bool writeVideo(const char *path) const;
+    fl::string reportJson() const;
+
+  private:
+    class Impl;
+    void onShow();
+
+    Fn mSetup;
+    Fn mLoop;
+    Impl *mImpl;
+    fl::u32 mFrameMicros = 16667;
+    bool mCapture = true;
+    bool mSetupDone = false;
+    fl::u32 mLoops = 0;
+    fl::u64 mClockMicros = 0; // Virtual time, kept between run() calls.
+    fl::u32 mShows = 0;
+    fl::u64 mSetupNanos = 0;
+    fl::u64 mSetupAllocs = 0;
+    fl::vector<fl::u32> mLoopNanos;
+    fl::vector<SketchFrame> mFrames;
+    fl::vector<fl::u32> mStripSizes;
+};
+
+} // namespace fl
+
+#endif // FASTLED_HAS_SKETCH_RUNNER
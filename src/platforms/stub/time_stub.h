@@ -0,0 +1,21 @@
+#pragma once
+
+// Virtual clock for the native stub platform. While it is enabled millis()
+// and micros() return the virtual time, which only moves when it is set or
+// advanced, and delay() advances it instead of sleeping. The sketch runner
+// uses it to run sketches as fast as the host allows with deterministic
+// timing. Not available on wasm, which has its own clock.
+
+#include "fl/int.h"
+
+namespace fl {
+
+void setStubClockVirtual(bool enabled);
+bool stubClockIsVirtual();
+// Virtual time in microseconds, starts at 0 and keeps its value while the
+// clock is switched back to real time.
+fl::u64 stubClockMicros();
+void setStubClockMicros(fl::u64 micros);
+void advanceStubClock(fl::u64 micros);
+
+} // namespace fl
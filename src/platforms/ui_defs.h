@@ -16,6 +16,7 @@
 #include "platforms/shared/ui/json/checkbox.h"
 #include "platforms/shared/ui/json/description.h"
 #include "platforms/shared/ui/json/dropdown.h"
+#include "platforms/shared/ui/json/frame_stats.h"
 #include "platforms/shared/ui/json/help.h"
 #include "platforms/shared/ui/json/number_field.h"
 #include "platforms/shared/ui/json/slider.h"
@@ -32,6 +33,7 @@ namespace fl {
 #define FASTLED_HAS_UI_HELP 1
 #define FASTLED_HAS_UI_AUDIO 1
 #define FASTLED_HAS_UI_DROPDOWN 1
+#define FASTLED_HAS_UI_FRAME_STATS 1
 
 typedef JsonNumberFieldImpl UINumberFieldImpl;
 typedef JsonSliderImpl UISliderImpl;
@@ -42,6 +44,7 @@ typedef JsonDescriptionImpl UIDescriptionImpl;
 typedef JsonHelpImpl UIHelpImpl;
 typedef JsonAudioImpl UIAudioImpl;
 typedef JsonDropdownImpl UIDropdownImpl;
+typedef JsonFrameStatsImpl UIFrameStatsImpl;
 
 } // namespace fl
 
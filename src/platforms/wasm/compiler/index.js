@@ -530,6 +530,11 @@ function FastLED_onFrame(frameData, uiUpdateCallback) {
  */
 function FastLED_onUiElementsAdded(jsonData) {
   // uses global variables.
+  if (jsonData && !Array.isArray(jsonData) && Array.isArray(jsonData.delta)) {
+    // {"delta": [...]} only carries the components that changed.
+    uiManager.applyUiDelta(jsonData.delta);
+    return;
+  }
   uiManager.addUiElements(jsonData);
 }
 
@@ -373,6 +373,54 @@ function createButton(element) {
   return controlDiv;
 }
 
+/**
+ * Creates a read only frame statistics display (UIFrameStats on the backend)
+ * @param {Object} element - Element configuration object
+ * @param {string} element.name - Display name for the statistics
+ * @param {string} element.id - Unique identifier for the display
+ * @param {Object} element.stats - fl::FrameStats json
+ * @returns {HTMLDivElement} Container div with label and statistics text
+ */
+function createFrameStats(element) {
+  const controlDiv = document.createElement('div');
+  controlDiv.className = 'ui-control frame-stats-control';
+
+  const label = document.createElement('label');
+  label.textContent = element.name;
+
+  const text = document.createElement('div');
+  text.id = `frame-stats-${element.id}`;
+  text.className = 'frame-stats-value';
+  text.style.fontFamily = 'monospace';
+  text.style.fontSize = '0.85em';
+  text.style.color = '#E0E0E0';
+
+  controlDiv.appendChild(label);
+  controlDiv.appendChild(text);
+  updateFrameStats(controlDiv, element.stats);
+  return controlDiv;
+}
+
+/**
+ * Refreshes a display made by createFrameStats()
+ * @param {HTMLDivElement} control - Container returned by createFrameStats()
+ * @param {Object} stats - fl::FrameStats json
+ */
+function updateFrameStats(control, stats) {
+  const text = control.querySelector('.frame-stats-value');
+  if (!text || !stats) {
+    return;
+  }
+  const frame = stats.frame_us || {};
+  const render = stats.render_us || {};
+  const show = stats.show_us || {};
+  const idle = stats.idle_us || {};
+  text.textContent = `${stats.fps} fps, jitter ${stats.jitter_us}us\n`
+    + `frame p50 ${frame.p50}us p99 ${frame.p99}us\n`
+    + `render ${render.p50}us show ${show.p50}us idle ${idle.p50}us`;
+  text.style.whiteSpace = 'pre';
+}
+
 function createDropdown(element) {
   const controlDiv = document.createElement('div');
   controlDiv.className = 'ui-control';
@@ -790,6 +838,12 @@ export class JsonUiManager {
     /** @type {Object} Previous state values for change detection */
     this.previousUiState = {};
 
+    /** @type {string|null} Component ids of the last full snapshot */
+    this.lastSnapshotKey = null;
+
+    /** @type {Object} Read only frame stats displays by id, never sent back */
+    this.frameStatsControls = {};
+
     /** @type {string} HTML element ID for the UI controls container */
     this.uiControlsId = uiControlsId;
 
@@ -1042,6 +1096,8 @@ export class JsonUiManager {
     this.ungroupedContainer2 = null;
     this.uiElements = {};
     this.previousUiState = {};
+    this.lastSnapshotKey = null;
+    this.frameStatsControls = {};
 
     // Reset element distribution counter for ultra-wide mode
     this.elementDistributionIndex = 0;
@@ -1144,10 +1200,20 @@ export class JsonUiManager {
   }
 
   addUiElements(jsonData) {
+    // The backend resends a full snapshot every so often. When it carries the
+    // same components as the last one only the values can have changed, so
+    // skip rebuilding the layout.
+    const snapshotKey = jsonData.map((data) => data.id).join(',');
+    if (snapshotKey === this.lastSnapshotKey) {
+      this.applyUiDelta(jsonData);
+      return;
+    }
+
     console.log('UI elements added:', jsonData);
 
     // Clear existing UI elements
     this.clearUiElements();
+    this.lastSnapshotKey = snapshotKey;
 
     let foundUi = false;
     const groupedElements = new Map();
@@ -1247,6 +1313,41 @@ export class JsonUiManager {
     }
   }
 
+  /**
+   * Applies values from a delta message, which only carries the components
+   * that changed on the backend. Unknown ids are skipped, the next full
+   * snapshot brings them in.
+   * @param {Array<Object>} elements - Changed component objects
+   */
+  applyUiDelta(elements) {
+    elements.forEach((data) => {
+      if (data.type === 'frame_stats') {
+        const control = this.frameStatsControls[data.id];
+        if (control) {
+          updateFrameStats(control, data.stats);
+        }
+        return;
+      }
+      const element = this.uiElements[data.id];
+      if (!element || data.type === 'button' || data.type === 'audio') {
+        return;
+      }
+      if (element.type === 'checkbox') {
+        element.checked = Boolean(data.value);
+      } else {
+        element.value = data.value;
+        if (element.type === 'range') {
+          const valueDisplay = element.parentElement.querySelector('.slider-value');
+          if (valueDisplay) {
+            valueDisplay.textContent = element.value;
+          }
+        }
+      }
+      // Keep processUiChanges() from echoing the value back.
+      this.previousUiState[data.id] = data.value;
+    });
+  }
+
   /**
    * Add layout hints to UI elements based on their type and properties
    */
@@ -1441,6 +1542,8 @@ export class JsonUiManager {
       control = createAudioField(data);
     } else if (data.type === 'dropdown') {
       control = createDropdown(data);
+    } else if (data.type === 'frame_stats') {
+      control = createFrameStats(data);
     }
 
     return control;
@@ -1448,6 +1551,11 @@ export class JsonUiManager {
 
   // Register a control element for state tracking
   registerControlElement(control, data) {
+    if (data.type === 'frame_stats') {
+      // Read only, kept out of uiElements so nothing is sent back.
+      this.frameStatsControls[data.id] = control;
+      return;
+    }
     if (data.type === 'number-pair') {
       // Register both left and right elements separately
       const leftElement = data.leftElement;
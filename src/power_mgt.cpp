@@ -6,6 +6,8 @@
 #include "FastLED.h"
 #include "power_mgt.h"
 #include "fl/namespace.h"
+#include "fl/planar_rgb.h"
+#include "fl/trace.h"
 
 FASTLED_NAMESPACE_BEGIN
 
@@ -87,6 +89,26 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
     return total;
 }
 
+uint32_t calculate_unscaled_power_mW( const fl::PlanarRGB& planes )
+{
+    // Three unit stride walks instead of one strided one.
+    uint32_t red32 = 0, green32 = 0, blue32 = 0;
+    const uint8_t* r = planes.r();
+    const uint8_t* g = planes.g();
+    const uint8_t* b = planes.b();
+    const fl::size n = planes.size();
+    for (fl::size i = 0; i < n; ++i) {
+        red32   += r[i];
+        green32 += g[i];
+        blue32  += b[i];
+    }
+
+    uint32_t total = ((red32 * gRed_mW) >> 8) + ((green32 * gGreen_mW) >> 8) +
+                     ((blue32 * gBlue_mW) >> 8) + (gDark_mW * uint32_t(n));
+
+    return total;
+}
+
 
 uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_V, uint32_t max_power_mA) {
 	return calculate_max_brightness_for_power_mW(ledbuffer, numLeds, target_brightness, max_power_V * max_power_mA);
@@ -110,6 +132,7 @@ uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t nu
 //  - no more than max_mW milliwatts
 uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, fl::u32 max_power_mW)
 {
+    FL_TRACE_SCOPE("power.calc");
     uint32_t total_mW = gMCU_mW;
 
     CLEDController *pCur = CLEDController::head();
@@ -4,6 +4,10 @@
 
 #include "pixeltypes.h"
 
+namespace fl {
+class PlanarRGB;
+}
+
 /// @file power_mgt.h
 /// Functions to limit the power used by FastLED
 
@@ -67,6 +71,10 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 /// @returns the number of milliwatts the LED data would consume at max brightness
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 
+/// @copydoc calculate_unscaled_power_mW(const CRGB*, uint16_t)
+/// Sums each plane of a planar buffer in one pass.
+uint32_t calculate_unscaled_power_mW( const fl::PlanarRGB& planes);
+
 /// Determines the highest brightness level you can use and still stay under
 /// the specified power budget for a given set of LEDs.
 /// @param ledbuffer the LED data to check
@@ -50,11 +50,11 @@ void _generate_guassian(kiss_fft_scalar window[], int N){
     }
 }
 
-void _generate_kernel(kiss_fft_cpx kernel[], kiss_fftr_cfg cfg, enum window_type window_type, float f, float fmin, float fs, int N){
+void _generate_kernel_into(kiss_fft_cpx kernel[], kiss_fft_scalar time_K[], kiss_fftr_cfg cfg, enum window_type window_type, float f, float fmin, float fs, int N){
     // Generates window in the center and zero everywhere else
     float factor = f/fmin;
     int N_window = N/factor; // Scales inversely with frequency (see CQT paper)
-    kiss_fft_scalar *time_K = (kiss_fft_scalar*)calloc(N, sizeof(kiss_fft_scalar));
+    for(int i = 0; i < N; i++) time_K[i] = 0;
 
     switch(window_type){
         case HAMMING:
@@ -68,9 +68,10 @@ void _generate_kernel(kiss_fft_cpx kernel[], kiss_fftr_cfg cfg, enum window_type
     // Fills window with f Hz wave sampled at fs Hz
     for(int i = 0; i < N; i++) time_K[i] *= cos(2*M_PI*(f/fs)*(i-N/2));
 
+    // kiss_fftr only writes the N/2+1 non-redundant bins
     #ifdef FIXED_POINT // If using fixed point, just scale inversely to N after FFT (don't normalize)
     kiss_fftr(cfg, time_K, kernel); // Outputs garbage for Q31
-    for(int i = 0; i < N; i++){
+    for(int i = 0; i < N/2+1; i++){
         kernel[i].r *= factor;
         kernel[i].i *= factor;
     }
@@ -78,7 +79,11 @@ void _generate_kernel(kiss_fft_cpx kernel[], kiss_fftr_cfg cfg, enum window_type
     for(int i = 0; i < N; i++) time_K[i] /= N_window;
     kiss_fftr(cfg, time_K, kernel);
     #endif
+}
 
+void _generate_kernel(kiss_fft_cpx kernel[], kiss_fftr_cfg cfg, enum window_type window_type, float f, float fmin, float fs, int N){
+    kiss_fft_scalar *time_K = (kiss_fft_scalar*)malloc(N*sizeof(kiss_fft_scalar));
+    _generate_kernel_into(kernel, time_K, cfg, window_type, f, fmin, fs, N);
     free(time_K);
 }
 
@@ -86,43 +91,58 @@ kiss_fft_scalar _mag(kiss_fft_cpx x){
     return sqrt(x.r*x.r+x.i*x.i);
 }
 
-struct sparse_arr* generate_kernels(struct cq_kernel_cfg cfg){
-    float *freq = (float*)malloc(cfg.bands * sizeof(float));
-    _generate_center_freqs(freq, cfg.bands, cfg.fmin, cfg.fmax);
+size_t kernel_scratch_size(struct cq_kernel_cfg cfg){
+    // Spectrum first so that it stays aligned for kiss_fft_cpx
+    return (cfg.samples/2+1)*sizeof(kiss_fft_cpx) + cfg.samples*sizeof(kiss_fft_scalar);
+}
 
-    kiss_fftr_cfg fft_cfg = kiss_fftr_alloc(cfg.samples, 0, NULL, NULL);
-    struct sparse_arr* kernels = (struct sparse_arr*)malloc(cfg.bands*sizeof(struct sparse_arr));
-    kiss_fft_cpx *temp_kernel = (kiss_fft_cpx*)malloc(cfg.samples*sizeof(kiss_fft_cpx));
+int generate_kernel_band(struct cq_kernel_cfg cfg, kiss_fftr_cfg fft_cfg, int band, void *scratch){
+    kiss_fft_cpx *spectrum = (kiss_fft_cpx*)scratch;
+    kiss_fft_scalar *time_K = (kiss_fft_scalar*)(spectrum + cfg.samples/2+1);
 
-    for(int i = 0; i < cfg.bands; i++){
-        // Clears temp_kernel before calling _generate_kernel on it
-        for(int i = 0; i < cfg.samples; i++) temp_kernel[i].r = temp_kernel[i].i = 0;
+    // Same expression as _generate_center_freqs, so no frequency array is needed
+    float m = log(cfg.fmax/cfg.fmin);
+    float f = cfg.fmin*exp(m*band/(cfg.bands-1));
+    _generate_kernel_into(spectrum, time_K, fft_cfg, cfg.window_type, f, cfg.fmin, cfg.fs, cfg.samples);
 
-        _generate_kernel(temp_kernel, fft_cfg, cfg.window_type, freq[i], cfg.fmin, cfg.fs, cfg.samples);
+    // Counts number of elements with a complex magnitude above cfg.min_val
+    int n_elems = 0;
+    for(int j = 0; j < cfg.samples/2+1; j++) if(_mag(spectrum[j]) > cfg.min_val) n_elems++;
+    return n_elems;
+}
+
+void copy_kernel_band(struct cq_kernel_cfg cfg, const void *scratch, struct sparse_arr_elem out[]){
+    const kiss_fft_cpx *spectrum = (const kiss_fft_cpx*)scratch;
+    int k = 0;
+    for(int j = 0; j < cfg.samples/2+1; j++){
+        if(_mag(spectrum[j]) > cfg.min_val){
+            out[k].val = spectrum[j];
+            out[k].n = j;
+            k++;
+        }
+    }
+}
 
-        // Counts number of elements with a complex magnitude above cfg.min_val in temp_kernel
-        int n_elems = 0;
-        for(int j = 0; j < cfg.samples; j++) if(_mag(temp_kernel[j]) > cfg.min_val) n_elems++;
+struct sparse_arr* generate_kernels_with_fft(struct cq_kernel_cfg cfg, kiss_fftr_cfg fft_cfg){
+    struct sparse_arr* kernels = (struct sparse_arr*)malloc(cfg.bands*sizeof(struct sparse_arr));
+    void *scratch = malloc(kernel_scratch_size(cfg));
 
+    for(int i = 0; i < cfg.bands; i++){
         // Generates sparse_arr holding n_elems sparse_arr_elem's
+        int n_elems = generate_kernel_band(cfg, fft_cfg, i, scratch);
         kernels[i].n_elems = n_elems;
         kernels[i].elems = (struct sparse_arr_elem*)malloc(n_elems*sizeof(struct sparse_arr_elem));
-
-        // Generates sparse_arr_elem's from complex values counted before
-        int k = 0;
-        for(int j = 0; j < cfg.samples; j++){
-            if(_mag(temp_kernel[j]) > cfg.min_val){
-                kernels[i].elems[k].val = temp_kernel[j];
-                kernels[i].elems[k].n = j;
-                k++;
-            }
-        }
+        copy_kernel_band(cfg, scratch, kernels[i].elems);
     }
 
-    free(fft_cfg);
-    free(temp_kernel);
-    free(freq);
+    free(scratch);
+    return kernels;
+}
 
+struct sparse_arr* generate_kernels(struct cq_kernel_cfg cfg){
+    kiss_fftr_cfg fft_cfg = kiss_fftr_alloc(cfg.samples, 0, NULL, NULL);
+    struct sparse_arr* kernels = generate_kernels_with_fft(cfg, fft_cfg);
+    free(fft_cfg);
     return kernels;
 }
 
@@ -63,6 +63,7 @@ void _generate_center_freqs(float freq[], int bands, float fmin, float fmax);
 void _generate_hamming(kiss_fft_scalar window[], int N);
 void _generate_gaussian(kiss_fft_scalar window[], int N);
 void _generate_kernel(kiss_fft_cpx K[], kiss_fftr_cfg cfg, enum window_type window_type, float f, float fmin, float fs, int N);
+void _generate_kernel_into(kiss_fft_cpx K[], kiss_fft_scalar time_K[], kiss_fftr_cfg cfg, enum window_type window_type, float f, float fmin, float fs, int N);
 kiss_fft_scalar _mag(kiss_fft_cpx x);
 
 // public functions
@@ -71,11 +72,38 @@ kiss_fft_scalar _mag(kiss_fft_cpx x);
  *  
  *  typical usage: cq_kernels_t kernels = generate_kernels(cfg);
  * 
- *  Beware massive memory usage, uses more than 3*cfg.samples*sizeof(kiss_fft_scalar) bytes at a time
- *  to calculate all of the kernels. However, it will return sparse arrays that use much less memory.
+ *  Kernels are generated one band at a time, the transient memory is one kiss_fftr_cfg plus
+ *  kernel_scratch_size(cfg) bytes. The returned sparse arrays use much less memory.
  * */
 struct sparse_arr* generate_kernels(struct cq_kernel_cfg cfg);
 
+/*
+ *  generate_kernels_with_fft - same as generate_kernels, but reuses an existing kiss_fftr_cfg
+ *  for cfg.samples instead of allocating a second one
+ * */
+struct sparse_arr* generate_kernels_with_fft(struct cq_kernel_cfg cfg, kiss_fftr_cfg fft_cfg);
+
+/*
+ *  Streaming interface, lets the caller choose where the kernels are stored
+ *
+ *  typical usage:
+ *  void *scratch = malloc(kernel_scratch_size(cfg));
+ *  for(int band = 0; band < cfg.bands; band++){
+ *      int n = generate_kernel_band(cfg, fft_cfg, band, scratch);
+ *      struct sparse_arr_elem *dst = ...n elements...;
+ *      copy_kernel_band(cfg, scratch, dst);
+ *  }
+ *  free(scratch);
+ *
+ *  kernel_scratch_size - bytes of scratch needed, (samples/2+1) complex bins plus samples scalars
+ *  generate_kernel_band - computes the spectrum of one band into scratch, returns the number of
+ *                         sparse elements above cfg.min_val
+ *  copy_kernel_band - writes those elements from scratch to out
+ * */
+size_t kernel_scratch_size(struct cq_kernel_cfg cfg);
+int generate_kernel_band(struct cq_kernel_cfg cfg, kiss_fftr_cfg fft_cfg, int band, void *scratch);
+void copy_kernel_band(struct cq_kernel_cfg cfg, const void *scratch, struct sparse_arr_elem out[]);
+
 /*
  *  reallocate_kernels - (optional) reallocates the kernels
  * 
@@ -0,0 +1,40 @@
+# SketchRunner.cmake
+# Native headless runners for examples/, see src/platforms/stub/sketch_runner.h
+#
+#   cmake -S tests -B build -DFASTLED_SKETCH_RUNNER_EXAMPLES="Wave2d;FxEngine"
+#   cmake --build build --target sketch_runner_Wave2d
+#   ./tests/.build/bin/sketch_runner_Wave2d --loops 1000 --video wave.rgb
+
+set(FASTLED_SKETCH_RUNNER_EXAMPLES "" CACHE STRING
+    "Examples to build headless sketch runners for (semicolon separated)")
+
+function(create_sketch_runner example)
+    set(example_dir ${CMAKE_CURRENT_SOURCE_DIR}/../examples/${example})
+    if(NOT EXISTS ${example_dir}/${example}.ino)
+        message(FATAL_ERROR "Sketch runner: ${example_dir}/${example}.ino not found")
+    endif()
+    set(target sketch_runner_${example})
+    add_executable(${target} ${CMAKE_CURRENT_SOURCE_DIR}/../src/fl/stub_main.cpp)
+    target_compile_features(${target} PRIVATE cxx_std_17)
+    # Sketches get Arduino.h from the wasm emulation and expect the fl
+    # namespace to be pulled in, as on device.
+    target_include_directories(${target} PRIVATE
+        ${example_dir}
+        ${CMAKE_CURRENT_SOURCE_DIR}/../src/platforms/wasm/compiler
+    )
+    target_compile_definitions(${target} PRIVATE
+        FASTLED_SKETCH_RUNNER
+        FASTLED_FORCE_USE_NAMESPACE=1
+        FASTLED_STUB_MAIN_INCLUDE_INO=${example_dir}/${example}.ino
+    )
+    target_compile_options(${target} PRIVATE -fno-rtti)
+    target_link_libraries(${target} fastled)
+    apply_static_runtime_linking(${target})
+    message(STATUS "Created sketch runner: ${target}")
+endfunction()
+
+function(create_sketch_runners)
+    foreach(example ${FASTLED_SKETCH_RUNNER_EXAMPLES})
+        create_sketch_runner(${example})
+    endforeach()
+endfunction()
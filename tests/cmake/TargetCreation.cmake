@@ -120,8 +120,13 @@ function(create_test_executable name sources)
         # Create executable
         add_executable(${name} ${sources})
         
-        # Link against FastLED library
-        target_link_libraries(${name} fastled)
+        # Link against FastLED library. The trace test gets the build with
+        # the FL_TRACE_SCOPEs compiled in, every other test the default one.
+        if(name STREQUAL "test_trace")
+            target_link_libraries(${name} fastled_trace)
+        else()
+            target_link_libraries(${name} fastled)
+        endif()
         
         # Link against test infrastructure
         target_link_libraries(${name} test_shared_static)
@@ -140,6 +145,9 @@ function(create_test_executable name sources)
     # Apply common test settings and flags
     apply_test_settings(${name})
     apply_unit_test_flags(${name})
+    if(name STREQUAL "test_trace")
+        target_compile_definitions(${name} PRIVATE FASTLED_TRACE=1)
+    endif()
     
     # Set the target as created
     set(${name}_CREATED TRUE PARENT_SCOPE)
@@ -203,6 +211,28 @@ function(configure_windows_executable target)
     endif()
 endfunction()
 
+# Function to create a copy of the fastled library built with FASTLED_TRACE=1,
+# for test_trace only. The other tests cover the default FASTLED_TRACE=0.
+function(create_traced_fastled_library)
+    get_target_property(sources fastled SOURCES)
+    get_target_property(options fastled COMPILE_OPTIONS)
+    get_target_property(definitions fastled COMPILE_DEFINITIONS)
+    get_target_property(source_dir fastled SOURCE_DIR)
+    set(absolute_sources "")
+    foreach(source ${sources})
+        get_filename_component(source ${source} ABSOLUTE BASE_DIR ${source_dir})
+        list(APPEND absolute_sources ${source})
+    endforeach()
+
+    # Only built when test_trace links it.
+    add_library(fastled_trace STATIC EXCLUDE_FROM_ALL ${absolute_sources})
+    target_compile_options(fastled_trace PRIVATE ${options})
+    target_compile_definitions(fastled_trace PRIVATE ${definitions} FASTLED_TRACE=1)
+    target_include_directories(fastled_trace PRIVATE ${source_dir})
+
+    message(STATUS "Created traced FastLED library: fastled_trace")
+endfunction()
+
 # Function to create the test infrastructure library
 function(create_test_infrastructure)
     # Create static library for test infrastructure
@@ -213,6 +243,8 @@ function(create_test_infrastructure)
     apply_unit_test_flags(test_shared_static)
     
     message(STATUS "Created test infrastructure library: test_shared_static")
+
+    create_traced_fastled_library()
 endfunction()
 
 # Function to create all test targets from source files
@@ -0,0 +1,152 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+#include <math.h>
+
+#include "FastLED.h"
+#include "fl/vector.h"
+#include "fx/2d/animartrix.hpp"
+
+using namespace fl;
+
+namespace {
+
+const int kWidth = 32;
+const int kHeight = 32;
+const u32 kTimes[] = {1000, 7000, 23000, 61000};
+
+template <typename MathT>
+struct TierRenderer : public animartrix_detail::ANIMartRIXT<MathT> {
+    typedef animartrix_detail::ANIMartRIXT<MathT> Base;
+    typedef void (Base::*Animation)();
+
+    fl::vector<CRGB> leds;
+
+    TierRenderer() : leds(kWidth * kHeight) { this->init(kWidth, kHeight); }
+
+    uint16_t xyMap(uint16_t x, uint16_t y) override {
+        return y * kWidth + x;
+    }
+    void setPixelColorInternal(int x, int y,
+                               animartrix_detail::rgb pixel) override {
+        leds[xyMap(x, y)] = CRGB(pixel.red, pixel.green, pixel.blue);
+    }
+
+    void run(int anim) {
+        static const Animation kAnimations[] = {
+#define FL_TIER_ENTRY(ANIM, FUNC) &Base::FUNC,
+            FL_ANIMARTRIX_ANIMATIONS(FL_TIER_ENTRY)
+#undef FL_TIER_ENTRY
+        };
+        (this->*kAnimations[anim])();
+    }
+};
+
+// Renders every frame time for one animation, returns the seconds spent.
+template <typename MathT>
+double render_frames(int anim, fl::vector<CRGB> *out) {
+    TierRenderer<MathT> renderer;
+    out->clear();
+    double seconds = 0;
+    for (u32 t : kTimes) {
+        renderer.setTime(t);
+        auto start = std::chrono::steady_clock::now();
+        renderer.run(anim);
+        seconds += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+        for (const CRGB &c : renderer.leds) {
+            out->push_back(c);
+        }
+    }
+    return seconds;
+}
+
+struct TierError {
+    double mean = 0; // Mean absolute channel error, 0..255.
+    int max = 0;
+    double psnr = 99; // dB, 99 when identical.
+};
+
+TierError compare(const fl::vector<CRGB> &exact, const fl::vector<CRGB> &tier) {
+    TierError out;
+    double sum = 0;
+    double sq = 0;
+    for (fl::size i = 0; i < exact.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            int d = ABS(int(exact[i].raw[c]) - int(tier[i].raw[c]));
+            sum += d;
+            sq += double(d) * d;
+            out.max = MAX(out.max, d);
+        }
+    }
+    const double n = double(exact.size()) * 3;
+    out.mean = sum / n;
+    if (sq > 0) {
+        out.psnr = 10.0 * log10(255.0 * 255.0 / (sq / n));
+    }
+    return out;
+}
+
+template <typename MathT> float max_trig_error() {
+    float worst = 0;
+    for (int i = -4000; i <= 4000; ++i) {
+        float x = i * 0.0123f;
+        worst = MAX(worst, fabsf(MathT::sin(x) - sinf(x)));
+        worst = MAX(worst, fabsf(MathT::cos(x) - cosf(x)));
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST_CASE("Animartrix math tiers stay close to libm") {
+    CHECK(max_trig_error<AnimartrixMathExact>() == 0.0f);
+    CHECK(max_trig_error<AnimartrixMathFloatFast>() < 0.002f);
+    CHECK(max_trig_error<AnimartrixMathFixed>() < 0.001f);
+
+    float worst = 0;
+    for (int y = -20; y <= 20; ++y) {
+        for (int x = -20; x <= 20; ++x) {
+            float fx = x * 0.73f;
+            float fy = y * 0.61f;
+            worst = MAX(worst, fabsf(AnimartrixMathFloatFast::atan2(fy, fx) -
+                                     atan2f(fy, fx)));
+        }
+    }
+    CHECK(worst < 0.0005f);
+    CHECK(AnimartrixMathFloatFast::atan2(0, 0) == 0.0f);
+    CHECK(AnimartrixMathFixed::sin(1e5f) == doctest::Approx(sinf(1e5f)).epsilon(0.01));
+}
+
+TEST_CASE("Animartrix per animation error and timing by math tier") {
+    fl::vector<CRGB> exact, fast, fixed;
+    double t_exact = 0, t_fast = 0, t_fixed = 0;
+    double worst_fast = 0, worst_fixed = 0;
+    MESSAGE(fl::string("animation: mean abs err / psnr dB, float_fast | fixed"));
+    for (int anim = 0; anim < NUM_ANIMATIONS; ++anim) {
+        t_exact += render_frames<AnimartrixMathExact>(anim, &exact);
+        t_fast += render_frames<AnimartrixMathFloatFast>(anim, &fast);
+        t_fixed += render_frames<AnimartrixMathFixed>(anim, &fixed);
+        REQUIRE(exact.size() == fast.size());
+        REQUIRE(exact.size() == fixed.size());
+        TierError e_fast = compare(exact, fast);
+        TierError e_fixed = compare(exact, fixed);
+        worst_fast = MAX(worst_fast, e_fast.mean);
+        worst_fixed = MAX(worst_fixed, e_fixed.mean);
+        MESSAGE(getAnimartrixName(anim)
+                << ": " << e_fast.mean << " / " << e_fast.psnr << " | "
+                << e_fixed.mean << " / " << e_fixed.psnr);
+    }
+    const int frames = NUM_ANIMATIONS * int(sizeof(kTimes) / sizeof(kTimes[0]));
+    MESSAGE("ms/frame at " << kWidth << "x" << kHeight << ": exact "
+                           << t_exact * 1000 / frames << ", float_fast "
+                           << t_fast * 1000 / frames << ", fixed "
+                           << t_fixed * 1000 / frames);
+    MESSAGE("worst mean abs err: float_fast " << worst_fast << ", fixed "
+                                              << worst_fixed);
+    CHECK(worst_fast < 3.0);
+    CHECK(worst_fixed < 0.5);
+}
@@ -0,0 +1,239 @@
+// Compile with: g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "fl/blob_cache.h"
+#include "fl/corkscrew.h"
+#include "fl/file_system.h"
+#include "fl/memory_budget.h"
+#include "fl/xymap.h"
+
+using namespace fl;
+
+namespace {
+
+class MemoryFile : public FileHandle {
+  public:
+    MemoryFile(const fl::vector<u8> &data, const char *path)
+        : mData(data), mPath(path) {}
+    bool available() const override { return mPos < mData.size(); }
+    fl::size size() const override { return mData.size(); }
+    fl::size read(u8 *dst, fl::size n) override {
+        fl::size i = 0;
+        for (; i < n && mPos < mData.size(); ++i) {
+            dst[i] = mData[mPos++];
+        }
+        return i;
+    }
+    fl::size pos() const override { return mPos; }
+    const char *path() const override { return mPath.c_str(); }
+    bool seek(fl::size pos) override {
+        mPos = pos;
+        return pos <= mData.size();
+    }
+    void close() override {}
+    bool valid() const override { return true; }
+
+  private:
+    fl::vector<u8> mData;
+    fl::string mPath;
+    fl::size mPos = 0;
+};
+
+// Appends to the file vector as it goes, like a card writing sectors.
+class MemoryWriter : public FileWriter {
+  public:
+    explicit MemoryWriter(fl::vector<u8> *file) : mFile(file) { mFile->clear(); }
+    bool write(const u8 *data, fl::size n) override {
+        // The card's storage isn't part of what the cache costs.
+        MemScope scope(MemCategory::kOther);
+        for (fl::size i = 0; i < n; ++i) {
+            mFile->push_back(data[i]);
+        }
+        return true;
+    }
+    bool close() override { return true; }
+
+  private:
+    fl::vector<u8> *mFile;
+};
+
+class MemoryFs : public FsImpl {
+  public:
+    bool begin() override { return true; }
+    void end() override {}
+    void close(FileHandlePtr file) override { (void)file; }
+    FileHandlePtr openRead(const char *path) override {
+        auto it = files.find(path);
+        if (it == files.end()) {
+            return FileHandlePtr();
+        }
+        // Handles copy the file, which a card doesn't, so keep that out of
+        // the caller's category too.
+        MemScope scope(MemCategory::kOther);
+        return fl::make_intrusive<MemoryFile>(it->second, path);
+    }
+    // Like an SD card, files can only go into existing directories.
+    FileWriterPtr openWrite(const char *path) override {
+        std::string parent(path);
+        parent = parent.substr(0, parent.rfind('/'));
+        if (!parent.empty() && !dirs.count(parent)) {
+            return FileWriterPtr();
+        }
+        writes++;
+        return fl::make_intrusive<MemoryWriter>(&files[path]);
+    }
+
+    bool mkdir(const char *path) override {
+        dirs.insert(path);
+        return true;
+    }
+
+    std::map<std::string, fl::vector<u8>> files;
+    std::set<std::string> dirs;
+    int writes = 0;
+};
+
+} // namespace
+
+TEST_CASE("BlobCache stores, loads and validates entries") {
+    auto mem = fl::make_intrusive<MemoryFs>();
+    FileSystem fs;
+    fs.begin(mem);
+    BlobCache cache(&fs);
+
+    BlobCacheKey key("test", 1);
+    key.add(u16(64)).add(1.5f);
+    u32 table[32];
+    int computed = 0;
+    auto compute = [&]() {
+        computed++;
+        for (int i = 0; i < 32; ++i) {
+            table[i] = u32(i * i);
+        }
+    };
+    CHECK_FALSE(cache.loadOrCompute(key, table, sizeof(table), compute));
+    CHECK(computed == 1);
+    CHECK(mem->writes == 1);
+    CHECK(mem->dirs.count("/flcache") == 1);
+
+    u32 loaded[32] = {};
+    CHECK(cache.loadOrCompute(key, loaded, sizeof(loaded), compute));
+    CHECK(computed == 1);
+    CHECK(loaded[31] == 31 * 31);
+    CHECK(cache.stats().hits == 1);
+
+    SUBCASE("different parameters miss") {
+        BlobCacheKey other("test", 1);
+        other.add(u16(65)).add(1.5f);
+        CHECK(other.value() != key.value());
+        CHECK_FALSE(cache.load(other, loaded, sizeof(loaded)));
+        BlobCacheKey bumped("test", 2);
+        bumped.add(u16(64)).add(1.5f);
+        CHECK(bumped.value() != key.value());
+    }
+
+    SUBCASE("size mismatch and corruption are rejected") {
+        CHECK_FALSE(cache.load(key, loaded, sizeof(loaded) - 4));
+        fl::vector<u8> &bytes = mem->files[cache.pathFor(key).c_str()];
+        bytes[bytes.size() - 1] ^= 0xFF;
+        CHECK_FALSE(cache.load(key, loaded, sizeof(loaded)));
+        CHECK(cache.stats().corrupt == 2);
+    }
+
+    SUBCASE("root directory") {
+        BlobCache root(&fs, "");
+        CHECK(root.pathFor(key).find("/flcache") == fl::string::npos);
+        CHECK(root.store(key, table, sizeof(table)));
+        CHECK(fs.writeFile("/plain.bin", reinterpret_cast<const u8 *>(table),
+                           8));
+        CHECK(mem->files["/plain.bin"].size() == 8);
+        CHECK(mem->dirs.size() == 1);
+        CHECK(root.load(key, loaded, sizeof(loaded)));
+    }
+
+    SUBCASE("no file system") {
+        BlobCache none(nullptr);
+        CHECK_FALSE(none.load(key, loaded, sizeof(loaded)));
+        CHECK_FALSE(none.store(key, loaded, sizeof(loaded)));
+    }
+}
+
+TEST_CASE("XYMap look up table from the persistent cache") {
+    auto mem = fl::make_intrusive<MemoryFs>();
+    FileSystem fs;
+    fs.begin(mem);
+    BlobCache cache(&fs);
+
+    XYMap expected = XYMap::constructSerpentine(16, 8);
+    XYMap first = XYMap::constructSerpentine(16, 8);
+    first.convertToLookUpTable(cache);
+    CHECK(first.isLUT());
+    CHECK(cache.stats().stores == 1);
+
+    XYMap second = XYMap::constructSerpentine(16, 8);
+    second.convertToLookUpTable(cache);
+    CHECK(cache.stats().hits == 1);
+    for (u16 y = 0; y < 8; ++y) {
+        for (u16 x = 0; x < 16; ++x) {
+            REQUIRE(second.mapToIndex(x, y) == expected.mapToIndex(x, y));
+        }
+    }
+}
+
+TEST_CASE("Corkscrew tile cache from the persistent cache") {
+    auto mem = fl::make_intrusive<MemoryFs>();
+    FileSystem fs;
+    fs.begin(mem);
+    BlobCache cache(&fs);
+
+    Corkscrew::Input input(19.0f, 288);
+    Corkscrew reference(input);
+    reference.setCachingEnabled(false);
+
+    Corkscrew first(input);
+    first.setPersistentCache(&cache);
+    first.at_wrap(0);
+    CHECK(cache.stats().stores == 1);
+
+    Corkscrew second(input);
+    second.setPersistentCache(&cache);
+    for (u16 i = 0; i < 288; ++i) {
+        Tile2x2_u8_wrap a = second.at_wrap(i);
+        Tile2x2_u8_wrap b = reference.at_wrap(i);
+        for (u16 x = 0; x < 2; ++x) {
+            for (u16 y = 0; y < 2; ++y) {
+                REQUIRE(a.at(x, y).first == b.at(x, y).first);
+                REQUIRE(a.at(x, y).second == b.at(x, y).second);
+            }
+        }
+    }
+    CHECK(cache.stats().hits == 1);
+}
+
+TEST_CASE("Corkscrew persistent cache keeps one copy of the tiles") {
+    auto mem = fl::make_intrusive<MemoryFs>();
+    FileSystem fs;
+    fs.begin(mem);
+    BlobCache cache(&fs);
+    Corkscrew::Input input(19.0f, 288);
+    const u32 tiles = MemoryPlan().corkscrew(input).total() -
+                      MemoryPlan().corkscrew(input, false).total();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        Corkscrew corkscrew(input);
+        corkscrew.setPersistentCache(&cache);
+        const u32 before = MemoryBudget::usage(MemCategory::kCorkscrew).live;
+        MemoryBudget::resetPeaks();
+        corkscrew.at_wrap(0);
+        // Store, then load: neither stages the whole table a second time.
+        CHECK(MemoryBudget::usage(MemCategory::kCorkscrew).peak - before ==
+              tiles);
+    }
+    CHECK(cache.stats().stores == 1);
+    CHECK(cache.stats().hits == 1);
+}
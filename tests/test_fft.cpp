@@ -5,10 +5,15 @@
 
 #include "test.h"
 
+#include "fl/audio.h"
 #include "fl/fft.h"
 #include "fl/fft_impl.h"
+#include "fl/fft_kernels_512x16.hpp"
 #include "fl/math.h"
 
+#include "third_party/cq_kernel/cq_kernel.h"
+#include "third_party/cq_kernel/kiss_fftr.h"
+
 // // Proof of concept FFTImpl using KISS FFTImpl. Right now this is fixed sized blocks
 // of 512. But this is
 // // intended to change with a C++ wrapper around ot/
@@ -140,3 +145,67 @@ TEST_CASE("fft tester 256 with 64 bands") {
     FASTLED_WARN("FFTImpl info: " << info);
     FASTLED_WARN("Done");
 }
+
+TEST_CASE("fft precomputed kernels match the runtime generator") {
+    using namespace fft_precomputed;
+    cq_kernel_cfg cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.samples = kSamples;
+    cfg.bands = kBands;
+    cfg.fmin = kMinFrequency;
+    cfg.fmax = kMaxFrequency;
+    cfg.fs = kSampleRate;
+    cfg.window_type = HAMMING;
+    cfg.min_val = kMinVal;
+
+    // Streaming generator, one band at a time.
+    kiss_fftr_cfg fft_cfg = kiss_fftr_alloc(kSamples, 0, NULL, NULL);
+    fl::vector<u8> scratch(kernel_scratch_size(cfg));
+    CHECK(scratch.size() < kSamples * (sizeof(kiss_fft_cpx) + 2));
+    for (int band = 0; band < kBands; ++band) {
+        int n = generate_kernel_band(cfg, fft_cfg, band, scratch.data());
+        REQUIRE(u32(n) == kOffsets[band + 1] - kOffsets[band]);
+        fl::vector<sparse_arr_elem> elems(n);
+        copy_kernel_band(cfg, scratch.data(), elems.data());
+        for (int j = 0; j < n; ++j) {
+            const sparse_arr_elem &expected = kElems[kOffsets[band] + j];
+            CHECK(elems[j].n == expected.n);
+            CHECK(elems[j].val.r == expected.val.r);
+            CHECK(elems[j].val.i == expected.val.i);
+        }
+    }
+    kiss_fftr_free(fft_cfg);
+
+    // The allocating wrapper produces the same kernels.
+    sparse_arr *kernels = generate_kernels(cfg);
+    for (int band = 0; band < kBands; ++band) {
+        REQUIRE(u32(kernels[band].n_elems) ==
+                kOffsets[band + 1] - kOffsets[band]);
+        for (int j = 0; j < kernels[band].n_elems; ++j) {
+            const sparse_arr_elem &expected = kElems[kOffsets[band] + j];
+            CHECK(kernels[band].elems[j].n == expected.n);
+            CHECK(kernels[band].elems[j].val.r == expected.val.r);
+        }
+    }
+    free_kernels(kernels, cfg);
+}
+
+TEST_CASE("fft default args use the precomputed kernels") {
+    FFTImpl defaults(FFT_Args{});
+    CHECK(defaults.precomputedKernels());
+    FFTImpl other(FFT_Args(256));
+    CHECK_FALSE(other.precomputedKernels());
+}
+
+TEST_CASE("fft warmup creates the cached fft ahead of run") {
+    FFT fft;
+    CHECK(fft.size() == 0);
+    FFT_Args args(256, 16);
+    fft.warmup(args);
+    CHECK(fft.size() == 1);
+    fl::vector<i16> buffer(256);
+    FFTBins out(16);
+    fft.run(buffer, &out, args);
+    CHECK(fft.size() == 1); // Reused, not created again.
+    AudioSample::warmupFFT();
+}
@@ -0,0 +1,188 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "FastLED.h"
+#include "cled_controller.h"
+#include "fl/atomic.h"
+#include "fl/frame_exchange.h"
+#include "fl/vector.h"
+
+#if FASTLED_MULTITHREADED
+#include <pthread.h>
+#endif
+
+using namespace fl;
+
+namespace {
+
+// Checks every frame it shows is whole: all pixels carry the same frame
+// number, and the numbers never go backwards.
+class ExchangeTestController : public CLEDController {
+  public:
+    void init() override {}
+    void showColor(const CRGB &, int, u8) override {}
+    void show(const CRGB *data, int nLeds, u8) override {
+        ++shows;
+        const u32 frame = exchange_test_frame(data[0]);
+        for (int i = 1; i < nLeds; ++i) {
+            if (data[i] != data[0]) {
+                ++torn;
+            }
+        }
+        if (frame < last) {
+            ++backwards;
+        }
+        last = frame;
+    }
+    static u32 exchange_test_frame(const CRGB &c) {
+        return u32(c.r) | (u32(c.g) << 8);
+    }
+    int shows = 0;
+    int torn = 0;
+    int backwards = 0;
+    u32 last = 0;
+};
+
+void exchange_test_draw(CRGB *leds, fl::size n, u32 frame) {
+    for (fl::size i = 0; i < n; ++i) {
+        leds[i] = CRGB(u8(frame), u8(frame >> 8), 7);
+    }
+}
+
+#if FASTLED_MULTITHREADED
+struct ExchangeTestProducer {
+    FrameExchange *exchange;
+    int slot;
+    u32 frames;
+    fl::atomic_bool *done;
+};
+
+void *exchange_test_produce(void *arg) {
+    ExchangeTestProducer *p = static_cast<ExchangeTestProducer *>(arg);
+    for (u32 f = 1; f <= p->frames; ++f) {
+        exchange_test_draw(p->exchange->acquire(p->slot),
+                           p->exchange->size(p->slot), f);
+        p->exchange->submit(p->slot);
+    }
+    p->done->store(true);
+    return nullptr;
+}
+#endif
+
+} // namespace
+
+TEST_CASE("FrameExchange shows the newest submitted frame") {
+    // Controllers stay on the global list for good, so they are static.
+    static ExchangeTestController a;
+    static ExchangeTestController b;
+    CRGB leds[8];
+    a.setLeds(leds, 8);
+    b.setLeds(leds, 5);
+    FrameExchange exchange;
+    const int slotA = exchange.add(&a);
+    const int slotB = exchange.add(&b);
+    CHECK(exchange.slots() == 2);
+    CHECK(exchange.size(slotB) == 5);
+    CHECK(a.leds() != leds);
+    CHECK(a.leds()[0] == CRGB(0, 0, 0));
+
+    // Nothing submitted, nothing changes.
+    CHECK(exchange.present() == 0);
+
+    // Two submits before present(): the second one wins.
+    exchange_test_draw(exchange.acquire(slotA), 8, 1);
+    exchange.submit(slotA);
+    exchange_test_draw(exchange.acquire(slotA), 8, 2);
+    exchange.submit(slotA);
+    CHECK(exchange.submitted(slotA) == 2);
+    CHECK(a.leds()[0] == CRGB(0, 0, 0));
+    CHECK(exchange.present() == 1);
+    CHECK(ExchangeTestController::exchange_test_frame(a.leds()[7]) == 2);
+    CHECK(exchange.present() == 0);
+
+    // The producer never gets the buffer being shown.
+    CHECK(exchange.acquire(slotA) != a.leds());
+    exchange_test_draw(exchange.acquire(slotB), 5, 3);
+    exchange.submit(slotB);
+    CHECK(exchange.acquire(slotB) != b.leds());
+    CHECK(exchange.present() == 1);
+    CHECK(ExchangeTestController::exchange_test_frame(b.leds()[4]) == 3);
+    CHECK(ExchangeTestController::exchange_test_frame(a.leds()[0]) == 2);
+    // The controllers outlive leds, keep later FastLED.show() calls away.
+    a.setEnabled(false);
+    b.setEnabled(false);
+}
+
+TEST_CASE("FrameExchange gives the controllers their LEDs back") {
+    static ExchangeTestController controller;
+    static CRGB leds[6];
+    controller.setLeds(leds, 6);
+    {
+        FrameExchange exchange;
+        const int slot = exchange.add(&controller);
+        CHECK(controller.leds() != leds);
+        exchange_test_draw(exchange.acquire(slot), 6, 5);
+        exchange.submit(slot);
+        CHECK(exchange.present() == 1);
+    }
+    CHECK(controller.leds() == leds);
+    CHECK(controller.size() == 6);
+
+    // Shows the sketch's array again, not the freed slot buffers.
+    leds[0] = leds[1] = leds[2] = leds[3] = leds[4] = leds[5] = CRGB(9, 0, 7);
+    const int shows = controller.shows;
+    FastLED.show(255);
+    CHECK(controller.shows == shows + 1);
+    CHECK(controller.last == 9);
+    CHECK(controller.torn == 0);
+}
+
+#if FASTLED_MULTITHREADED
+TEST_CASE("FrameExchange producers on their own threads") {
+    const int kProducers = 3;
+    const u32 kFrames = 3000;
+    static ExchangeTestController controllers[kProducers];
+    // The exchange hands leds back on destruction, so it outlives the test.
+    static CRGB leds[64];
+    FrameExchange exchange;
+    ExchangeTestProducer producers[kProducers];
+    fl::atomic_bool done[kProducers];
+    for (int i = 0; i < kProducers; ++i) {
+        controllers[i].setLeds(leds, 16 + 16 * i);
+        done[i].store(false);
+        producers[i] = {&exchange, exchange.add(&controllers[i]), kFrames,
+                        &done[i]};
+    }
+
+    pthread_t threads[kProducers];
+    for (int i = 0; i < kProducers; ++i) {
+        REQUIRE(pthread_create(&threads[i], nullptr, exchange_test_produce,
+                               &producers[i]) == 0);
+    }
+    // The transmit loop: keep showing until every producer finished and its
+    // last frame went out.
+    for (;;) {
+        bool finished = true;
+        for (int i = 0; i < kProducers; ++i) {
+            finished = finished && done[i].load();
+        }
+        exchange.show(255);
+        if (finished) {
+            exchange.show(255);
+            break;
+        }
+    }
+    for (int i = 0; i < kProducers; ++i) {
+        pthread_join(threads[i], nullptr);
+    }
+
+    for (int i = 0; i < kProducers; ++i) {
+        CHECK(exchange.submitted(i) == kFrames);
+        CHECK(controllers[i].torn == 0);
+        CHECK(controllers[i].backwards == 0);
+        CHECK(controllers[i].last == kFrames);
+        CHECK(controllers[i].shows > 0);
+    }
+}
+#endif
@@ -0,0 +1,179 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "fl/engine_events.h"
+#include "fl/frame_scheduler.h"
+
+using namespace fl;
+
+namespace {
+
+// Virtual microsecond clock, tasks advance it to simulate their cost.
+u32 gNow = 0;
+
+struct ClockFixture {
+    ClockFixture() {
+        gNow = 0;
+        FrameScheduler::instance().clear();
+        FrameScheduler::instance().setClock([]() { return gNow; });
+    }
+    ~ClockFixture() {
+        FrameScheduler::instance().clear();
+        FrameScheduler::instance().setClock(FrameScheduler::Clock());
+    }
+};
+
+struct CountingListener : public EngineEvents::Listener {
+    CountingListener(u32 cost) : cost(cost) {
+        EngineEvents::addListener(this);
+    }
+    ~CountingListener() { EngineEvents::removeListener(this); }
+    void onEndFrame() override {
+        endFrames++;
+        gNow += cost;
+    }
+    void onEndShowLeds() override { endShows++; }
+    u32 cost;
+    int endFrames = 0;
+    int endShows = 0;
+};
+
+} // namespace
+
+TEST_CASE("FrameScheduler runs tasks by priority within the budget") {
+    ClockFixture fixture;
+    FrameScheduler &sched = FrameScheduler::instance();
+    fl::vector<int> order;
+    int low = sched.addTask("low", [&]() { order.push_back(3); gNow += 100; },
+                            FrameScheduler::kLow, 200);
+    sched.addTask("high", [&]() { order.push_back(1); gNow += 400; },
+                  FrameScheduler::kHigh, 500);
+    sched.addTask("critical", [&]() { order.push_back(0); gNow += 50; },
+                  FrameScheduler::kCritical, 10);
+
+    CHECK(sched.runIdle(1000) == 3);
+    REQUIRE(order.size() == 3);
+    CHECK(order[0] == 0);
+    CHECK(order[1] == 1);
+    CHECK(order[2] == 3);
+    CHECK(sched.stats(low)->runs == 1);
+    CHECK(sched.name(low) != nullptr);
+
+    SUBCASE("tasks that do not fit are deferred, critical always runs") {
+        order.clear();
+        CHECK(sched.runIdle(600) == 2);
+        CHECK(order.size() == 2); // critical + high, low no longer fits.
+        CHECK(sched.stats(low)->deferrals == 1);
+        CHECK(sched.stats(low)->runs == 1);
+    }
+
+    SUBCASE("deadline misses and slice overruns") {
+        int slow = sched.addTask("slow", []() { gNow += 300; },
+                                 FrameScheduler::kNormal, 200);
+        sched.runIdle(5000);
+        CHECK(sched.stats(slow)->deadlineMisses == 1);
+        CHECK(sched.stats(slow)->maxMicros == 300);
+        CHECK(sched.sliceOverruns() == 0);
+        sched.runIdle(0);
+        CHECK(sched.sliceOverruns() == 1); // The critical task still ran.
+    }
+
+    SUBCASE("removed tasks stop running") {
+        CHECK(sched.removeTask(low));
+        CHECK_FALSE(sched.removeTask(low));
+        CHECK(sched.stats(low) == nullptr);
+        order.clear();
+        sched.runIdle(1000);
+        CHECK(order.size() == 2);
+    }
+}
+
+TEST_CASE("FrameScheduler prefers tasks that waited") {
+    ClockFixture fixture;
+    FrameScheduler &sched = FrameScheduler::instance();
+    int runsA = 0;
+    int runsB = 0;
+    sched.addTask("a", [&]() { runsA++; gNow += 100; }, FrameScheduler::kNormal,
+                  100);
+    sched.addTask("b", [&]() { runsB++; gNow += 100; }, FrameScheduler::kNormal,
+                  100);
+    // Room for one task per slice, they have to take turns.
+    for (int i = 0; i < 10; ++i) {
+        sched.runIdle(150);
+    }
+    CHECK(runsA == 5);
+    CHECK(runsB == 5);
+}
+
+TEST_CASE("FrameScheduler posted tasks run once") {
+    ClockFixture fixture;
+    FrameScheduler &sched = FrameScheduler::instance();
+    int runs = 0;
+    sched.post([&]() { runs++; }, FrameScheduler::kLow, 2000);
+    sched.runIdle(1000); // Does not fit.
+    CHECK(runs == 0);
+    CHECK(sched.numPending() == 1);
+    sched.runIdle(3000);
+    CHECK(runs == 1);
+    CHECK(sched.numPending() == 0);
+    sched.runIdle(3000);
+    CHECK(runs == 1);
+
+    // Work posted from inside a slice waits for the next one.
+    sched.post([&]() {
+        runs++;
+        FrameScheduler::instance().post([&]() { runs += 10; });
+    });
+    sched.runIdle(1000);
+    CHECK(runs == 2);
+    sched.runIdle(1000);
+    CHECK(runs == 12);
+}
+
+#if FASTLED_HAS_ENGINE_EVENTS
+TEST_CASE("EngineEvents listener stats and deferred listeners") {
+    ClockFixture fixture;
+    CountingListener sync(30);
+    CountingListener deferred(200);
+    EngineEvents::setBudget(&sync, 20);
+    EngineEvents::setDeferred(&deferred, true, FrameScheduler::kLow, 250);
+
+    EngineEvents::onEndFrame();
+    EngineEvents::onEndShowLeds();
+    CHECK(sync.endFrames == 1);
+    CHECK(sync.endShows == 1);
+    CHECK(deferred.endFrames == 0); // Queued for the idle slice.
+    CHECK(FrameScheduler::instance().numPending() == 1);
+
+    const EngineEvents::ListenerStats *stats = EngineEvents::stats(&sync);
+    REQUIRE(stats);
+    CHECK(stats->calls == 2);
+    CHECK(stats->maxMicros == 30);
+    CHECK(stats->deadlineMisses == 1);
+
+    SUBCASE("runs in the idle slice") {
+        FrameScheduler::instance().runIdle(1000);
+        CHECK(deferred.endFrames == 1);
+        CHECK(deferred.endShows == 1);
+        stats = EngineEvents::stats(&deferred);
+        CHECK(stats->deferredCalls == 2);
+        CHECK(stats->deadlineMisses == 0);
+    }
+
+    SUBCASE("coalesces frames while the slice has no room") {
+        FrameScheduler::instance().runIdle(100);
+        EngineEvents::onEndFrame();
+        CHECK(FrameScheduler::instance().numPending() == 1);
+        FrameScheduler::instance().runIdle(1000);
+        CHECK(deferred.endFrames == 1);
+    }
+
+    SUBCASE("removed listeners are not called") {
+        EngineEvents::removeListener(&deferred);
+        FrameScheduler::instance().runIdle(1000);
+        CHECK(deferred.endFrames == 0);
+        CHECK(EngineEvents::stats(&deferred) == nullptr);
+    }
+}
+#endif
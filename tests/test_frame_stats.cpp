@@ -0,0 +1,206 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "FastLED.h"
+#include "fl/frame_stats.h"
+#include "fl/json.h"
+#include "fl/json_console.h"
+#include "fl/ui.h"
+#include "fl/vector.h"
+
+using namespace fl;
+
+namespace {
+
+// One frame of a fake show(): render, then wait, then push the pixels.
+u32 fake_frame(FrameStats &stats, u32 now, u32 render, u32 idle, u32 show) {
+    now += render;
+    stats.beginShow(now);
+    stats.endWait(now, now + idle);
+    now += idle + show;
+    stats.endShow(now);
+    return now;
+}
+
+} // namespace
+
+TEST_CASE("FrameTimeHistogram buckets") {
+    for (u32 v = 0; v < 8; ++v) {
+        CHECK(FrameTimeHistogram::bucketOf(v) == int(v));
+        CHECK(FrameTimeHistogram::bucketUpper(int(v)) == v);
+    }
+    CHECK(FrameTimeHistogram::bucketOf(8) == 8);
+    CHECK(FrameTimeHistogram::bucketOf(15) == 15);
+    CHECK(FrameTimeHistogram::bucketOf(16) == 16);
+    CHECK(FrameTimeHistogram::bucketOf(17) == 16);
+    CHECK(FrameTimeHistogram::bucketUpper(16) == 17);
+    CHECK(FrameTimeHistogram::bucketOf(0xFFFFFFFFu) ==
+          FrameTimeHistogram::kNumBuckets - 1);
+    CHECK(FrameTimeHistogram::bucketUpper(FrameTimeHistogram::kNumBuckets - 1) ==
+          0xFFFFFFFFu);
+
+    // Every value sits in its bucket, edges are contiguous and the bucket
+    // width stays within 1/8 of the value.
+    for (int b = 1; b < FrameTimeHistogram::kNumBuckets; ++b) {
+        const u32 lower = FrameTimeHistogram::bucketUpper(b - 1) + 1;
+        const u32 upper = FrameTimeHistogram::bucketUpper(b);
+        REQUIRE(FrameTimeHistogram::bucketOf(lower) == b);
+        REQUIRE(FrameTimeHistogram::bucketOf(upper) == b);
+        REQUIRE(upper - lower <= lower / 8);
+    }
+}
+
+TEST_CASE("FrameTimeHistogram percentiles") {
+    FrameTimeHistogram h;
+    CHECK(h.percentile(50) == 0);
+    for (u32 v = 1; v <= 100; ++v) {
+        h.add(v * 100);
+    }
+    CHECK(h.samples() == 100);
+    CHECK(h.min() == 100);
+    CHECK(h.max() == 10000);
+    CHECK(h.mean() == 5050);
+    CHECK(h.last() == 10000);
+    // Upper bucket edges, at most 1/8 above the exact value.
+    const u32 p50 = h.percentile(50);
+    CHECK(p50 >= 5000);
+    CHECK(p50 <= 5000 + 5000 / 8);
+    const u32 p99 = h.percentile(99);
+    CHECK(p99 >= 9900);
+    CHECK(p99 <= 10000);
+    CHECK(h.percentile(100) == 10000);
+    CHECK(h.percentile(0) <= 100 + 100 / 8);
+
+    h.reset();
+    CHECK(h.samples() == 0);
+    CHECK(h.max() == 0);
+}
+
+TEST_CASE("FrameTimeHistogram halves counts on overflow") {
+    FrameTimeHistogram h;
+    for (u32 i = 0; i < 0x10000; ++i) {
+        h.add(1000);
+    }
+    h.add(2000);
+    CHECK(h.samples() == 0x10001);
+    CHECK(h.count(FrameTimeHistogram::bucketOf(1000)) == 0x8000);
+    CHECK(h.count(FrameTimeHistogram::bucketOf(2000)) == 1);
+    CHECK(h.percentile(50) <= 1000 + 1000 / 8);
+}
+
+TEST_CASE("FrameStats phase breakdown and jitter") {
+    FrameStats stats;
+    u32 now = 1000;
+    for (int i = 0; i < 50; ++i) {
+        now = fake_frame(stats, now, 10000, 5000, 1000);
+    }
+    CHECK(stats.frames() == 50);
+    CHECK(stats.frame().samples() == 49);
+    CHECK(stats.render().samples() == 49);
+    CHECK(stats.show().samples() == 50);
+    CHECK(stats.idle().samples() == 50);
+    CHECK(stats.frame().min() == 16000);
+    CHECK(stats.frame().max() == 16000);
+    CHECK(stats.render().mean() == 10000);
+    CHECK(stats.idle().mean() == 5000);
+    CHECK(stats.show().mean() == 1000);
+    CHECK(stats.jitterMicros() == 0);
+    CHECK(stats.fps() == 62);
+
+    // Alternating frame times: the jitter converges towards the difference.
+    for (int i = 0; i < 200; ++i) {
+        now = fake_frame(stats, now, i % 2 ? 12000 : 8000, 5000, 1000);
+    }
+    CHECK(stats.jitterMicros() > 3500);
+    CHECK(stats.jitterMicros() <= 4000);
+    CHECK(stats.fps() >= 61);
+    CHECK(stats.fps() <= 63);
+
+    stats.reset();
+    CHECK(stats.frames() == 0);
+    CHECK(stats.fps() == 0);
+}
+
+TEST_CASE("FrameStats counts the idle slice as idle, not render") {
+    FrameStats stats;
+    u32 now = 0;
+    for (int i = 0; i < 10; ++i) {
+        now = fake_frame(stats, now, 3000, 1000, 500);
+        now += 2000;
+        stats.endIdleSlice(now);
+    }
+    CHECK(stats.render().max() == 3000);
+    CHECK(stats.show().max() == 500);
+    // The first frame had no slice before it.
+    CHECK(stats.idle().min() == 1000);
+    CHECK(stats.idle().max() == 3000);
+    CHECK(stats.frame().mean() == 6500);
+}
+
+TEST_CASE("FrameStats json") {
+    FrameStats stats;
+    u32 now = 0;
+    for (int i = 0; i < 10; ++i) {
+        now = fake_frame(stats, now, 2000, 0, 500);
+    }
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(stats.toJsonString().c_str(), &doc));
+    CHECK(doc["frames"].as<int>() == 10);
+    CHECK(doc["fps"].as<int>() == 400);
+    CHECK(doc["frame_us"]["p50"].as<int>() == 2500);
+    CHECK(doc["render_us"]["max"].as<int>() == 2000);
+    CHECK(doc["show_us"]["mean"].as<int>() == 500);
+    CHECK(doc["idle_us"]["max"].as<int>() == 0);
+    auto buckets = doc["frame_histogram"].as<FLArduinoJson::JsonArrayConst>();
+    REQUIRE(buckets.size() == 1);
+    CHECK(buckets[0][1].as<int>() == 9);
+}
+
+TEST_CASE("show() feeds FrameStats") {
+    FrameStats &stats = FrameStats::instance();
+    stats.reset();
+    FastLED.show();
+    FastLED.show();
+    FastLED.show();
+    CHECK(stats.frames() == 3);
+    CHECK(stats.frame().samples() == 2);
+    CHECK(FastLED.getFPS() == stats.fps());
+}
+
+TEST_CASE("frame stats over the json UI") {
+    fl::string published;
+    fl::setJsonUiHandlers([&published](const char *json) { published = json; });
+    {
+        UIFrameStats ui("Frame stats", 0);
+        FastLED.show();
+        fl::processJsonUiPendingUpdates();
+        fl::JsonDocument doc;
+        REQUIRE(fl::parseJson(published.c_str(), &doc));
+        bool found = false;
+        for (auto c : doc.as<FLArduinoJson::JsonArrayConst>()) {
+            if (fl::string(c["type"].as<const char *>()) == "frame_stats") {
+                found = true;
+                CHECK(c["stats"]["frames"].as<int>() ==
+                      int(FrameStats::instance().frames()));
+            }
+        }
+        CHECK(found);
+    }
+    fl::setJsonUiHandlers(fl::function<void(const char *)>{});
+}
+
+TEST_CASE("JsonConsole stats command") {
+    fl::vector<fl::string> output;
+    JsonConsole console([]() { return 0; }, []() { return -1; },
+                        [&output](const char *s) { output.push_back(s); });
+    FrameStats::instance().reset();
+    FastLED.show();
+    CHECK(console.executeCommand("stats"));
+    REQUIRE(output.size() == 1);
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(output[0].c_str(), &doc));
+    CHECK(doc["frames"].as<int>() == 1);
+    CHECK(console.executeCommand("stats reset"));
+    CHECK(FrameStats::instance().frames() == 0);
+}
@@ -1,5 +1,7 @@
 #include "test.h"
 
+#include <chrono>
+
 #include "fl/json.h"
 #include "fl/namespace.h"
 #include "fl/map.h"
@@ -416,6 +418,162 @@ TEST_CASE("JsonUiManager multiple components basic") {
     setJsonUiHandlers(fl::function<void(const char*)>());
 }
 
+TEST_CASE("JsonUiManager publishes only changed components as deltas") {
+    fl::vector<fl::string> messages;
+    JsonUiManager manager([&](const char *json) { messages.push_back(json); });
+    manager.setFullSnapshotInterval(3);
+
+    int values[3] = {10, 20, 30};
+    fl::vector<JsonUiInternalPtr> components;
+    for (int i = 0; i < 3; ++i) {
+        int *value = &values[i];
+        fl::string name = "c";
+        name.append(i);
+        auto toJson = [value, name](FLArduinoJson::JsonObject &json) {
+            json["name"] = name.c_str();
+            json["value"] = *value;
+        };
+        components.push_back(fl::make_intrusive<JsonUiInternal>(
+            name, JsonUiInternal::UpdateFunction(), toJson));
+        manager.addComponent(components.back());
+    }
+
+    // Registration sends the full array.
+    manager.processPendingUpdates();
+    REQUIRE(messages.size() == 1);
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(messages[0].c_str(), &doc));
+    CHECK(doc.as<FLArduinoJson::JsonArrayConst>().size() == 3);
+
+    // Nothing changed, nothing sent.
+    manager.processPendingUpdates();
+    CHECK(messages.size() == 1);
+
+    values[1] = 21;
+    components[1]->markChanged();
+    components[1]->markChanged(); // Already dirty, listed once.
+    manager.processPendingUpdates();
+    REQUIRE(messages.size() == 2);
+    REQUIRE(fl::parseJson(messages[1].c_str(), &doc));
+    auto delta = doc["delta"].as<FLArduinoJson::JsonArrayConst>();
+    REQUIRE(delta.size() == 1);
+    CHECK(fl::string(delta[0]["name"].as<const char *>()) == "c1");
+    CHECK(delta[0]["value"].as<int>() == 21);
+    CHECK_FALSE(components[1]->hasChanged());
+
+    values[2] = 31;
+    components[2]->markChanged();
+    manager.processPendingUpdates();
+    REQUIRE(fl::parseJson(messages[2].c_str(), &doc));
+    CHECK(doc["delta"].as<FLArduinoJson::JsonArrayConst>().size() == 1);
+
+    // Third change since the snapshot: the periodic full snapshot.
+    components[0]->markChanged();
+    manager.processPendingUpdates();
+    REQUIRE(messages.size() == 4);
+    REQUIRE(fl::parseJson(messages[3].c_str(), &doc));
+    CHECK(doc.as<FLArduinoJson::JsonArrayConst>().size() == 3);
+
+    // A removed component is no longer reported.
+    manager.removeComponent(components[0]);
+    components[0]->markChanged();
+    manager.processPendingUpdates();
+    CHECK(messages.size() == 4);
+
+    for (auto &component : components) {
+        manager.removeComponent(component);
+        component->clearFunctions();
+    }
+}
+
+TEST_CASE("JsonUiManager finds components by id and name") {
+    JsonUiManager manager([](const char *) {});
+    auto noop = [](FLArduinoJson::JsonObject &) {};
+    auto a = fl::make_intrusive<JsonUiInternal>(
+        "speed", JsonUiInternal::UpdateFunction(), noop);
+    auto b = fl::make_intrusive<JsonUiInternal>(
+        "speed", JsonUiInternal::UpdateFunction(), noop);
+    auto c = fl::make_intrusive<JsonUiInternal>(
+        "7up", JsonUiInternal::UpdateFunction(), noop);
+    manager.addComponent(a);
+    manager.addComponent(b);
+    manager.addComponent(c);
+
+    fl::string idStr;
+    idStr.append(b->id());
+    CHECK(manager.findUiComponent(idStr.c_str()) == b);
+    CHECK(manager.findUiComponent("speed") == a); // First registered wins.
+    CHECK(manager.findUiComponent("7up") == c);
+    CHECK_FALSE(manager.findUiComponent("missing"));
+
+    // The name moves on to the next owner.
+    manager.removeComponent(a);
+    CHECK(manager.findUiComponent("speed") == b);
+
+    // Dropped without removeComponent(), pruned on lookup.
+    fl::WeakPtr<JsonUiInternal> weakC = c;
+    c->clearFunctions();
+    c.reset();
+    CHECK_FALSE(weakC.lock());
+    CHECK_FALSE(manager.findUiComponent("7up"));
+
+    manager.removeComponent(b);
+    CHECK_FALSE(manager.findUiComponent("speed"));
+    a->clearFunctions();
+    b->clearFunctions();
+}
+
+TEST_CASE("JsonUiManager update lookup benchmark") {
+    const int kComponents = 200;
+    const int kUpdatesPerFrame = 100;
+    const int kFrames = 200;
+    JsonUiManager manager([](const char *) {});
+    int updates = 0;
+    fl::vector<JsonUiInternalPtr> components;
+    for (int i = 0; i < kComponents; ++i) {
+        fl::string name = "slider";
+        name.append(i);
+        components.push_back(fl::make_intrusive<JsonUiInternal>(
+            name,
+            [&updates](const FLArduinoJson::JsonVariantConst &) { ++updates; },
+            [](FLArduinoJson::JsonObject &) {}));
+        manager.addComponent(components.back());
+    }
+
+    // Half the keys by id, half by name, spread over the whole set.
+    fl::string json = "{";
+    for (int i = 0; i < kUpdatesPerFrame; ++i) {
+        auto &component = components[(i * 37) % kComponents];
+        json.append(i ? ",\"" : "\"");
+        if (i % 2) {
+            json.append(component->id());
+        } else {
+            json.append(component->name());
+        }
+        json.append("\":");
+        json.append(i);
+    }
+    json.append("}");
+    FLArduinoJson::JsonDocument doc;
+    deserializeJson(doc, json.c_str());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        manager.executeUiUpdates(doc);
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    CHECK(updates == kUpdatesPerFrame * kFrames);
+    MESSAGE(kComponents << " components, " << kUpdatesPerFrame
+                        << " updates/frame: " << seconds * 1e6 / kFrames
+                        << " us/frame");
+    for (auto &component : components) {
+        manager.removeComponent(component);
+        component->clearFunctions();
+    }
+}
+
 #endif
 
 #else
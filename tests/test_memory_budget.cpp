@@ -0,0 +1,137 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "FastLED.h"
+#include "fl/corkscrew.h"
+#include "fl/fft.h"
+#include "fl/frame_exchange.h"
+#include "fl/memory_budget.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+
+using namespace fl;
+
+namespace {
+
+class BudgetTestController : public CLEDController {
+  public:
+    void init() override {}
+    void showColor(const CRGB &, int, u8) override {}
+    void show(const CRGB *, int, u8) override {}
+};
+
+u32 budget_test_live(MemCategory category) {
+    return MemoryBudget::usage(category).live;
+}
+
+} // namespace
+
+TEST_CASE("MemoryBudget charges allocations to the innermost scope") {
+    REQUIRE(MemoryBudget::enabled());
+    CHECK(int(MemScope::current()) == int(MemCategory::kOther));
+    const u32 fxBefore = budget_test_live(MemCategory::kFxLayer);
+    const u32 jsonBefore = budget_test_live(MemCategory::kJson);
+    const u32 allocsBefore = MemoryBudget::usage(MemCategory::kFxLayer).allocs;
+    {
+        MemScope outer(MemCategory::kFxLayer);
+        fl::vector<u8> a;
+        a.reserve(1000);
+        {
+            MemScope inner(MemCategory::kJson);
+            CHECK(int(MemScope::current()) == int(MemCategory::kJson));
+            fl::vector<u8> b;
+            b.reserve(300);
+            CHECK(budget_test_live(MemCategory::kJson) == jsonBefore + 300);
+        }
+        CHECK(int(MemScope::current()) == int(MemCategory::kFxLayer));
+        CHECK(budget_test_live(MemCategory::kJson) == jsonBefore);
+        CHECK(budget_test_live(MemCategory::kFxLayer) == fxBefore + 1000);
+        CHECK(MemoryBudget::usage(MemCategory::kFxLayer).peak >=
+              fxBefore + 1000);
+    }
+    CHECK(int(MemScope::current()) == int(MemCategory::kOther));
+    CHECK(budget_test_live(MemCategory::kFxLayer) == fxBefore);
+    CHECK(MemoryBudget::usage(MemCategory::kFxLayer).allocs == allocsBefore + 1);
+
+    // PSRAM allocations are counted the same way.
+    {
+        MemScope scope(MemCategory::kDrawBuffer);
+        u8 *p = PSRamAllocator<u8>::Alloc(64);
+        CHECK(budget_test_live(MemCategory::kDrawBuffer) == 64);
+        PSRamAllocator<u8>::Free(p);
+    }
+    CHECK(budget_test_live(MemCategory::kDrawBuffer) == 0);
+
+    MemoryBudget::resetPeaks();
+    CHECK(MemoryBudget::total().peak == MemoryBudget::total().live);
+}
+
+TEST_CASE("MemoryPlan matches what the tagged classes allocate") {
+    // XYMap look up table, wide indices over 256 leds.
+    {
+        const u32 before = budget_test_live(MemCategory::kXYMap);
+        XYMap map = XYMap::constructSerpentine(24, 20);
+        map.convertToLookUpTable();
+        CHECK(map.mapToIndex(3, 4) < 24 * 20);
+        const u32 planned = MemoryPlan().xyMap(24, 20).total();
+        CHECK(planned == 24 * 20 * 2);
+        const u32 used = budget_test_live(MemCategory::kXYMap) - before;
+        CHECK(used >= planned);
+        CHECK(used <= planned + planned / 2);
+    }
+
+    // Corkscrew buffer and tile cache.
+    {
+        const u32 before = budget_test_live(MemCategory::kCorkscrew);
+        CorkscrewInput input(19, 288);
+        Corkscrew corkscrew(input);
+        corkscrew.getBuffer();
+        corkscrew.at_wrap(10.0f);
+        const u32 used = budget_test_live(MemCategory::kCorkscrew) - before;
+        CHECK(used == MemoryPlan().corkscrew(input).total());
+    }
+
+    // FrameExchange slots.
+    {
+        static BudgetTestController controller;
+        static CRGB leds[50];
+        controller.setLeds(leds, 50);
+        const u32 before = budget_test_live(MemCategory::kLeds);
+        FrameExchange exchange;
+        exchange.add(&controller);
+        CHECK(budget_test_live(MemCategory::kLeds) - before ==
+              MemoryPlan().frameExchange(50).total());
+        CHECK(MemoryBudget::controllerLedBytes() >= 50 * sizeof(CRGB));
+    }
+
+    // FFT kernels stay under the planned upper bound.
+    {
+        const u32 before = budget_test_live(MemCategory::kAudio);
+        const FFT_Args args(256, 12);
+        FFT fft;
+        fft.warmup(args);
+        const u32 used = budget_test_live(MemCategory::kAudio) - before;
+        CHECK(used > 0);
+        CHECK(used <= MemoryPlan().fft(args).total());
+    }
+}
+
+TEST_CASE("MemoryPlan sums categories and reports") {
+    MemoryPlan plan;
+    plan.leds(100).fxEngine(100).frames(100, 4).drawBuffer(2, 100, true);
+    CHECK(plan.bytes(MemCategory::kLeds) == 300);
+    CHECK(plan.bytes(MemCategory::kFxLayer) == 600);
+    CHECK(plan.bytes(MemCategory::kFrame) == 1200);
+    CHECK(plan.bytes(MemCategory::kDrawBuffer) == 800);
+    CHECK(plan.total() == 2900);
+    CHECK(plan.fits(2900));
+    CHECK_FALSE(plan.fits(2899));
+
+    const fl::string json = plan.toJsonString();
+    CHECK(json.find("\"fx_layer\":600") != fl::string::npos);
+    const fl::string report = MemoryBudget::toJsonString();
+    CHECK(report.find("\"categories\"") != fl::string::npos);
+    CHECK(report.find("\"corkscrew\"") != fl::string::npos);
+    CHECK(fl::string(toString(MemCategory::kDrawBuffer)) == "draw_buffer");
+}
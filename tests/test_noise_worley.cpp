@@ -0,0 +1,152 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/noise_woryley.h"
+#include "fl/vector.h"
+#include "fx/2d/worley.h"
+
+using namespace fl;
+
+namespace {
+
+void check_field_matches(const WorleyFieldParams &p, u16 w, u16 h) {
+    WorleyField field;
+    fl::vector<i32> out(w * h);
+    fl::vector<u8> out8(w * h);
+    field.fill(p, w, h, out.data());
+    field.fill8(p, w, h, out8.data());
+    for (u16 row = 0; row < h; ++row) {
+        for (u16 col = 0; col < w; ++col) {
+            const i32 x = p.x + col * p.step_x;
+            const i32 y = p.y + row * p.step_y;
+            const i32 expected = worley_noise_2d_q15(x, y, p.mode, p.time);
+            REQUIRE(out[row * w + col] == expected);
+            REQUIRE(out8[row * w + col] == u8(expected >> 7));
+            REQUIRE(expected >= 0);
+            REQUIRE(expected < 32768);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("worley point function") {
+    // The mode/time overload at time 0 is the original F1 field.
+    for (i32 i = 0; i < 200; ++i) {
+        const i32 x = i * 4099 - 300000;
+        const i32 y = i * 7919 + 12345;
+        CHECK(worley_noise_2d_q15(x, y) ==
+              worley_noise_2d_q15(x, y, WORLEY_F1, 0));
+        const i32 f1 = worley_noise_2d_q15(x, y, WORLEY_F1, 0);
+        const i32 f2 = worley_noise_2d_q15(x, y, WORLEY_F2, 0);
+        CHECK(f1 <= f2);
+        CHECK(worley_noise_2d_q15(x, y, WORLEY_F2_MINUS_F1, 0) <= f2);
+    }
+    // Sitting on a feature point gives F1 == 0.
+    bool found_zero = false;
+    for (i32 x = 0; x < 32768 && !found_zero; x += 128) {
+        for (i32 y = 0; y < 32768 && !found_zero; y += 128) {
+            found_zero = worley_noise_2d_q15(x, y) == 0;
+        }
+    }
+    CHECK(found_zero);
+}
+
+TEST_CASE("worley field matches the point function") {
+    WorleyFieldParams p;
+    SUBCASE("F1") { check_field_matches(p, 37, 23); }
+    SUBCASE("F2, negative origin") {
+        p.mode = WORLEY_F2;
+        p.x = -5 * 32768 + 77;
+        p.y = -3 * 32768 - 1000;
+        check_field_matches(p, 40, 40);
+    }
+    SUBCASE("F2 - F1, animated, uneven steps") {
+        p.mode = WORLEY_F2_MINUS_F1;
+        p.time = 123456;
+        p.step_x = 1500;
+        p.step_y = 9000;
+        check_field_matches(p, 64, 16);
+    }
+    SUBCASE("negative time and step") {
+        p.time = -70000;
+        p.step_x = -2000;
+        p.step_y = -700;
+        check_field_matches(p, 16, 64);
+    }
+    SUBCASE("single sample") { check_field_matches(p, 1, 1); }
+}
+
+TEST_CASE("worley time offset animates smoothly") {
+    WorleyField field;
+    WorleyFieldParams p;
+    fl::vector<i32> a(32 * 32);
+    fl::vector<i32> b(32 * 32);
+    p.time = 1000;
+    field.fill(p, 32, 32, a.data());
+    p.time = 1100;
+    field.fill(p, 32, 32, b.data());
+    bool changed = false;
+    for (fl::size i = 0; i < a.size(); ++i) {
+        const i32 d = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        // 100 time units move a feature point by at most 50 per axis.
+        CHECK(d <= 100);
+        changed = changed || d != 0;
+    }
+    CHECK(changed);
+}
+
+TEST_CASE("worley field throughput") {
+    const u16 kW = 128;
+    const u16 kH = 128;
+    const int kFrames = 50;
+    WorleyField field;
+    WorleyFieldParams p;
+    fl::vector<u8> out(kW * kH);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        p.time = frame * 300;
+        field.fill8(p, kW, kH, out.data());
+    }
+    double bulk = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    u32 sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (u16 y = 0; y < kH; ++y) {
+            for (u16 x = 0; x < kW; ++x) {
+                sum += u32(worley_noise_2d_q15(x * p.step_x, y * p.step_y,
+                                               WORLEY_F1, frame * 300));
+            }
+        }
+    }
+    double point = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    CHECK(sum > 0);
+    MESSAGE("worley " << kW << "x" << kH << ": field " << bulk * 1e3 / kFrames
+                      << " ms/frame, per point " << point * 1e3 / kFrames
+                      << " ms/frame");
+}
+
+TEST_CASE("WorleyPalette draws every led") {
+    XYMap xy = XYMap::constructRectangularGrid(16, 8);
+    WorleyPalette fx(xy, RainbowColors_p);
+    fx.setCellSize(4);
+    fx.setMode(WORLEY_F2_MINUS_F1);
+    fl::vector<CRGB> leds(16 * 8, CRGB(1, 2, 3));
+    Fx::DrawContext ctx(1000, leds.data());
+    fx.draw(ctx);
+    bool varied = false;
+    for (const CRGB &c : leds) {
+        CHECK(c != CRGB(1, 2, 3));
+        varied = varied || c != leds[0];
+    }
+    CHECK(varied);
+    CHECK(fx.fxName() == "WorleyPalette");
+}
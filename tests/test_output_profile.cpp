@@ -0,0 +1,138 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "cpixel_ledcontroller.h"
+#include "fl/vector.h"
+#include "pixel_controller.h"
+
+using namespace fl;
+
+namespace {
+
+// Keeps what show() handed to showPixels().
+class ProfileTestController : public CPixelLEDController<RGB> {
+  public:
+    void init() override {}
+    void showPixels(PixelController<RGB> &pixels) override {
+        premixed = pixels.mColorAdjustment.premixed;
+        for (int i = 0; i < 3; ++i) {
+            e[i] = pixels.e[i];
+        }
+        ++shows;
+    }
+    CRGB premixed;
+    u8 e[3] = {0, 0, 0};
+    int shows = 0;
+};
+
+// What show() used to set up on every call.
+ColorAdjustment profile_test_adjustment(CLEDController &c, u8 brightness) {
+#if FASTLED_HD_COLOR_MIXING
+    ColorAdjustment out = {c.getAdjustment(brightness), c.getAdjustment(255),
+                           brightness};
+#else
+    ColorAdjustment out = {c.getAdjustment(brightness)};
+#endif
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("OutputProfile follows the controller settings") {
+    ProfileTestController controller;
+    CRGB leds[4];
+    const OutputProfile *first = &controller.getOutputProfile(200);
+    CHECK(first->adjustment.premixed == CRGB(200, 200, 200));
+    CHECK(first->dither == BINARY_DITHER);
+    CHECK(&controller.getOutputProfile(200) == first);
+
+    controller.setCorrection(TypicalLEDStrip);
+    CHECK(controller.getOutputProfile(200).adjustment.premixed ==
+          profile_test_adjustment(controller, 200).premixed);
+    controller.setTemperature(Candle);
+    CHECK(controller.getOutputProfile(200).adjustment.premixed ==
+          profile_test_adjustment(controller, 200).premixed);
+    CHECK(controller.getOutputProfile(90).adjustment.premixed ==
+          profile_test_adjustment(controller, 90).premixed);
+    controller.setDither(DISABLE_DITHER);
+    CHECK(controller.getOutputProfile(90).dither == DISABLE_DITHER);
+
+    // show() hands the cached profile to the pixels.
+    controller.setDither(BINARY_DITHER);
+    controller.showInternal(leds, 4, 77);
+    CHECK(controller.shows == 1);
+    CHECK(controller.premixed == profile_test_adjustment(controller, 77).premixed);
+    PixelControllerCore core;
+    core.mColorAdjustment = profile_test_adjustment(controller, 77);
+    core.initBinaryDithering(1);
+    for (int i = 0; i < 3; ++i) {
+        CHECK(controller.e[i] == core.e[i]);
+    }
+}
+
+TEST_CASE("Cached dither steps match the per show setup") {
+    PixelControllerCore a;
+    PixelControllerCore b;
+    for (int s = 0; s < 256; s += 3) {
+        a.mColorAdjustment.premixed = CRGB(u8(s), u8(255 - s), u8(s / 2));
+        b.mColorAdjustment = a.mColorAdjustment;
+        u8 steps[3];
+        PixelControllerCore::ditherSteps(b.mColorAdjustment.premixed, steps);
+        for (int r = 0; r < 8; ++r) {
+            a.initBinaryDithering(u8(r));
+            b.initBinaryDithering(u8(r), steps);
+            for (int i = 0; i < 3; ++i) {
+                REQUIRE(a.d[i] == b.d[i]);
+                REQUIRE(a.e[i] == b.e[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("OutputProfile setup cost for many small controllers") {
+    const int kControllers = 32;
+    const int kLeds = 16;
+    const int kFrames = 2000;
+    fl::vector<ProfileTestController> controllers(kControllers);
+    CRGB leds[kLeds];
+    for (int i = 0; i < kControllers; ++i) {
+        controllers[i].setCorrection(TypicalLEDStrip).setTemperature(Tungsten100W);
+    }
+    u32 sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        for (int i = 0; i < kControllers; ++i) {
+            ColorAdjustment adjustment =
+                profile_test_adjustment(controllers[i], 128);
+            PixelController<RGB> pixels(leds, kLeds, adjustment,
+                                        controllers[i].getDither());
+            sink += pixels.e[0];
+        }
+    }
+    const double perShow = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        for (int i = 0; i < kControllers; ++i) {
+            PixelController<RGB> pixels(leds, kLeds,
+                                        controllers[i].getOutputProfile(128));
+            sink += pixels.e[0];
+        }
+    }
+    const double cached = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    CHECK(sink != 1);
+    MESSAGE("us per frame of setup for " << kControllers
+                                         << " controllers: per show "
+                                         << perShow * 1e6 / kFrames
+                                         << ", cached profile "
+                                         << cached * 1e6 / kFrames);
+}
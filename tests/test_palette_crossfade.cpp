@@ -0,0 +1,122 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/palette_crossfade.h"
+
+using namespace fl;
+
+TEST_CASE("PaletteCrossfade ends on the target and starts on the source") {
+    PaletteCrossfade fade(OceanColors_p);
+    CRGBPalette256 ocean(OceanColors_p);
+    CRGBPalette256 lava(LavaColors_p);
+    CHECK(fade.palette() == ocean);
+    CHECK_FALSE(fade.update(0));
+
+    fade.fadeTo(LavaColors_p, 1000, 5000);
+    CHECK(fade.isFading());
+    CHECK(fade.update(5000));
+    CHECK(fade.palette() == ocean);
+
+    CHECK(fade.update(5500));
+    CHECK(fade.amount() == 128);
+    for (int i = 0; i < 256; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            int mid = (int(ocean[i].raw[c]) + int(lava[i].raw[c])) / 2;
+            CHECK(ABS(int(fade[u8(i)].raw[c]) - mid) <= 1);
+        }
+    }
+
+    CHECK_FALSE(fade.update(6000));
+    CHECK(fade.palette() == lava);
+    CHECK_FALSE(fade.isFading());
+}
+
+TEST_CASE("PaletteCrossfade retargets from the blended colors") {
+    PaletteCrossfade fade(CRGBPalette16(CRGB::Black));
+    fade.fadeTo(CRGBPalette16(CRGB(200, 100, 0)), 100, 0);
+    fade.update(50);
+    const CRGB halfway = fade[0];
+    CHECK(halfway == CRGB(100, 50, 0));
+    // New target in the middle of the fade, no jump.
+    fade.fadeTo(CRGBPalette16(CRGB(0, 0, 200)), 100, 50);
+    fade.update(50);
+    CHECK(fade[0] == halfway);
+    fade.update(150);
+    CHECK(fade[0] == CRGB(0, 0, 200));
+
+    fade.fadeTo(CRGBPalette16(CRGB::White), 0, 200);
+    CHECK_FALSE(fade.update(200));
+    CHECK(fade[77] == CRGB(255, 255, 255));
+
+    fade.setAmount(0);
+    CHECK(fade[77] == CRGB(0, 0, 200));
+}
+
+TEST_CASE("PaletteCrossfade setAmount without a fade") {
+    CRGBPalette256 red;
+    fill_solid(red.entries, 256, CRGB(200, 0, 0));
+
+    // Before any fadeTo() the palette stays what it was.
+    PaletteCrossfade fade(red);
+    fade.setAmount(0);
+    CHECK(fade[10] == CRGB(200, 0, 0));
+    fade.setAmount(128);
+    CHECK(fade[10] == CRGB(200, 0, 0));
+    PaletteCrossfade black;
+    black.setAmount(100);
+    CHECK(black[255] == CRGB(0, 0, 0));
+
+    // setPalette() after a fade replaces both ends.
+    CRGBPalette256 blue;
+    fill_solid(blue.entries, 256, CRGB(0, 0, 200));
+    fade.fadeTo(blue, 100, 0);
+    fade.update(50);
+    fade.setPalette(OceanColors_p);
+    CRGBPalette256 ocean;
+    UpscalePalette(CRGBPalette16(OceanColors_p), ocean);
+    fade.setAmount(256);
+    CHECK(fade[42] == ocean.entries[42]);
+    fade.setAmount(0);
+    CHECK(fade[200] == ocean.entries[200]);
+}
+
+TEST_CASE("PaletteCrossfade against nblendPaletteTowardPalette benchmark") {
+    const int kLeds = 1024;
+    const int kFrames = 200;
+    CRGB leds[kLeds];
+    auto start = std::chrono::steady_clock::now();
+    CRGBPalette16 current(OceanColors_p);
+    CRGBPalette16 target(LavaColors_p);
+    for (int f = 0; f < kFrames; ++f) {
+        nblendPaletteTowardPalette(current, target, 12);
+        for (int i = 0; i < kLeds; ++i) {
+            leds[i] = ColorFromPalette(current, u8(i * 7 + f));
+        }
+    }
+    double nblend = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+    start = std::chrono::steady_clock::now();
+    PaletteCrossfade fade(OceanColors_p);
+    fade.fadeTo(LavaColors_p, kFrames, 0);
+    for (int f = 0; f < kFrames; ++f) {
+        fade.update(f);
+        for (int i = 0; i < kLeds; ++i) {
+            leds[i] = fade[u8(i * 7 + f)];
+        }
+    }
+    double crossfade = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    CHECK(leds[0] != CRGB(1, 2, 3)); // Keep the loops alive.
+    MESSAGE("us/frame for " << kLeds << " leds: nblend+ColorFromPalette "
+                            << nblend * 1e6 / kFrames << ", PaletteCrossfade "
+                            << crossfade * 1e6 / kFrames << "; RAM "
+                            << 2 * sizeof(CRGBPalette16) << " vs "
+                            << sizeof(PaletteCrossfade) << " bytes");
+}
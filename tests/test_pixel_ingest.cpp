@@ -0,0 +1,280 @@
+// Compile with: g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define HAS_UDP_LOOPBACK 1
+#else
+#define HAS_UDP_LOOPBACK 0
+#endif
+
+#include "fl/pixel_ingest.h"
+
+using namespace fl;
+
+namespace {
+
+void fill_pattern(CRGB *leds, int n, u8 seed) {
+    for (int i = 0; i < n; ++i) {
+        leds[i] = CRGB(u8(i + seed), u8(i * 3 + seed), u8(255 - i));
+    }
+}
+
+} // namespace
+
+TEST_CASE("PixelIngest decodes what the encoders produce") {
+    u8 data[6] = {1, 2, 3, 4, 5, 6};
+    u8 buf[700];
+    IngestPacket packet;
+
+    SUBCASE("DDP") {
+        fl::size n = encodeDDP(buf, sizeof(buf), 300, data, 6, 5, true);
+        REQUIRE(n == 16);
+        REQUIRE(decodeIngestPacket(buf, n, &packet));
+        CHECK(packet.protocol == IngestProtocol::kDDP);
+        CHECK(packet.offset == 300);
+        CHECK(packet.length == 6);
+        CHECK(packet.sequence == 5);
+        CHECK(packet.sync);
+        CHECK(packet.data[5] == 6);
+    }
+
+    SUBCASE("E1.31 data and sync") {
+        fl::size n = encodeE131(buf, sizeof(buf), 7, data, 6, 42, 99);
+        REQUIRE(n == 132);
+        REQUIRE(decodeIngestPacket(buf, n, &packet));
+        CHECK(packet.protocol == IngestProtocol::kE131);
+        CHECK(packet.universe == 7);
+        CHECK(packet.sequence == 42);
+        CHECK(packet.syncAddress == 99);
+        CHECK(packet.hasData);
+        CHECK_FALSE(packet.sync);
+        CHECK(packet.data[0] == 1);
+
+        n = encodeE131Sync(buf, sizeof(buf), 99, 3);
+        REQUIRE(decodeIngestPacket(buf, n, &packet));
+        CHECK(packet.sync);
+        CHECK_FALSE(packet.hasData);
+        CHECK(packet.syncAddress == 99);
+    }
+
+    SUBCASE("Art-Net dmx pads odd lengths, sync") {
+        fl::size n = encodeArtNet(buf, sizeof(buf), 0x1234, data, 5, 9);
+        REQUIRE(n == 18 + 6);
+        REQUIRE(decodeIngestPacket(buf, n, &packet));
+        CHECK(packet.protocol == IngestProtocol::kArtNet);
+        CHECK(packet.universe == 0x1234);
+        CHECK(packet.length == 6);
+        CHECK(packet.data[5] == 0);
+
+        n = encodeArtSync(buf, sizeof(buf));
+        REQUIRE(decodeIngestPacket(buf, n, &packet));
+        CHECK(packet.sync);
+    }
+
+    SUBCASE("Truncated packets are rejected") {
+        fl::size n = encodeE131(buf, sizeof(buf), 1, data, 6, 0);
+        CHECK_FALSE(decodeE131(buf, n - 1, &packet));
+        n = encodeArtNet(buf, sizeof(buf), 1, data, 6, 0);
+        CHECK_FALSE(decodeArtNet(buf, n - 1, &packet));
+        n = encodeDDP(buf, sizeof(buf), 0, data, 6, 0, false);
+        CHECK_FALSE(decodeDDP(buf, n - 1, &packet));
+        CHECK(encodeDDP(buf, 4, 0, data, 6, 0, false) == 0);
+    }
+}
+
+TEST_CASE("PixelIngest writes universes into led buffers") {
+    const int kNum = 200; // 170 pixels in universe 1, 30 in universe 2.
+    CRGB src[kNum];
+    CRGB dst[kNum];
+    fill_pattern(src, kNum, 11);
+    PixelIngest ingest;
+    CHECK(ingest.mapLeds(1, dst, kNum) == 3);
+    CHECK(ingest.numSegments() == 2);
+    int frames = 0;
+    ingest.onFrame([&frames]() { frames++; });
+
+    const u8 *bytes = reinterpret_cast<const u8 *>(src);
+    u8 buf[700];
+    fl::size n = encodeE131(buf, sizeof(buf), 1, bytes, 510, 0);
+    CHECK(ingest.ingest(buf, n));
+    CHECK(frames == 0); // Universe 2 still missing.
+    n = encodeE131(buf, sizeof(buf), 2, bytes + 510, 90, 0);
+    CHECK(ingest.ingest(buf, n));
+    CHECK(frames == 1);
+    for (int i = 0; i < kNum; ++i) {
+        REQUIRE(dst[i] == src[i]);
+    }
+    CHECK(ingest.stats().pixels == kNum);
+
+    SUBCASE("Stale sequence numbers are dropped") {
+        fill_pattern(src, kNum, 77);
+        n = encodeE131(buf, sizeof(buf), 1, bytes, 510, 0);
+        ingest.ingest(buf, n);
+        CHECK(ingest.stats().dropped == 1);
+        CHECK(dst[0] != src[0]);
+        // Sequence wrap around is not stale.
+        n = encodeE131(buf, sizeof(buf), 1, bytes, 510, 1);
+        ingest.ingest(buf, n);
+        CHECK(dst[0] == src[0]);
+    }
+
+    SUBCASE("Unmapped universes are counted") {
+        n = encodeArtNet(buf, sizeof(buf), 9, bytes, 30, 0);
+        ingest.ingest(buf, n);
+        CHECK(ingest.stats().unmapped == 1);
+    }
+}
+
+TEST_CASE("PixelIngest sync packets gate the frame") {
+    const int kNum = 340;
+    CRGB src[kNum];
+    CRGB dst[kNum];
+    fill_pattern(src, kNum, 3);
+    const u8 *bytes = reinterpret_cast<const u8 *>(src);
+    PixelIngest ingest;
+    ingest.mapLeds(0, dst, kNum);
+    int frames = 0;
+    ingest.onFrame([&frames]() { frames++; });
+    u8 buf[700];
+
+    SUBCASE("ArtSync") {
+        fl::size n = encodeArtSync(buf, sizeof(buf));
+        ingest.ingest(buf, n);
+        CHECK(ingest.syncMode());
+        CHECK(frames == 0); // Nothing written yet.
+        for (u16 u = 0; u < 2; ++u) {
+            n = encodeArtNet(buf, sizeof(buf), u, bytes + u * 510, 510, 1);
+            ingest.ingest(buf, n);
+        }
+        CHECK(frames == 0);
+        n = encodeArtSync(buf, sizeof(buf));
+        ingest.ingest(buf, n);
+        CHECK(frames == 1);
+        CHECK(dst[kNum - 1] == src[kNum - 1]);
+    }
+
+    SUBCASE("E1.31 synchronization address") {
+        for (u16 u = 0; u < 2; ++u) {
+            fl::size n = encodeE131(buf, sizeof(buf), u, bytes + u * 510, 510,
+                                    0, 4000);
+            ingest.ingest(buf, n);
+        }
+        CHECK(frames == 0);
+        fl::size n = encodeE131Sync(buf, sizeof(buf), 4000, 0);
+        ingest.ingest(buf, n);
+        CHECK(frames == 1);
+        // A replayed sync packet is stale.
+        ingest.ingest(buf, n);
+        CHECK(ingest.stats().dropped == 1);
+    }
+
+    SUBCASE("DDP push across segments") {
+        // One packet spanning both universes of the linear space.
+        fl::size n = encodeDDP(buf, sizeof(buf), 0, bytes, 600, 1, false);
+        ingest.ingest(buf, n);
+        n = encodeDDP(buf, sizeof(buf), 600, bytes + 600, 420, 2, true);
+        ingest.ingest(buf, n);
+        CHECK(frames == 1);
+        for (int i = 0; i < kNum; ++i) {
+            REQUIRE(dst[i] == src[i]);
+        }
+        // Duplicate sequence number is dropped.
+        ingest.ingest(buf, n);
+        CHECK(ingest.stats().dropped == 1);
+        CHECK(frames == 1);
+    }
+}
+
+#if HAS_UDP_LOOPBACK
+TEST_CASE("PixelIngest over udp loopback") {
+    int rx = socket(AF_INET, SOCK_DGRAM, 0);
+    int tx = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0; // Let the os pick a free port.
+    socklen_t addr_len = sizeof(addr);
+    if (rx < 0 || tx < 0 ||
+        bind(rx, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        getsockname(rx, reinterpret_cast<sockaddr *>(&addr), &addr_len) != 0) {
+        MESSAGE("udp loopback not available, skipping");
+        if (rx >= 0) close(rx);
+        if (tx >= 0) close(tx);
+        return;
+    }
+    timeval timeout = {1, 0};
+    setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const int kNum = 170;
+    CRGB src[kNum];
+    CRGB dst[kNum];
+    fill_pattern(src, kNum, 21);
+    PixelIngest ingest;
+    ingest.mapLeds(1, dst, kNum);
+    int frames = 0;
+    ingest.onFrame([&frames]() { frames++; });
+
+    u8 packet[700];
+    fl::size n = encodeArtNet(packet, sizeof(packet), 1,
+                              reinterpret_cast<const u8 *>(src), 510, 1);
+    sendto(tx, packet, n, 0, reinterpret_cast<sockaddr *>(&addr),
+           sizeof(addr));
+    u8 datagram[1500];
+    ssize_t got = recv(rx, datagram, sizeof(datagram), 0);
+    close(rx);
+    close(tx);
+    REQUIRE(got == ssize_t(n));
+    CHECK(ingest.ingest(datagram, fl::size(got)));
+    CHECK(frames == 1);
+    for (int i = 0; i < kNum; ++i) {
+        REQUIRE(dst[i] == src[i]);
+    }
+}
+#endif
+
+TEST_CASE("PixelIngest throughput") {
+    const int kUniverses = 32;
+    const int kNum = 170 * kUniverses;
+    fl::vector<CRGB> src(kNum);
+    fl::vector<CRGB> dst(kNum);
+    fill_pattern(src.data(), kNum, 1);
+    const u8 *bytes = reinterpret_cast<const u8 *>(src.data());
+    fl::vector<fl::vector<u8>> packets;
+    for (int u = 0; u < kUniverses; ++u) {
+        fl::vector<u8> packet(700);
+        fl::size n = encodeE131(packet.data(), packet.size(), u16(u),
+                                bytes + u * 510, 510, 0);
+        packet.resize(n);
+        packets.push_back(packet);
+    }
+    PixelIngest ingest;
+    ingest.mapLeds(0, dst.data(), kNum);
+    const int kFrames = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (int u = 0; u < kUniverses; ++u) {
+            // Bump the sequence so no packet is considered stale.
+            packets[u][111] = u8(frame);
+            ingest.ingest(packets[u].data(), packets[u].size());
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    CHECK(ingest.stats().frames == kFrames);
+    CHECK(ingest.stats().dropped == 0);
+    CHECK(dst[kNum - 1] == src[kNum - 1]);
+    if (seconds > 0) {
+        MESSAGE("E1.31 ingest: " << (kFrames * kUniverses) / seconds
+                                 << " packets/s, "
+                                 << ingest.stats().pixels / seconds
+                                 << " pixels/s");
+    }
+}
@@ -0,0 +1,114 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "FastLED.h"
+#include "pixel_controller.h"
+#include "pixel_iterator.h"
+
+using namespace fl;
+
+namespace {
+
+const int kNumLeds = 8;
+
+void fill_pattern(CRGB *leds) {
+    for (int i = 0; i < kNumLeds; ++i) {
+        leds[i] = CRGB(u8(i * 31 + 1), u8(200 - i * 17), u8(i * 7));
+    }
+}
+
+ColorAdjustment make_adjustment() {
+    ColorAdjustment adj;
+    adj.premixed = CRGB(200, 150, 100);
+#if FASTLED_HD_COLOR_MIXING
+    adj.color = CRGB(255, 200, 128);
+    adj.brightness = 180;
+#endif
+    return adj;
+}
+
+// Walks a copy of pc with the templated accessors and another copy through
+// the runtime order iterator, both must produce the same bytes.
+template <EOrder ORDER> void check_order_matches() {
+    CRGB leds[kNumLeds];
+    fill_pattern(leds);
+    PixelController<ORDER> pc(leds, kNumLeds, make_adjustment(), BINARY_DITHER);
+    PixelController<ORDER> expected = pc;
+    PixelController<ORDER> actual = pc;
+    PixelIterator it = actual.as_iterator(RgbwInvalid());
+    CHECK(it.size() == kNumLeds);
+    while (expected.has(1)) {
+        REQUIRE(it.has(1));
+        u8 e[3], a[3];
+        expected.loadAndScaleRGB(&e[0], &e[1], &e[2]);
+        it.loadAndScaleRGB(&a[0], &a[1], &a[2]);
+        CHECK(e[0] == a[0]);
+        CHECK(e[1] == a[1]);
+        CHECK(e[2] == a[2]);
+
+        u16 e16[3], a16[3];
+        expected.loadAndScale_WS2816_HD(&e16[0], &e16[1], &e16[2]);
+        it.loadAndScale_WS2816_HD(&a16[0], &a16[1], &a16[2]);
+        CHECK(e16[0] == a16[0]);
+        CHECK(e16[1] == a16[1]);
+        CHECK(e16[2] == a16[2]);
+
+        expected.advanceData();
+        expected.stepDithering();
+        it.advanceData();
+        it.stepDithering();
+    }
+    CHECK_FALSE(it.has(1));
+
+    // The bulk path gives the same stream as the per pixel calls.
+    PixelController<ORDER> bulk = pc;
+    PixelController<ORDER> single = pc;
+    u8 bulk_out[kNumLeds * 3] = {};
+    CHECK(bulk.as_iterator(RgbwInvalid()).writeAll(bulk_out) == kNumLeds * 3);
+    for (int i = 0; i < kNumLeds; ++i) {
+        u8 e[3];
+        single.loadAndScaleRGB(&e[0], &e[1], &e[2]);
+        CHECK(bulk_out[i * 3 + 0] == e[0]);
+        CHECK(bulk_out[i * 3 + 1] == e[1]);
+        CHECK(bulk_out[i * 3 + 2] == e[2]);
+        single.advanceData();
+        single.stepDithering();
+    }
+}
+
+} // namespace
+
+TEST_CASE("PixelIterator matches PixelController for every color order") {
+    check_order_matches<RGB>();
+    check_order_matches<RBG>();
+    check_order_matches<GRB>();
+    check_order_matches<GBR>();
+    check_order_matches<BRG>();
+    check_order_matches<BGR>();
+}
+
+TEST_CASE("PixelIterator RGBW matches PixelController") {
+    CRGB leds[kNumLeds];
+    fill_pattern(leds);
+    Rgbw rgbw(kRGBWDefaultColorTemp, kRGBWExactColors, W0);
+    PixelController<GRB> pc(leds, kNumLeds, make_adjustment(), DISABLE_DITHER);
+    PixelController<GRB> expected = pc;
+    PixelController<GRB> actual = pc;
+    PixelIterator it = actual.as_iterator(rgbw);
+    CHECK(it.get_rgbw().active());
+    u8 bulk_out[kNumLeds * 4] = {};
+    PixelController<GRB> bulk = pc;
+    CHECK(bulk.as_iterator(rgbw).writeAll(bulk_out) == kNumLeds * 4);
+    for (int i = 0; i < kNumLeds; ++i) {
+        u8 e[4], a[4];
+        expected.loadAndScaleRGBW(rgbw, &e[0], &e[1], &e[2], &e[3]);
+        it.loadAndScaleRGBW(&a[0], &a[1], &a[2], &a[3]);
+        for (int j = 0; j < 4; ++j) {
+            CHECK(e[j] == a[j]);
+            CHECK(bulk_out[i * 4 + j] == e[j]);
+        }
+        expected.advanceData();
+        it.advanceData();
+    }
+}
@@ -0,0 +1,126 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/pixel_pipeline.h"
+#include "fl/vector.h"
+
+using namespace fl;
+
+namespace {
+
+void pipeline_test_fill(CRGB *leds, int n, u32 seed) {
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        leds[i] = CRGB(u8(seed >> 8), u8(seed >> 16), u8(seed >> 24));
+    }
+}
+
+// The sequence of calls a sketch makes today.
+void pipeline_test_reference(CRGB *leds, int n, const CRGB *overlay,
+                             u16 time) {
+    fill_noise16(leds, n, 2, 1000, 60, 1, 500, 30, time, 7);
+    nblend(leds, overlay, u16(n), 100);
+    fadeToBlackBy(leds, u16(n), 30);
+    napplyGamma_video(leds, u16(n), 2.2f);
+    blur1d(leds, u16(n), 64);
+}
+
+void pipeline_test_fused(CRGB *leds, int n, const CRGB *overlay, u16 time) {
+    pipe(leds, n)
+        .noise16(2, 1000, 60, 1, 500, 30, time, 7)
+        .blend(overlay, 100)
+        .fade(30)
+        .gamma(2.2f)
+        .blur1d(64);
+}
+
+} // namespace
+
+TEST_CASE("Pixel pipeline matches the separate calls") {
+    // Over 255 leds, so the noise restart at every 255 leds is covered.
+    const int n = 300;
+    fl::vector<CRGB> expected(n);
+    fl::vector<CRGB> actual(n);
+    fl::vector<CRGB> overlay(n);
+    pipeline_test_fill(overlay.data(), n, 5);
+    for (u16 time : {u16(0), u16(1234), u16(60000)}) {
+        pipeline_test_reference(expected.data(), n, overlay.data(), time);
+        pipeline_test_fused(actual.data(), n, overlay.data(), time);
+        for (int i = 0; i < n; ++i) {
+            REQUIRE(expected[i] == actual[i]);
+        }
+    }
+
+    // Stages after a boundary run on the blurred pixels.
+    pipeline_test_fill(expected.data(), n, 9);
+    actual = expected;
+    blur1d(expected.data(), n, 80);
+    nscale8(expected.data(), n, 200);
+    pipe(actual.data(), n).blur1d(80).nscale8(200).run();
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(expected[i] == actual[i]);
+    }
+}
+
+TEST_CASE("Pixel pipeline runs nothing until asked") {
+    CRGB leds[4] = {CRGB(10, 20, 30), CRGB(40, 50, 60), CRGB(70, 80, 90),
+                    CRGB(1, 2, 3)};
+    auto pending = pipe(leds).fade(255);
+    CHECK(leds[0] == CRGB(10, 20, 30));
+    pending.run();
+    CHECK(leds[0] == CRGB(0, 0, 0));
+
+    // map() stages see the index, pass() sees the whole buffer.
+    int passes = 0;
+    pipe(leds)
+        .map([](CRGB &c, fl::size i) { c = CRGB(u8(i), 0, 0); })
+        .pass([&](CRGB *p, fl::size n) {
+            ++passes;
+            CHECK(n == 4);
+            CHECK(p[3] == CRGB(3, 0, 0));
+        })
+        .map([](CRGB &c, fl::size) { c.g = c.r; })
+        .run();
+    CHECK(passes == 1);
+    CHECK(leds[2] == CRGB(2, 2, 0));
+}
+
+TEST_CASE("Pixel pipeline shares the gamma table between stages") {
+    CRGB leds[4];
+    auto chain = pipe(leds).gamma(2.2f).fade(10).gamma(1.8f).fade(20);
+    // Each then() copies the chain, the tables must not come along.
+    CHECK(sizeof(chain) < 2 * 256);
+}
+
+TEST_CASE("Pixel pipeline benchmark against separate calls") {
+    const int n = 1024;
+    const int kFrames = 100;
+    fl::vector<CRGB> leds(n);
+    fl::vector<CRGB> overlay(n);
+    pipeline_test_fill(overlay.data(), n, 11);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        pipeline_test_reference(leds.data(), n, overlay.data(), u16(f * 10));
+    }
+    const double separate = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+    const CRGB last = leds[n - 1];
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        pipeline_test_fused(leds.data(), n, overlay.data(), u16(f * 10));
+    }
+    const double fused = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    CHECK(leds[n - 1] == last);
+    MESSAGE("us/frame for " << n << " leds: separate calls "
+                            << separate * 1e6 / kFrames << ", pipeline "
+                            << fused * 1e6 / kFrames);
+}
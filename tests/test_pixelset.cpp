@@ -0,0 +1,234 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/math8_bulk.h"
+#include "fl/vector.h"
+#include "pixelset.h"
+
+using namespace fl;
+
+namespace {
+
+void pixelset_test_fill(CRGB *leds, int n, u32 seed) {
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        leds[i] = CRGB(u8(seed >> 8), u8(seed >> 16), u8(seed >> 24));
+    }
+}
+
+// What the iterator loops computed: pixel k of a set from start to end
+// (inclusive, either way round) is base[start + k * dir].
+int pixelset_test_index(int start, int end, int k) {
+    return start <= end ? start + k : start - k;
+}
+
+} // namespace
+
+TEST_CASE("math8 bulk kernels are bit exact") {
+    fl::vector<u8> a;
+    fl::vector<u8> b;
+    for (int i = 0; i < 256 * 3 + 7; ++i) {
+        a.push_back(u8(i * 7));
+        b.push_back(u8(i * 13 + 5));
+    }
+    for (u8 value : {u8(0), u8(1), u8(100), u8(255)}) {
+        fl::vector<u8> add = a, sub = a, hi = a, lo = a;
+        qadd8_bulk(add.data(), add.size(), value);
+        qsub8_bulk(sub.data(), sub.size(), value);
+        max8_bulk(hi.data(), hi.size(), value);
+        min8_bulk(lo.data(), lo.size(), value);
+        for (fl::size i = 0; i < a.size(); ++i) {
+            REQUIRE(add[i] == qadd8(a[i], value));
+            REQUIRE(sub[i] == qsub8(a[i], value));
+            REQUIRE(hi[i] == (a[i] > value ? a[i] : value));
+            REQUIRE(lo[i] == (a[i] < value ? a[i] : value));
+        }
+    }
+    fl::vector<u8> add = a, sub = a, hi = a, lo = a;
+    // Offset by one to exercise the unaligned head and the scalar tail.
+    qadd8_bulk(add.data() + 1, b.data() + 1, a.size() - 1);
+    qsub8_bulk(sub.data() + 1, b.data() + 1, a.size() - 1);
+    max8_bulk(hi.data() + 1, b.data() + 1, a.size() - 1);
+    min8_bulk(lo.data() + 1, b.data() + 1, a.size() - 1);
+    CHECK(add[0] == a[0]);
+    for (fl::size i = 1; i < a.size(); ++i) {
+        REQUIRE(add[i] == qadd8(a[i], b[i]));
+        REQUIRE(sub[i] == qsub8(a[i], b[i]));
+        REQUIRE(hi[i] == (a[i] > b[i] ? a[i] : b[i]));
+        REQUIRE(lo[i] == (a[i] < b[i] ? a[i] : b[i]));
+    }
+}
+
+TEST_CASE("CRGBSet ops on forward and reversed sets") {
+    const int n = 60;
+    CRGB source[n];
+    pixelset_test_fill(source, n, 3);
+    // start, end pairs; the reversed ones used to take the iterator loop.
+    const int ranges[][2] = {{0, 19}, {19, 0}, {5, 40}, {40, 5}};
+    for (const auto &range : ranges) {
+        const int start = range[0];
+        const int end = range[1];
+        const int count = (start < end ? end - start : start - end) + 1;
+        CRGB leds[n];
+        CRGB expected[n];
+        for (int i = 0; i < n; ++i) {
+            leds[i] = expected[i] = source[i];
+        }
+        CRGBSet set(leds, start, end);
+        for (int k = 0; k < count; ++k) {
+            CRGB &e = expected[pixelset_test_index(start, end, k)];
+            e.nscale8(200);
+            e.nscale8_video(100);
+            e.addToRGB(30);
+            e.subtractFromRGB(10);
+            e |= u8(40);
+            e &= u8(220);
+            e.nscale8(CRGB(255, 128, 64));
+            ++e;
+        }
+        set.nscale8(200).nscale8_video(100).addToRGB(30).subFromRGB(10);
+        set |= u8(40);
+        set &= u8(220);
+        CRGB scale(255, 128, 64);
+        set.nscale8(scale);
+        ++set;
+        for (int i = 0; i < n; ++i) {
+            REQUIRE(leds[i] == expected[i]);
+        }
+        CHECK(bool(set));
+        set = CRGB::Black;
+        CHECK_FALSE(bool(set));
+        CHECK(leds[start] == CRGB(0, 0, 0));
+    }
+}
+
+TEST_CASE("CRGBSet pairwise ops pair pixels in iteration order") {
+    const int n = 80;
+    CRGB a[n];
+    CRGB b[n];
+    pixelset_test_fill(a, n, 1);
+    pixelset_test_fill(b, n, 2);
+    // lhs start/end, rhs start/end: same way, opposite ways, different sizes.
+    const int cases[][4] = {
+        {0, 29, 10, 39}, {29, 0, 39, 10}, {0, 29, 39, 10}, {29, 0, 10, 39},
+        {0, 9, 30, 0},   {50, 40, 0, 30},
+    };
+    for (const auto &c : cases) {
+        CRGB lhs[n];
+        CRGB expected[n];
+        for (int i = 0; i < n; ++i) {
+            lhs[i] = expected[i] = a[i];
+        }
+        const int lhsCount = c[0] < c[1] ? c[1] - c[0] : c[0] - c[1];
+        const int rhsCount = c[2] < c[3] ? c[3] - c[2] : c[2] - c[3];
+        const int count = (lhsCount < rhsCount ? lhsCount : rhsCount) + 1;
+        for (int k = 0; k < count; ++k) {
+            CRGB &e = expected[pixelset_test_index(c[0], c[1], k)];
+            const CRGB &o = b[pixelset_test_index(c[2], c[3], k)];
+            e += o;
+            e -= CRGB(o.r / 4, o.g / 4, o.b / 4);
+            e |= o;
+            e &= CRGB(o.b, o.r, o.g);
+            nblend(e, o, 77);
+        }
+        CRGB quarter[n];
+        CRGB rotated[n];
+        for (int i = 0; i < n; ++i) {
+            quarter[i] = CRGB(b[i].r / 4, b[i].g / 4, b[i].b / 4);
+            rotated[i] = CRGB(b[i].b, b[i].r, b[i].g);
+        }
+        CRGBSet set(lhs, c[0], c[1]);
+        CRGBSet other(b, c[2], c[3]);
+        CRGBSet otherQuarter(quarter, c[2], c[3]);
+        CRGBSet otherRotated(rotated, c[2], c[3]);
+        set += other;
+        set -= otherQuarter;
+        set |= other;
+        set &= otherRotated;
+        set.nblend(other, 77);
+        for (int i = 0; i < n; ++i) {
+            REQUIRE(lhs[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("CRGBSet overlapping pairwise ops keep the iterator order") {
+    const int n = 20;
+    CRGB leds[n];
+    CRGB expected[n];
+    for (int i = 0; i < n; ++i) {
+        leds[i] = expected[i] = CRGB(u8(i), u8(i * 2), u8(i * 3));
+    }
+    // Mirror the first half onto the second half and then add the strip to
+    // its own reverse, both overlap their source.
+    CRGBSet all(leds, n);
+    for (int k = 0; k < 10; ++k) {
+        expected[10 + k] = expected[9 - k];
+    }
+    for (int k = 0; k < n; ++k) {
+        expected[k] += expected[n - 1 - k];
+    }
+    all(10, 19) = all(9, 0);
+    CRGBSet reversed = -all;
+    all += reversed;
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(leds[i] == expected[i]);
+    }
+    // Shift by one in place, each pixel takes the one before it.
+    for (int k = 0; k < 5; ++k) {
+        expected[1 + k] = expected[k];
+    }
+    all(1, 5) = all(0, 4);
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(leds[i] == expected[i]);
+    }
+}
+
+TEST_CASE("CRGBArray ops against hand written loops benchmark") {
+    const int kLeds = 1024;
+    const int kRuns = 500;
+    static CRGBArray<kLeds> leds;
+    static CRGBArray<kLeds> other;
+    pixelset_test_fill(leds.get(), kLeds, 9);
+    pixelset_test_fill(other.get(), kLeds, 10);
+    CRGB *raw = leds.get();
+    const CRGB *src = other.get();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+        for (int i = 0; i < kLeds; ++i) {
+            raw[i].fadeToBlackBy(1);
+        }
+        for (int i = 0; i < kLeds; ++i) {
+            raw[i] += src[i];
+        }
+        for (int i = 0; i < kLeds; ++i) {
+            raw[kLeds - 1 - i].nscale8(250);
+        }
+        for (int i = 0; i < kLeds / 2; ++i) {
+            raw[kLeds / 2 + i] |= raw[kLeds / 2 - 1 - i];
+        }
+    }
+    const double loops = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+        leds.fadeToBlackBy(1);
+        leds += other;
+        leds(kLeds - 1, 0).nscale8(250);
+        leds(kLeds / 2, kLeds - 1) |= leds(kLeds / 2 - 1, 0);
+    }
+    const double sets = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    CHECK(raw[0] != CRGB(1, 2, 3)); // Keep the loops alive.
+    MESSAGE("us per frame for " << kLeds << " leds: hand written loops "
+                                << loops * 1e6 / kRuns << ", CRGBArray ops "
+                                << sets * 1e6 / kRuns);
+}
@@ -0,0 +1,224 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/blur.h"
+#include "fl/planar_rgb.h"
+#include "fl/vector.h"
+#include "pixel_controller_core.h"
+#include "power_mgt.h"
+
+using namespace fl;
+
+namespace {
+
+void planar_test_fill(CRGB *leds, int n, u32 seed) {
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        leds[i] = CRGB(u8(seed >> 8), u8(seed >> 16), u8(seed >> 24));
+    }
+}
+
+bool planar_test_equal(const PlanarRGB &planes, const CRGB *leds, int n) {
+    if (int(planes.size()) != n) {
+        return false;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (planes.get(i) != leds[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double planar_test_seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+} // namespace
+
+TEST_CASE("PlanarRGB converts to and from CRGB") {
+    CRGB leds[37];
+    planar_test_fill(leds, 37, 1);
+    PlanarRGB planes;
+    planes.fromInterleaved(leds, 37);
+    CHECK(planar_test_equal(planes, leds, 37));
+    CHECK(planes.g() == planes.r() + 37);
+    CHECK(planes.plane(2) == planes.b());
+
+    CRGB back[37];
+    planes.toInterleaved(back);
+    for (int i = 0; i < 37; ++i) {
+        REQUIRE(back[i] == leds[i]);
+    }
+
+    // Growing keeps the pixels and adds black ones.
+    planes.resize(40);
+    CHECK(planes.get(36) == leds[36]);
+    CHECK(planes.get(39) == CRGB(0, 0, 0));
+    planes.resize(10);
+    CHECK(planar_test_equal(planes, leds, 10));
+}
+
+TEST_CASE("Planar kernels match the CRGB kernels") {
+    const int n = 101;
+    CRGB a[n];
+    CRGB b[n];
+    planar_test_fill(a, n, 7);
+    planar_test_fill(b, n, 99);
+    PlanarRGB pa;
+    PlanarRGB pb;
+    pa.fromInterleaved(a, n);
+    pb.fromInterleaved(b, n);
+
+    fadeToBlackBy(a, n, 40);
+    planar::fadeToBlackBy(pa, 40);
+    CHECK(planar_test_equal(pa, a, n));
+
+    fadeUsingColor(a, n, CRGB(200, 100, 255));
+    planar::nscale8(pa, CRGB(200, 100, 255));
+    CHECK(planar_test_equal(pa, a, n));
+
+    for (u8 amount : {u8(0), u8(77), u8(255)}) {
+        nblend(a, b, n, amount);
+        planar::nblend(pa, pb, amount);
+        CHECK(planar_test_equal(pa, a, n));
+        planar_test_fill(b, n, amount);
+        pb.fromInterleaved(b, n);
+    }
+
+    for (u8 amount : {u8(0), u8(64), u8(172), u8(250)}) {
+        blur1d(a, n, amount);
+        planar::blur1d(pa, amount);
+        CHECK(planar_test_equal(pa, a, n));
+    }
+
+    CRGBPalette256 palette(LavaColors_p);
+    u8 indices[n];
+    for (int i = 0; i < n; ++i) {
+        indices[i] = u8(i * 37);
+        a[i] = palette[indices[i]];
+    }
+    planar::map_palette(pa, indices, n, palette);
+    CHECK(planar_test_equal(pa, a, n));
+
+    CHECK(calculate_unscaled_power_mW(pa) ==
+          calculate_unscaled_power_mW(a, n));
+
+    fill_solid(a, n, CRGB(1, 2, 3));
+    planar::fill_solid(pa, CRGB(1, 2, 3));
+    CHECK(planar_test_equal(pa, a, n));
+}
+
+TEST_CASE("PlanarRGB writes controller byte order") {
+    CRGB leds[3] = {CRGB(10, 20, 30), CRGB(255, 128, 0), CRGB(1, 2, 3)};
+    PlanarRGB planes;
+    planes.fromInterleaved(leds, 3);
+    u8 out[9];
+    planes.writeOrdered(PixelOrder::of(GRB), CRGB(255, 128, 64), out);
+    for (int i = 0; i < 3; ++i) {
+        CHECK(out[i * 3 + 0] == scale8(leds[i].g, 128));
+        CHECK(out[i * 3 + 1] == scale8(leds[i].r, 255));
+        CHECK(out[i * 3 + 2] == scale8(leds[i].b, 64));
+    }
+}
+
+TEST_CASE("Planar kernels benchmark") {
+    const int n = 1024;
+    const int kRuns = 2000;
+    fl::vector<CRGB> leds(n);
+    fl::vector<CRGB> other(n);
+    planar_test_fill(leds.data(), n, 3);
+    planar_test_fill(other.data(), n, 4);
+    PlanarRGB planes;
+    PlanarRGB otherPlanes;
+    planes.fromInterleaved(leds.data(), n);
+    otherPlanes.fromInterleaved(other.data(), n);
+    CRGBPalette256 palette(OceanColors_p);
+    u8 indices[n];
+    for (int i = 0; i < n; ++i) {
+        indices[i] = u8(i * 7);
+    }
+    u8 wire[n * 3];
+    const PixelOrder grb = PixelOrder::of(GRB);
+    const CRGB scale(255, 200, 180);
+    u32 sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+        planes.fromInterleaved(leds.data(), n);
+        planes.toInterleaved(leds.data());
+    }
+    const double convert = planar_test_seconds(start);
+
+    struct Row {
+        const char *name;
+        double aos;
+        double soa;
+    };
+    Row rows[6];
+    int count = 0;
+    auto run = [&](const char *name, auto aos, auto soa) {
+        auto t = std::chrono::steady_clock::now();
+        for (int r = 0; r < kRuns; ++r) {
+            aos(r);
+        }
+        const double a = planar_test_seconds(t);
+        t = std::chrono::steady_clock::now();
+        for (int r = 0; r < kRuns; ++r) {
+            soa(r);
+        }
+        rows[count++] = {name, a, planar_test_seconds(t)};
+    };
+
+    run(
+        "fade", [&](int) { fadeToBlackBy(leds.data(), n, 1); },
+        [&](int) { planar::fadeToBlackBy(planes, 1); });
+    run(
+        "blend", [&](int) { nblend(leds.data(), other.data(), n, 100); },
+        [&](int) { planar::nblend(planes, otherPlanes, 100); });
+    run(
+        "palette",
+        [&](int r) {
+            for (int i = 0; i < n; ++i) {
+                leds[i] = palette[u8(indices[i] + r)];
+            }
+        },
+        [&](int) { planar::map_palette(planes, indices, n, palette); });
+    run(
+        "blur", [&](int) { blur1d(leds.data(), n, 64); },
+        [&](int) { planar::blur1d(planes, 64); });
+    run(
+        "power",
+        [&](int) { sink += calculate_unscaled_power_mW(leds.data(), n); },
+        [&](int) { sink += calculate_unscaled_power_mW(planes); });
+    run(
+        "encode",
+        [&](int) {
+            const u8 *p = reinterpret_cast<const u8 *>(leds.data());
+            for (int i = 0; i < n; ++i) {
+                wire[i * 3 + 0] = scale8(p[i * 3 + grb.slot[0]],
+                                         scale.raw[grb.slot[0]]);
+                wire[i * 3 + 1] = scale8(p[i * 3 + grb.slot[1]],
+                                         scale.raw[grb.slot[1]]);
+                wire[i * 3 + 2] = scale8(p[i * 3 + grb.slot[2]],
+                                         scale.raw[grb.slot[2]]);
+            }
+        },
+        [&](int) { planes.writeOrdered(grb, scale, wire); });
+
+    CHECK(sink != 1);
+    CHECK(wire[0] != 1 + wire[1] + 300); // Keep the loops alive.
+    MESSAGE("us per " << n << " leds, convert both ways "
+                      << convert * 1e6 / kRuns);
+    for (int i = 0; i < count; ++i) {
+        MESSAGE(fl::string(rows[i].name)
+                << " CRGB " << rows[i].aos * 1e6 / kRuns << ", planar "
+                << rows[i].soa * 1e6 / kRuns);
+    }
+}
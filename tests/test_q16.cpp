@@ -0,0 +1,191 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+#include <math.h>
+
+#include "fl/q16.h"
+#include "fl/raster.h"
+#include "fl/splat.h"
+#include "fl/transform.h"
+#include "fl/xypath.h"
+
+using namespace fl;
+
+namespace {
+
+// Largest distance between the float and fixed point version of a path.
+float max_path_error(XYPathGenerator &path) {
+    float worst = 0;
+    for (u32 a = 0; a <= 0xFFFF; a += 97) {
+        vec2f f = path.compute(a / 65535.0f);
+        vec2f q = to_vec2f(path.compute_q16(alpha16(a)));
+        worst = MAX(worst, fabsf(f.x - q.x));
+        worst = MAX(worst, fabsf(f.y - q.y));
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST_CASE("q16 arithmetic") {
+    CHECK(q16(3).raw() == 3 * 65536);
+    CHECK(q16(-2).to_int() == -2);
+    CHECK(q16::from_float(-0.5f).to_int() == -1); // floor
+    CHECK(q16::from_float(-0.5f).frac() == 0x8000);
+    CHECK((q16(3) * q16::from_float(0.25f)) == q16::from_float(0.75f));
+    CHECK((q16(3) / q16(4)).to_float() == 0.75f);
+    CHECK(q16::from_float(1.5f).to_float() == 1.5f);
+
+    // The split multiply is exact against the 64 bit one.
+    u32 seed = 12345;
+    for (int i = 0; i < 10000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        i32 a = i32(seed) >> (seed & 7);
+        seed = seed * 1664525u + 1013904223u;
+        i32 b = i32(seed) >> 12;
+        i32 expected = i32((i64(a) * i64(b)) >> 16);
+        REQUIRE(q16::mul(a, b) == expected);
+    }
+}
+
+TEST_CASE("float alpha converts to a clamped alpha16") {
+    CHECK(alpha16_from_float(0.0f) == 0);
+    CHECK(alpha16_from_float(0.5f) == 32768);
+    CHECK(alpha16_from_float(1.0f) == 65535);
+    CHECK(alpha16_from_float(-0.25f) == 0);
+    CHECK(alpha16_from_float(1.5f) == 65535);
+    CHECK(alpha16_from_float(1e9f) == 65535);
+    CHECK(alpha16_from_float(NAN) == 0);
+}
+
+TEST_CASE("q16 trig against sinf/cosf") {
+    for (u32 i = 0; i < 1024; ++i) {
+        float turns = i / 1024.0f;
+        u32 angle = turns_to_angle(q16::from_float(turns));
+        CHECK(fabsf(sin_q16(angle).to_float() - sinf(turns * 2 * PI)) < 0.001f);
+        CHECK(fabsf(cos_q16(angle).to_float() - cosf(turns * 2 * PI)) < 0.001f);
+    }
+    CHECK(alpha16_to_q16(0) == q16(0));
+    CHECK(alpha16_to_q16(0xFFFF) == q16(1));
+}
+
+TEST_CASE("TransformQ16 matches TransformFloat") {
+    TransformFloat tx;
+    tx.set_scale_x(3.5f);
+    tx.set_scale_y(-2.0f);
+    tx.set_offset_x(1.25f);
+    tx.set_offset_y(-4.0f);
+    tx.set_rotation(0.3f);
+    TransformQ16 q = TransformQ16::From(tx);
+    CHECK_FALSE(q.is_identity());
+    CHECK(TransformQ16().is_identity());
+    for (int i = -10; i <= 10; ++i) {
+        vec2f in(i * 0.1f, 1.0f - i * 0.05f);
+        vec2f f = tx.transform(in);
+        vec2f out = to_vec2f(q.transform(to_vec2q16(in)));
+        CHECK(fabsf(f.x - out.x) < 0.002f);
+        CHECK(fabsf(f.y - out.y) < 0.002f);
+    }
+}
+
+TEST_CASE("q16 paths match the float paths") {
+    CirclePath circle;
+    CHECK(max_path_error(circle) < 0.001f);
+    LinePath line(-1.0f, 0.5f, 1.0f, -0.25f);
+    CHECK(max_path_error(line) < 0.001f);
+    PointPath point(0.25f, -0.75f);
+    CHECK(max_path_error(point) < 0.001f);
+    HeartPath heart;
+    CHECK(max_path_error(heart) < 0.002f);
+    ArchimedeanSpiralPath spiral(5, 0.8f);
+    CHECK(max_path_error(spiral) < 0.002f);
+    RosePath rose(3, 1);
+    CHECK(max_path_error(rose) < 0.002f);
+    RosePath rose_fraction(5, 3);
+    CHECK(max_path_error(rose_fraction) < 0.002f);
+    // Falls back to compute(), still in range.
+    PhyllotaxisPath phyllotaxis;
+    CHECK(max_path_error(phyllotaxis) < 0.001f);
+}
+
+TEST_CASE("q16 paths follow parameter changes") {
+    LinePathParamsPtr params = fl::make_intrusive<LinePathParams>();
+    LinePath line(params);
+    CHECK(to_vec2f(line.compute_q16(0xFFFF)).x == doctest::Approx(1.0f));
+    // Shared params edited in place.
+    params->x1 = 0.5f;
+    CHECK(to_vec2f(line.compute_q16(0xFFFF)).x == doctest::Approx(0.5f));
+    line.set(0.0f, 0.0f, -1.0f, 0.25f);
+    CHECK(max_path_error(line) < 0.001f);
+
+    PointPath point(0.25f, -0.75f);
+    point.set(-0.5f, 0.5f);
+    CHECK(max_path_error(point) < 0.001f);
+    ArchimedeanSpiralPath spiral(3, 0.5f);
+    spiral.setRadius(0.9f);
+    CHECK(max_path_error(spiral) < 0.002f);
+}
+
+TEST_CASE("splat q16 matches splat float") {
+    for (int i = 0; i < 200; ++i) {
+        vec2f xy(-3.0f + i * 0.0371f, 5.0f - i * 0.0533f);
+        Tile2x2_u8 f = splat(xy);
+        Tile2x2_u8 q = splat(to_vec2q16(xy));
+        REQUIRE(f.origin() == q.origin());
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x) {
+                CHECK(ABS(int(f.at(x, y)) - int(q.at(x, y))) <= 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("XYPath q16 pipeline follows the float pipeline") {
+    XYPathPtr path = XYPath::NewHeartPath(48, 32);
+    path->transform().set_scale(0.8f);
+    path->transform().set_rotation(0.1f);
+    for (u32 a = 0; a <= 0xFFFF; a += 257) {
+        vec2f f = path->at(a / 65535.0f);
+        vec2f q = to_vec2f(path->at_q16(alpha16(a)));
+        CHECK(fabsf(f.x - q.x) < 0.05f);
+        CHECK(fabsf(f.y - q.y) < 0.05f);
+    }
+    Tile2x2_u8 tile = path->at_subpixel_q16(0x4000);
+    vec2f center = path->at(0x4000 / 65535.0f);
+    CHECK(tile.origin().x == i16(floorf(center.x - 0.5f)));
+    CHECK(tile.origin().y == i16(floorf(center.y - 0.5f)));
+}
+
+TEST_CASE("q16 path benchmark") {
+    XYPathPtr path = XYPath::NewRosePath(64, 64);
+    path->transform().set_rotation(0.25f);
+    XYRasterU8Sparse raster;
+    const int kSteps = 2000;
+    const int kDraws = 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kDraws; ++i) {
+        raster.clear();
+        path->rasterize(0.0f, 1.0f, kSteps, raster);
+    }
+    double fp = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    const fl::size float_pixels = raster.size();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kDraws; ++i) {
+        raster.clear();
+        path->rasterize_q16(0, 0xFFFF, kSteps, raster);
+    }
+    double fixed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    CHECK(raster.size() > 0);
+    CHECK(ABS(int(raster.size()) - int(float_pixels)) < int(float_pixels) / 20);
+    // Host numbers, the FPU-less targets are where the gap shows.
+    MESSAGE("RosePath rasterize: float " << fp * 1e9 / (kSteps * kDraws)
+                                         << " ns/point, q16 "
+                                         << fixed * 1e9 / (kSteps * kDraws)
+                                         << " ns/point");
+}
@@ -0,0 +1,99 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "fl/rmt_symbol_encoder.h"
+#include "fl/vector.h"
+
+using namespace fl;
+
+namespace {
+
+// WS2812 at the IDF4 driver's 40 MHz RMT clock.
+const u32 kZero = rmt_symbol(16, 34);
+const u32 kOne = rmt_symbol(32, 18);
+
+// The per bit loop the IDF4 driver used before the table.
+void reference_encode(u8 byteval, u32 zero, u32 one, u32 *out) {
+    u32 pixel_u32 = u32(byteval) << 24;
+    for (u32 j = 0; j < 8; j++) {
+        out[j] = (pixel_u32 & 0x80000000L) ? one : zero;
+        pixel_u32 <<= 1;
+    }
+}
+
+} // namespace
+
+TEST_CASE("rmt_symbol packs the RMT item layout") {
+    // duration0:15 level0:1 duration1:15 level1:1
+    CHECK(rmt_symbol(16, 34) == (16u | (1u << 15) | (34u << 16)));
+    CHECK((rmt_symbol(0x7FFF, 0x7FFF) >> 31) == 0u); // Low level stays low.
+}
+
+TEST_CASE("RmtSymbolEncoder matches the per bit encoder") {
+    RmtSymbolEncoder enc(kZero, kOne);
+    CHECK(enc.zero() == kZero);
+    CHECK(enc.one() == kOne);
+    for (int b = 0; b < 256; ++b) {
+        u32 expected[8];
+        u32 actual[8];
+        reference_encode(u8(b), kZero, kOne, expected);
+        enc.encode(u8(b), actual);
+        for (int j = 0; j < 8; ++j) {
+            REQUIRE(expected[j] == actual[j]);
+        }
+    }
+
+    // Bulk into a volatile destination, the way the refill writes RMT memory.
+    u8 data[37];
+    for (int i = 0; i < 37; ++i) {
+        data[i] = u8(i * 53 + 7);
+    }
+    volatile u32 out[37 * 8 + 1];
+    out[37 * 8] = 0xDEADBEEF;
+    CHECK(enc.encode(data, 37, out) == 37 * 8);
+    CHECK(out[37 * 8] == 0xDEADBEEF);
+    for (int i = 0; i < 37; ++i) {
+        u32 expected[8];
+        reference_encode(data[i], kZero, kOne, expected);
+        for (int j = 0; j < 8; ++j) {
+            REQUIRE(out[i * 8 + j] == expected[j]);
+        }
+    }
+}
+
+TEST_CASE("RmtSymbolEncoder throughput") {
+    const u32 kBytes = 3 * 1000; // 1000 RGB leds.
+    const int kRuns = 200;
+    fl::vector<u8> data(kBytes);
+    for (u32 i = 0; i < kBytes; ++i) {
+        data[i] = u8(i * 131 + 17);
+    }
+    fl::vector<u32> out(kBytes * 8);
+    RmtSymbolEncoder enc(kZero, kOne);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+        for (u32 i = 0; i < kBytes; ++i) {
+            reference_encode(data[i], kZero, kOne, &out[i * 8]);
+        }
+    }
+    double per_bit = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    u32 check = out[kBytes * 8 - 1];
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+        enc.encode(data.data(), kBytes, out.data());
+    }
+    double table = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    CHECK(out[kBytes * 8 - 1] == check);
+    const double mb = double(kBytes) * kRuns / 1e6;
+    MESSAGE("RMT encode MB/s: per bit " << mb / per_bit << ", table "
+                                        << mb / table);
+}
@@ -0,0 +1,130 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+
+#include "FastLED.h"
+#include "fl/colorutils.h"
+#include "fl/scale8_bulk.h"
+#include "fl/vector.h"
+
+using namespace fl;
+
+namespace {
+
+// Every byte value, shifted per scale so that lanes see different inputs. The
+// odd length and offset exercise the unaligned head and the scalar tail.
+fl::vector<u8> all_bytes(int rotate) {
+    fl::vector<u8> out;
+    for (int i = 0; i < 256 * 3 + 7; ++i) {
+        out.push_back(u8(i * 7 + rotate));
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("scale8_bulk is bit exact with scale8") {
+    MESSAGE("scale8_bulk kernels: " << fl::string(scale8_bulk_impl()));
+    for (int scale = 0; scale < 256; ++scale) {
+        fl::vector<u8> data = all_bytes(scale);
+        fl::vector<u8> expected = data;
+        for (fl::size i = 1; i < expected.size(); ++i) {
+            expected[i] = scale8(expected[i], u8(scale));
+        }
+        scale8_bulk(data.data() + 1, data.size() - 1, u8(scale));
+        for (fl::size i = 0; i < data.size(); ++i) {
+            REQUIRE(data[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("scale8_video_bulk is bit exact with scale8_video") {
+    for (int scale = 0; scale < 256; ++scale) {
+        fl::vector<u8> data = all_bytes(scale);
+        // Make sure zeros hit every lane position.
+        for (fl::size i = 0; i < data.size(); i += 5) {
+            data[i] = 0;
+        }
+        fl::vector<u8> expected = data;
+        for (fl::size i = 0; i < expected.size(); ++i) {
+            expected[i] = scale8_video(expected[i], u8(scale));
+        }
+        scale8_video_bulk(data.data(), data.size(), u8(scale));
+        for (fl::size i = 0; i < data.size(); ++i) {
+            REQUIRE(data[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("bulk CRGB fades match the per pixel versions") {
+    const int kNum = 301;
+    fl::vector<CRGB> leds(kNum);
+    for (int i = 0; i < kNum; ++i) {
+        leds[i] = CRGB(u8(i * 3), u8(i * 5 + 1), u8(255 - i));
+    }
+    const u8 scales[] = {0, 1, 2, 127, 128, 200, 254, 255};
+    for (u8 scale : scales) {
+        fl::vector<CRGB> a = leds;
+        fl::vector<CRGB> b = leds;
+        nscale8(a.data(), kNum, scale);
+        for (auto &c : b) {
+            c.nscale8(scale);
+        }
+        REQUIRE(a == b);
+
+        a = leds;
+        b = leds;
+        nscale8_video(a.data(), kNum, scale);
+        for (auto &c : b) {
+            c.nscale8_video(scale);
+        }
+        REQUIRE(a == b);
+
+        a = leds;
+        b = leds;
+        fadeToBlackBy(a.data(), kNum, scale);
+        for (auto &c : b) {
+            c.fadeToBlackBy(scale);
+        }
+        REQUIRE(a == b);
+
+        a = leds;
+        b = leds;
+        const CRGB mask(scale, u8(255 - scale), u8(scale / 2));
+        fadeUsingColor(a.data(), kNum, mask);
+        for (auto &c : b) {
+            c.r = scale8(c.r, mask.r);
+            c.g = scale8(c.g, mask.g);
+            c.b = scale8(c.b, mask.b);
+        }
+        REQUIRE(a == b);
+    }
+}
+
+TEST_CASE("scale8_bulk throughput") {
+    const int kNum = 4096;
+    const int kFrames = 2000;
+    fl::vector<CRGB> leds(kNum, CRGB(200, 100, 50));
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        fadeToBlackBy(leds.data(), kNum, 1);
+    }
+    double bulk = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (auto &c : leds) {
+            c.nscale8(254);
+        }
+    }
+    double scalar = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    CHECK(leds[0].r < 200);
+    MESSAGE("fadeToBlackBy " << kNum << " leds: bulk " << bulk * 1e6 / kFrames
+                             << " us/frame, per pixel "
+                             << scalar * 1e6 / kFrames << " us/frame");
+}
@@ -5,6 +5,9 @@
 
 #include "test.h"
 #include "fl/screenmap.h"
+#include "fl/file_system.h"
+
+#include <chrono>
 
 #include "fl/namespace.h"
 FASTLED_USING_NAMESPACE
@@ -157,3 +160,195 @@ TEST_CASE("ScreenMap getBounds functionality") {
     CHECK(emptyBounds.x == 0.0f);
     CHECK(emptyBounds.y == 0.0f);
 }
+
+namespace {
+
+// In memory file handle, used to exercise the streaming binary parser.
+class MemoryFileHandle : public fl::FileHandle {
+  public:
+    explicit MemoryFileHandle(const fl::vector<u8> &data) : mData(data) {}
+    bool available() const override { return mPos < mData.size(); }
+    fl::size size() const override { return mData.size(); }
+    fl::size read(u8 *dst, fl::size n) override {
+        fl::size i = 0;
+        for (; i < n && mPos < mData.size(); ++i) {
+            dst[i] = mData[mPos++];
+        }
+        return i;
+    }
+    fl::size pos() const override { return mPos; }
+    const char *path() const override { return "memory"; }
+    bool seek(fl::size pos) override {
+        if (pos > mData.size()) {
+            return false;
+        }
+        mPos = pos;
+        return true;
+    }
+    void close() override {}
+    bool valid() const override { return true; }
+
+  private:
+    fl::vector<u8> mData;
+    fl::size mPos = 0;
+};
+
+} // namespace
+
+TEST_CASE("ScreenMap binary round trip") {
+    FixedMap<fl::string, ScreenMap, 16> maps;
+    maps.insert("circle", ScreenMap::Circle(1000, 2.0f, 0.5f));
+    ScreenMap strip(3, 1.5f);
+    strip.set(0, {10.0f, 20.0f});
+    strip.set(1, {30.0f, 40.0f});
+    strip.set(2, {50.0f, 60.0f});
+    maps.insert("strip", strip);
+
+    for (int delta = 0; delta < 2; ++delta) {
+        fl::vector<u8> binary;
+        ScreenMap::toBinary(maps, &binary, delta != 0);
+        CHECK(ScreenMap::IsBinary(binary.data(), binary.size()));
+
+        FixedMap<fl::string, ScreenMap, 16> decoded;
+        fl::string err;
+        REQUIRE(ScreenMap::ParseBinary(binary.data(), binary.size(), &decoded,
+                                       &err));
+        REQUIRE(decoded.size() == 2);
+        const ScreenMap &circle = decoded["circle"];
+        const ScreenMap &orig = maps["circle"];
+        REQUIRE(circle.getLength() == 1000);
+        CHECK(circle.getDiameter() == 0.5f);
+        // Half a quantization step over the bounding box.
+        const float tolerance = orig.getBounds().x / 65534.0f;
+        for (u32 i = 0; i < circle.getLength(); ++i) {
+            REQUIRE(fabsf(circle[i].x - orig[i].x) <= tolerance);
+            REQUIRE(fabsf(circle[i].y - orig[i].y) <= tolerance);
+        }
+        CHECK(decoded["strip"][2].x == doctest::Approx(50.0f).epsilon(0.001));
+        CHECK(decoded["strip"][2].y == doctest::Approx(60.0f).epsilon(0.001));
+    }
+
+    SUBCASE("delta encoding is smaller than raw i16") {
+        fl::vector<u8> raw, delta;
+        ScreenMap::toBinary(maps, &raw, false);
+        ScreenMap::toBinary(maps, &delta, true);
+        CHECK(delta.size() < raw.size());
+        // A 1000 point json float layout is easily 20kB, the binary is <4kB.
+        CHECK(raw.size() < 4200);
+    }
+
+    SUBCASE("truncated data is rejected") {
+        fl::vector<u8> binary;
+        ScreenMap::toBinary(maps, &binary);
+        FixedMap<fl::string, ScreenMap, 16> decoded;
+        CHECK_FALSE(ScreenMap::ParseBinary(binary.data(), binary.size() - 1,
+                                           &decoded));
+    }
+
+    SUBCASE("corrupt point count is rejected before allocating") {
+        FixedMap<fl::string, ScreenMap, 16> one;
+        one.insert("strip", strip);
+        fl::vector<u8> binary;
+        ScreenMap::toBinary(one, &binary);
+        // magic, version, flags, segment count, name length, "strip",
+        // encoding, then the u32 point count.
+        const fl::size count_pos = 4 + 1 + 1 + 2 + 1 + 5 + 1;
+        REQUIRE(binary[count_pos] == 3);
+        binary[count_pos + 3] = 0x7F;
+        FixedMap<fl::string, ScreenMap, 16> decoded;
+        fl::string err;
+        CHECK_FALSE(ScreenMap::ParseBinary(binary.data(), binary.size(),
+                                           &decoded, &err));
+        CHECK(err == "point count exceeds payload");
+
+        // A payload size running past the end of the file is caught too.
+        binary[count_pos + 3] = 0;
+        binary.resize(binary.size() - 2);
+        MemoryFileHandle file(binary);
+        ScreenMap truncated;
+        CHECK_FALSE(ScreenMap::ParseBinary(file, "strip", &truncated, &err));
+        CHECK(err == "point count exceeds payload");
+    }
+
+    SUBCASE("deltas running out of range are rejected") {
+        FixedMap<fl::string, ScreenMap, 16> one;
+        one.insert("strip", strip);
+        fl::vector<u8> binary;
+        ScreenMap::toBinary(one, &binary, true);
+        // After the point count: diameter, origin x, origin y, step, then
+        // the u32 payload size and the payload.
+        const fl::size size_pos = 4 + 1 + 1 + 2 + 1 + 5 + 1 + 4 + 4 * 4;
+        // Every point steps x by INT32_MAX, dy 0.
+        const u8 point[6] = {0xFE, 0xFF, 0xFF, 0xFF, 0x0F, 0x00};
+        binary.resize(size_pos + 4);
+        binary[size_pos] = 3 * sizeof(point);
+        for (int i = 0; i < 3; ++i) {
+            for (u8 b : point) {
+                binary.push_back(b);
+            }
+        }
+        FixedMap<fl::string, ScreenMap, 16> decoded;
+        fl::string err;
+        CHECK_FALSE(ScreenMap::ParseBinary(binary.data(), binary.size(),
+                                           &decoded, &err));
+        CHECK(err == "delta out of range");
+    }
+
+    SUBCASE("streaming and lazy loading from a file") {
+        fl::vector<u8> binary;
+        ScreenMap::toBinary(maps, &binary);
+        MemoryFileHandle file(binary);
+        ScreenMap strip_only;
+        REQUIRE(ScreenMap::ParseBinary(file, "strip", &strip_only));
+        CHECK(strip_only.getLength() == 3);
+        CHECK(strip_only.getDiameter() == 1.5f);
+        CHECK(strip_only[1].x == doctest::Approx(30.0f).epsilon(0.001));
+
+        MemoryFileHandle file2(binary);
+        ScreenMap missing;
+        CHECK_FALSE(ScreenMap::ParseBinary(file2, "nope", &missing));
+
+        MemoryFileHandle file3(binary);
+        FixedMap<fl::string, ScreenMap, 16> decoded;
+        REQUIRE(ScreenMap::ParseBinary(file3, &decoded));
+        CHECK(decoded.size() == 2);
+    }
+}
+
+TEST_CASE("ScreenMap json to binary converter") {
+    const char *json = R"({"map": {"strip1": {"x": [0, 1, 2], "y": [0, -1, -2],
+                                             "diameter": 0.25}}})";
+    fl::vector<u8> binary;
+    REQUIRE(ScreenMap::JsonToBinary(json, &binary));
+    FixedMap<fl::string, ScreenMap, 16> decoded;
+    REQUIRE(ScreenMap::ParseBinary(binary.data(), binary.size(), &decoded));
+    const ScreenMap &strip = decoded["strip1"];
+    REQUIRE(strip.getLength() == 3);
+    CHECK(strip.getDiameter() == 0.25f);
+    CHECK(strip[2].x == doctest::Approx(2.0f).epsilon(0.001));
+    CHECK(strip[2].y == doctest::Approx(-2.0f).epsilon(0.001));
+}
+
+TEST_CASE("ScreenMap binary vs json load time") {
+    FixedMap<fl::string, ScreenMap, 16> maps;
+    maps.insert("sculpture", ScreenMap::Circle(10000, 1.0f, 0.5f));
+    fl::string json;
+    ScreenMap::toJsonStr(maps, &json);
+    fl::vector<u8> binary;
+    ScreenMap::toBinary(maps, &binary);
+
+    auto t0 = std::chrono::steady_clock::now();
+    FixedMap<fl::string, ScreenMap, 16> from_json;
+    REQUIRE(ScreenMap::ParseJson(json.c_str(), &from_json));
+    auto t1 = std::chrono::steady_clock::now();
+    FixedMap<fl::string, ScreenMap, 16> from_binary;
+    REQUIRE(ScreenMap::ParseBinary(binary.data(), binary.size(), &from_binary));
+    auto t2 = std::chrono::steady_clock::now();
+
+    CHECK(from_binary["sculpture"].getLength() == 10000);
+    MESSAGE("10k points: json " << json.size() << " bytes in "
+            << std::chrono::duration<double, std::micro>(t1 - t0).count()
+            << "us, binary " << binary.size() << " bytes in "
+            << std::chrono::duration<double, std::micro>(t2 - t1).count()
+            << "us");
+}
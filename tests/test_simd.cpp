@@ -0,0 +1,235 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "FastLED.h"
+#include "fl/scale8_bulk.h"
+#include "fl/simd.h"
+#include "fl/vector.h"
+
+using namespace fl;
+using fl::simd::Isa;
+using fl::simd::Native;
+using fl::simd::Scalar;
+
+namespace {
+
+const Isa kAllIsas[] = {Isa::kScalar, Isa::kSse2, Isa::kAvx2, Isa::kNeon,
+                        Isa::kWasm};
+
+// Deterministic inputs that cover 0, 255 and everything in between.
+void fill_u8(u8 *out, int n, int seed) {
+    u32 x = u32(seed) * 2654435761u + 1;
+    for (int i = 0; i < n; ++i) {
+        x = x * 1664525u + 1013904223u;
+        out[i] = u8(x >> 24);
+    }
+    out[0] = 0;
+    out[n - 1] = 255;
+}
+
+void fill_i32(i32 *out, int n, int seed) {
+    u32 x = u32(seed) * 2246822519u + 7;
+    for (int i = 0; i < n; ++i) {
+        x = x * 1664525u + 1013904223u;
+        out[i] = i32(x) >> (seed % 12);
+    }
+}
+
+// Runs an u8 op on the native backend and on the scalar reference.
+template <typename OpN, typename OpS>
+void check_u8_op(OpN native_op, OpS scalar_op) {
+    for (int seed = 0; seed < 64; ++seed) {
+        u8 a[16], b[16], got[16], want[16];
+        fill_u8(a, 16, seed);
+        fill_u8(b, 16, seed + 1000);
+        if (seed % 4 == 0) {
+            b[3] = a[3]; // Equal lanes for cmpeq.
+        }
+        Native::store(got, native_op(Native::load_u8x16(a),
+                                     Native::load_u8x16(b)));
+        Scalar::store(want, scalar_op(Scalar::load_u8x16(a),
+                                      Scalar::load_u8x16(b)));
+        for (int i = 0; i < 16; ++i) {
+            REQUIRE(got[i] == want[i]);
+        }
+    }
+}
+
+template <typename OpN, typename OpS>
+void check_i32_op(OpN native_op, OpS scalar_op) {
+    for (int seed = 0; seed < 64; ++seed) {
+        i32 a[4], b[4], got[4], want[4];
+        fill_i32(a, 4, seed);
+        fill_i32(b, 4, seed + 1000);
+        Native::store(got, native_op(Native::load_i32x4(a),
+                                     Native::load_i32x4(b)));
+        Scalar::store(want, scalar_op(Scalar::load_i32x4(a),
+                                      Scalar::load_i32x4(b)));
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(got[i] == want[i]);
+        }
+    }
+}
+
+fl::vector<u8> prefix(const fl::vector<u8> &v, fl::size n) {
+    fl::vector<u8> out;
+    for (fl::size i = 0; i < n; ++i) {
+        out.push_back(v[i]);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("simd backend ops match the scalar backend") {
+    const Isa native =
+        simd::bestIsa() == Isa::kAvx2 ? Isa::kSse2 : simd::bestIsa();
+    MESSAGE("simd native backend: " << fl::string(simd::isaName(native)));
+    typedef Native N;
+    typedef Scalar S;
+
+    SUBCASE("u8x16") {
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::add_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::add_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::adds_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::adds_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::subs_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::subs_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::min_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::min_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::max_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::max_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::cmpeq_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::cmpeq_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::and_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::and_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::or_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::or_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16 b) { return N::andnot_u8(a, b); },
+                    [](S::u8x16 a, S::u8x16 b) { return S::andnot_u8(a, b); });
+        check_u8_op([](N::u8x16 a, N::u8x16) { return N::add_u8(a, N::splat_u8(7)); },
+                    [](S::u8x16 a, S::u8x16) { return S::add_u8(a, S::splat_u8(7)); });
+    }
+
+    SUBCASE("u16x8 through widen and narrow") {
+        // (a * b) >> 8 per byte, the scale8 core.
+        check_u8_op(
+            [](N::u8x16 a, N::u8x16 b) {
+                N::u16x8 lo = N::shr_u16<8>(
+                    N::mullo_u16(N::widen_lo_u8(a), N::widen_lo_u8(b)));
+                N::u16x8 hi = N::shr_u16<8>(
+                    N::mullo_u16(N::widen_hi_u8(a), N::widen_hi_u8(b)));
+                return N::narrow_u16(lo, hi);
+            },
+            [](S::u8x16 a, S::u8x16 b) {
+                S::u16x8 lo = S::shr_u16<8>(
+                    S::mullo_u16(S::widen_lo_u8(a), S::widen_lo_u8(b)));
+                S::u16x8 hi = S::shr_u16<8>(
+                    S::mullo_u16(S::widen_hi_u8(a), S::widen_hi_u8(b)));
+                return S::narrow_u16(lo, hi);
+            });
+        // Wrapping add and shl, kept below 256 before narrowing.
+        check_u8_op(
+            [](N::u8x16 a, N::u8x16 b) {
+                N::u16x8 lo = N::shr_u16<2>(N::add_u16(
+                    N::shl_u16<1>(N::widen_lo_u8(a)), N::widen_lo_u8(b)));
+                N::u16x8 hi = N::shr_u16<2>(N::add_u16(
+                    N::splat_u16(3), N::widen_hi_u8(b)));
+                return N::narrow_u16(lo, hi);
+            },
+            [](S::u8x16 a, S::u8x16 b) {
+                S::u16x8 lo = S::shr_u16<2>(S::add_u16(
+                    S::shl_u16<1>(S::widen_lo_u8(a)), S::widen_lo_u8(b)));
+                S::u16x8 hi = S::shr_u16<2>(S::add_u16(
+                    S::splat_u16(3), S::widen_hi_u8(b)));
+                return S::narrow_u16(lo, hi);
+            });
+        u16 in[8] = {0, 1, 255, 256, 4095, 32768, 65534, 65535};
+        u16 got[8], want[8];
+        N::store(got, N::mullo_u16(N::load_u16x8(in), N::splat_u16(3)));
+        S::store(want, S::mullo_u16(S::load_u16x8(in), S::splat_u16(3)));
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(got[i] == want[i]);
+        }
+    }
+
+    SUBCASE("i32x4") {
+        check_i32_op([](N::i32x4 a, N::i32x4 b) { return N::add_i32(a, b); },
+                     [](S::i32x4 a, S::i32x4 b) { return S::add_i32(a, b); });
+        check_i32_op([](N::i32x4 a, N::i32x4 b) { return N::sub_i32(a, b); },
+                     [](S::i32x4 a, S::i32x4 b) { return S::sub_i32(a, b); });
+        check_i32_op([](N::i32x4 a, N::i32x4 b) { return N::mullo_i32(a, b); },
+                     [](S::i32x4 a, S::i32x4 b) { return S::mullo_i32(a, b); });
+        check_i32_op([](N::i32x4 a, N::i32x4 b) { return N::min_i32(a, b); },
+                     [](S::i32x4 a, S::i32x4 b) { return S::min_i32(a, b); });
+        check_i32_op([](N::i32x4 a, N::i32x4 b) { return N::max_i32(a, b); },
+                     [](S::i32x4 a, S::i32x4 b) { return S::max_i32(a, b); });
+        check_i32_op(
+            [](N::i32x4 a, N::i32x4) {
+                return N::add_i32(N::sra_i32<5>(a), N::shl_i32<3>(N::splat_i32(-9)));
+            },
+            [](S::i32x4 a, S::i32x4) {
+                return S::add_i32(S::sra_i32<5>(a), S::shl_i32<3>(S::splat_i32(-9)));
+            });
+    }
+}
+
+TEST_CASE("simd forceIsa") {
+    CHECK(simd::isaAvailable(Isa::kScalar));
+    CHECK(simd::activeIsa() == simd::bestIsa());
+    CHECK(simd::forceIsa(Isa::kScalar));
+    CHECK(simd::activeIsa() == Isa::kScalar);
+    CHECK(fl::string(scale8_bulk_impl()) == "scalar");
+    for (Isa isa : kAllIsas) {
+        if (!simd::isaAvailable(isa)) {
+            CHECK_FALSE(simd::forceIsa(isa));
+            CHECK(simd::activeIsa() == Isa::kScalar);
+        }
+    }
+    simd::resetIsa();
+    CHECK(simd::activeIsa() == simd::bestIsa());
+}
+
+TEST_CASE("scale8 bulk kernels agree in every available ISA") {
+    fl::vector<u8> input;
+    for (int i = 0; i < 256 * 3 + 11; ++i) {
+        input.push_back(u8(i * 13 + 5));
+    }
+    for (fl::size i = 0; i < input.size(); i += 7) {
+        input[i] = 0;
+    }
+    const u8 scales[] = {0, 1, 2, 3, 64, 127, 128, 129, 200, 254, 255};
+    for (Isa isa : kAllIsas) {
+        if (!simd::forceIsa(isa)) {
+            continue;
+        }
+        MESSAGE("checking scale8 bulk kernels with "
+                << fl::string(simd::isaName(isa)));
+        for (u8 scale : scales) {
+            // Odd lengths so every kernel leaves a tail.
+            for (fl::size n : {fl::size(1), fl::size(15), fl::size(33),
+                               fl::size(input.size())}) {
+                fl::vector<u8> a = prefix(input, n);
+                fl::vector<u8> b = a;
+                scale8_bulk(a.data(), n, scale);
+                scale8_video_bulk(b.data(), n, scale);
+                for (fl::size i = 0; i < n; ++i) {
+                    REQUIRE(a[i] == scale8(input[i], scale));
+                    REQUIRE(b[i] == scale8_video(input[i], scale));
+                }
+            }
+            const fl::size pixels = input.size() / 3;
+            fl::vector<u8> rgb = prefix(input, pixels * 3);
+            const u8 sg = u8(255 - scale);
+            const u8 sb = u8(scale / 2);
+            scale8_rgb_bulk(rgb.data(), pixels, scale, sg, sb);
+            for (fl::size i = 0; i < pixels; ++i) {
+                REQUIRE(rgb[i * 3] == scale8(input[i * 3], scale));
+                REQUIRE(rgb[i * 3 + 1] == scale8(input[i * 3 + 1], sg));
+                REQUIRE(rgb[i * 3 + 2] == scale8(input[i * 3 + 2], sb));
+            }
+        }
+    }
+    simd::resetIsa();
+}
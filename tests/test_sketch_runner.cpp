@@ -0,0 +1,128 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#include "FastLED.h"
+#include "fl/vector.h"
+#include "platforms/stub/sketch_runner.h"
+#include "platforms/stub/time_stub.h"
+
+using namespace fl;
+
+namespace {
+
+CRGB gStripA[4];
+CRGB gStripB[3];
+
+void two_strip_setup() {
+    FastLED.addLeds<WS2812, 1, GRB>(gStripA, 4);
+    FastLED.addLeds<WS2812, 2, GRB>(gStripB, 3);
+}
+
+// Paints the virtual time in milliseconds so frames are easy to check.
+void two_strip_loop() {
+    const u8 t = u8(millis() / 1000);
+    fill_solid(gStripA, 4, CRGB(t, 1, 2));
+    fill_solid(gStripB, 3, CRGB(3, t, 4));
+    FastLED.show();
+}
+
+} // namespace
+
+TEST_CASE("SketchRunner captures every controller on the virtual clock") {
+    SketchRunner runner(two_strip_setup, two_strip_loop);
+    runner.setFrameMicros(1000000);
+    runner.run(5);
+    CHECK_FALSE(stubClockIsVirtual());
+
+    const fl::vector<SketchFrame> &frames = runner.frames();
+    REQUIRE(frames.size() == 5);
+    REQUIRE(runner.stripSizes().size() == 2);
+    CHECK(runner.stripSizes()[0] == 4);
+    CHECK(runner.stripSizes()[1] == 3);
+    for (u32 i = 0; i < frames.size(); ++i) {
+        const SketchFrame &f = frames[i];
+        CHECK(f.loop == i);
+        CHECK(f.micros == u64(i) * 1000000);
+        REQUIRE(f.pixels.size() == 7);
+        CHECK(f.pixels[0] == CRGB(u8(i), 1, 2));
+        CHECK(f.pixels[3] == CRGB(u8(i), 1, 2));
+        CHECK(f.pixels[4] == CRGB(3, u8(i), 4));
+        CHECK(f.pixels[6] == CRGB(3, u8(i), 4));
+    }
+
+    // The clock carries on where the previous run stopped.
+    runner.run(2);
+    REQUIRE(runner.frames().size() == 7);
+    CHECK(runner.frames()[6].micros == 6000000);
+    CHECK(runner.frames()[6].pixels[0] == CRGB(6, 1, 2));
+
+    SketchRunStats stats = runner.stats();
+    CHECK(stats.loops == 7);
+    CHECK(stats.frames == 7);
+    CHECK(stats.loopMinNanos <= stats.loopP50Nanos);
+    CHECK(stats.loopP50Nanos <= stats.loopMaxNanos);
+
+    // Raw RGB24 frames back to back.
+    const char *path = "sketch_runner_test.rgb";
+    REQUIRE(runner.writeVideo(path));
+    FILE *f = fopen(path, "rb");
+    REQUIRE(f != nullptr);
+    fl::vector<u8> bytes;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        bytes.push_back(u8(c));
+    }
+    fclose(f);
+    remove(path);
+    REQUIRE(bytes.size() == 7 * 7 * 3);
+    CHECK(bytes[3 * 7 * 2 + 0] == 2); // Frame 2, first pixel red.
+    CHECK(bytes[3 * 7 * 2 + 3 * 4 + 1] == 2); // Frame 2, strip B green.
+}
+
+TEST_CASE("SketchRunner delay() advances the virtual clock") {
+    u32 last_millis = 0;
+    SketchRunner runner([]() {},
+                        [&last_millis]() {
+                            delay(60000);
+                            last_millis = millis();
+                        });
+    runner.setFrameMicros(1000);
+    runner.setCapture(false);
+    const auto start = std::chrono::steady_clock::now();
+    runner.run(100);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    // 100 minutes of sketch time, no real sleeping.
+    CHECK(last_millis == 100u * 60000u);
+    CHECK(elapsed < std::chrono::seconds(5));
+    CHECK(runner.frames().empty());
+}
+
+TEST_CASE("SketchRunner counts allocations") {
+    SketchRunner runner(
+        []() {
+            fl::vector<int> v;
+            v.push_back(1);
+        },
+        []() {
+            fl::vector<int> v;
+            for (int i = 0; i < 64; ++i) {
+                v.push_back(i);
+            }
+        });
+    runner.setCapture(false);
+    runner.run(10);
+    SketchRunStats stats = runner.stats();
+    CHECK(stats.setupAllocs >= 1);
+    CHECK(stats.allocs >= stats.setupAllocs + 10);
+    CHECK(stats.allocBytes >= 10 * 64 * sizeof(int));
+    CHECK(stats.frees == stats.allocs);
+
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(runner.reportJson().c_str(), &doc));
+    CHECK(doc["loops"].as<int>() == 10);
+    CHECK(doc["allocs"].as<int>() == int(stats.allocs));
+}
@@ -146,6 +146,30 @@ TEST_CASE("Str overflowing inline data") {
     }
 }
 
+TEST_CASE("Str substring is terminated at its length") {
+    // The inline copy of a slice must not pick up the character after it.
+    Str s("slider: 42");
+    Str name = s.substring(0, 6);
+    CHECK(name.size() == 6);
+    CHECK(strlen(name.c_str()) == 6);
+    CHECK(strcmp(name.c_str(), "slider") == 0);
+    CHECK(name == "slider");
+
+    Str middle = s.substring(2, 5);
+    CHECK(strcmp(middle.c_str(), "ide") == 0);
+
+    Str trimmed = Str("  x  ").trim();
+    CHECK(strcmp(trimmed.c_str(), "x") == 0);
+
+    // Same on the heap path.
+    std::string long_string(FASTLED_STR_INLINED_SIZE + 10, 'd');
+    long_string += "tail";
+    Str big(long_string.c_str());
+    Str head = big.substring(0, FASTLED_STR_INLINED_SIZE + 5);
+    CHECK(strlen(head.c_str()) == FASTLED_STR_INLINED_SIZE + 5);
+    CHECK(head[head.size() - 1] == 'd');
+}
+
 TEST_CASE("String concatenation operators") {
     SUBCASE("String literal + fl::to_string") {
         // Test the specific case mentioned in the user query
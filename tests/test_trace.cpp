@@ -0,0 +1,179 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include <thread>
+
+#include "FastLED.h"
+#include "fl/json.h"
+#include "fl/atomic.h"
+#include "fl/json_console.h"
+#include "fl/trace.h"
+#include "fl/vector.h"
+
+using namespace fl;
+
+namespace {
+
+int count_events(const fl::string &json, const char *name) {
+    fl::string needle = "\"name\":\"";
+    needle += name;
+    needle += "\"";
+    int n = 0;
+    const char *p = json.c_str();
+    while ((p = strstr(p, needle.c_str())) != nullptr) {
+        ++n;
+        p += needle.size();
+    }
+    return n;
+}
+
+void traced_work() {
+    FL_TRACE_SCOPE("test.work");
+    volatile int sink = 0;
+    for (int i = 0; i < 1000; ++i) {
+        sink = sink + i;
+    }
+}
+
+} // namespace
+
+TEST_CASE("FL_TRACE_SCOPE records into the ring") {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+    CHECK(tracer.numEvents() == 0);
+    for (int i = 0; i < 3; ++i) {
+        traced_work();
+    }
+    CHECK(tracer.numEvents() == 3);
+    fl::string json = tracer.chromeTraceJson();
+    CHECK(count_events(json, "test.work") == 3);
+    CHECK(json.find("\"ph\":\"X\"") != fl::string::npos);
+
+    // The export is valid json in the Chrome trace event format.
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(json.c_str(), &doc));
+    auto events = doc["traceEvents"].as<FLArduinoJson::JsonArrayConst>();
+    CHECK(events.size() == 3);
+    CHECK(fl::string(events[0]["name"].as<const char *>()) == "test.work");
+    CHECK(events[0]["ts"].as<int>() == 0);
+
+    tracer.setEnabled(false);
+    traced_work();
+    tracer.setEnabled(true);
+    CHECK(tracer.numEvents() == 3);
+
+    tracer.clear();
+    CHECK(tracer.numEvents() == 0);
+    CHECK(tracer.chromeTraceJson() ==
+          "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+}
+
+TEST_CASE("trace ring keeps the newest events") {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+    const u32 before = tracer.numRecorded();
+    for (int i = 0; i < FASTLED_TRACE_RING_SIZE + 10; ++i) {
+        tracer.record(i < 10 ? "old" : "new", u32(i), u32(i + 1));
+    }
+    CHECK(tracer.numRecorded() - before == FASTLED_TRACE_RING_SIZE + 10);
+    CHECK(tracer.numEvents() == FASTLED_TRACE_RING_SIZE);
+    fl::string json = tracer.chromeTraceJson();
+    CHECK(count_events(json, "old") == 0);
+    CHECK(count_events(json, "new") == FASTLED_TRACE_RING_SIZE);
+    tracer.clear();
+}
+
+TEST_CASE("trace rings are per thread") {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+    traced_work();
+    std::thread worker([]() {
+        for (int i = 0; i < 5; ++i) {
+            FL_TRACE_SCOPE("test.worker");
+        }
+    });
+    worker.join();
+    CHECK(tracer.numEvents() == 6);
+    fl::string json = tracer.chromeTraceJson();
+    CHECK(count_events(json, "test.worker") == 5);
+    // Two distinct thread ids in the export.
+    fl::JsonDocument doc;
+    REQUIRE(fl::parseJson(json.c_str(), &doc));
+    int main_tid = -1;
+    int worker_tid = -1;
+    for (auto e : doc["traceEvents"].as<FLArduinoJson::JsonArrayConst>()) {
+        const int tid = e["tid"].as<int>();
+        if (fl::string(e["name"].as<const char *>()) == "test.work") {
+            main_tid = tid;
+        } else {
+            worker_tid = tid;
+        }
+    }
+    CHECK(main_tid >= 0);
+    CHECK(worker_tid >= 0);
+    CHECK(main_tid != worker_tid);
+    tracer.clear();
+}
+
+TEST_CASE("trace export never shows a half written event") {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+    // The owner keeps lapping its ring while this thread exports. Every
+    // event's name says whether its duration is even or odd, a torn copy
+    // would mix the two.
+    fl::atomic_bool stop(false);
+    std::thread worker([&tracer, &stop]() {
+        for (u32 i = 0; !stop.load(); ++i) {
+            tracer.record(i % 2 ? "odd" : "even", 0, i);
+        }
+    });
+    while (tracer.numEvents() < FASTLED_TRACE_RING_SIZE) {
+    }
+    int mismatched = 0;
+    for (int exports = 0; exports < 50; ++exports) {
+        fl::JsonDocument doc;
+        REQUIRE(fl::parseJson(tracer.chromeTraceJson().c_str(), &doc));
+        for (auto e : doc["traceEvents"].as<FLArduinoJson::JsonArrayConst>()) {
+            const bool odd = e["dur"].as<u32>() % 2 == 1;
+            if (fl::string(e["name"].as<const char *>()) !=
+                (odd ? "odd" : "even")) {
+                ++mismatched;
+            }
+        }
+    }
+    stop.store(true);
+    worker.join();
+    CHECK(mismatched == 0);
+    tracer.clear();
+}
+
+TEST_CASE("show() is traced") {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+    FastLED.show();
+    fl::string json = tracer.chromeTraceJson();
+    CHECK(count_events(json, "show") == 1);
+    CHECK(count_events(json, "events.end_frame") == 1);
+    tracer.clear();
+}
+
+TEST_CASE("JsonConsole trace command") {
+    fl::vector<fl::string> output;
+    JsonConsole console([]() { return 0; }, []() { return -1; },
+                        [&output](const char *s) { output.push_back(s); });
+    Tracer::instance().clear();
+    traced_work();
+    CHECK(console.executeCommand("trace"));
+    fl::string json;
+    for (const fl::string &line : output) {
+        json += line;
+    }
+    CHECK(count_events(json, "test.work") == 1);
+    fl::JsonDocument doc;
+    CHECK(fl::parseJson(json.c_str(), &doc));
+
+    output.clear();
+    CHECK(console.executeCommand("trace clear"));
+    CHECK(Tracer::instance().numEvents() == 0);
+}
@@ -501,4 +501,31 @@ TEST_CASE("JsonConsole dump function") {
         CHECK(contains(dump, "=== End JsonConsole Dump ==="));
     }
 }
+
+TEST_CASE("JsonConsole keeps component names across delta updates") {
+    fl::vector<fl::string> output;
+    fl::JsonConsole console([]() { return 0; }, []() { return -1; },
+                            [&output](const char *s) { output.push_back(s); });
+    console.init();
+    {
+        fl::UISlider slider("brightness", 10.0f, 0.0f, 255.0f);
+        fl::UICheckbox toggle("toggle", false);
+        // Full snapshot, then a delta carrying only the checkbox.
+        fl::processJsonUiPendingUpdates();
+        toggle = true;
+        fl::processJsonUiPendingUpdates();
+
+        fl::sstream dump;
+        console.dump(dump);
+        CHECK(strstr(dump.str().c_str(), "Component Count: 2") != nullptr);
+
+        // Set by name after the delta.
+        CHECK(console.executeCommand("brightness: 42"));
+        CHECK(slider.value() == doctest::Approx(42.0f));
+        REQUIRE(!output.empty());
+        CHECK(output.back() == "Set brightness to 42");
+    }
+    fl::setJsonUiHandlers(fl::function<void(const char *)>{});
+}
+
 #endif // SKETCH_HAS_LOTS_OF_MEMORY
@@ -0,0 +1,98 @@
+// g++ --std=c++11 test.cpp
+
+#include "test.h"
+
+#include "fl/xymap.h"
+
+using namespace fl;
+
+namespace {
+
+u16 xymap_lut_test_fn(u16 x, u16 y, u16 width, u16 height) {
+    return (height - 1 - y) * width + x;
+}
+
+} // namespace
+
+TEST_CASE("XYMap look up table is built lazily and shared") {
+    const fl::size before = XYMapLUT::liveCount();
+    {
+        XYMap a = XYMap::constructSerpentine(40, 10);
+        XYMap reference = a;
+        a.convertToLookUpTable();
+        CHECK(a.isLUT());
+        CHECK(XYMapLUT::liveCount() == before); // Not built yet.
+
+        XYMap b = XYMap::constructSerpentine(40, 10);
+        b.convertToLookUpTable();
+        for (u16 y = 0; y < 10; ++y) {
+            for (u16 x = 0; x < 40; ++x) {
+                REQUIRE(a.mapToIndex(x, y) == reference.mapToIndex(x, y));
+            }
+        }
+        CHECK(XYMapLUT::liveCount() == before + 1);
+        CHECK(a.getLookUpTable() == b.getLookUpTable());
+        CHECK_FALSE(a.getLookUpTable()->isNarrow()); // 400 leds.
+        CHECK(a.getLookUpTable()->bytes() == 400 * sizeof(u16));
+
+        // Different geometry, different table.
+        XYMap c = XYMap::constructRectangularGrid(40, 10);
+        c.convertToLookUpTable();
+        CHECK(c.getLookUpTable() != a.getLookUpTable());
+        CHECK(XYMapLUT::liveCount() == before + 2);
+    }
+    // Released with the last map that used it.
+    CHECK(XYMapLUT::liveCount() == before);
+}
+
+TEST_CASE("XYMap look up table registry drops freed tables") {
+    for (u16 w = 1; w <= 32; ++w) {
+        XYMap map = XYMap::constructSerpentine(w, 3);
+        map.convertToLookUpTable();
+        map.mapToIndex(0, 0);
+        // Only the table just built may be left, plus at most one freed key
+        // that the next build prunes.
+        CHECK(XYMapLUT::registeredCount() <= XYMapLUT::liveCount() + 1);
+    }
+    // User tables, same geometry, different contents.
+    for (u16 i = 0; i < 8; ++i) {
+        const u16 indices[4] = {i, 3, 2, 1};
+        XYMap map = XYMap::constructWithLookUpTable(4, 1, indices);
+        CHECK(XYMapLUT::registeredCount() <= XYMapLUT::liveCount() + 1);
+    }
+}
+
+TEST_CASE("XYMap look up table narrows and keeps the offset") {
+    XYMap map = XYMap::constructSerpentine(16, 16, 100);
+    XYMap reference = map;
+    map.convertToLookUpTable();
+    CHECK(map.getLookUpTable()->isNarrow());
+    CHECK(map.getLookUpTable()->bytes() == 256);
+    for (u16 y = 0; y < 16; ++y) {
+        for (u16 x = 0; x < 16; ++x) {
+            REQUIRE(map.mapToIndex(x, y) == reference.mapToIndex(x, y));
+        }
+    }
+
+    XYMap fn = XYMap::constructWithUserFunction(8, 4, xymap_lut_test_fn);
+    XYMap fnReference = fn;
+    fn.convertToLookUpTable();
+    CHECK(fn.mapToIndex(3, 0) == fnReference.mapToIndex(3, 0));
+    CHECK(fn.mapToIndex(7, 3) == fnReference.mapToIndex(7, 3));
+    fn.setRectangularGrid();
+    CHECK_FALSE(fn.getLookUpTable());
+}
+
+TEST_CASE("XYMap user look up tables share identical contents") {
+    u16 table[6] = {5, 4, 3, 2, 1, 0};
+    u16 other[6] = {0, 1, 2, 3, 4, 5};
+    XYMap a = XYMap::constructWithLookUpTable(3, 2, table);
+    XYMap b = XYMap::constructWithLookUpTable(3, 2, table);
+    XYMap c = XYMap::constructWithLookUpTable(3, 2, other);
+    CHECK(a.getLookUpTable() == b.getLookUpTable());
+    CHECK(a.getLookUpTable() != c.getLookUpTable());
+    CHECK(a.mapToIndex(0, 0) == 5);
+    CHECK(c.mapToIndex(2, 1) == 5);
+    XYMap d = XYMap::constructWithLookUpTable(3, 2, table, 10);
+    CHECK(d.mapToIndex(0, 0) == 15);
+}